@@ -2452,7 +2452,7 @@ size_t QtSLiMGraphView::tallyGUIMutationReferences(slim_objectid_t subpop_id, in
                 
                 for (int run_index = 0; run_index < mutrun_count; ++run_index)
                 {
-                    const MutationRun *mutrun = genome.mutruns_[run_index];
+                    const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
                     const MutationIndex *genome_iter = mutrun->begin_pointer_const();
                     const MutationIndex *genome_end_iter = mutrun->end_pointer_const();
                     
@@ -2506,7 +2506,7 @@ size_t QtSLiMGraphView::tallyGUIMutationReferences(const std::vector<Genome *> &
             
             for (int run_index = 0; run_index < mutrun_count; ++run_index)
             {
-                const MutationRun *mutrun = genome->mutruns_[run_index];
+                const MutationRun *mutrun = genome->MutationRunAtIndex(run_index);
                 const MutationIndex *genome_iter = mutrun->begin_pointer_const();
                 const MutationIndex *genome_end_iter = mutrun->end_pointer_const();
                 
@@ -484,7 +484,7 @@ void QtSLiMHaplotypeManager::configureDisplayBuffers(void)
 			
 			for (int run_index = 0; run_index < mutrun_count; ++run_index)
 			{
-				const MutationRun *mutrun = genome.mutruns_[run_index];
+				const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 				const MutationIndex *mut_start_ptr = mutrun->begin_pointer_const();
 				const MutationIndex *mut_end_ptr = mutrun->end_pointer_const();
 				
@@ -514,7 +514,7 @@ void QtSLiMHaplotypeManager::configureDisplayBuffers(void)
 			
 			for (int run_index = 0; run_index < mutrun_count; ++run_index)
 			{
-				const MutationRun *mutrun = genome.mutruns_[run_index];
+				const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 				const MutationIndex *mut_start_ptr = mutrun->begin_pointer_const();
 				const MutationIndex *mut_end_ptr = mutrun->end_pointer_const();
 				
@@ -653,20 +653,20 @@ int64_t *QtSLiMHaplotypeManager::buildDistanceArray(void)
 		int64_t *distance_column = distances + i;
 		int64_t *distance_row = distances + i * genome_count;
 		int mutrun_count = genome1->mutrun_count_;
-		const MutationRun **genome1_mutruns = genome1->mutruns_;
+		const MutationRunRef *genome1_mutruns = genome1->mutruns_;
 		
 		distance_row[i] = 0;
 		
 		for (size_t j = i + 1; j < genome_count; ++j)
 		{
 			Genome *genome2 = genomes[j];
-			const MutationRun **genome2_mutruns = genome2->mutruns_;
+			const MutationRunRef *genome2_mutruns = genome2->mutruns_;
 			int64_t distance = 0;
 			
 			for (int mutrun_index = 0; mutrun_index < mutrun_count; ++mutrun_index)
 			{
-				const MutationRun *genome1_mutrun = genome1_mutruns[mutrun_index];
-				const MutationRun *genome2_mutrun = genome2_mutruns[mutrun_index];
+				const MutationRun *genome1_mutrun = MutationRun::RunForRef(genome1_mutruns[mutrun_index]);
+				const MutationRun *genome2_mutrun = MutationRun::RunForRef(genome2_mutruns[mutrun_index]);
 				int genome1_mutcount = genome1_mutrun->size();
 				int genome2_mutcount = genome2_mutrun->size();
 				
@@ -740,14 +740,14 @@ int64_t *QtSLiMHaplotypeManager::buildDistanceArrayForSubrange(void)
 		int64_t *distance_row = distances + i * genome_count;
 		slim_position_t mutrun_length = genome1->mutrun_length_;
 		int mutrun_count = genome1->mutrun_count_;
-		const MutationRun **genome1_mutruns = genome1->mutruns_;
+		const MutationRunRef *genome1_mutruns = genome1->mutruns_;
 		
 		distance_row[i] = 0;
 		
 		for (size_t j = i + 1; j < genome_count; ++j)
 		{
 			Genome *genome2 = genomes[j];
-			const MutationRun **genome2_mutruns = genome2->mutruns_;
+			const MutationRunRef *genome2_mutruns = genome2->mutruns_;
 			int64_t distance = 0;
 			
 			for (int mutrun_index = 0; mutrun_index < mutrun_count; ++mutrun_index)
@@ -757,8 +757,8 @@ int64_t *QtSLiMHaplotypeManager::buildDistanceArrayForSubrange(void)
 					continue;
 				
 				// OK, this mutrun intersects with our chosen subrange; proceed
-				const MutationRun *genome1_mutrun = genome1_mutruns[mutrun_index];
-				const MutationRun *genome2_mutrun = genome2_mutruns[mutrun_index];
+				const MutationRun *genome1_mutrun = MutationRun::RunForRef(genome1_mutruns[mutrun_index]);
+				const MutationRun *genome2_mutrun = MutationRun::RunForRef(genome2_mutruns[mutrun_index]);
 				
 				if (genome1_mutrun == genome2_mutrun)
 					;										// identical runs have no differences
@@ -840,20 +840,20 @@ int64_t *QtSLiMHaplotypeManager::buildDistanceArrayForSubtypes(void)
 		int64_t *distance_column = distances + i;
 		int64_t *distance_row = distances + i * genome_count;
 		int mutrun_count = genome1->mutrun_count_;
-		const MutationRun **genome1_mutruns = genome1->mutruns_;
+		const MutationRunRef *genome1_mutruns = genome1->mutruns_;
 		
 		distance_row[i] = 0;
 		
 		for (size_t j = i + 1; j < genome_count; ++j)
 		{
 			Genome *genome2 = genomes[j];
-			const MutationRun **genome2_mutruns = genome2->mutruns_;
+			const MutationRunRef *genome2_mutruns = genome2->mutruns_;
 			int64_t distance = 0;
 			
 			for (int mutrun_index = 0; mutrun_index < mutrun_count; ++mutrun_index)
 			{
-				const MutationRun *genome1_mutrun = genome1_mutruns[mutrun_index];
-				const MutationRun *genome2_mutrun = genome2_mutruns[mutrun_index];
+				const MutationRun *genome1_mutrun = MutationRun::RunForRef(genome1_mutruns[mutrun_index]);
+				const MutationRun *genome2_mutrun = MutationRun::RunForRef(genome2_mutruns[mutrun_index]);
 				
 				if (genome1_mutrun == genome2_mutrun)
 					;										// identical runs have no differences
@@ -936,14 +936,14 @@ int64_t *QtSLiMHaplotypeManager::buildDistanceArrayForSubrangeAndSubtypes(void)
 		int64_t *distance_row = distances + i * genome_count;
 		slim_position_t mutrun_length = genome1->mutrun_length_;
 		int mutrun_count = genome1->mutrun_count_;
-		const MutationRun **genome1_mutruns = genome1->mutruns_;
+		const MutationRunRef *genome1_mutruns = genome1->mutruns_;
 		
 		distance_row[i] = 0;
 		
 		for (size_t j = i + 1; j < genome_count; ++j)
 		{
 			Genome *genome2 = genomes[j];
-			const MutationRun **genome2_mutruns = genome2->mutruns_;
+			const MutationRunRef *genome2_mutruns = genome2->mutruns_;
 			int64_t distance = 0;
 			
 			for (int mutrun_index = 0; mutrun_index < mutrun_count; ++mutrun_index)
@@ -953,8 +953,8 @@ int64_t *QtSLiMHaplotypeManager::buildDistanceArrayForSubrangeAndSubtypes(void)
 					continue;
 				
 				// OK, this mutrun intersects with our chosen subrange; proceed
-				const MutationRun *genome1_mutrun = genome1_mutruns[mutrun_index];
-				const MutationRun *genome2_mutrun = genome2_mutruns[mutrun_index];
+				const MutationRun *genome1_mutrun = MutationRun::RunForRef(genome1_mutruns[mutrun_index]);
+				const MutationRun *genome2_mutrun = MutationRun::RunForRef(genome2_mutruns[mutrun_index]);
 				
 				if (genome1_mutrun == genome2_mutrun)
 					;										// identical runs have no differences
@@ -45,12 +45,13 @@ public:
 	GenomicElement *genomic_element_ptr_;			// pointer to the genomic element that contains this subrange
 	slim_position_t start_position_;				// the start position of the subrange
 	slim_position_t end_position_;					// the end position of the subrange
+	double requested_rate_;							// the requested (un-adjusted) mutation rate per base across the subrange
 	
-	GESubrange(GenomicElement *p_genomic_element_ptr, slim_position_t p_start_position, slim_position_t p_end_position);
+	GESubrange(GenomicElement *p_genomic_element_ptr, slim_position_t p_start_position, slim_position_t p_end_position, double p_requested_rate);
 };
 
-inline __attribute__((always_inline)) GESubrange::GESubrange(GenomicElement *p_genomic_element_ptr, slim_position_t p_start_position, slim_position_t p_end_position) :
-	genomic_element_ptr_(p_genomic_element_ptr), start_position_(p_start_position), end_position_(p_end_position)
+inline __attribute__((always_inline)) GESubrange::GESubrange(GenomicElement *p_genomic_element_ptr, slim_position_t p_start_position, slim_position_t p_end_position, double p_requested_rate) :
+	genomic_element_ptr_(p_genomic_element_ptr), start_position_(p_start_position), end_position_(p_end_position), requested_rate_(p_requested_rate)
 {
 }
 
@@ -108,6 +109,17 @@ Chromosome::~Chromosome(void)
 	if (lookup_recombination_F_)
 		gsl_ran_discrete_free(lookup_recombination_F_);
 	
+	delete cumulative_mutation_H_;
+	delete cumulative_mutation_M_;
+	delete cumulative_mutation_F_;
+	delete cumulative_recombination_H_;
+	delete cumulative_recombination_M_;
+	delete cumulative_recombination_F_;
+	
+	delete nucleotide_table_H_;
+	delete nucleotide_table_M_;
+	delete nucleotide_table_F_;
+	
 	// Dispose of any nucleotide sequence
 	delete ancestral_seq_buffer_;
 	ancestral_seq_buffer_ = nullptr;
@@ -255,7 +267,7 @@ void Chromosome::InitializeDraws(void)
 	// Now remake our mutation map info, which we delegate to _InitializeOneMutationMap()
 	if (single_mutation_map_)
 	{
-		_InitializeOneMutationMap(lookup_mutation_H_, mutation_end_positions_H_, mutation_rates_H_, overall_mutation_rate_H_userlevel_, overall_mutation_rate_H_, exp_neg_overall_mutation_rate_H_, mutation_subranges_H_);
+		_InitializeOneMutationMap(lookup_mutation_H_, cumulative_mutation_H_, mutation_end_positions_H_, mutation_rates_H_, overall_mutation_rate_H_userlevel_, overall_mutation_rate_H_, exp_neg_overall_mutation_rate_H_, mutation_subranges_H_);
 		
 		// Copy the H rates into the M and F ivars, so that they can be used by DrawMutationAndBreakpointCounts() if needed
 		overall_mutation_rate_M_userlevel_ = overall_mutation_rate_F_userlevel_ = overall_mutation_rate_H_userlevel_;
@@ -264,8 +276,8 @@ void Chromosome::InitializeDraws(void)
 	}
 	else
 	{
-		_InitializeOneMutationMap(lookup_mutation_M_, mutation_end_positions_M_, mutation_rates_M_, overall_mutation_rate_M_userlevel_, overall_mutation_rate_M_, exp_neg_overall_mutation_rate_M_, mutation_subranges_M_);
-		_InitializeOneMutationMap(lookup_mutation_F_, mutation_end_positions_F_, mutation_rates_F_, overall_mutation_rate_F_userlevel_, overall_mutation_rate_F_, exp_neg_overall_mutation_rate_F_, mutation_subranges_F_);
+		_InitializeOneMutationMap(lookup_mutation_M_, cumulative_mutation_M_, mutation_end_positions_M_, mutation_rates_M_, overall_mutation_rate_M_userlevel_, overall_mutation_rate_M_, exp_neg_overall_mutation_rate_M_, mutation_subranges_M_);
+		_InitializeOneMutationMap(lookup_mutation_F_, cumulative_mutation_F_, mutation_end_positions_F_, mutation_rates_F_, overall_mutation_rate_F_userlevel_, overall_mutation_rate_F_, exp_neg_overall_mutation_rate_F_, mutation_subranges_F_);
 	}
 	
 	// Now remake our recombination map info, which we delegate to _InitializeOneRecombinationMap()
@@ -273,7 +285,7 @@ void Chromosome::InitializeDraws(void)
 	
 	if (single_recombination_map_)
 	{
-		_InitializeOneRecombinationMap(lookup_recombination_H_, recombination_end_positions_H_, recombination_rates_H_, overall_recombination_rate_H_, exp_neg_overall_recombination_rate_H_, overall_recombination_rate_H_userlevel_);
+		_InitializeOneRecombinationMap(lookup_recombination_H_, cumulative_recombination_H_, recombination_end_positions_H_, recombination_rates_H_, overall_recombination_rate_H_, exp_neg_overall_recombination_rate_H_, overall_recombination_rate_H_userlevel_);
 		
 		// Copy the H rates into the M and F ivars, so that they can be used by DrawMutationAndBreakpointCounts() if needed
 		overall_recombination_rate_M_ = overall_recombination_rate_F_ = overall_recombination_rate_H_;
@@ -282,10 +294,21 @@ void Chromosome::InitializeDraws(void)
 	}
 	else
 	{
-		_InitializeOneRecombinationMap(lookup_recombination_M_, recombination_end_positions_M_, recombination_rates_M_, overall_recombination_rate_M_, exp_neg_overall_recombination_rate_M_, overall_recombination_rate_M_userlevel_);
-		_InitializeOneRecombinationMap(lookup_recombination_F_, recombination_end_positions_F_, recombination_rates_F_, overall_recombination_rate_F_, exp_neg_overall_recombination_rate_F_, overall_recombination_rate_F_userlevel_);
+		_InitializeOneRecombinationMap(lookup_recombination_M_, cumulative_recombination_M_, recombination_end_positions_M_, recombination_rates_M_, overall_recombination_rate_M_, exp_neg_overall_recombination_rate_M_, overall_recombination_rate_M_userlevel_);
+		_InitializeOneRecombinationMap(lookup_recombination_F_, cumulative_recombination_F_, recombination_end_positions_F_, recombination_rates_F_, overall_recombination_rate_F_, exp_neg_overall_recombination_rate_F_, overall_recombination_rate_F_userlevel_);
 	}
 	
+	// In nucleotide-based models the overall mutation rates calculated above may be replaced by PrepareNucleotideMutationDraws(),
+	// which builds the per-context rate tables lazily; note that they need to be rebuilt, since the maps have changed
+	nucleotide_tables_valid_ = false;
+	nucleotide_draws_valid_ = false;
+	
+	_InitializeAllJointProbabilities();
+}
+
+// calculate the joint mutation/recombination probabilities for the H/M/F cases, from the current overall rates
+void Chromosome::_InitializeAllJointProbabilities(void)
+{
 #ifndef USE_GSL_POISSON
 	// Calculate joint mutation/recombination probabilities for the H/M/F cases
 	if (single_mutation_map_ && single_recombination_map_)
@@ -468,7 +491,7 @@ void Chromosome::ChooseMutationRunLayout(int p_preferred_count)
 }
 
 // initialize one recombination map, used internally by InitializeDraws() to avoid code duplication
-void Chromosome::_InitializeOneRecombinationMap(gsl_ran_discrete_t *&p_lookup, std::vector<slim_position_t> &p_end_positions, std::vector<double> &p_rates, double &p_overall_rate, double &p_exp_neg_overall_rate, double &p_overall_rate_userlevel)
+void Chromosome::_InitializeOneRecombinationMap(gsl_ran_discrete_t *&p_lookup, CumulativeRateIndex *&p_cumulative, std::vector<slim_position_t> &p_end_positions, std::vector<double> &p_rates, double &p_overall_rate, double &p_exp_neg_overall_rate, double &p_overall_rate_userlevel)
 {
 	// Patch the recombination interval end vector if it is empty; see setRecombinationRate() and initializeRecombinationRate().
 	// Basically, the length of the chromosome might not have been known yet when the user set the rate.
@@ -586,14 +609,11 @@ void Chromosome::_InitializeOneRecombinationMap(gsl_ran_discrete_t *&p_lookup, s
 	p_exp_neg_overall_rate = Eidos_FastRandomPoisson_PRECALCULATE(p_overall_rate);				// exp(-mu); can be 0 due to underflow
 #endif
 	
-	if (p_lookup)
-		gsl_ran_discrete_free(p_lookup);
-	
-	p_lookup = gsl_ran_discrete_preproc(reparameterized_rates.size(), B.data());
+	_InitializeOneLookup(p_lookup, p_cumulative, reparameterized_rates.size(), B.data());
 }
 
 // initialize one mutation map, used internally by InitializeDraws() to avoid code duplication
-void Chromosome::_InitializeOneMutationMap(gsl_ran_discrete_t *&p_lookup, std::vector<slim_position_t> &p_end_positions, std::vector<double> &p_rates, double &p_requested_overall_rate, double &p_overall_rate, double &p_exp_neg_overall_rate, std::vector<GESubrange> &p_subranges)
+void Chromosome::_InitializeOneMutationMap(gsl_ran_discrete_t *&p_lookup, CumulativeRateIndex *&p_cumulative, std::vector<slim_position_t> &p_end_positions, std::vector<double> &p_rates, double &p_requested_overall_rate, double &p_overall_rate, double &p_exp_neg_overall_rate, std::vector<GESubrange> &p_subranges)
 {
 	// Patch the mutation interval end vector if it is empty; see setMutationRate() and initializeMutationRate().
 	// Basically, the length of the chromosome might not have been known yet when the user set the rate.
@@ -673,7 +693,7 @@ void Chromosome::_InitializeOneMutationMap(gsl_ran_discrete_t *&p_lookup, std::v
 				
 				A.emplace_back(requested_subrange_weight);
 				B.emplace_back(adjusted_subrange_weight);
-				p_subranges.emplace_back(&ge, subrange_start, subrange_end);
+				p_subranges.emplace_back(&ge, subrange_start, subrange_end, requested_rate);
 				
 				// Now we need to decide whether to advance the genomic element or not; advancing mutrange_index here is not needed
 				if (end_of_mutrange >= ge.end_position_)
@@ -691,10 +711,482 @@ void Chromosome::_InitializeOneMutationMap(gsl_ran_discrete_t *&p_lookup, std::v
 	p_exp_neg_overall_rate = Eidos_FastRandomPoisson_PRECALCULATE(p_overall_rate);				// exp(-mu); can be 0 due to underflow
 #endif
 	
+	_InitializeOneLookup(p_lookup, p_cumulative, B.size(), B.data());
+}
+
+// build the lookup for one rate map: a CumulativeRateIndex for maps with many intervals, a gsl_ran_discrete_t otherwise
+void Chromosome::_InitializeOneLookup(gsl_ran_discrete_t *&p_lookup, CumulativeRateIndex *&p_cumulative, size_t p_count, const double *p_weights)
+{
 	if (p_lookup)
+	{
 		gsl_ran_discrete_free(p_lookup);
+		p_lookup = nullptr;
+	}
+	
+	delete p_cumulative;
+	p_cumulative = nullptr;
+	
+	if (p_count >= SLIM_CUMULATIVE_RATE_INDEX_MIN_INTERVALS)
+		p_cumulative = new CumulativeRateIndex(p_count, p_weights);
+	else
+		p_lookup = gsl_ran_discrete_preproc(p_count, p_weights);
+}
+
+CumulativeRateIndex::CumulativeRateIndex(size_t p_count, const double *p_weights)
+{
+	if ((p_count == 0) || (p_count > UINT32_MAX))
+		EIDOS_TERMINATION << "ERROR (CumulativeRateIndex::CumulativeRateIndex): (internal error) interval count out of range." << EidosTerminate();
+	
+	// sum the weights; the last interval with a positive weight gets a cumulative value of exactly 1.0, as do any zero-weight
+	// intervals after it, so that roundoff can never let a draw fall off the end or land in a trailing zero-weight interval
+	double total = 0.0;
+	size_t last_positive = 0;
+	
+	cumulative_.resize(p_count);
+	
+	for (size_t index = 0; index < p_count; ++index)
+	{
+		double weight = p_weights[index];
+		
+		if (weight < 0.0)
+			EIDOS_TERMINATION << "ERROR (CumulativeRateIndex::CumulativeRateIndex): (internal error) negative weight." << EidosTerminate();
+		
+		if (weight > 0.0)
+			last_positive = index;
+		
+		total += weight;
+		cumulative_[index] = total;
+	}
+	
+	// an all-zero map is never drawn from (the Poisson count will be zero), but we keep it well-formed anyway
+	double inverse_total = (total > 0.0) ? (1.0 / total) : 0.0;
+	
+	for (size_t index = 0; index < last_positive; ++index)
+		cumulative_[index] *= inverse_total;
+	for (size_t index = last_positive; index < p_count; ++index)
+		cumulative_[index] = 1.0;
+	
+	// build the guide table with one bucket per interval; guide_[j] is the first interval whose cumulative weight exceeds j / p_count
+	guide_.resize(p_count);
+	
+	size_t index = 0;
+	
+	for (size_t bucket = 0; bucket < p_count; ++bucket)
+	{
+		double bucket_start = bucket / static_cast<double>(p_count);
+		
+		while (cumulative_[index] <= bucket_start)
+			index++;
+		
+		guide_[bucket] = static_cast<uint32_t>(index);
+	}
+}
+
+NucleotideRateTable::NucleotideRateTable(const std::vector<GESubrange> &p_subranges, const NucleotideArray &p_sequence, slim_position_t p_last_position) : last_position_(p_last_position)
+{
+	if (p_subranges.size() > UINT32_MAX)
+		EIDOS_TERMINATION << "ERROR (NucleotideRateTable::NucleotideRateTable): (internal error) subrange count out of range." << EidosTerminate();
+	
+	// Each subrange's requested rate is the hotspot multiplier times the maximum sequence-based rate (see CreateNucleotideMutationRateMap()),
+	// and the rate for a given context is that times the context's fraction of the maximum rate, which CacheNucleotideMatrices() keeps
+	// as the last threshold for the context.  We copy those fractions, 64 per genomic element type, with NAN (from zero-rate contexts
+	// when the maximum rate is zero) cleaned up to zero.  We also find the largest fraction for each type, for the bound_ below.
+	std::vector<const GenomicElementType *> types;
+	std::vector<double> type_max_fractions;
+	
+	for (const GESubrange &subrange : p_subranges)
+	{
+		GenomicElement *element = subrange.genomic_element_ptr_;
+		const GenomicElementType *type = element->genomic_element_type_ptr_;
+		auto type_iter = std::find(types.begin(), types.end(), type);
+		size_t type_index = type_iter - types.begin();
+		bool trinucleotide = (type->mutation_matrix_->Count() == 256);
+		
+		if (type_iter == types.end())
+		{
+			int context_count = (trinucleotide ? 64 : 4);
+			double max_fraction = 0.0;
+			
+			types.emplace_back(type);
+			
+			for (int context = 0; context < 64; ++context)
+			{
+				double fraction = ((context < context_count) ? type->mm_thresholds[(size_t)context * 4 + 3] : 0.0);
+				
+				if (!(fraction > 0.0))
+					fraction = 0.0;
+				
+				context_fractions_.emplace_back(fraction);
+				max_fraction = std::max(max_fraction, fraction);
+			}
+			
+			type_max_fractions.emplace_back(max_fraction);
+		}
+		
+		// The uniquing of drawn positions means that a position with requested rate x needs an adjusted rate of -log1p(-x), as in
+		// _InitializeOneMutationMap(); the ratio g(x) = -log1p(-x) / x grows with x, so g() of the region's largest rate bounds it
+		double max_requested = subrange.requested_rate_ * type_max_fractions[type_index];
+		double bound = ((max_requested > 0.0) ? (-log1p(-max_requested) / max_requested) : 1.0);
+		
+		regions_.emplace_back(Region{element, subrange.start_position_, subrange.end_position_, type_index * 64, trinucleotide, subrange.requested_rate_, bound});
+	}
+	
+	// cut each region into buckets and sum the context fractions in each
+	for (size_t region_index = 0; region_index < regions_.size(); ++region_index)
+	{
+		const Region &region = regions_[region_index];
+		
+		for (slim_position_t bucket_start = region.start_position_; bucket_start <= region.end_position_; bucket_start += SLIM_NUCLEOTIDE_RATE_BUCKET_SIZE)
+		{
+			bucket_starts_.emplace_back(bucket_start);
+			bucket_regions_.emplace_back((uint32_t)region_index);
+		}
+	}
+	
+	bucket_fractions_.resize(bucket_starts_.size());
+	
+	for (size_t bucket = 0; bucket < bucket_starts_.size(); ++bucket)
+		bucket_fractions_[bucket] = _BucketFraction(bucket, p_sequence);
+	
+	_RebuildBucketIndex();
+}
+
+NucleotideRateTable::~NucleotideRateTable(void)
+{
+	delete bucket_index_;
+	bucket_index_ = nullptr;
+	
+	delete perturbed_index_;
+	perturbed_index_ = nullptr;
+}
+
+double NucleotideRateTable::_BucketFraction(size_t p_bucket, const NucleotideArray &p_sequence) const
+{
+	const Region &region = regions_[bucket_regions_[p_bucket]];
+	slim_position_t start = bucket_starts_[p_bucket];
+	slim_position_t end = std::min(start + SLIM_NUCLEOTIDE_RATE_BUCKET_SIZE - 1, region.end_position_);
+	double sum = 0.0;
+	
+	for (slim_position_t position = start; position <= end; ++position)
+		sum += ContextFraction(region, p_sequence, position);
+	
+	return sum;
+}
+
+void NucleotideRateTable::_RebuildBucketIndex(void)
+{
+	// a bucket's adjusted rate is its summed requested rate times the region's bound; DrawPosition() thins the excess back out
+	std::vector<double> weights(bucket_starts_.size());
+	
+	for (size_t bucket = 0; bucket < bucket_starts_.size(); ++bucket)
+	{
+		const Region &region = regions_[bucket_regions_[bucket]];
+		
+		weights[bucket] = region.max_rate_ * region.bound_ * bucket_fractions_[bucket];
+	}
+	
+	static_rate_ = Eidos_ExactSum(weights.data(), weights.size());
+	
+	delete bucket_index_;
+	bucket_index_ = nullptr;
+	
+	if (static_rate_ > 0.0)
+		bucket_index_ = new CumulativeRateIndex(weights.size(), weights.data());
+}
+
+void NucleotideRateTable::AncestralSequenceChanged(const std::vector<slim_position_t> &p_positions, const NucleotideArray &p_sequence)
+{
+	// a change at a position alters the trinucleotide contexts of its neighbors too, which may be in the neighboring bucket or region
+	for (slim_position_t changed_position : p_positions)
+	{
+		for (slim_position_t position = changed_position - 1; position <= changed_position + 1; ++position)
+		{
+			auto bucket_iter = std::upper_bound(bucket_starts_.begin(), bucket_starts_.end(), position);
+			
+			if (bucket_iter == bucket_starts_.begin())
+				continue;
+			
+			size_t bucket = (bucket_iter - bucket_starts_.begin()) - 1;
+			
+			if (position > regions_[bucket_regions_[bucket]].end_position_)
+				continue;
+			
+			bucket_fractions_[bucket] = _BucketFraction(bucket, p_sequence);
+		}
+	}
+	
+	_RebuildBucketIndex();
+}
+
+void NucleotideRateTable::SetPerturbedPositions(const std::vector<slim_position_t> &p_positions, const NucleotideArray &p_sequence)
+{
+	// A perturbed position needs a total adjusted rate of -log1p(-max_rate_), so that after uniquing it is proposed at the maximum
+	// rate and can be accepted in proportion to its actual context's rate; the buckets already provide the ancestral context's share.
+	std::vector<double> weights;
+	
+	perturbed_positions_.clear();
+	perturbed_regions_.clear();
+	
+	auto region_iter = regions_.begin();
+	
+	for (slim_position_t position : p_positions)
+	{
+		while ((region_iter != regions_.end()) && (region_iter->end_position_ < position))
+			region_iter++;
+		
+		if (region_iter == regions_.end())
+			break;
+		if (region_iter->start_position_ > position)
+			continue;
+		
+		const Region &region = *region_iter;
+		double extra = -log1p(-region.max_rate_) + log1p(-region.max_rate_ * ContextFraction(region, p_sequence, position));
+		
+		if (extra > 0.0)
+		{
+			perturbed_positions_.emplace_back(position);
+			perturbed_regions_.emplace_back((uint32_t)(region_iter - regions_.begin()));
+			weights.emplace_back(extra);
+		}
+	}
+	
+	perturbed_rate_ = Eidos_ExactSum(weights.data(), weights.size());
+	
+	delete perturbed_index_;
+	perturbed_index_ = nullptr;
+	
+	if (perturbed_rate_ > 0.0)
+		perturbed_index_ = new CumulativeRateIndex(weights.size(), weights.data());
+	else
+		perturbed_rate_ = 0.0;
+}
+
+bool NucleotideRateTable::DrawPosition(gsl_rng *p_rng, const NucleotideArray &p_sequence, std::pair<slim_position_t, GenomicElement *> &p_position) const
+{
+	if ((perturbed_rate_ > 0.0) && (Eidos_rng_uniform(p_rng) * (static_rate_ + perturbed_rate_) >= static_rate_))
+	{
+		size_t index = perturbed_index_->DrawIndex(p_rng);
+		
+		p_position.first = perturbed_positions_[index];
+		p_position.second = regions_[perturbed_regions_[index]].genomic_element_ptr_;
+		return true;
+	}
+	
+	// choose a bucket, then scan it for the position at which the cumulative context fraction passes a uniform draw
+	size_t bucket = bucket_index_->DrawIndex(p_rng);
+	const Region &region = regions_[bucket_regions_[bucket]];
+	slim_position_t start = bucket_starts_[bucket];
+	slim_position_t end = std::min(start + SLIM_NUCLEOTIDE_RATE_BUCKET_SIZE - 1, region.end_position_);
+	double target = Eidos_rng_uniform(p_rng) * bucket_fractions_[bucket];
+	slim_position_t chosen_position = -1;
+	double chosen_fraction = 0.0;
+	bool found = false;
+	
+	for (slim_position_t position = start; position <= end; ++position)
+	{
+		double fraction = ContextFraction(region, p_sequence, position);
+		
+		if (fraction > 0.0)
+		{
+			chosen_position = position;
+			chosen_fraction = fraction;
+			
+			if (target < fraction)
+			{
+				found = true;
+				break;
+			}
+			
+			target -= fraction;
+		}
+	}
+	
+	// roundoff can carry the target past the end; the last position with a nonzero rate is then used, as if the target were 0
+	if (!found)
+		target = 0.0;
+	
+	// The bucket was drawn at the region's bound times the requested rate, so the candidate is accepted with probability g(x) / bound_,
+	// where x is the position's requested rate and g(x) = -log1p(-x) / x, giving it the adjusted rate -log1p(-x) that uniquing needs.
+	// Given the chosen position, target / chosen_fraction is uniform in [0, 1), so it can be reused for this; rejection is very rare
+	// in practice, since g(x) is within about x/2 of 1.0, and it is not needed at all for the region's maximum-rate contexts.
+	double requested_rate = region.max_rate_ * chosen_fraction;
+	
+	if (target * region.bound_ * region.max_rate_ >= -log1p(-requested_rate))
+		return false;
+	
+	p_position.first = chosen_position;
+	p_position.second = region.genomic_element_ptr_;
+	return true;
+}
+
+size_t NucleotideRateTable::MemoryUsage(void) const
+{
+	size_t usage = 0;
+	
+	usage += regions_.size() * sizeof(Region);
+	usage += context_fractions_.size() * sizeof(double);
+	usage += bucket_starts_.size() * (sizeof(slim_position_t) + sizeof(uint32_t) + sizeof(double));
+	usage += perturbed_positions_.size() * (sizeof(slim_position_t) + sizeof(uint32_t));
+	
+	if (bucket_index_)
+		usage += bucket_index_->MemoryUsage();
+	if (perturbed_index_)
+		usage += perturbed_index_->MemoryUsage();
+	
+	return usage;
+}
+
+// build per-context rate tables for the mutation maps of a nucleotide-based model, if its mutation matrices make them worthwhile
+void Chromosome::_BuildNucleotideRateTables(void)
+{
+	delete nucleotide_table_H_;
+	delete nucleotide_table_M_;
+	delete nucleotide_table_F_;
+	nucleotide_table_H_ = nullptr;
+	nucleotide_table_M_ = nullptr;
+	nucleotide_table_F_ = nullptr;
+	
+	nucleotide_tables_valid_ = true;
+	nucleotide_tables_sequence_ = ancestral_seq_buffer_;
+	nucleotide_tables_sequence_changes_ = ancestral_seq_buffer_->ChangeCount();
+	nucleotide_substituted_positions_.clear();
+	
+	// If every context of every genomic element type mutates at the maximum rate, the rate maps from InitializeDraws() already draw
+	// positions with no rejection, and the tables would just slow things down; that is the case for Jukes-Cantor models, for example.
+	// If any element type has no mutation matrix (which should not happen), we also stick with the standard machinery.
+	bool rates_vary = false;
+	
+	for (GenomicElement *element : genomic_elements_)
+	{
+		const GenomicElementType *type = element->genomic_element_type_ptr_;
+		
+		if (!type->mutation_matrix_ || !type->mm_thresholds)
+			return;
+		
+		int context_count = ((type->mutation_matrix_->Count() == 256) ? 64 : 4);
+		
+		for (int context = 0; context < context_count; ++context)
+			if (!(type->mm_thresholds[(size_t)context * 4 + 3] >= 1.0))
+				rates_vary = true;
+	}
 	
-	p_lookup = gsl_ran_discrete_preproc(B.size(), B.data());
+	if (!rates_vary)
+		return;
+	
+	if (single_mutation_map_)
+	{
+		nucleotide_table_H_ = new NucleotideRateTable(mutation_subranges_H_, *ancestral_seq_buffer_, last_position_);
+	}
+	else
+	{
+		nucleotide_table_M_ = new NucleotideRateTable(mutation_subranges_M_, *ancestral_seq_buffer_, last_position_);
+		nucleotide_table_F_ = new NucleotideRateTable(mutation_subranges_F_, *ancestral_seq_buffer_, last_position_);
+	}
+}
+
+void Chromosome::PrepareNucleotideMutationDraws(void)
+{
+	if (nucleotide_draws_valid_)
+		return;
+	
+	THREAD_SAFETY_IN_ANY_PARALLEL("Chromosome::PrepareNucleotideMutationDraws(): the rate tables are shared by all threads");
+	
+	nucleotide_draws_valid_ = true;
+	
+	if (!species_.IsNucleotideBased() || !species_.HasGenetics() || !ancestral_seq_buffer_)
+		return;
+	
+	// Bring the tables up to date with the ancestral sequence.  Substitutions are handled incrementally; they were noted for us by
+	// AncestralNucleotideSubstituted().  Any other change (loading a saved population, for example) triggers a complete rebuild.
+	if (nucleotide_tables_valid_)
+	{
+		uint64_t change_count = ancestral_seq_buffer_->ChangeCount();
+		
+		if ((nucleotide_tables_sequence_ != ancestral_seq_buffer_) || (change_count - nucleotide_tables_sequence_changes_ != nucleotide_substituted_positions_.size()))
+		{
+			nucleotide_tables_valid_ = false;
+		}
+		else if (nucleotide_substituted_positions_.size())
+		{
+			if (nucleotide_table_H_)
+				nucleotide_table_H_->AncestralSequenceChanged(nucleotide_substituted_positions_, *ancestral_seq_buffer_);
+			if (nucleotide_table_M_)
+				nucleotide_table_M_->AncestralSequenceChanged(nucleotide_substituted_positions_, *ancestral_seq_buffer_);
+			if (nucleotide_table_F_)
+				nucleotide_table_F_->AncestralSequenceChanged(nucleotide_substituted_positions_, *ancestral_seq_buffer_);
+			
+			nucleotide_tables_sequence_changes_ = change_count;
+			nucleotide_substituted_positions_.clear();
+		}
+	}
+	
+	if (!nucleotide_tables_valid_)
+		_BuildNucleotideRateTables();
+	
+	if (!nucleotide_table_H_ && !nucleotide_table_M_)
+		return;
+	
+	// Find the perturbed positions: those at, or adjacent to, a segregating mutation with a nucleotide.  The registry contains every
+	// mutation in the parental genomes, so everywhere else the context in every genome is the ancestral context.  Adjacent positions
+	// only matter for trinucleotide contexts, but we don't bother distinguishing; extra perturbed positions cost a little speed, not accuracy.
+	int registry_size;
+	const MutationIndex *registry = species_.population_.MutationRegistry(&registry_size);
+	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	
+	nucleotide_perturbed_positions_.clear();
+	
+	for (int registry_index = 0; registry_index < registry_size; ++registry_index)
+	{
+		const Mutation *mut = mut_block_ptr + registry[registry_index];
+		
+		if (mut->nucleotide_ != -1)
+		{
+			slim_position_t position = mut->position_;
+			
+			if (position > 0)
+				nucleotide_perturbed_positions_.emplace_back(position - 1);
+			nucleotide_perturbed_positions_.emplace_back(position);
+			if (position < last_position_)
+				nucleotide_perturbed_positions_.emplace_back(position + 1);
+		}
+	}
+	
+	std::sort(nucleotide_perturbed_positions_.begin(), nucleotide_perturbed_positions_.end());
+	nucleotide_perturbed_positions_.erase(std::unique(nucleotide_perturbed_positions_.begin(), nucleotide_perturbed_positions_.end()), nucleotide_perturbed_positions_.end());
+	
+	// Set the perturbed positions into the tables, and replace the overall mutation rates from InitializeDraws() with the tables' rates
+	if (single_mutation_map_)
+	{
+		nucleotide_table_H_->SetPerturbedPositions(nucleotide_perturbed_positions_, *ancestral_seq_buffer_);
+		
+		overall_mutation_rate_H_ = overall_mutation_rate_M_ = overall_mutation_rate_F_ = nucleotide_table_H_->OverallRate();
+#ifndef USE_GSL_POISSON
+		exp_neg_overall_mutation_rate_H_ = exp_neg_overall_mutation_rate_M_ = exp_neg_overall_mutation_rate_F_ = Eidos_FastRandomPoisson_PRECALCULATE(overall_mutation_rate_H_);
+#endif
+	}
+	else
+	{
+		nucleotide_table_M_->SetPerturbedPositions(nucleotide_perturbed_positions_, *ancestral_seq_buffer_);
+		nucleotide_table_F_->SetPerturbedPositions(nucleotide_perturbed_positions_, *ancestral_seq_buffer_);
+		
+		overall_mutation_rate_M_ = nucleotide_table_M_->OverallRate();
+		overall_mutation_rate_F_ = nucleotide_table_F_->OverallRate();
+#ifndef USE_GSL_POISSON
+		exp_neg_overall_mutation_rate_M_ = Eidos_FastRandomPoisson_PRECALCULATE(overall_mutation_rate_M_);
+		exp_neg_overall_mutation_rate_F_ = Eidos_FastRandomPoisson_PRECALCULATE(overall_mutation_rate_F_);
+#endif
+	}
+	
+	_InitializeAllJointProbabilities();
+}
+
+void Chromosome::AncestralNucleotideSubstituted(slim_position_t p_position)
+{
+	// the tables are brought up to date by the next PrepareNucleotideMutationDraws(); if they are already stale, there is no need to track
+	if (nucleotide_tables_valid_)
+		nucleotide_substituted_positions_.emplace_back(p_position);
+	
+	nucleotide_draws_valid_ = false;
 }
 
 // prints an error message and exits
@@ -719,13 +1211,17 @@ int Chromosome::DrawSortedUniquedMutationPositions(int p_count, IndividualSex p_
 	// accepted.  The right fix seems to be to unique the drawn mutation positions before creating mutations, avoiding all these issues;
 	// multiple mutations at the same position in the same gamete seems unbiological anyway.
 	gsl_ran_discrete_t *lookup;
+	const CumulativeRateIndex *cumulative;
 	const std::vector<GESubrange> *subranges;
+	const NucleotideRateTable *nucleotide_table;
 	
 	if (single_mutation_map_)
 	{
 		// With a single map, we don't care what sex we are passed; same map for all, and sex may be enabled or disabled
 		lookup = lookup_mutation_H_;
+		cumulative = cumulative_mutation_H_;
 		subranges = &mutation_subranges_H_;
+		nucleotide_table = nucleotide_table_H_;
 	}
 	else
 	{
@@ -733,12 +1229,16 @@ int Chromosome::DrawSortedUniquedMutationPositions(int p_count, IndividualSex p_
 		if (p_sex == IndividualSex::kMale)
 		{
 			lookup = lookup_mutation_M_;
+			cumulative = cumulative_mutation_M_;
 			subranges = &mutation_subranges_M_;
+			nucleotide_table = nucleotide_table_M_;
 		}
 		else if (p_sex == IndividualSex::kFemale)
 		{
 			lookup = lookup_mutation_F_;
+			cumulative = cumulative_mutation_F_;
 			subranges = &mutation_subranges_F_;
+			nucleotide_table = nucleotide_table_F_;
 		}
 		else
 		{
@@ -750,24 +1250,39 @@ int Chromosome::DrawSortedUniquedMutationPositions(int p_count, IndividualSex p_
 	gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 	Eidos_MT_State *mt = EIDOS_MT_RNG(omp_get_thread_num());
 	
-	for (int i = 0; i < p_count; ++i)
+	if (nucleotide_table)
 	{
-		int mut_subrange_index = static_cast<int>(gsl_ran_discrete(rng, lookup));
-		const GESubrange &subrange = (*subranges)[mut_subrange_index];
-		GenomicElement *source_element = subrange.genomic_element_ptr_;
-		
-		// Draw the position along the chromosome for the mutation, within the genomic element
-		slim_position_t position = subrange.start_position_ + static_cast<slim_position_t>(Eidos_rng_uniform_int_MT64(mt, subrange.end_position_ - subrange.start_position_ + 1));
-		// old 32-bit position not MT64 code:
-		//slim_position_t position = subrange.start_position_ + static_cast<slim_position_t>(Eidos_rng_uniform_int(rng, (uint32_t)(subrange.end_position_ - subrange.start_position_ + 1)));
+		// In nucleotide-based models with context-dependent rates, positions are drawn in proportion to their context's rate; a few
+		// candidates may be discarded here (see NucleotideRateTable::DrawPosition()), so we may end up with fewer than p_count
+		std::pair<slim_position_t, GenomicElement *> position;
 		
-		p_positions.emplace_back(position, source_element);
+		for (int i = 0; i < p_count; ++i)
+			if (nucleotide_table->DrawPosition(rng, *ancestral_seq_buffer_, position))
+				p_positions.emplace_back(position);
+	}
+	else
+	{
+		for (int i = 0; i < p_count; ++i)
+		{
+			int mut_subrange_index = static_cast<int>(cumulative ? cumulative->DrawIndex(rng) : gsl_ran_discrete(rng, lookup));
+			const GESubrange &subrange = (*subranges)[mut_subrange_index];
+			GenomicElement *source_element = subrange.genomic_element_ptr_;
+			
+			// Draw the position along the chromosome for the mutation, within the genomic element
+			slim_position_t position = subrange.start_position_ + static_cast<slim_position_t>(Eidos_rng_uniform_int_MT64(mt, subrange.end_position_ - subrange.start_position_ + 1));
+			// old 32-bit position not MT64 code:
+			//slim_position_t position = subrange.start_position_ + static_cast<slim_position_t>(Eidos_rng_uniform_int(rng, (uint32_t)(subrange.end_position_ - subrange.start_position_ + 1)));
+			
+			p_positions.emplace_back(position, source_element);
+		}
 	}
 	
 	// sort and unique by position; 1 and 2 mutations are particularly common, so try to speed those up
-	if (p_count > 1)
+	size_t drawn_count = p_positions.size();
+	
+	if (drawn_count > 1)
 	{
-		if (p_count == 2)
+		if (drawn_count == 2)
 		{
 			if (p_positions[0].first > p_positions[1].first)
 				std::swap(p_positions[0], p_positions[1]);
@@ -1029,7 +1544,38 @@ MutationIndex Chromosome::DrawNewMutationExtended(std::pair<slim_position_t, Gen
 		EidosValue_Float *mm = genomic_element_type.mutation_matrix_.get();
 		int mm_count = mm->Count();
 		
-		if (mm_count == 16)
+		if ((nucleotide_table_H_ || nucleotide_table_M_) && !std::binary_search(nucleotide_perturbed_positions_.begin(), nucleotide_perturbed_positions_.end(), position))
+		{
+			// The position was drawn by a NucleotideRateTable, in proportion to the rate for its ancestral context, and it is not near any
+			// segregating mutation with a nucleotide, so every genome has the ancestral context here; choose the derived nucleotide in
+			// proportion to the rates for that context, with no rejection.  The thresholds are scaled by the context's fraction of the
+			// maximum rate, which is the last threshold, so we scale the uniform draw to match.  See PrepareNucleotideMutationDraws().
+			int context;
+			
+			original_nucleotide = (int8_t)ancestral_seq_buffer_->NucleotideAtIndex(position);
+			
+			if (mm_count == 256)
+			{
+				int nuc1 = ((position == 0) ? 0 : ancestral_seq_buffer_->NucleotideAtIndex(position - 1));
+				int nuc3 = ((position == last_position_) ? 0 : ancestral_seq_buffer_->NucleotideAtIndex(position + 1));
+				
+				context = nuc1 * 16 + ((int)original_nucleotide) * 4 + nuc3;
+			}
+			else
+			{
+				context = original_nucleotide;
+			}
+			
+			double *nuc_thresholds = genomic_element_type.mm_thresholds + (size_t)context * 4;
+			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
+			double draw = Eidos_rng_uniform(rng) * nuc_thresholds[3];
+			
+			if (draw < nuc_thresholds[0])		nucleotide = 0;
+			else if (draw < nuc_thresholds[1])	nucleotide = 1;
+			else if (draw < nuc_thresholds[2])	nucleotide = 2;
+			else								nucleotide = 3;
+		}
+		else if (mm_count == 16)
 		{
 			// The mutation matrix only cares about the single-nucleotide context; figure it out
 			GenomeWalker walker(background_genome);
@@ -1211,12 +1757,14 @@ void Chromosome::DrawCrossoverBreakpoints(IndividualSex p_parent_sex, const int
 #endif
 	
 	gsl_ran_discrete_t *lookup;
+	const CumulativeRateIndex *cumulative;
 	const std::vector<slim_position_t> *end_positions;
 	
 	if (single_recombination_map_)
 	{
 		// With a single map, we don't care what sex we are passed; same map for all, and sex may be enabled or disabled
 		lookup = lookup_recombination_H_;
+		cumulative = cumulative_recombination_H_;
 		end_positions = &recombination_end_positions_H_;
 	}
 	else
@@ -1225,11 +1773,13 @@ void Chromosome::DrawCrossoverBreakpoints(IndividualSex p_parent_sex, const int
 		if (p_parent_sex == IndividualSex::kMale)
 		{
 			lookup = lookup_recombination_M_;
+			cumulative = cumulative_recombination_M_;
 			end_positions = &recombination_end_positions_M_;
 		}
 		else if (p_parent_sex == IndividualSex::kFemale)
 		{
 			lookup = lookup_recombination_F_;
+			cumulative = cumulative_recombination_F_;
 			end_positions = &recombination_end_positions_F_;
 		}
 		else
@@ -1245,7 +1795,7 @@ void Chromosome::DrawCrossoverBreakpoints(IndividualSex p_parent_sex, const int
 	for (int i = 0; i < p_num_breakpoints; i++)
 	{
 		slim_position_t breakpoint = 0;
-		int recombination_interval = static_cast<int>(gsl_ran_discrete(rng, lookup));
+		int recombination_interval = static_cast<int>(cumulative ? cumulative->DrawIndex(rng) : gsl_ran_discrete(rng, lookup));
 		
 		// choose a breakpoint anywhere in the chosen recombination interval with equal probability
 		
@@ -1321,6 +1871,7 @@ void Chromosome::DrawDSBBreakpoints(IndividualSex p_parent_sex, const int p_num_
 #endif
 	
 	gsl_ran_discrete_t *lookup;
+	const CumulativeRateIndex *cumulative;
 	const std::vector<slim_position_t> *end_positions;
 	const std::vector<double> *rates;
 	
@@ -1328,6 +1879,7 @@ void Chromosome::DrawDSBBreakpoints(IndividualSex p_parent_sex, const int p_num_
 	{
 		// With a single map, we don't care what sex we are passed; same map for all, and sex may be enabled or disabled
 		lookup = lookup_recombination_H_;
+		cumulative = cumulative_recombination_H_;
 		end_positions = &recombination_end_positions_H_;
 		rates = &recombination_rates_H_;
 	}
@@ -1337,12 +1889,14 @@ void Chromosome::DrawDSBBreakpoints(IndividualSex p_parent_sex, const int p_num_
 		if (p_parent_sex == IndividualSex::kMale)
 		{
 			lookup = lookup_recombination_M_;
+			cumulative = cumulative_recombination_M_;
 			end_positions = &recombination_end_positions_M_;
 			rates = &recombination_rates_M_;
 		}
 		else if (p_parent_sex == IndividualSex::kFemale)
 		{
 			lookup = lookup_recombination_F_;
+			cumulative = cumulative_recombination_F_;
 			end_positions = &recombination_end_positions_F_;
 			rates = &recombination_rates_F_;
 		}
@@ -1410,7 +1964,7 @@ generateDSBsWithoutRedrawingLengths:
 	for (int i = 0; i < p_num_breakpoints; i++)
 	{
 		slim_position_t breakpoint = 0;
-		int recombination_interval = static_cast<int>(gsl_ran_discrete(rng, lookup));
+		int recombination_interval = static_cast<int>(cumulative ? cumulative->DrawIndex(rng) : gsl_ran_discrete(rng, lookup));
 		
 		if (recombination_interval == 0)
 			breakpoint = static_cast<slim_position_t>(Eidos_rng_uniform_int_MT64(mt, (*end_positions)[recombination_interval]) + 1);
@@ -1520,6 +2074,26 @@ size_t Chromosome::MemoryUsageForMutationMaps(void)
 	if (lookup_mutation_F_)
 		usage += lookup_mutation_F_->K * (sizeof(size_t) + sizeof(double));
 	
+	if (cumulative_mutation_H_)
+		usage += cumulative_mutation_H_->MemoryUsage();
+	
+	if (cumulative_mutation_M_)
+		usage += cumulative_mutation_M_->MemoryUsage();
+	
+	if (cumulative_mutation_F_)
+		usage += cumulative_mutation_F_->MemoryUsage();
+	
+	if (nucleotide_table_H_)
+		usage += nucleotide_table_H_->MemoryUsage();
+	
+	if (nucleotide_table_M_)
+		usage += nucleotide_table_M_->MemoryUsage();
+	
+	if (nucleotide_table_F_)
+		usage += nucleotide_table_F_->MemoryUsage();
+	
+	usage += nucleotide_perturbed_positions_.size() * sizeof(slim_position_t);
+	
 	return usage;
 }
 
@@ -1539,6 +2113,15 @@ size_t Chromosome::MemoryUsageForRecombinationMaps(void)
 	if (lookup_recombination_F_)
 		usage += lookup_recombination_F_->K * (sizeof(size_t) + sizeof(double));
 	
+	if (cumulative_recombination_H_)
+		usage += cumulative_recombination_H_->MemoryUsage();
+	
+	if (cumulative_recombination_M_)
+		usage += cumulative_recombination_M_->MemoryUsage();
+	
+	if (cumulative_recombination_F_)
+		usage += cumulative_recombination_F_->MemoryUsage();
+	
 	return usage;
 }
 
@@ -2198,6 +2781,10 @@ EidosValue_SP Chromosome::ExecuteMethod_setAncestralNucleotides(EidosGlobalStrin
 	// debugging
 	//std::cout << "ancestral sequence set: " << *ancestral_seq_buffer_ << std::endl;
 	
+	// the per-context mutation rate tables need to be rebuilt from the new sequence
+	nucleotide_tables_valid_ = false;
+	nucleotide_draws_valid_ = false;
+	
 	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(ancestral_seq_buffer_->size()));
 }
 
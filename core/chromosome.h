@@ -39,11 +39,140 @@
 #include "eidos_rng.h"
 #include "eidos_value.h"
 
+// Rate maps with at least this many intervals are drawn from with a CumulativeRateIndex instead of a gsl_ran_discrete_t; see below.
+// Smaller maps keep using the GSL's alias tables, so their draws (and thus the results for a given seed) are unchanged.
+#define SLIM_CUMULATIVE_RATE_INDEX_MIN_INTERVALS	10000
+
+// In nucleotide-based models with context-dependent mutation rates, NucleotideRateTable groups positions into buckets of up to this many
+// bases; a draw picks a bucket and then scans the bucket's sequence contexts.  Smaller buckets scan faster but take more memory.
+#define SLIM_NUCLEOTIDE_RATE_BUCKET_SIZE	64
+
+
 struct GESubrange;
 class Genome;
 class Species;
 
 
+// CumulativeRateIndex draws an interval index in proportion to a vector of interval weights, by inversion: a uniform draw in [0, 1)
+// is looked up in the normalized cumulative weights.  A "guide table" of equal-width buckets gives, for each bucket, the first
+// interval whose cumulative weight reaches into that bucket, so a draw is one bucket lookup plus a short forward scan (about one
+// step, on average, since there are as many buckets as intervals).  Compared to gsl_ran_discrete_t (Walker's alias method), this
+// takes 12 bytes per interval instead of 16, and preprocessing is a single O(n) pass with no temporary stacks, which matters for
+// fine-scale recombination maps with hundreds of thousands of intervals.  Like gsl_ran_discrete(), a draw uses exactly one
+// gsl_rng_uniform() from the GSL generator, and intervals with zero weight are never drawn.
+class CumulativeRateIndex
+{
+private:
+	std::vector<double> cumulative_;		// cumulative_[i] is the normalized summed weight of intervals 0..i; the last entry is 1.0
+	std::vector<uint32_t> guide_;			// guide_[j] is the first interval i with cumulative_[i] > j / guide_.size()
+	
+public:
+	CumulativeRateIndex(const CumulativeRateIndex&) = delete;
+	CumulativeRateIndex& operator=(const CumulativeRateIndex&) = delete;
+	CumulativeRateIndex(void) = delete;
+	
+	CumulativeRateIndex(size_t p_count, const double *p_weights);
+	
+	inline __attribute__((always_inline)) size_t DrawIndex(gsl_rng *p_rng) const
+	{
+		double u = gsl_rng_uniform(p_rng);
+		size_t index = guide_[static_cast<size_t>(u * guide_.size())];
+		
+		while (cumulative_[index] <= u)
+			index++;
+		
+		return index;
+	}
+	
+	inline size_t MemoryUsage(void) const { return cumulative_.size() * sizeof(double) + guide_.size() * sizeof(uint32_t); }
+};
+
+
+// NucleotideRateTable draws new mutation positions for one mutation rate map (H, M, or F) of a nucleotide-based model, in proportion to
+// the rate given by each position's context in the ancestral sequence (its nucleotide or its trinucleotide, depending upon the mutation
+// matrix of its genomic element type) times the hotspot multiplier.  Each constant-rate subrange of the map is cut into buckets of up to
+// SLIM_NUCLEOTIDE_RATE_BUCKET_SIZE bases with a cached sum of context rates; a draw picks a bucket with a CumulativeRateIndex and then
+// scans the bucket.  Since the ancestral context is then known, no rejection sampling is needed for the great majority of positions.
+// The exception is positions adjacent to (or at) a segregating mutation with a nucleotide, whose context differs between genomes; these
+// "perturbed" positions get extra weight, from a second small index, to bring them up to the maximum rate, and candidates there are
+// accepted or rejected against the actual genetic background as before.  The perturbed positions are set by the Chromosome each cycle.
+class NucleotideRateTable
+{
+private:
+	// a constant-rate subrange of a genomic element; max_rate_ is the requested rate for a context with the maximum sequence-based rate
+	struct Region
+	{
+		GenomicElement *genomic_element_ptr_;
+		slim_position_t start_position_;
+		slim_position_t end_position_;
+		size_t fractions_offset_;				// offset into context_fractions_ for the region's genomic element type
+		bool trinucleotide_;					// true if the context is the trinucleotide centered on a position, false for its nucleotide alone
+		double max_rate_;						// the hotspot multiplier times the maximum sequence-based mutation rate
+		double bound_;							// the largest adjusted-to-requested rate ratio in the region; see DrawPosition()
+	};
+	
+	std::vector<Region> regions_;
+	std::vector<double> context_fractions_;		// 64 entries per genomic element type: each context's rate as a fraction of the maximum rate
+	slim_position_t last_position_;
+	
+	std::vector<slim_position_t> bucket_starts_;	// the first position in each bucket; buckets never span regions
+	std::vector<uint32_t> bucket_regions_;			// the region containing each bucket
+	std::vector<double> bucket_fractions_;			// the summed context fractions of the positions in each bucket
+	CumulativeRateIndex *bucket_index_ = nullptr;	// OWNED POINTER: draws a bucket in proportion to its adjusted rate
+	double static_rate_ = 0.0;						// the summed adjusted rate of all buckets
+	
+	std::vector<slim_position_t> perturbed_positions_;	// perturbed positions with extra weight, and their regions
+	std::vector<uint32_t> perturbed_regions_;
+	CumulativeRateIndex *perturbed_index_ = nullptr;	// OWNED POINTER: draws a perturbed position in proportion to its extra adjusted rate
+	double perturbed_rate_ = 0.0;						// the summed extra adjusted rate of all perturbed positions
+	
+	inline double ContextFraction(const Region &p_region, const NucleotideArray &p_sequence, slim_position_t p_position) const
+	{
+		int context;
+		
+		if (p_region.trinucleotide_)
+		{
+			// off-chromosome bases are taken to be A, as in Chromosome::DrawNewMutationExtended()
+			int nuc1 = ((p_position == 0) ? 0 : p_sequence.NucleotideAtIndex(p_position - 1));
+			int nuc3 = ((p_position == last_position_) ? 0 : p_sequence.NucleotideAtIndex(p_position + 1));
+			
+			context = nuc1 * 16 + p_sequence.NucleotideAtIndex(p_position) * 4 + nuc3;
+		}
+		else
+		{
+			context = p_sequence.NucleotideAtIndex(p_position);
+		}
+		
+		return context_fractions_[p_region.fractions_offset_ + context];
+	}
+	
+	double _BucketFraction(size_t p_bucket, const NucleotideArray &p_sequence) const;
+	void _RebuildBucketIndex(void);
+	
+public:
+	NucleotideRateTable(const NucleotideRateTable&) = delete;
+	NucleotideRateTable& operator=(const NucleotideRateTable&) = delete;
+	NucleotideRateTable(void) = delete;
+	
+	NucleotideRateTable(const std::vector<GESubrange> &p_subranges, const NucleotideArray &p_sequence, slim_position_t p_last_position);
+	~NucleotideRateTable(void);
+	
+	// bring the bucket sums up to date after the ancestral sequence changed at the given positions
+	void AncestralSequenceChanged(const std::vector<slim_position_t> &p_positions, const NucleotideArray &p_sequence);
+	
+	// set the perturbed positions, which must be sorted and uniqued
+	void SetPerturbedPositions(const std::vector<slim_position_t> &p_positions, const NucleotideArray &p_sequence);
+	
+	// the overall adjusted rate, for the Poisson draw of the number of mutations
+	inline double OverallRate(void) const { return static_rate_ + perturbed_rate_; }
+	
+	// draw one candidate position; returns false if the candidate is discarded (which is rare; see DrawPosition())
+	bool DrawPosition(gsl_rng *p_rng, const NucleotideArray &p_sequence, std::pair<slim_position_t, GenomicElement *> &p_position) const;
+	
+	size_t MemoryUsage(void) const;
+};
+
+
 extern EidosClass *gSLiM_Chromosome_Class;
 
 
@@ -82,6 +211,15 @@ private:
 	gsl_ran_discrete_t *lookup_recombination_M_ = nullptr;
 	gsl_ran_discrete_t *lookup_recombination_F_ = nullptr;
 	
+	// for maps with many intervals, these replace the lookup tables above, which are then nullptr; see SLIM_CUMULATIVE_RATE_INDEX_MIN_INTERVALS
+	CumulativeRateIndex *cumulative_mutation_H_ = nullptr;	// OWNED POINTER: cumulative-rate index for drawing mutations
+	CumulativeRateIndex *cumulative_mutation_M_ = nullptr;
+	CumulativeRateIndex *cumulative_mutation_F_ = nullptr;
+	
+	CumulativeRateIndex *cumulative_recombination_H_ = nullptr;	// OWNED POINTER: cumulative-rate index for drawing recombination breakpoints
+	CumulativeRateIndex *cumulative_recombination_M_ = nullptr;
+	CumulativeRateIndex *cumulative_recombination_F_ = nullptr;
+	
 	// caches to speed up Poisson draws in CrossoverMutation()
 	double exp_neg_overall_mutation_rate_H_;			
 	double exp_neg_overall_mutation_rate_M_;
@@ -111,6 +249,20 @@ private:
 	std::vector<GESubrange> mutation_subranges_M_;
 	std::vector<GESubrange> mutation_subranges_F_;
 	
+	// nucleotide-based models with context-dependent mutation rates draw new mutation positions from these; see PrepareNucleotideMutationDraws()
+	NucleotideRateTable *nucleotide_table_H_ = nullptr;		// OWNED POINTER: per-context rate table for drawing mutations, or nullptr
+	NucleotideRateTable *nucleotide_table_M_ = nullptr;
+	NucleotideRateTable *nucleotide_table_F_ = nullptr;
+	
+	bool nucleotide_tables_valid_ = false;						// false if the tables need to be rebuilt from the mutation maps
+	bool nucleotide_draws_valid_ = false;						// false if PrepareNucleotideMutationDraws() needs to run before drawing
+	const NucleotideArray *nucleotide_tables_sequence_ = nullptr;	// the ancestral sequence the tables reflect, and its change count
+	uint64_t nucleotide_tables_sequence_changes_ = 0;
+	std::vector<slim_position_t> nucleotide_substituted_positions_;	// positions changed by substitution since the tables were updated
+	std::vector<slim_position_t> nucleotide_perturbed_positions_;	// sorted positions where genomes may differ from the ancestral context
+	
+	void _BuildNucleotideRateTables(void);
+	
 public:
 	
 	Community &community_;
@@ -192,14 +344,23 @@ public:
 	
 	// initialize the random lookup tables used by Chromosome to draw mutation and recombination events
 	void InitializeDraws(void);
-	void _InitializeOneRecombinationMap(gsl_ran_discrete_t *&p_lookup, std::vector<slim_position_t> &p_end_positions, std::vector<double> &p_rates, double &p_overall_rate, double &p_exp_neg_overall_rate, double &p_overall_rate_userlevel);
-	void _InitializeOneMutationMap(gsl_ran_discrete_t *&p_lookup, std::vector<slim_position_t> &p_end_positions, std::vector<double> &p_rates, double &p_requested_overall_rate, double &p_overall_rate, double &p_exp_neg_overall_rate, std::vector<GESubrange> &p_subranges);
+	void _InitializeOneRecombinationMap(gsl_ran_discrete_t *&p_lookup, CumulativeRateIndex *&p_cumulative, std::vector<slim_position_t> &p_end_positions, std::vector<double> &p_rates, double &p_overall_rate, double &p_exp_neg_overall_rate, double &p_overall_rate_userlevel);
+	void _InitializeOneMutationMap(gsl_ran_discrete_t *&p_lookup, CumulativeRateIndex *&p_cumulative, std::vector<slim_position_t> &p_end_positions, std::vector<double> &p_rates, double &p_requested_overall_rate, double &p_overall_rate, double &p_exp_neg_overall_rate, std::vector<GESubrange> &p_subranges);
+	void _InitializeOneLookup(gsl_ran_discrete_t *&p_lookup, CumulativeRateIndex *&p_cumulative, size_t p_count, const double *p_weights);
+	void _InitializeAllJointProbabilities(void);
 	void ChooseMutationRunLayout(int p_preferred_count);
 	
 	inline bool UsingSingleRecombinationMap(void) const { return single_recombination_map_; }
 	inline bool UsingSingleMutationMap(void) const { return single_mutation_map_; }
 	inline size_t GenomicElementCount(void) const { return genomic_elements_.size(); }
 	
+	// nucleotide-based models: bring the per-context rate tables up to date for the current parental genomes, before mutations are drawn;
+	// this must be called outside of parallel regions, at the start of offspring generation and after script changes the genomes
+	void PrepareNucleotideMutationDraws(void);
+	inline void InvalidateNucleotideMutationDraws(void) { nucleotide_draws_valid_ = false; }
+	inline void InvalidateNucleotideRateTables(void) { nucleotide_tables_valid_ = false; InvalidateNucleotideMutationDraws(); }	// when the rates themselves change
+	void AncestralNucleotideSubstituted(slim_position_t p_position);
+	
 	// draw the number of mutations that occur, based on the overall mutation rate
 	int DrawMutationCount(IndividualSex p_sex) const;
 	
@@ -100,6 +100,9 @@ Community::Community(void) : self_symbol_(gID_community, EidosValue_SP(new (gEid
 	AddZeroTickFunctionsToMap(simulation_functions_);
 	AddSLiMFunctionsToMap(simulation_functions_);
 	
+	// deterministic parallel execution is opt-in per model, with parallelSetDeterministic(); don't inherit it from a previous model
+	gEidosDeterministicParallel = false;
+	
 	// reading from the input file is deferred to InitializeFromFile() to make raise-handling simpler - finish construction
 }
 
@@ -2435,6 +2438,38 @@ void Community::AllSpecies_PurgeRemovedObjects(void)
 	}
 }
 
+void Community::AllSpecies_CompactMutationBlock(void)
+{
+	// After a burst of new mutations followed by their loss or fixation, the live mutations can end up scattered
+	// across a mutation block that is mostly free, since the block never shrinks on its own; that wastes memory and
+	// hurts the locality of every loop over mutations and refcounts.  If that has happened, we compact the block,
+	// renumbering the live mutations densely, and then rewrite the MutationIndex values held by every species.
+	// This is called just after the mutation registries have been maintained, when no unreferenced mutation runs
+	// remain in use and no script is running.  In SLiMgui the block is shared among all open simulations, so
+	// no single simulation can compact it.
+#ifndef SLIMGUI
+	size_t live_estimate = 0;
+	
+	for (Species *species : all_species_)
+	{
+		int registry_size;
+		
+		species->population_.MutationRegistry(&registry_size);
+		live_estimate += registry_size;
+	}
+	
+	if (!SLiM_MutationBlockNeedsCompaction(live_estimate))
+		return;
+	
+	std::vector<MutationIndex> remap;
+	
+	SLiM_CompactMutationBlock(remap);
+	
+	for (Species *species : all_species_)
+		species->population_.RemapMutationIndices(remap);
+#endif
+}
+
 //
 //		_RunOneTickWF() : runs all the stages for one cycle of a WF model
 //
@@ -2576,6 +2611,8 @@ bool Community::_RunOneTickWF(void)
 			if (species->Active())
 				species->MaintainMutationRegistry();
 		
+		AllSpecies_CompactMutationBlock();
+		
 		// Invalidate interactions, now that the generation they were valid for is disappearing
 		for (Species *species : all_species_)
 			if (species->Active())
@@ -3045,6 +3082,8 @@ bool Community::_RunOneTickNonWF(void)
 			if (species->Active())
 				species->MaintainMutationRegistry();
 		
+		AllSpecies_CompactMutationBlock();
+		
 #if (SLIMPROFILING == 1)
 		// PROFILING
 		SLIM_PROFILE_BLOCK_END(profile_stage_totals_[6]);
@@ -3195,6 +3234,7 @@ void Community::TabulateSLiMMemoryUsage_Community(SLiMMemoryUsage_Community *p_u
 	
 	// Mutation global buffers
 	p_usage->mutationRefcountBuffer = SLiMMemoryUsageForMutationRefcounts();
+	p_usage->mutationHotFieldBuffers = SLiMMemoryUsageForMutationHotFields();
 	p_usage->mutationUnusedPoolSpace = SLiMMemoryUsageForFreeMutations();		// note that in SLiMgui everybody shares this
 	
 	// InteractionType
@@ -3395,6 +3435,25 @@ void Community::AllSpecies_TSF_Enable(void)
 		SLIM_ERRSTREAM << "// ********** Turning on tree-sequence recording without crosschecks (-TSF)." << std::endl << std::endl;
 }
 
+void Community::AllSpecies_MutrunCache_Enable(const std::string &p_cache_path, const std::vector<std::string> &p_defined_constants)
+{
+	// This is called by command-line slim if a -mutrunCache command-line option is supplied.  Cache entries are keyed by
+	// a hash of the script and the -d[efine] constants, so that replicates differing only in their seed share an entry.
+	std::string model_string = ScriptString();
+	
+	for (const std::string &constant : p_defined_constants)
+		model_string.append("\n-d ").append(constant);
+	
+	uint8_t model_hash[32];
+	char model_hash_string[65];
+	
+	Eidos_calc_sha_256(model_hash, model_string.c_str(), model_string.length());
+	Eidos_hash_to_string(model_hash_string, model_hash);
+	
+	for (Species *species : all_species_)
+		species->MutationRunCache_Enable(p_cache_path, std::string(model_hash_string));
+}
+
 
 
 
@@ -259,6 +259,7 @@ public:
 	void RunInitializeCallbacks(void);												// run `species all` initialize() callbacks
 	void AllSpecies_CheckIntegrity(void);
 	void AllSpecies_PurgeRemovedObjects(void);
+	void AllSpecies_CompactMutationBlock(void);										// renumber mutations densely if the shared mutation block has become sparse
 	
 	bool _RunOneTickWF(void);														// called by _RunOneTick() to run a tick (WF models)
 	bool _RunOneTickNonWF(void);													// called by _RunOneTick() to run a tick (nonWF models)
@@ -320,6 +321,7 @@ public:
 	
 	void AllSpecies_TSXC_Enable(void);          // forces tree-seq with crosschecks on for all species; called by the undocumented -TSXC option
 	void AllSpecies_TSF_Enable(void);           // forces tree-seq without crosschecks on for all species; called by the undocumented -TSF option
+	void AllSpecies_MutrunCache_Enable(const std::string &p_cache_path, const std::vector<std::string> &p_defined_constants);	// called by the -mutrunCache option
 	
 	slim_tick_t tree_seq_tick_ = 0;				// the tick for the tree sequence code, incremented after generating offspring
 												// this is needed since addSubpop() in an early() event makes one gen, and then the offspring
@@ -72,11 +72,11 @@ MutationRun *Genome::WillModifyRun(slim_mutrun_index_t p_run_index, MutationRunC
 	// This method used to support in-place modification for mutruns with a use count of 1,
 	// saving the new mutation run allocation; this is now done only in WillModifyRun_UNSHARED().
 	// See the header comment for more information.
-	const MutationRun *original_run = mutruns_[p_run_index];
+	const MutationRun *original_run = MutationRunAtIndex(p_run_index);
 	MutationRun *new_run = MutationRun::NewMutationRun(p_mutrun_context);	// take from shared pool of used objects
 	
 	new_run->copy_from_run(*original_run);
-	mutruns_[p_run_index] = new_run;
+	SetMutationRunAtIndex(p_run_index, new_run);
 	
 	// We return a non-const pointer to the caller, giving them permission to modify this new run
 	return new_run;
@@ -92,14 +92,14 @@ MutationRun *Genome::WillModifyRun_UNSHARED(slim_mutrun_index_t p_run_index, Mut
 	// This method avoids the new mutation run allocation, unless the mutation run is empty.
 	// This is based on a guarantee from the caller that the run is unshared (unless it is empty).
 	// See the header comment for more information.
-	const MutationRun *original_run = mutruns_[p_run_index];
+	const MutationRun *original_run = MutationRunAtIndex(p_run_index);
 	
 	if (original_run->size() == 0)
 	{
 		MutationRun *new_run = MutationRun::NewMutationRun(p_mutrun_context);	// take from shared pool of used objects
 		
 		new_run->copy_from_run(*original_run);
-		mutruns_[p_run_index] = new_run;
+		SetMutationRunAtIndex(p_run_index, new_run);
 		
 		// We return a non-const pointer to the caller, giving them permission to modify this new run
 		return new_run;
@@ -155,7 +155,7 @@ MutationRun *Genome::WillModifyRunForBulkOperation(int64_t p_operation_id, slim_
 #else
 	// The interesting version remembers the operation in progress, using the ID, and
 	// tracks original/final MutationRun pointers, returning nullptr if an original is matched.
-	const MutationRun *original_run = mutruns_[p_mutrun_index];
+	const MutationRun *original_run = MutationRunAtIndex(p_mutrun_index);
 	
 	if (p_operation_id != s_bulk_operation_id_)
 			EIDOS_TERMINATION << "ERROR (Genome::WillModifyRunForBulkOperation): (internal error) missing bulk operation start." << EidosTerminate();
@@ -168,7 +168,7 @@ MutationRun *Genome::WillModifyRunForBulkOperation(int64_t p_operation_id, slim_
 		MutationRun *product_run = MutationRun::NewMutationRun(p_mutrun_context);
 		
 		product_run->copy_from_run(*original_run);
-		mutruns_[p_mutrun_index] = product_run;
+		SetMutationRunAtIndex(p_mutrun_index, product_run);
 		
 		try {
 			s_bulk_operation_runs_.emplace(original_run, product_run);
@@ -183,7 +183,7 @@ MutationRun *Genome::WillModifyRunForBulkOperation(int64_t p_operation_id, slim_
 	else
 	{
 		// This MutationRun is in the map, so we can just reuse it to redo the operation
-		mutruns_[p_mutrun_index] = found_run_pair->second;
+		SetMutationRunAtIndex(p_mutrun_index, found_run_pair->second);
 		
 		//std::cout << "   WillModifyRunForBulkOperation() substituted known product for " << original_run << std::endl;
 		
@@ -216,11 +216,13 @@ void Genome::TallyGenomeReferences_Checkback(slim_refcount_t *p_mutrun_ref_tally
 #endif
 	for (int run_index = 0; run_index < mutrun_count_; ++run_index)
 	{
-		if (mutruns_[run_index]->operation_id_ != p_operation_id)
+		const MutationRun *mutrun = MutationRunAtIndex(run_index);
+		
+		if (mutrun->operation_id_ != p_operation_id)
 		{
-			(*p_mutrun_ref_tally) += mutruns_[run_index]->use_count();
+			(*p_mutrun_ref_tally) += mutrun->use_count();
 			(*p_mutrun_tally)++;
-			mutruns_[run_index]->operation_id_ = p_operation_id;
+			mutrun->operation_id_ = p_operation_id;
 		}
 	}
 }
@@ -253,7 +255,7 @@ void Genome::ReinitializeGenomeToMutruns(GenomeType p_genome_type, int32_t p_mut
 			if (mutrun_count_ <= SLIM_GENOME_MUTRUN_BUFSIZE)
 				mutruns_ = run_buffer_;
 			else
-				mutruns_ = (const MutationRun **)malloc(mutrun_count_ * sizeof(const MutationRun *));	// overwritten below
+				mutruns_ = (MutationRunRef *)malloc(mutrun_count_ * sizeof(MutationRunRef));	// overwritten below
 		}
 		else if (mutrun_count_ != p_mutrun_count)
 		{
@@ -267,7 +269,7 @@ void Genome::ReinitializeGenomeToMutruns(GenomeType p_genome_type, int32_t p_mut
 			if (mutrun_count_ <= SLIM_GENOME_MUTRUN_BUFSIZE)
 				mutruns_ = run_buffer_;
 			else
-				mutruns_ = (const MutationRun **)malloc(mutrun_count_ * sizeof(const MutationRun *));	// overwritten below
+				mutruns_ = (MutationRunRef *)malloc(mutrun_count_ * sizeof(MutationRunRef));	// overwritten below
 		}
 		else
 		{
@@ -275,7 +277,7 @@ void Genome::ReinitializeGenomeToMutruns(GenomeType p_genome_type, int32_t p_mut
 		}
 		
 		for (int run_index = 0; run_index < mutrun_count_; ++run_index)
-			mutruns_[run_index] = p_runs[run_index];
+			SetMutationRunAtIndex(run_index, p_runs[run_index]);
 	}
 	else // if (!p_mutrun_count)
 	{
@@ -307,10 +309,10 @@ void Genome::ReinitializeGenomeNullptr(GenomeType p_genome_type, int32_t p_mutru
 			if (mutrun_count_ <= SLIM_GENOME_MUTRUN_BUFSIZE)
 			{
 				mutruns_ = run_buffer_;
-				EIDOS_BZERO(run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(const MutationRun *));
+				EIDOS_BZERO(run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(MutationRunRef));
 			}
 			else
-				mutruns_ = (const MutationRun **)calloc(mutrun_count_, sizeof(const MutationRun *));
+				mutruns_ = (MutationRunRef *)calloc(mutrun_count_, sizeof(MutationRunRef));
 		}
 		else if (mutrun_count_ != p_mutrun_count)
 		{
@@ -324,18 +326,18 @@ void Genome::ReinitializeGenomeNullptr(GenomeType p_genome_type, int32_t p_mutru
 			if (mutrun_count_ <= SLIM_GENOME_MUTRUN_BUFSIZE)
 			{
 				mutruns_ = run_buffer_;
-				EIDOS_BZERO(run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(const MutationRun *));
+				EIDOS_BZERO(run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(MutationRunRef));
 			}
 			else
-				mutruns_ = (const MutationRun **)calloc(mutrun_count_, sizeof(const MutationRun *));
+				mutruns_ = (MutationRunRef *)calloc(mutrun_count_, sizeof(MutationRunRef));
 		}
 		else
 		{
 			// the number of mutruns has not changed; need to zero out
 			if (p_mutrun_count <= SLIM_GENOME_MUTRUN_BUFSIZE)
-				EIDOS_BZERO(run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(const MutationRun *));		// much faster because optimized at compile time
+				EIDOS_BZERO(run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(MutationRunRef));		// much faster because optimized at compile time
 			else
-				EIDOS_BZERO(mutruns_, p_mutrun_count * sizeof(const MutationRun *));
+				EIDOS_BZERO(mutruns_, p_mutrun_count * sizeof(MutationRunRef));
 		}
 		
 		// we leave the new mutruns_ buffer filled with nullptr
@@ -368,7 +370,7 @@ void Genome::record_derived_states(Species *p_species) const
 	
 	for (int run_index = 0; run_index < mutrun_count_; ++run_index)
 	{
-		const MutationRun *mutrun = mutruns_[run_index];
+		const MutationRun *mutrun = MutationRunAtIndex(run_index);
 		int mutrun_size = mutrun->size();
 		slim_position_t last_pos = -1;
 		
@@ -483,7 +485,7 @@ EidosValue_SP Genome::GetProperty(EidosGlobalStringID p_property_id)
 			
 			for (int run_index = 0; run_index < mutrun_count_; ++run_index)
 			{
-				const MutationRun *mutrun = mutruns_[run_index];
+				const MutationRun *mutrun = MutationRunAtIndex(run_index);
 				const MutationIndex *mut_start_ptr = mutrun->begin_pointer_const();
 				const MutationIndex *mut_end_ptr = mutrun->end_pointer_const();
 				
@@ -769,7 +771,7 @@ EidosValue_SP Genome::ExecuteMethod_Accelerated_containsMutations(EidosObject **
 			if (element->IsNull())
 				EIDOS_TERMINATION << "ERROR (Genome::ExecuteMethod_Accelerated_containsMutations): containsMutations() cannot be called on a null genome." << EidosTerminate();
 			
-			bool contained = element->mutruns_[mutrun_index]->contains_mutation(mut_block_index);
+			bool contained = element->MutationRunAtIndex(mutrun_index)->contains_mutation(mut_block_index);
 			
 			return (contained ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
 		}
@@ -848,7 +850,7 @@ EidosValue_SP Genome::ExecuteMethod_Accelerated_countOfMutationsOfType(EidosObje
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
 		{
-			const MutationRun *mutrun = element->mutruns_[run_index];
+			const MutationRun *mutrun = element->MutationRunAtIndex(run_index);
 			int mut_count = mutrun->size();
 			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 			
@@ -891,7 +893,7 @@ EidosValue_SP Genome::ExecuteMethod_mutationsOfType(EidosGlobalStringID p_method
 	
 	for (run_index = 0; run_index < mutrun_count_; ++run_index)
 	{
-		const MutationRun *mutrun = mutruns_[run_index];
+		const MutationRun *mutrun = MutationRunAtIndex(run_index);
 		int mut_count = mutrun->size();
 		const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 		
@@ -1243,7 +1245,7 @@ EidosValue_SP Genome::ExecuteMethod_positionsOfMutationsOfType(EidosGlobalString
 	
 	for (int run_index = 0; run_index < mutrun_count_; ++run_index)
 	{
-		const MutationRun *mutrun = mutruns_[run_index];
+		const MutationRun *mutrun = MutationRunAtIndex(run_index);
 		int mut_count = mutrun->size();
 		const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 		
@@ -1281,7 +1283,7 @@ EidosValue_SP Genome::ExecuteMethod_sumOfMutationsOfType(EidosGlobalStringID p_m
 	
 	for (int run_index = 0; run_index < mutrun_count; ++run_index)
 	{
-		const MutationRun *mutrun = mutruns_[run_index];
+		const MutationRun *mutrun = MutationRunAtIndex(run_index);
 		int genome1_count = mutrun->size();
 		const MutationIndex *genome_ptr = mutrun->begin_pointer_const();
 		
@@ -1315,7 +1317,7 @@ void Genome::PrintGenomes_SLiM(std::ostream &p_out, std::vector<Genome *> &p_gen
 		
 		for (int run_index = 0; run_index < genome.mutrun_count_; ++run_index)
 		{
-			const MutationRun *mutrun = genome.mutruns_[run_index];
+			const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 			int mut_count = mutrun->size();
 			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 			
@@ -1347,7 +1349,7 @@ void Genome::PrintGenomes_SLiM(std::ostream &p_out, std::vector<Genome *> &p_gen
 		
 		for (int run_index = 0; run_index < genome.mutrun_count_; ++run_index)
 		{
-			const MutationRun *mutrun = genome.mutruns_[run_index];
+			const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 			int mut_count = mutrun->size();
 			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 			
@@ -1390,7 +1392,7 @@ void Genome::PrintGenomes_MS(std::ostream &p_out, std::vector<Genome *> &p_genom
 			
 			for (int run_index = 0; run_index < genome.mutrun_count_; ++run_index)
 			{
-				const MutationRun *mutrun = genome.mutruns_[run_index];
+				const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 				int mut_count = mutrun->size();
 				const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 				
@@ -1468,7 +1470,7 @@ void Genome::PrintGenomes_MS(std::ostream &p_out, std::vector<Genome *> &p_genom
 		
 		for (int run_index = 0; run_index < genome.mutrun_count_; ++run_index)
 		{
-			const MutationRun *mutrun = genome.mutruns_[run_index];
+			const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 			int mut_count = mutrun->size();
 			const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 			
@@ -1510,7 +1512,7 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 		{
 			for (int run_index = 0; run_index < genome1.mutrun_count_; ++run_index)
 			{
-				const MutationRun *mutrun = genome1.mutruns_[run_index];
+				const MutationRun *mutrun = genome1.MutationRunAtIndex(run_index);
 				int mut_count = mutrun->size();
 				const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 				
@@ -1523,7 +1525,7 @@ void Genome::PrintGenomes_VCF(std::ostream &p_out, std::vector<Genome *> &p_geno
 		{
 			for (int run_index = 0; run_index < genome2.mutrun_count_; ++run_index)
 			{
-				const MutationRun *mutrun = genome2.mutruns_[run_index];
+				const MutationRun *mutrun = genome2.MutationRunAtIndex(run_index);
 				int mut_count = mutrun->size();
 				const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 				
@@ -2120,6 +2122,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_addMutations(EidosGlobalStringID p_met
 		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_addMutations): " << "addMutations() requires that all target genomes belong to the same species." << EidosTerminate();
 	
 	species->population_.CheckForDeferralInGenomes(p_target, "Genome_Class::ExecuteMethod_addMutations");
+	species->TheChromosome().InvalidateNucleotideMutationDraws();		// added nucleotides can change the genetic background
 	
 	Community &community = species->community_;
 	
@@ -2410,6 +2413,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_addNewMutation(EidosGlobalStringID p_m
 		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_addNewMutation): " << method_name << " requires that all target genomes belong to the same species." << EidosTerminate();
 	
 	species->population_.CheckForDeferralInGenomes(p_target, "Genome_Class::ExecuteMethod_addNewMutation");
+	species->TheChromosome().InvalidateNucleotideMutationDraws();		// added nucleotides can change the genetic background
 	
 	Community &community = species->community_;
 	
@@ -2763,7 +2767,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_addNewMutation(EidosGlobalStringID p_m
 			Genome *target_genome = targets[target_index];
 			
 			// See if WillModifyRunForBulkOperation() can short-circuit the operation for us
-			const MutationRun *original_run = target_genome->mutruns_[mutrun_index];
+			const MutationRun *original_run = target_genome->MutationRunAtIndex(mutrun_index);
 			MutationRun *modifiable_mutrun = target_genome->WillModifyRunForBulkOperation(operation_id, mutrun_index, mutrun_context);
 			
 			if (modifiable_mutrun)
@@ -3026,6 +3030,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromMS(EidosGlobalStringID p_metho
 	}
 	
 	species.population_.CheckForDeferralInGenomes(p_target, "Genome_Class::ExecuteMethod_readFromMS");
+	species.TheChromosome().InvalidateNucleotideMutationDraws();		// added nucleotides can change the genetic background
 	
 	// Parse the whole input file and retain the information from it
 	std::ifstream infile(file_path);
@@ -3261,6 +3266,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_readFromVCF(EidosGlobalStringID p_meth
 		EIDOS_TERMINATION << "ERROR (Genome_Class::ExecuteMethod_readFromVCF): " << "readFromVCF() requires that all target genomes belong to the same species." << EidosTerminate();
 	
 	species->population_.CheckForDeferralInGenomes(p_target, "Genome_Class::ExecuteMethod_readFromVCF");
+	species->TheChromosome().InvalidateNucleotideMutationDraws();		// added nucleotides can change the genetic background
 	
 	Community &community = species->community_;
 	Population &pop = species->population_;
@@ -3948,7 +3954,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_removeMutations(EidosGlobalStringID p_
 			for (int genome_index = 0; genome_index < target_size; ++genome_index)
 			{
 				Genome *target_genome = target_genomes[genome_index];
-				const MutationRun *mutrun = target_genome->mutruns_[run_index];
+				const MutationRun *mutrun = target_genome->MutationRunAtIndex(run_index);
 				
 				if (mutrun->size())
 				{
@@ -3959,7 +3965,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_removeMutations(EidosGlobalStringID p_
 						shared_empty_run = MutationRun::NewMutationRun(mutrun_context);
 					}
 					
-					target_genome->mutruns_[run_index] = shared_empty_run;
+					target_genome->SetMutationRunAtIndex(run_index, shared_empty_run);
 				}
 			}
 		}
@@ -4296,7 +4302,7 @@ void GenomeWalker::NextMutation(void)
 				return;
 			}
 			
-			const MutationRun *mutrun = genome_->mutruns_[mutrun_index_];
+			const MutationRun *mutrun = genome_->MutationRunAtIndex(mutrun_index_);
 			mutrun_ptr_ = mutrun->begin_pointer_const();
 			mutrun_end_ = mutrun->end_pointer_const();
 		}
@@ -4329,7 +4335,7 @@ void GenomeWalker::MoveToPosition(slim_position_t p_position)
 		}
 		
 		// get the information on the mutrun
-		const MutationRun *mutrun = genome->mutruns_[mutrun_index_];
+		const MutationRun *mutrun = genome->MutationRunAtIndex(mutrun_index_);
 		mutrun_ptr_ = mutrun->begin_pointer_const();
 		mutrun_end_ = mutrun->end_pointer_const();
 		
@@ -114,8 +114,8 @@ private:
 	
 	int32_t mutrun_count_;											// number of runs being used; 0 for a null genome, otherwise >= 1
 	slim_position_t mutrun_length_;									// the length, in base pairs, of each run; the last run may not use its full length
-	const MutationRun *run_buffer_[SLIM_GENOME_MUTRUN_BUFSIZE];		// an internal buffer used to avoid allocation and memory nonlocality for simple models
-	const MutationRun **mutruns_;									// mutation runs; nullptr if a null genome OR an empty genome
+	MutationRunRef run_buffer_[SLIM_GENOME_MUTRUN_BUFSIZE];			// an internal buffer used to avoid allocation and memory nonlocality for simple models
+	MutationRunRef *mutruns_;										// mutation runs; nullptr if a null genome OR an empty genome; see MutationRunAtIndex()
 	
 	Individual *individual_;										// NOT OWNED: the Individual this genome belongs to
 	slim_usertag_t tag_value_;										// a user-defined tag value
@@ -149,10 +149,10 @@ public:
 		if (mutrun_count_ <= SLIM_GENOME_MUTRUN_BUFSIZE)
 		{
 			mutruns_ = run_buffer_;
-			EIDOS_BZERO(run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(const MutationRun *));
+			EIDOS_BZERO(run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(MutationRunRef));
 		}
 		else
-			mutruns_ = (const MutationRun **)calloc(mutrun_count_, sizeof(const MutationRun *));
+			mutruns_ = (MutationRunRef *)calloc(mutrun_count_, sizeof(MutationRunRef));
 	};
 	
 	~Genome(void);
@@ -175,6 +175,11 @@ public:
 	
 	void MakeNull(void) __attribute__((cold));	// transform into a null genome
 	
+	// Runs are kept as MutationRunRef values, which are handles rather than pointers if SLIM_MUTRUN_HANDLES is enabled, so access
+	// to them goes through these methods; refs may still be copied directly from one genome's mutruns_ to another's, however.
+	inline __attribute__((always_inline)) const MutationRun *MutationRunAtIndex(slim_mutrun_index_t p_run_index) const { return MutationRun::RunForRef(mutruns_[p_run_index]); }
+	inline __attribute__((always_inline)) void SetMutationRunAtIndex(slim_mutrun_index_t p_run_index, const MutationRun *p_run) { mutruns_[p_run_index] = MutationRun::RefForRun(p_run); }
+	
 	// used to re-initialize Genomes to a new state, reusing them for efficiency
 	void ReinitializeGenomeToMutruns(GenomeType p_genome_type, int32_t p_mutrun_count, slim_position_t p_mutrun_length, const std::vector<MutationRun *> &p_runs);
 	void ReinitializeGenomeNullptr(GenomeType p_genome_type, int32_t p_mutrun_count, slim_position_t p_mutrun_length);
@@ -193,7 +198,7 @@ public:
 		
 		MutationRun *new_run = MutationRun::NewMutationRun(p_mutrun_context);	// take from shared pool of used objects
 		
-		mutruns_[p_run_index] = new_run;
+		SetMutationRunAtIndex(p_run_index, new_run);
 		return new_run;
 	}
 	
@@ -208,7 +213,7 @@ public:
 		
 		MutationRun *new_run = MutationRun::NewMutationRun_LOCKED(p_mutrun_context);	// take from shared pool of used objects
 		
-		mutruns_[p_run_index] = new_run;
+		SetMutationRunAtIndex(p_run_index, new_run);
 		return new_run;
 	}
 	
@@ -250,7 +255,7 @@ public:
 		// mutation runs here.  This method is called only when fixed mutations are being removed from *all* genomes,
 		// so the fact that it modifies other genomes that share this mutation run is a feature, not a bug.  See
 		// Population::RemoveAllFixedMutations() for further context on this.
-		MutationRun *mutrun = const_cast<MutationRun *>(mutruns_[p_mutrun_index]);
+		MutationRun *mutrun = const_cast<MutationRun *>(MutationRunAtIndex(p_mutrun_index));
 		
 		mutrun->RemoveFixedMutations(p_operation_id);
 	}
@@ -266,14 +271,14 @@ public:
 #endif
 		if (mutrun_count_ == 1)
 		{
-			return run_buffer_[0]->size();
+			return MutationRun::RunForRef(run_buffer_[0])->size();
 		}
 		else
 		{
 			int mut_count = 0;
 			
 			for (int run_index = 0; run_index < mutrun_count_; ++run_index)
-				mut_count += mutruns_[run_index]->size();
+				mut_count += MutationRunAtIndex(run_index)->size();
 			
 			return mut_count;
 		}
@@ -284,9 +289,9 @@ public:
 		// It is legal to call this method on null genomes, for speed/simplicity; it does no harm
 		// That is because it zeroes run_buffer_, even for null genomes; it isn't worth the time to check for a null genome
 		if (mutrun_count_ <= SLIM_GENOME_MUTRUN_BUFSIZE)
-			EIDOS_BZERO(run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(const MutationRun *));		// much faster because optimized at compile time
+			EIDOS_BZERO(run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(MutationRunRef));		// much faster because optimized at compile time
 		else
-			EIDOS_BZERO(mutruns_, mutrun_count_ * sizeof(const MutationRun *));
+			EIDOS_BZERO(mutruns_, mutrun_count_ * sizeof(MutationRunRef));
 	}
 	
 	inline void check_cleared_to_nullptr(void)
@@ -303,7 +308,7 @@ public:
 		if (mutrun_count_ == 0)
 			NullGenomeAccessError();
 #endif
-		return mutruns_[(gSLiM_Mutation_Block + p_mutation_index)->position_ / mutrun_length_]->contains_mutation(p_mutation_index);
+		return MutationRunAtIndex((gSLiM_Mutation_Block + p_mutation_index)->position_ / mutrun_length_)->contains_mutation(p_mutation_index);
 	}
 	
 	inline __attribute__((always_inline)) Mutation *mutation_with_type_and_position(MutationType *p_mut_type, slim_position_t p_position, slim_position_t p_last_position)
@@ -312,7 +317,7 @@ public:
 		if (mutrun_count_ == 0)
 			NullGenomeAccessError();
 #endif
-		return mutruns_[p_position / mutrun_length_]->mutation_with_type_and_position(p_mut_type, p_position, p_last_position);
+		return MutationRunAtIndex(p_position / mutrun_length_)->mutation_with_type_and_position(p_mut_type, p_position, p_last_position);
 	}
 	
 	inline void copy_from_genome(const Genome &p_source_genome)
@@ -340,7 +345,7 @@ public:
 			}
 			else
 			{
-				memcpy(mutruns_, p_source_genome.mutruns_, mutrun_count_ * sizeof(const MutationRun *));
+				memcpy(mutruns_, p_source_genome.mutruns_, mutrun_count_ * sizeof(MutationRunRef));
 			}
 		}
 		
@@ -356,7 +361,7 @@ public:
 	{
 		slim_mutrun_index_t run_index = (slim_mutrun_index_t)(p_position / mutrun_length_);
 		
-		return mutruns_[run_index]->derived_mutation_ids_at_position(p_position);
+		return MutationRunAtIndex(run_index)->derived_mutation_ids_at_position(p_position);
 	}
 	
 	void record_derived_states(Species *p_species) const;
@@ -198,6 +198,10 @@ EidosValue_SP GenomicElement::ExecuteMethod_setGenomicElementType(EidosGlobalStr
 	Species &species = genomic_element_type_ptr_->species_;
 	GenomicElementType *getype_ptr = SLiM_ExtractGenomicElementTypeFromEidosValue_io(genomicElementType_value, 0, &species.community_, &species, "setGenomicElementType()");		// SPECIES CONSISTENCY CHECK
 	
+	// in nucleotide-based models the per-context rate tables hold the mutation matrix of each element's type, so they must be rebuilt
+	if ((getype_ptr != genomic_element_type_ptr_) && species.IsNucleotideBased())
+		species.TheChromosome().InvalidateNucleotideRateTables();
+	
 	genomic_element_type_ptr_ = getype_ptr;
 	
 	return gStaticEidosValueVOID;
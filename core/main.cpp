@@ -104,7 +104,7 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 	
 	SLIM_OUTSTREAM << "usage: slim -v[ersion] | -u[sage] | -h[elp] | -testEidos | -testSLiM |" << std::endl;
 	SLIM_OUTSTREAM << "   [-l[ong] [<l>]] [-s[eed] <seed>] [-t[ime]] [-m[em]] [-M[emhist]] [-x]" << std::endl;
-	SLIM_OUTSTREAM << "   [-d[efine] <def>] ";
+	SLIM_OUTSTREAM << "   [-d[efine] <def>] [-mutrunCache <path>] ";
 #ifdef _OPENMP
 	// Some flags are visible only for a parallel build
 	SLIM_OUTSTREAM << "[-maxThreads <n>] [-perTaskThreads \"x\"] ";
@@ -131,6 +131,7 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 		SLIM_OUTSTREAM << "   -M[emhist]         : print a histogram of SLiM's memory usage" << std::endl;
 		SLIM_OUTSTREAM << "   -x                 : disable SLiM's runtime safety/consistency checks" << std::endl;
 		SLIM_OUTSTREAM << "   -d[efine] <def>    : define an Eidos constant, such as \"mu=1e-7\"" << std::endl;
+		SLIM_OUTSTREAM << "   -mutrunCache <path>: reuse mutation run experiment results across runs" << std::endl;
 #ifdef _OPENMP
 		// Some flags are visible only for a parallel build
 		SLIM_OUTSTREAM << "   -maxThreads <n>    : set the maximum number of threads used" << std::endl;
@@ -187,6 +188,7 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 	const char *input_file = nullptr;
 	bool keep_time = false, keep_mem = false, keep_mem_hist = false, skip_checks = false, tree_seq_checks = false, tree_seq_force = false;
 	std::vector<std::string> defined_constants;
+	std::string mutrun_cache_path;
 	
 #ifdef _OPENMP
 	long max_thread_count = omp_get_max_threads();
@@ -388,6 +390,23 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 			continue;
 		}
 		
+		// -mutrunCache <path>: load/save converged mutation run experiment results from/to a cache file
+		if (strcmp(arg, "-mutrunCache") == 0)
+		{
+			if (++arg_index == argc)
+				PrintUsageAndDie(false, true);
+			
+			mutrun_cache_path = std::string(argv[arg_index]);
+			
+			if (mutrun_cache_path.length() == 0)
+			{
+				SLIM_OUTSTREAM << "The -mutrunCache command-line option requires a non-zero-length filesystem path." << std::endl;
+				exit(EXIT_FAILURE);
+			}
+			
+			continue;
+		}
+		
 		// -maxThreads <x>: set the maximum number of OpenMP threads that will be used
 		if (strcmp(arg, "-maxThreads") == 0)
 		{
@@ -643,6 +662,8 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 			community->AllSpecies_TSXC_Enable();
         if (tree_seq_force && !tree_seq_checks)
 			community->AllSpecies_TSF_Enable();
+		if (mutrun_cache_path.length())
+			community->AllSpecies_MutrunCache_Enable(mutrun_cache_path, defined_constants);
 		
 #if DO_MEMORY_CHECKS
 		// We check memory usage at the end of every 10 ticks, to be able to provide the user with a decent error message
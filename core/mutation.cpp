@@ -28,6 +28,7 @@
 #include <vector>
 #include <cstdint>
 #include <csignal>
+#include <cstring>
 
 
 // All Mutation objects get allocated out of a single shared block, for speed; see SLiM_WarmUp()
@@ -43,10 +44,28 @@ EidosDebugLock gSLiM_Mutation_LOCK("gSLiM_Mutation_LOCK");
 
 slim_refcount_t *gSLiM_Mutation_Refcounts = nullptr;
 
+slim_position_t *gSLiM_Mutation_Positions = nullptr;
+slim_selcoeff_t *gSLiM_Mutation_OnePlusSel = nullptr;
+slim_selcoeff_t *gSLiM_Mutation_OnePlusDomSel = nullptr;
+slim_selcoeff_t *gSLiM_Mutation_OnePlusHaploidDomSel = nullptr;
+
 #define SLIM_MUTATION_BLOCK_INITIAL_SIZE	16384		// makes for about a 1 MB block; not unreasonable		// NOLINT(*-macro-to-enum) : this is fine
+#define SLIM_MUTATION_BLOCK_COMPACTION_RATIO	8		// compact the block when live mutations occupy less than 1/8 of it		// NOLINT(*-macro-to-enum) : this is fine
 
 extern std::vector<EidosValue_Object *> gEidosValue_Object_Mutation_Registry;	// this is in Eidos; see SLiM_IncreaseMutationBlockCapacity()
 
+// (Re)allocate the hot-field buffers to match gSLiM_Mutation_Block_Capacity; existing entries are preserved, new entries are uninitialized
+static void SLiM_ResizeMutationHotFields(void)
+{
+	gSLiM_Mutation_Positions = (slim_position_t *)realloc(gSLiM_Mutation_Positions, gSLiM_Mutation_Block_Capacity * sizeof(slim_position_t));						// NOLINT(*-realloc-usage) : realloc failure is a fatal error anyway
+	gSLiM_Mutation_OnePlusSel = (slim_selcoeff_t *)realloc(gSLiM_Mutation_OnePlusSel, gSLiM_Mutation_Block_Capacity * sizeof(slim_selcoeff_t));					// NOLINT(*-realloc-usage) : realloc failure is a fatal error anyway
+	gSLiM_Mutation_OnePlusDomSel = (slim_selcoeff_t *)realloc(gSLiM_Mutation_OnePlusDomSel, gSLiM_Mutation_Block_Capacity * sizeof(slim_selcoeff_t));				// NOLINT(*-realloc-usage) : realloc failure is a fatal error anyway
+	gSLiM_Mutation_OnePlusHaploidDomSel = (slim_selcoeff_t *)realloc(gSLiM_Mutation_OnePlusHaploidDomSel, gSLiM_Mutation_Block_Capacity * sizeof(slim_selcoeff_t));	// NOLINT(*-realloc-usage) : realloc failure is a fatal error anyway
+	
+	if (!gSLiM_Mutation_Positions || !gSLiM_Mutation_OnePlusSel || !gSLiM_Mutation_OnePlusDomSel || !gSLiM_Mutation_OnePlusHaploidDomSel)
+		EIDOS_TERMINATION << "ERROR (SLiM_ResizeMutationHotFields): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+}
+
 void SLiM_CreateMutationBlock(void)
 {
 	THREAD_SAFETY_IN_ANY_PARALLEL("SLiM_CreateMutationBlock(): gSLiM_Mutation_Block address change");
@@ -59,6 +78,8 @@ void SLiM_CreateMutationBlock(void)
 	if (!gSLiM_Mutation_Block || !gSLiM_Mutation_Refcounts)
 		EIDOS_TERMINATION << "ERROR (SLiM_CreateMutationBlock): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
 	
+	SLiM_ResizeMutationHotFields();
+	
 	//std::cout << "Allocating initial mutation block, " << SLIM_MUTATION_BLOCK_INITIAL_SIZE * sizeof(Mutation) << " bytes (sizeof(Mutation) == " << sizeof(Mutation) << ")" << std::endl;
 	
 	// now we need to set up our free list inside the block; initially all blocks are free
@@ -127,6 +148,8 @@ void SLiM_IncreaseMutationBlockCapacity(void)
 	if (!gSLiM_Mutation_Block || !gSLiM_Mutation_Refcounts)
 		EIDOS_TERMINATION << "ERROR (SLiM_IncreaseMutationBlockCapacity): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
 	
+	SLiM_ResizeMutationHotFields();
+	
 	//std::cout << "new capacity: " << gSLiM_Mutation_Block_Capacity << std::endl;
 	
 	std::uintptr_t new_mutation_block = reinterpret_cast<std::uintptr_t>(gSLiM_Mutation_Block);
@@ -166,6 +189,118 @@ void SLiM_IncreaseMutationBlockCapacity(void)
 #endif
 }
 
+bool SLiM_MutationBlockNeedsCompaction(size_t p_live_estimate)
+{
+	// We compact when the block has grown beyond its initial size and the live mutations occupy less than
+	// 1/SLIM_MUTATION_BLOCK_COMPACTION_RATIO of it.  SLiM_CompactMutationBlock() leaves the block at least 25%
+	// occupied, so there is plenty of hysteresis; a model that bounces around in mutation count will not thrash.
+	if (gSLiM_Mutation_Block_Capacity <= SLIM_MUTATION_BLOCK_INITIAL_SIZE)
+		return false;
+	
+	return (p_live_estimate * SLIM_MUTATION_BLOCK_COMPACTION_RATIO < (size_t)gSLiM_Mutation_Block_Capacity);
+}
+
+void SLiM_CompactMutationBlock(std::vector<MutationIndex> &p_remap)
+{
+	// Compact the mutation block so that all live Mutation objects occupy a dense prefix of it, preserving their relative
+	// order, and then shrink the block.  On return, p_remap maps each old MutationIndex to its new MutationIndex, or -1 for
+	// indices that were free.  The caller is responsible for rewriting every MutationIndex held anywhere (mutation runs,
+	// registries) using p_remap; see Community::AllSpecies_CompactMutationBlock().  As in SLiM_IncreaseMutationBlockCapacity(),
+	// we patch the Mutation * references held by EidosValue_Object ourselves; since the objects do not all move by the same
+	// amount here, each pointer has to be remapped individually.  Note that this must not be called in SLiMgui, where the
+	// mutation block is shared by all of the running simulations.
+	THREAD_SAFETY_IN_ANY_PARALLEL("SLiM_CompactMutationBlock(): gSLiM_Mutation_Block address change");
+	
+#ifdef DEBUG_LOCKS_ENABLED
+	gSLiM_Mutation_LOCK.start_critical(1);
+#endif
+	
+	if (!gSLiM_Mutation_Block)
+		EIDOS_TERMINATION << "ERROR (SLiM_CompactMutationBlock): (internal error) called before SLiM_CreateMutationBlock()." << EidosTerminate();
+	
+	std::uintptr_t old_mutation_block = reinterpret_cast<std::uintptr_t>(gSLiM_Mutation_Block);
+	MutationIndex old_block_capacity = gSLiM_Mutation_Block_Capacity;
+	
+	// Mark the free slots by walking the free list; every other slot holds a live Mutation, whether it is in a registry
+	// or just retained by an EidosValue_Object after being lost or fixed
+	p_remap.assign(old_block_capacity, 0);
+	
+	for (MutationIndex free_index = gSLiM_Mutation_FreeIndex; free_index != -1; free_index = *(MutationIndex *)(gSLiM_Mutation_Block + free_index))
+		p_remap[free_index] = -1;
+	
+	// Slide each live Mutation down to the next dense index, along with its entries in the parallel buffers; since
+	// new_index <= old_index, a slot is always vacated before anything is moved into it.  Mutation is not trivially
+	// copyable according to C++, but moving it bytewise is safe, just as it is in SLiM_IncreaseMutationBlockCapacity().
+	MutationIndex live_count = 0;
+	
+	for (MutationIndex old_index = 0; old_index < old_block_capacity; ++old_index)
+	{
+		if (p_remap[old_index] == -1)
+			continue;
+		
+		if (live_count != old_index)
+		{
+			memcpy((void *)(gSLiM_Mutation_Block + live_count), (void *)(gSLiM_Mutation_Block + old_index), sizeof(Mutation));
+			gSLiM_Mutation_Refcounts[live_count] = gSLiM_Mutation_Refcounts[old_index];
+			gSLiM_Mutation_Positions[live_count] = gSLiM_Mutation_Positions[old_index];
+			gSLiM_Mutation_OnePlusSel[live_count] = gSLiM_Mutation_OnePlusSel[old_index];
+			gSLiM_Mutation_OnePlusDomSel[live_count] = gSLiM_Mutation_OnePlusDomSel[old_index];
+			gSLiM_Mutation_OnePlusHaploidDomSel[live_count] = gSLiM_Mutation_OnePlusHaploidDomSel[old_index];
+		}
+		
+		p_remap[old_index] = live_count++;
+	}
+	
+	// Shrink the block to the smallest power-of-two multiple of the initial size that leaves it no more than half full
+	MutationIndex new_block_capacity = SLIM_MUTATION_BLOCK_INITIAL_SIZE;
+	
+	while ((new_block_capacity < old_block_capacity) && (new_block_capacity < (int64_t)live_count * 2))
+		new_block_capacity *= 2;
+	
+	if (new_block_capacity < old_block_capacity)
+	{
+		gSLiM_Mutation_Block_Capacity = new_block_capacity;
+		gSLiM_Mutation_Block = (Mutation *)realloc((void*)gSLiM_Mutation_Block, gSLiM_Mutation_Block_Capacity * sizeof(Mutation));						// NOLINT(*-realloc-usage) : realloc failure is a fatal error anyway
+		gSLiM_Mutation_Refcounts = (slim_refcount_t *)realloc(gSLiM_Mutation_Refcounts, gSLiM_Mutation_Block_Capacity * sizeof(slim_refcount_t));		// NOLINT(*-realloc-usage) : realloc failure is a fatal error anyway
+		
+		if (!gSLiM_Mutation_Block || !gSLiM_Mutation_Refcounts)
+			EIDOS_TERMINATION << "ERROR (SLiM_CompactMutationBlock): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+		
+		SLiM_ResizeMutationHotFields();
+	}
+	
+	// Rebuild the free list over the tail of the block, in ascending order so new mutations keep filling densely
+	for (MutationIndex i = live_count; i < gSLiM_Mutation_Block_Capacity - 1; ++i)
+		*(MutationIndex *)(gSLiM_Mutation_Block + i) = i + 1;
+	
+	if (live_count < gSLiM_Mutation_Block_Capacity)
+	{
+		*(MutationIndex *)(gSLiM_Mutation_Block + gSLiM_Mutation_Block_Capacity - 1) = -1;
+		gSLiM_Mutation_FreeIndex = live_count;
+	}
+	else
+	{
+		gSLiM_Mutation_FreeIndex = -1;
+	}
+	
+	gSLiM_Mutation_Block_LastUsedIndex = live_count - 1;
+	
+	// Now fix Mutation * references in EidosValue_Object in all symbol tables
+	for (EidosValue_Object *mutation_value : gEidosValue_Object_Mutation_Registry)
+	{
+		mutation_value->PatchPointers([old_mutation_block, &p_remap](EidosObject *p_element) -> EidosObject * {
+			std::uintptr_t old_element_offset = reinterpret_cast<std::uintptr_t>(p_element) - old_mutation_block;
+			MutationIndex old_index = (MutationIndex)(old_element_offset / sizeof(Mutation));
+			
+			return gSLiM_Mutation_Block + p_remap[old_index];
+		});
+	}
+	
+#ifdef DEBUG_LOCKS_ENABLED
+	gSLiM_Mutation_LOCK.end_critical();
+#endif
+}
+
 void SLiM_ZeroRefcountBlock(MutationRun &p_mutation_registry, bool p_registry_only)
 {
 	THREAD_SAFETY_IN_ANY_PARALLEL("SLiM_ZeroRefcountBlock(): gSLiM_Mutation_Block change");
@@ -221,6 +356,11 @@ size_t SLiMMemoryUsageForMutationRefcounts(void)
 	return gSLiM_Mutation_Block_Capacity * sizeof(slim_refcount_t);
 }
 
+size_t SLiMMemoryUsageForMutationHotFields(void)
+{
+	return gSLiM_Mutation_Block_Capacity * (sizeof(slim_position_t) + 3 * sizeof(slim_selcoeff_t));
+}
+
 
 #pragma mark -
 #pragma mark Mutation
@@ -229,6 +369,10 @@ size_t SLiMMemoryUsageForMutationRefcounts(void)
 // A global counter used to assign all Mutation objects a unique ID
 slim_mutationid_t gSLiM_next_mutation_id = 0;
 
+// A log of new mutations created inside keyed RNG regions; see mutation.h
+bool gSLiM_Mutation_LogKeyed = false;
+std::vector<SLiM_KeyedMutationRecord> gSLiM_Mutation_KeyedLog;
+
 Mutation::Mutation(MutationType *p_mutation_type_ptr, slim_position_t p_position, double p_selection_coeff, slim_objectid_t p_subpop_index, slim_tick_t p_tick, int8_t p_nucleotide) :
 mutation_type_ptr_(p_mutation_type_ptr), position_(p_position), selection_coeff_(static_cast<slim_selcoeff_t>(p_selection_coeff)), subpop_index_(p_subpop_index), origin_tick_(p_tick), state_(MutationState::kNewMutation), nucleotide_(p_nucleotide), mutation_id_(gSLiM_next_mutation_id++)
 {
@@ -239,14 +383,17 @@ mutation_type_ptr_(p_mutation_type_ptr), position_(p_position), selection_coeff_
 	// initialize the tag to the "unset" value
 	tag_value_ = SLIM_TAG_UNSET_VALUE;
 	
-	// cache values used by the fitness calculation code for speed; see header
-	cached_one_plus_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + selection_coeff_);
-	cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
-	cached_one_plus_haploiddom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->haploid_dominance_coeff_ * selection_coeff_);
+	// fill in our hot fields, which are kept in separate buffers; see header
+	gSLiM_Mutation_Positions[BlockIndex()] = position_;
+	CacheFitnessEffects();
 	
 	// zero out our refcount, which is now kept in a separate buffer
 	gSLiM_Mutation_Refcounts[BlockIndex()] = 0;
 	
+	// log our creation if we are inside a keyed RNG region that will renumber us
+	if (gSLiM_Mutation_LogKeyed)
+		gSLiM_Mutation_KeyedLog.emplace_back(SLiM_KeyedMutationRecord{EIDOS_STATE_RNG(omp_get_thread_num())->keyed_stream_, mutation_id_, BlockIndex()});
+	
 #if DEBUG_MUTATIONS
 	std::cout << "Mutation constructed: " << this << std::endl;
 #endif
@@ -274,9 +421,6 @@ mutation_type_ptr_(p_mutation_type_ptr), position_(p_position), selection_coeff_
 			char *ptr_scratch_ = (char *)&(this->scratch_);
 			char *ptr_mutation_id_ = (char *)&(this->mutation_id_);
 			char *ptr_tag_value_ = (char *)&(this->tag_value_);
-			char *ptr_cached_one_plus_sel_ = (char *)&(this->cached_one_plus_sel_);
-			char *ptr_cached_one_plus_dom_sel_ = (char *)&(this->cached_one_plus_dom_sel_);
-			char *ptr_cached_one_plus_haploiddom_sel_ = (char *)&(this->cached_one_plus_haploiddom_sel_);
 			
 			std::cout << "Class Mutation memory layout (sizeof(Mutation) == " << sizeof(Mutation) << ") :" << std::endl << std::endl;
 			std::cout << "   " << (ptr_mutation_type_ptr_ - ptr_base) << " (" << sizeof(MutationType *) << " bytes): MutationType *mutation_type_ptr_" << std::endl;
@@ -289,9 +433,6 @@ mutation_type_ptr_(p_mutation_type_ptr), position_(p_position), selection_coeff_
 			std::cout << "   " << (ptr_scratch_ - ptr_base) << " (" << sizeof(int8_t) << " bytes): const int8_t scratch_" << std::endl;
 			std::cout << "   " << (ptr_mutation_id_ - ptr_base) << " (" << sizeof(slim_mutationid_t) << " bytes): const slim_mutationid_t mutation_id_" << std::endl;
 			std::cout << "   " << (ptr_tag_value_ - ptr_base) << " (" << sizeof(slim_usertag_t) << " bytes): slim_usertag_t tag_value_" << std::endl;
-			std::cout << "   " << (ptr_cached_one_plus_sel_ - ptr_base) << " (" << sizeof(slim_selcoeff_t) << " bytes): slim_selcoeff_t cached_one_plus_sel_" << std::endl;
-			std::cout << "   " << (ptr_cached_one_plus_dom_sel_ - ptr_base) << " (" << sizeof(slim_selcoeff_t) << " bytes): slim_selcoeff_t cached_one_plus_dom_sel_" << std::endl;
-			std::cout << "   " << (ptr_cached_one_plus_haploiddom_sel_ - ptr_base) << " (" << sizeof(slim_selcoeff_t) << " bytes): slim_selcoeff_t cached_one_plus_haploiddom_sel_" << std::endl;
 			std::cout << std::endl;
 			
 			been_here = true;
@@ -306,10 +447,9 @@ mutation_type_ptr_(p_mutation_type_ptr), position_(p_position), selection_coeff_
 	// initialize the tag to the "unset" value
 	tag_value_ = SLIM_TAG_UNSET_VALUE;
 	
-	// cache values used by the fitness calculation code for speed; see header
-	cached_one_plus_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + selection_coeff_);
-	cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
-	cached_one_plus_haploiddom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->haploid_dominance_coeff_ * selection_coeff_);
+	// fill in our hot fields, which are kept in separate buffers; see header
+	gSLiM_Mutation_Positions[BlockIndex()] = position_;
+	CacheFitnessEffects();
 	
 	// zero out our refcount, which is now kept in a separate buffer
 	gSLiM_Mutation_Refcounts[BlockIndex()] = 0;
@@ -327,6 +467,15 @@ mutation_type_ptr_(p_mutation_type_ptr), position_(p_position), selection_coeff_
 		gSLiM_next_mutation_id = mutation_id_ + 1;
 }
 
+void Mutation::CacheFitnessEffects(void)
+{
+	MutationIndex mutation_index = BlockIndex();
+	
+	gSLiM_Mutation_OnePlusSel[mutation_index] = (slim_selcoeff_t)std::max(0.0, 1.0 + selection_coeff_);
+	gSLiM_Mutation_OnePlusDomSel[mutation_index] = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
+	gSLiM_Mutation_OnePlusHaploidDomSel[mutation_index] = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->haploid_dominance_coeff_ * selection_coeff_);
+}
+
 void Mutation::SelfDelete(void)
 {
 	// This is called when our retain count reaches zero
@@ -727,25 +876,17 @@ EidosValue_SP Mutation::ExecuteMethod_setSelectionCoeff(EidosGlobalStringID p_me
 		
 		species.pure_neutral_ = false;							// let the sim know that it is no longer a pure-neutral simulation
 		mutation_type_ptr_->all_pure_neutral_DFE_ = false;	// let the mutation type for this mutation know that it is no longer pure neutral
-		
-		// If a selection coefficient has changed from zero to non-zero, or vice versa, MutationRun's nonneutral mutation caches need revalidation
-		if (old_coeff == 0.0)
-		{
-			species.nonneutral_change_counter_++;
-		}
-	}
-	else if (old_coeff != 0.0)	// && (selection_coeff_ == 0.0) implied by the "else"
-	{
-		Species &species = mutation_type_ptr_->species_;
-		
-		// If a selection coefficient has changed from zero to non-zero, or vice versa, MutationRun's nonneutral mutation caches need revalidation
-		species.nonneutral_change_counter_++;
 	}
 	
+	// If a selection coefficient has changed from zero to non-zero, or vice versa, MutationRun's nonneutral mutation caches need revalidation;
+	// any other change leaves the caches themselves valid, and only the fitness products kept with them need to be recomputed
+	if ((selection_coeff_ == 0.0) != (old_coeff == 0.0))
+		mutation_type_ptr_->species_.nonneutral_change_counter_++;
+	else if (selection_coeff_ != old_coeff)
+		mutation_type_ptr_->species_.fitness_product_change_counter_++;
+	
 	// cache values used by the fitness calculation code for speed; see header
-	cached_one_plus_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + selection_coeff_);
-	cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
-	cached_one_plus_haploiddom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->haploid_dominance_coeff_ * selection_coeff_);
+	CacheFitnessEffects();
 	
 	return gStaticEidosValueVOID;
 }
@@ -764,6 +905,10 @@ EidosValue_SP Mutation::ExecuteMethod_setMutationType(EidosGlobalStringID p_meth
 		EIDOS_TERMINATION << "ERROR (Mutation::ExecuteMethod_setMutationType): setMutationType() does not allow a mutation to be changed from nucleotide-based to non-nucleotide-based or vice versa." << EidosTerminate();
 	
 	// We take just the mutation type pointer; if the user wants a new selection coefficient, they can do that themselves
+	// The dominance coefficients may differ, though, so the fitness products kept with the nonneutral caches need revalidation
+	if ((mutation_type_ptr != mutation_type_ptr_) && (selection_coeff_ != 0.0))
+		species.fitness_product_change_counter_++;
+	
 	mutation_type_ptr_ = mutation_type_ptr;
 	
 	// If we are non-neutral, make sure the mutation type knows it is now also non-neutral; I think this is unnecessary but being safe...
@@ -771,9 +916,7 @@ EidosValue_SP Mutation::ExecuteMethod_setMutationType(EidosGlobalStringID p_meth
 		mutation_type_ptr_->all_pure_neutral_DFE_ = false;
 	
 	// cache values used by the fitness calculation code for speed; see header
-	cached_one_plus_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + selection_coeff_);
-	cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
-	cached_one_plus_haploiddom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->haploid_dominance_coeff_ * selection_coeff_);
+	CacheFitnessEffects();
 	
 	return gStaticEidosValueVOID;
 }
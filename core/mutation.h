@@ -51,6 +51,19 @@ extern slim_mutationid_t gSLiM_next_mutation_id;
 // difficult to code since MutationRun's internal buffer of MutationIndex is accessible and used directly by many clients.
 typedef int32_t MutationIndex;
 
+// While gSLiM_Mutation_LogKeyed is true, each new Mutation is logged in gSLiM_Mutation_KeyedLog along with the keyed RNG stream
+// (see Eidos_RNG_KeyedRegion) of the thread that created it, so that mutations created in parallel can afterwards be given ids
+// in an order that does not depend on the number of threads; see Population::EndKeyedMutationLog().  Mutations are created inside
+// the MutationAlloc critical region, so appending to the log is safe.
+typedef struct SLiM_KeyedMutationRecord {
+	uint64_t stream_;					// the keyed RNG stream of the creating thread
+	slim_mutationid_t mutation_id_;		// the provisional id assigned to the mutation
+	MutationIndex mutation_index_;		// the mutation's index in gSLiM_Mutation_Block
+} SLiM_KeyedMutationRecord;
+
+extern bool gSLiM_Mutation_LogKeyed;
+extern std::vector<SLiM_KeyedMutationRecord> gSLiM_Mutation_KeyedLog;
+
 // forward declaration of Mutation block allocation; see bottom of header
 class Mutation;
 extern Mutation *gSLiM_Mutation_Block;
@@ -91,14 +104,8 @@ public:
 	mutable slim_refcount_t gui_scratch_reference_count_;	// an additional refcount used for temporary tallies by SLiMgui, valid only when explicitly updated
 #endif
 	
-	// We cache values used in the fitness calculation code, for speed.  These are the final fitness effects of this mutation
-	// when it is homozygous or heterozygous, respectively.  These values are clamped to a minimum of 0.0, so that multiplying
-	// by them cannot cause the fitness of the individual to go below 0.0, avoiding slow tests in the core fitness loop.  These
-	// values use slim_selcoeff_t for speed; roundoff should not be a concern, since such differences would be inconsequential.
-	slim_selcoeff_t cached_one_plus_sel_;				// a cached value for (1 + selection_coeff_), clamped to 0.0 minimum
-	slim_selcoeff_t cached_one_plus_dom_sel_;			// a cached value for (1 + dominance_coeff * selection_coeff_), clamped to 0.0 minimum
-	slim_selcoeff_t cached_one_plus_haploiddom_sel_;	// a cached value for (1 + haploid_dominance_coeff * selection_coeff_), clamped to 0.0 minimum
-	// NOTE THERE ARE 4 BYTES FREE IN THE CLASS LAYOUT HERE; see Mutation::Mutation() and Mutation layout.graffle
+	// The values cached for the fitness calculation code (1 + s, 1 + hs, and 1 + h_haploid * s) used to be kept here; they are
+	// now kept in the hot-field buffers parallel to gSLiM_Mutation_Block (see below), and are updated by CacheFitnessEffects().
 	
 #if DEBUG
 	mutable slim_refcount_t refcount_CHECK_;					// scratch space for checking of parallel refcounting
@@ -124,6 +131,8 @@ public:
 	
 	inline __attribute__((always_inline)) MutationIndex BlockIndex(void) const			{ return (MutationIndex)(this - gSLiM_Mutation_Block); }
 	
+	void CacheFitnessEffects(void);						// recalculate this mutation's entries in the fitness hot-field buffers
+	
 	//
 	// Eidos support
 	//
@@ -209,13 +218,29 @@ extern EidosDebugLock gSLiM_Mutation_LOCK;
 #endif
 
 extern slim_refcount_t *gSLiM_Mutation_Refcounts;	// an auxiliary buffer, parallel to gSLiM_Mutation_Block, to increase memory cache efficiency
-													// note that I tried keeping the fitness cache values and positions in separate buffers too, not a win
+
+// Hot fields, kept in buffers parallel to gSLiM_Mutation_Block (structure-of-arrays style) so that the fitness loops, which look
+// at only a position and a fitness factor for each mutation, stream through a few bytes per mutation instead of pulling a whole
+// Mutation object into cache.  The positions duplicate Mutation::position_, which is const.  The fitness factors are the final
+// fitness effects of a mutation when it is homozygous, heterozygous, or paired with a null genome; they are clamped to a minimum
+// of 0.0, so that multiplying by them cannot cause the fitness of the individual to go below 0.0, avoiding slow tests in the core
+// fitness loop.  They use slim_selcoeff_t for speed; roundoff should not be a concern, since such differences would be
+// inconsequential.  They must be updated, with Mutation::CacheFitnessEffects(), whenever a selection or dominance coefficient
+// that they depend upon changes.
+extern slim_position_t *gSLiM_Mutation_Positions;				// a copy of position_
+extern slim_selcoeff_t *gSLiM_Mutation_OnePlusSel;				// a cached value for (1 + selection_coeff_), clamped to 0.0 minimum
+extern slim_selcoeff_t *gSLiM_Mutation_OnePlusDomSel;			// a cached value for (1 + dominance_coeff * selection_coeff_), clamped to 0.0 minimum
+extern slim_selcoeff_t *gSLiM_Mutation_OnePlusHaploidDomSel;	// a cached value for (1 + haploid_dominance_coeff * selection_coeff_), clamped to 0.0 minimum
+
 void SLiM_CreateMutationBlock(void);
 void SLiM_IncreaseMutationBlockCapacity(void);
+bool SLiM_MutationBlockNeedsCompaction(size_t p_live_estimate);
+void SLiM_CompactMutationBlock(std::vector<MutationIndex> &p_remap);
 void SLiM_ZeroRefcountBlock(MutationRun &p_mutation_registry, bool p_registry_only);
 size_t SLiMMemoryUsageForMutationBlock(void);
 size_t SLiMMemoryUsageForFreeMutations(void);
 size_t SLiMMemoryUsageForMutationRefcounts(void);
+size_t SLiMMemoryUsageForMutationHotFields(void);
 
 inline __attribute__((always_inline)) MutationIndex SLiM_NewMutationFromBlock(void)
 {
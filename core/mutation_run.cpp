@@ -26,6 +26,82 @@
 // For doing bulk operations across all MutationRun objects; see header
 int64_t MutationRun::sOperationID = 0;
 
+#if SLIM_MUTRUN_HANDLES
+// The handle table, shared by all species; see header
+const MutationRun **MutationRun::s_handle_chunks_[SLIM_MUTRUN_HANDLE_CHUNK_COUNT];
+
+static uint32_t s_handle_chunk_count = 0;					// the number of chunks ever allocated in s_handle_chunks_
+static std::vector<uint32_t> s_free_handle_chunks;			// chunks released by deleted contexts, available for reuse
+
+// Chunk 0 is allocated up front, so that looking up handle 0 (nullptr) is always safe, even before any run has been allocated;
+// it goes on the free list so that the first context to need a chunk will use it
+static bool s_handle_chunk_zero_allocated = []() {
+	MutationRun::s_handle_chunks_[0] = (const MutationRun **)calloc(SLIM_MUTRUN_HANDLE_CHUNK_SIZE, sizeof(const MutationRun *));
+	s_handle_chunk_count = 1;
+	s_free_handle_chunks.emplace_back(0);
+	return true;
+}();
+
+void MutationRun::AssignHandle(MutationRun *p_run, MutationRunContext &p_mutrun_context)
+{
+	if (p_mutrun_context.next_handle_ == p_mutrun_context.handle_limit_)
+	{
+		// The context's current chunk is used up, so reserve a new one; this is rare, so we just use a critical section
+		uint32_t chunk_index;
+		
+#pragma omp critical (MutationRunHandleChunks)
+		{
+			if (s_free_handle_chunks.size())
+			{
+				chunk_index = s_free_handle_chunks.back();
+				s_free_handle_chunks.pop_back();
+			}
+			else
+			{
+				if (s_handle_chunk_count == SLIM_MUTRUN_HANDLE_CHUNK_COUNT)
+					EIDOS_TERMINATION << "ERROR (MutationRun::AssignHandle): the maximum number of mutation runs has been exceeded; SLiM must be built without SLIM_MUTRUN_HANDLES for this model." << EidosTerminate(nullptr);
+				
+				chunk_index = s_handle_chunk_count++;
+				s_handle_chunks_[chunk_index] = (const MutationRun **)calloc(SLIM_MUTRUN_HANDLE_CHUNK_SIZE, sizeof(const MutationRun *));
+				
+				if (!s_handle_chunks_[chunk_index])
+					EIDOS_TERMINATION << "ERROR (MutationRun::AssignHandle): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+			}
+		}
+		
+		p_mutrun_context.handle_chunks_.emplace_back(chunk_index);
+		p_mutrun_context.next_handle_ = chunk_index << SLIM_MUTRUN_HANDLE_CHUNK_BITS;
+		p_mutrun_context.handle_limit_ = p_mutrun_context.next_handle_ + SLIM_MUTRUN_HANDLE_CHUNK_SIZE;	// wraps to 0 for the last chunk, which is fine
+		
+		// handle 0 is reserved to represent nullptr, so it is never assigned; its slot stays nullptr
+		if (p_mutrun_context.next_handle_ == 0)
+			p_mutrun_context.next_handle_ = 1;
+	}
+	
+	MutationRunHandle handle = p_mutrun_context.next_handle_++;
+	
+	s_handle_chunks_[handle >> SLIM_MUTRUN_HANDLE_CHUNK_BITS][handle & (SLIM_MUTRUN_HANDLE_CHUNK_SIZE - 1)] = p_run;
+	p_run->handle_ = handle;
+}
+
+void MutationRun::ReleaseHandles(MutationRunContext &p_mutrun_context)
+{
+	// The runs of the context have all been disposed of, so its chunks can be cleared and given to other contexts
+#pragma omp critical (MutationRunHandleChunks)
+	{
+		for (uint32_t chunk_index : p_mutrun_context.handle_chunks_)
+		{
+			EIDOS_BZERO(s_handle_chunks_[chunk_index], SLIM_MUTRUN_HANDLE_CHUNK_SIZE * sizeof(const MutationRun *));
+			s_free_handle_chunks.emplace_back(chunk_index);
+		}
+	}
+	
+	p_mutrun_context.handle_chunks_.clear();
+	p_mutrun_context.next_handle_ = 0;
+	p_mutrun_context.handle_limit_ = 0;
+}
+#endif
+
 
 MutationRun::MutationRun(void)
 #ifdef DEBUG_LOCKS_ENABLED
@@ -461,6 +537,8 @@ void MutationRun::cache_nonneutral_mutations_REGIME_1() const
 		if ((mut_block_ptr + mutindex)->selection_coeff_ != 0.0)
 			add_to_nonneutral_buffer(mutindex);
 	}
+	
+	cache_nonneutral_fitness_products();
 }
 
 void MutationRun::cache_nonneutral_mutations_REGIME_2() const
@@ -489,6 +567,8 @@ void MutationRun::cache_nonneutral_mutations_REGIME_2() const
 		if ((!mutptr->mutation_type_ptr_->set_neutral_by_global_active_callback_) && (mutptr->selection_coeff_ != 0.0))
 			add_to_nonneutral_buffer(mutindex);
 	}
+	
+	cache_nonneutral_fitness_products();
 }
 
 void MutationRun::cache_nonneutral_mutations_REGIME_3() const
@@ -516,6 +596,32 @@ void MutationRun::cache_nonneutral_mutations_REGIME_3() const
 		if ((mutptr->selection_coeff_ != 0.0) || (mutptr->mutation_type_ptr_->subject_to_mutationEffect_callback_))
 			add_to_nonneutral_buffer(mutindex);
 	}
+	
+	cache_nonneutral_fitness_products();
+}
+
+void MutationRun::cache_nonneutral_fitness_products() const
+{
+	// Multiply out the cached fitness factors for the mutations in the non-neutral buffer; this is called by each of
+	// the cache_nonneutral_mutations_REGIME_X() methods after the buffer has been filled.  The products are kept in
+	// double precision, like the fitness accumulator in FitnessOfParentWithGenomeIndices_NoCallbacks().
+	const slim_selcoeff_t *mut_one_plus_sel = gSLiM_Mutation_OnePlusSel;
+	const slim_selcoeff_t *mut_one_plus_dom_sel = gSLiM_Mutation_OnePlusDomSel;
+	const slim_selcoeff_t *mut_one_plus_haploiddom_sel = gSLiM_Mutation_OnePlusHaploidDomSel;
+	double homozygous_product = 1.0, heterozygous_product = 1.0, haploid_product = 1.0;
+	
+	for (int32_t bufindex = 0; bufindex < nonneutral_mutations_count_; ++bufindex)
+	{
+		MutationIndex mutindex = nonneutral_mutations_[bufindex];
+		
+		homozygous_product *= mut_one_plus_sel[mutindex];
+		heterozygous_product *= mut_one_plus_dom_sel[mutindex];
+		haploid_product *= mut_one_plus_haploiddom_sel[mutindex];
+	}
+	
+	nonneutral_homozygous_product_ = homozygous_product;
+	nonneutral_heterozygous_product_ = heterozygous_product;
+	nonneutral_haploid_product_ = haploid_product;
 }
 
 void MutationRun::check_nonneutral_mutation_cache() const
@@ -652,6 +758,30 @@ void MutationRun::clear_set_and_merge(const MutationRun &p_mutations_to_set, std
 	}
 }
 
+void MutationRun::remap_mutation_indices(const MutationIndex *p_remap)
+{
+	// The remapping preserves the relative order of mutation indices, and positions do not change, so the run stays sorted.
+	// A run that is in use but no longer referenced by any genome (not yet freed, in an inactive species) may refer to
+	// mutations that have since been disposed of; those map to -1, and must not be looked up again by a later compaction.
+	for (int32_t mut_index = 0; mut_index < mutation_count_; ++mut_index)
+	{
+		MutationIndex old_index = mutations_[mut_index];
+		
+		mutations_[mut_index] = ((old_index >= 0) ? p_remap[old_index] : -1);
+	}
+	
+#if SLIM_USE_NONNEUTRAL_CACHES
+	// A valid nonneutral cache stays valid; it just needs the same rewrite.  A stale cache may also be rewritten here (it will
+	// be rebuilt before it is next used), and may hold disposed mutations just as mutations_ may, so it needs the same guard.
+	for (int32_t mut_index = 0; mut_index < nonneutral_mutations_count_; ++mut_index)
+	{
+		MutationIndex old_index = nonneutral_mutations_[mut_index];
+		
+		nonneutral_mutations_[mut_index] = ((old_index >= 0) ? p_remap[old_index] : -1);
+	}
+#endif
+}
+
 size_t MutationRun::MemoryUsageForMutationIndexBuffers(void) const
 {
 	return mutation_capacity_ * sizeof(MutationIndex);
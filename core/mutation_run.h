@@ -54,6 +54,32 @@ class MutationRun;
 // for the MutationRuns being used by each thread.
 typedef std::vector<const MutationRun *> MutationRunPool;
 
+
+// If defined as 1, Genome refers to its MutationRun objects using 32-bit handles instead of 8-byte pointers.  This halves the
+// size of each genome's array of runs, which improves cache density in loops over all genomes (such as tallying run usage)
+// when there are many runs per genome, at the price of an extra table lookup to get from a handle to its run.  Handles are
+// indices into a global two-level handle table; each MutationRunContext reserves chunks of that table for the runs that it
+// allocates, so that handles can be assigned without locking.  A handle is assigned when a MutationRun is first allocated,
+// and since MutationRuns are recycled rather than freed, it stays with the run; handle 0 is reserved to represent nullptr.
+// This is off by default; it can be turned on with -D MUTRUN_HANDLES=ON in CMake, which defines it as 1 on the command line.
+#ifndef SLIM_MUTRUN_HANDLES
+#define SLIM_MUTRUN_HANDLES	0
+#endif
+
+#define SLIM_MUTRUN_HANDLE_CHUNK_BITS	16													// bits of a handle used for the index within a chunk
+#define SLIM_MUTRUN_HANDLE_CHUNK_SIZE	(1 << SLIM_MUTRUN_HANDLE_CHUNK_BITS)				// handles per chunk
+#define SLIM_MUTRUN_HANDLE_CHUNK_COUNT	(1 << (32 - SLIM_MUTRUN_HANDLE_CHUNK_BITS))			// chunks in the handle table
+
+typedef uint32_t MutationRunHandle;
+
+// MutationRunRef is what Genome actually keeps for each of its runs: a handle or a pointer, depending on SLIM_MUTRUN_HANDLES.
+// Refs can be copied between genomes directly, but must go through MutationRun::RunForRef() and MutationRun::RefForRun().
+#if SLIM_MUTRUN_HANDLES
+typedef MutationRunHandle MutationRunRef;
+#else
+typedef const MutationRun *MutationRunRef;
+#endif
+
 // This struct groups together all the objects for one context in which MutationRuns are allocated and used.  There is one
 // such context per thread.  The main benefit of the struct is that we can pass a reference to it, saving on parameters to
 // methods that require the context, such as NewMutationRun().
@@ -62,6 +88,11 @@ typedef struct MutationRunContext {
 	MutationRunPool in_use_pool_;						// MutationRun objects currently in use by the simulation
 	
 	EidosObjectPool *allocation_pool_ = nullptr;		// out of which brand-new MutationRun objects are ultimately allocated
+#if SLIM_MUTRUN_HANDLES
+	std::vector<uint32_t> handle_chunks_;				// the chunks of the MutationRun handle table reserved by this context
+	MutationRunHandle next_handle_ = 0;					// the next handle to be assigned, in the current chunk
+	MutationRunHandle handle_limit_ = 0;				// the end of the current chunk; a new chunk is needed when this is reached
+#endif
 #ifdef _OPENMP
 	omp_lock_t allocation_pool_lock_;					// must be used when accessing allocation pools across parallel threads
 #endif
@@ -183,6 +214,16 @@ private:
 	mutable int32_t nonneutral_mutations_count_ = -1;			// the number of entries currently used; -1 indicates an invalid cache
 	mutable MutationIndex *nonneutral_mutations_ = nullptr;		// OWNED POINTER: a pointer to MutationIndex for non-neutral mutations
 	
+	// Partial fitness products over the non-neutral buffer, computed whenever the buffer is recached; see cache_nonneutral_fitness_products().
+	// FitnessOfParentWithGenomeIndices_NoCallbacks() uses these to avoid walking the buffer when a run is paired with itself (all of its
+	// mutations are then homozygous), with an empty run (all heterozygous), or with a null genome (all haploid).  A change to a mutation's
+	// fitness factors that does not move it between neutral and non-neutral leaves the buffer valid, so it increments the separate counter
+	// fitness_product_change_counter_ instead, and the products alone are recomputed; see validate_nonneutral_fitness_products().
+	mutable int32_t nonneutral_product_validation_ = 0;			// compared to sim.fitness_product_change_counter_ to detect changes
+	mutable double nonneutral_homozygous_product_ = 1.0;		// the product of (1 + s) over the non-neutral buffer
+	mutable double nonneutral_heterozygous_product_ = 1.0;		// the product of (1 + hs) over the non-neutral buffer
+	mutable double nonneutral_haploid_product_ = 1.0;			// the product of (1 + h_haploid * s) over the non-neutral buffer
+	
 #if (SLIMPROFILING == 1)
 // PROFILING
 	mutable bool recached_run_ = false;							// so SLiMgui can count how many nonneutral caches get recached each tick
@@ -198,6 +239,34 @@ public:
 	mutable uint32_t use_count_CHECK_ = 0;	// a checkback for use_count_
 #endif
 	
+#if SLIM_MUTRUN_HANDLES
+	MutationRunHandle handle_ = 0;			// our index in the handle table; assigned at allocation, and kept through recycling
+	
+	static const MutationRun **s_handle_chunks_[SLIM_MUTRUN_HANDLE_CHUNK_COUNT];	// the handle table: chunks of run pointers
+	
+	static void AssignHandle(MutationRun *p_run, MutationRunContext &p_mutrun_context);
+	static void ReleaseHandles(MutationRunContext &p_mutrun_context);
+#endif
+	
+	// Conversion between MutationRun pointers and the refs kept by Genome; these compile to nothing without SLIM_MUTRUN_HANDLES
+	static inline __attribute__((always_inline)) const MutationRun *RunForRef(MutationRunRef p_ref)
+	{
+#if SLIM_MUTRUN_HANDLES
+		return s_handle_chunks_[p_ref >> SLIM_MUTRUN_HANDLE_CHUNK_BITS][p_ref & (SLIM_MUTRUN_HANDLE_CHUNK_SIZE - 1)];
+#else
+		return p_ref;
+#endif
+	}
+	
+	static inline __attribute__((always_inline)) MutationRunRef RefForRun(const MutationRun *p_run)
+	{
+#if SLIM_MUTRUN_HANDLES
+		return (p_run ? p_run->handle_ : 0);
+#else
+		return p_run;
+#endif
+	}
+	
 	static inline slim_pedigreeid_t GetNextOperationID(void)
 	{
 		THREAD_SAFETY_IN_ACTIVE_PARALLEL("GetNextOperationID(): MutationRun::sOperationID change");
@@ -238,7 +307,11 @@ public:
 			// we expect new MutationRuns to be coming from p_free_pool.  Rather, it is for memory locality; we want
 			// all the MutationRuns we're using (or that one thread is using) to be clustered together in memory.
 			MutationRun *new_run = new (p_mutrun_context.allocation_pool_->AllocateChunk()) MutationRun();
-
+			
+#if SLIM_MUTRUN_HANDLES
+			AssignHandle(new_run, p_mutrun_context);
+#endif
+			
 			// add our new run to the inuse pool
 			p_mutrun_context.in_use_pool_.push_back(new_run);
 			
@@ -284,7 +357,11 @@ public:
 			// we expect new MutationRuns to be coming from p_free_pool.  Rather, it is for memory locality; we want
 			// all the MutationRuns we're using (or that one thread is using) to be clustered together in memory.
 			MutationRun *new_run = new (p_mutrun_context.allocation_pool_->AllocateChunk()) MutationRun();
-
+			
+#if SLIM_MUTRUN_HANDLES
+			AssignHandle(new_run, p_mutrun_context);
+#endif
+			
 			// add our new run to the inuse pool
 			p_mutrun_context.in_use_pool_.push_back(new_run);
 			
@@ -337,6 +414,10 @@ public:
 		
 		free_pool.clear();
 		in_use_pool.clear();
+		
+#if SLIM_MUTRUN_HANDLES
+		ReleaseHandles(p_mutrun_context);
+#endif
 	}
 	
 	MutationRun(const MutationRun&) = delete;					// no copying
@@ -741,6 +822,24 @@ public:
 	void cache_nonneutral_mutations_REGIME_1() const;
 	void cache_nonneutral_mutations_REGIME_2() const;
 	void cache_nonneutral_mutations_REGIME_3() const;
+	void cache_nonneutral_fitness_products() const;
+	
+	// These are valid only after the non-neutral buffer has been validated, with beginend_nonneutral_pointers() or validate_nonneutral_cache(),
+	// and the products themselves with validate_nonneutral_fitness_products() (or validate_nonneutral_cache() when running parallel)
+	inline __attribute__((always_inline)) void validate_nonneutral_fitness_products(int32_t p_fitness_product_counter) const
+	{
+		if (nonneutral_product_validation_ != p_fitness_product_counter)
+		{
+			THREAD_SAFETY_IN_ACTIVE_PARALLEL("validate_nonneutral_fitness_products()");
+			
+			nonneutral_product_validation_ = p_fitness_product_counter;
+			cache_nonneutral_fitness_products();
+		}
+	}
+	
+	inline __attribute__((always_inline)) double nonneutral_homozygous_product(void) const { return nonneutral_homozygous_product_; }
+	inline __attribute__((always_inline)) double nonneutral_heterozygous_product(void) const { return nonneutral_heterozygous_product_; }
+	inline __attribute__((always_inline)) double nonneutral_haploid_product(void) const { return nonneutral_haploid_product_; }
 	
 	void check_nonneutral_mutation_cache() const;
 	
@@ -782,7 +881,7 @@ public:
 	// This is used by Subpopulation::FixNonNeutralCaches_OMP() to validate
 	// these caches; it starts a new task if the nonneutral cache is invalid
 	// This method is called from within a "single" construct.
-	inline __attribute__((always_inline)) void validate_nonneutral_cache(int32_t p_nonneutral_change_counter, int32_t p_nonneutral_regime) const
+	inline __attribute__((always_inline)) void validate_nonneutral_cache(int32_t p_nonneutral_change_counter, int32_t p_fitness_product_counter, int32_t p_nonneutral_regime) const
 	{
 		if ((nonneutral_change_validation_ != p_nonneutral_change_counter) || (nonneutral_mutations_count_ == -1))
 		{
@@ -790,6 +889,7 @@ public:
 			// reasons (most notably being a new mutation run that has not yet cached), validate it with an OpenMP task
 			// We set up these variables to prevent ourselves from seeing the cache as invalid again
 			nonneutral_change_validation_ = p_nonneutral_change_counter;
+			nonneutral_product_validation_ = p_fitness_product_counter;		// the products are recomputed along with the buffer
 			nonneutral_mutations_count_ = 0;
 			
 #if (SLIMPROFILING == 1)
@@ -809,6 +909,16 @@ public:
 				}
 			}
 		}
+		else if (nonneutral_product_validation_ != p_fitness_product_counter)
+		{
+			// The buffer is still valid, but the fitness factors of some of its mutations have changed
+			nonneutral_product_validation_ = p_fitness_product_counter;
+			
+#pragma omp task
+			{
+				cache_nonneutral_fitness_products();
+			}
+		}
 	}
 #endif
 	
@@ -831,6 +941,9 @@ public:
 	
 #endif	// SLIM_USE_NONNEUTRAL_CACHES
 	
+	// Rewrite every MutationIndex in this run (and its nonneutral cache) through p_remap; see SLiM_CompactMutationBlock()
+	void remap_mutation_indices(const MutationIndex *p_remap);
+	
 	// Memory usage tallying, for outputUsage()
 	size_t MemoryUsageForMutationIndexBuffers(void) const;
 	size_t MemoryUsageForNonneutralCaches(void) const;
@@ -263,104 +263,202 @@ double MutationType::DrawSelectionCoefficient(void) const
 			
 		case DFEType::kScript:
 		{
-			// We have a script string that we need to execute, and it will return a float or integer to us.  This
-			// is basically a lambda call, so the code here is parallel to the executeLambda() code in many ways.
+			// The script may return a vector of values, which are used in turn for successive new mutations within the same tick,
+			// so a script like "rexp(1000, 0.01);" is executed once per thousand mutations instead of once per mutation.  Values
+			// left over at the end of the tick are discarded, so that a script that depends on the model's state stays current.
+			if ((dfe_script_values_next_ >= dfe_script_values_.size()) || (dfe_script_values_tick_ != species_.community_.Tick()))
+				_RefillScriptDFEValues();
 			
-#ifdef DEBUG_LOCKS_ENABLED
-			// When running multi-threaded, this code is not re-entrant because it runs an Eidos interpreter.  We use
-			// EidosDebugLock to enforce that.  In addition, it can raise, so the caller must be prepared for that.
-			static EidosDebugLock DrawSelectionCoefficient_InterpreterLock("DrawSelectionCoefficient_InterpreterLock");
+			return dfe_script_values_[dfe_script_values_next_++];
+		}
+	}
+	EIDOS_TERMINATION << "ERROR (MutationType::DrawSelectionCoefficient): (internal error) unexpected dfe_type_ value." << EidosTerminate();
+}
+
+void MutationType::DrawSelectionCoefficients(double *p_buffer, int64_t p_count) const
+{
+	// Draw p_count selection coefficients into p_buffer; this gives the same values as p_count calls to DrawSelectionCoefficient()
+	// would, but the exponential and normal DFEs use the bulk fills in eidos_rng.h, and the others fetch the RNG only once.
+	switch (dfe_type_)
+	{
+		case DFEType::kFixed:
+		{
+			std::fill(p_buffer, p_buffer + p_count, dfe_parameters_[0]);
+			return;
+		}
 			
-			DrawSelectionCoefficient_InterpreterLock.start_critical(0);
-#endif
+		case DFEType::kGamma:
+		{
+			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
+			double shape = dfe_parameters_[1], scale = dfe_parameters_[0] / dfe_parameters_[1];
 			
-			double sel_coeff;
+			for (int64_t draw_index = 0; draw_index < p_count; ++draw_index)
+				p_buffer[draw_index] = gsl_ran_gamma(rng, shape, scale);
+			return;
+		}
 			
-			// Errors in lambdas should be reported for the lambda script, not for the calling script,
-			// if possible.  In the GUI this does not work well, however; there, errors should be
-			// reported as occurring in the call to executeLambda().  Here we save off the current
-			// error context and set up the error context for reporting errors inside the lambda,
-			// in case that is possible; see how exceptions are handled below.
-			EidosErrorContext error_context_save = gEidosErrorContext;
+		case DFEType::kExponential:
+		{
+			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 			
-			// We try to do tokenization and parsing once per script, by caching the script
-			if (!cached_dfe_script_)
-			{
-				std::string script_string = dfe_strings_[0];
-				cached_dfe_script_ = new EidosScript(script_string, -1);
-				
-				gEidosErrorContext = EidosErrorContext{{-1, -1, -1, -1}, cached_dfe_script_, true};
-				
-				try
-				{
-					cached_dfe_script_->Tokenize();
-					cached_dfe_script_->ParseInterpreterBlockToAST(false);
-				}
-				catch (...)
-				{
-					if (gEidosTerminateThrows)
-						gEidosErrorContext = error_context_save;
-					
-					delete cached_dfe_script_;
-					cached_dfe_script_ = nullptr;
-					
-#ifdef DEBUG_LOCKS_ENABLED
-					DrawSelectionCoefficient_InterpreterLock.end_critical();
-#endif
-					
-					EIDOS_TERMINATION << "ERROR (MutationType::DrawSelectionCoefficient): tokenize/parse error in type 's' DFE callback script." << EidosTerminate(nullptr);
-				}
-			}
+			Eidos_ran_exponential_fill(rng, p_buffer, p_count, dfe_parameters_[0]);
+			return;
+		}
 			
-			// Execute inside try/catch so we can handle errors well
-			gEidosErrorContext = EidosErrorContext{{-1, -1, -1, -1}, cached_dfe_script_, true};
+		case DFEType::kNormal:
+		{
+			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 			
-			try
-			{
-				Community &community = species_.community_;
-				EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &community.SymbolTable());
-				EidosFunctionMap &function_map = community.FunctionMap();
-				EidosInterpreter interpreter(*cached_dfe_script_, client_symbols, function_map, &community, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
-				
-				EidosValue_SP result_SP = interpreter.EvaluateInterpreterBlock(false, true);	// do not print output, return the last statement value
-				EidosValue *result = result_SP.get();
-				EidosValueType result_type = result->Type();
-				int result_count = result->Count();
-				
-				if ((result_type == EidosValueType::kValueFloat) && (result_count == 1))
-					sel_coeff = result->FloatData()[0];
-				else if ((result_type == EidosValueType::kValueInt) && (result_count == 1))
-					sel_coeff = result->IntData()[0];
-				else
-					EIDOS_TERMINATION << "ERROR (MutationType::DrawSelectionCoefficient): type 's' DFE callbacks must provide a singleton float or integer return value." << EidosTerminate(nullptr);
-			}
-			catch (...)
-			{
-				// If exceptions throw, then we want to set up the error information to highlight the
-				// executeLambda() that failed, since we can't highlight the actual error.  (If exceptions
-				// don't throw, this catch block will never be hit; exit() will already have been called
-				// and the error will have been reported from the context of the lambda script string.)
-				if (gEidosTerminateThrows)
-					gEidosErrorContext = error_context_save;
-				
+			Eidos_ran_gaussian_fill(rng, p_buffer, p_count, dfe_parameters_[1], dfe_parameters_[0]);
+			return;
+		}
+			
+		case DFEType::kWeibull:
+		{
+			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
+			double lambda = dfe_parameters_[0], k = dfe_parameters_[1];
+			
+			for (int64_t draw_index = 0; draw_index < p_count; ++draw_index)
+				p_buffer[draw_index] = gsl_ran_weibull(rng, lambda, k);
+			return;
+		}
+			
+		case DFEType::kLaplace:
+		{
+			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
+			double mean = dfe_parameters_[0], scale = dfe_parameters_[1];
+			
+			for (int64_t draw_index = 0; draw_index < p_count; ++draw_index)
+				p_buffer[draw_index] = gsl_ran_laplace(rng, scale) + mean;
+			return;
+		}
+			
+		case DFEType::kScript:
+		{
+			// values come from the script in whatever batches it supplies; see DrawSelectionCoefficient()
+			for (int64_t draw_index = 0; draw_index < p_count; ++draw_index)
+				p_buffer[draw_index] = DrawSelectionCoefficient();
+			return;
+		}
+	}
+	EIDOS_TERMINATION << "ERROR (MutationType::DrawSelectionCoefficients): (internal error) unexpected dfe_type_ value." << EidosTerminate();
+}
+
+void MutationType::_RefillScriptDFEValues(void) const
+{
+	// We have a script string that we need to execute, and it will return a float or integer vector to us.  This
+	// is basically a lambda call, so the code here is parallel to the executeLambda() code in many ways.
+	
 #ifdef DEBUG_LOCKS_ENABLED
-				DrawSelectionCoefficient_InterpreterLock.end_critical();
+	// When running multi-threaded, this code is not re-entrant because it runs an Eidos interpreter.  We use
+	// EidosDebugLock to enforce that.  In addition, it can raise, so the caller must be prepared for that.
+	static EidosDebugLock RefillScriptDFEValues_InterpreterLock("RefillScriptDFEValues_InterpreterLock");
+	
+	RefillScriptDFEValues_InterpreterLock.start_critical(0);
 #endif
-				
-				throw;
-			}
+	
+	// Errors in lambdas should be reported for the lambda script, not for the calling script,
+	// if possible.  In the GUI this does not work well, however; there, errors should be
+	// reported as occurring in the call to executeLambda().  Here we save off the current
+	// error context and set up the error context for reporting errors inside the lambda,
+	// in case that is possible; see how exceptions are handled below.
+	EidosErrorContext error_context_save = gEidosErrorContext;
+	
+	// We try to do tokenization and parsing once per script, by caching the script
+	if (!cached_dfe_script_)
+	{
+		std::string script_string = dfe_strings_[0];
+		cached_dfe_script_ = new EidosScript(script_string, -1);
+		
+		gEidosErrorContext = EidosErrorContext{{-1, -1, -1, -1}, cached_dfe_script_, true};
+		
+		try
+		{
+			cached_dfe_script_->Tokenize();
+			cached_dfe_script_->ParseInterpreterBlockToAST(false);
+		}
+		catch (...)
+		{
+			if (gEidosTerminateThrows)
+				gEidosErrorContext = error_context_save;
 			
-			// Restore the normal error context in the event that no exception occurring within the lambda
-			gEidosErrorContext = error_context_save;
+			delete cached_dfe_script_;
+			cached_dfe_script_ = nullptr;
 			
 #ifdef DEBUG_LOCKS_ENABLED
-			DrawSelectionCoefficient_InterpreterLock.end_critical();
+			RefillScriptDFEValues_InterpreterLock.end_critical();
 #endif
 			
-			return sel_coeff;
+			EIDOS_TERMINATION << "ERROR (MutationType::_RefillScriptDFEValues): tokenize/parse error in type 's' DFE callback script." << EidosTerminate(nullptr);
 		}
 	}
-	EIDOS_TERMINATION << "ERROR (MutationType::DrawSelectionCoefficient): (internal error) unexpected dfe_type_ value." << EidosTerminate();
+	
+	// Execute inside try/catch so we can handle errors well
+	gEidosErrorContext = EidosErrorContext{{-1, -1, -1, -1}, cached_dfe_script_, true};
+	
+	try
+	{
+		Community &community = species_.community_;
+		EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &community.SymbolTable());
+		EidosFunctionMap &function_map = community.FunctionMap();
+		EidosInterpreter interpreter(*cached_dfe_script_, client_symbols, function_map, &community, SLIM_OUTSTREAM, SLIM_ERRSTREAM);
+		
+		dfe_script_executing_++;
+		
+		EidosValue_SP result_SP = interpreter.EvaluateInterpreterBlock(false, true);	// do not print output, return the last statement value
+		
+		dfe_script_executing_--;
+		
+		EidosValue *result = result_SP.get();
+		EidosValueType result_type = result->Type();
+		int result_count = result->Count();
+		
+		if (((result_type != EidosValueType::kValueFloat) && (result_type != EidosValueType::kValueInt)) || (result_count == 0))
+			EIDOS_TERMINATION << "ERROR (MutationType::_RefillScriptDFEValues): type 's' DFE callbacks must provide a float or integer return value of length one or more." << EidosTerminate(nullptr);
+		
+		dfe_script_values_.resize(result_count);
+		
+		if (result_type == EidosValueType::kValueFloat)
+		{
+			const double *float_data = result->FloatData();
+			
+			std::copy(float_data, float_data + result_count, dfe_script_values_.data());
+		}
+		else
+		{
+			const int64_t *int_data = result->IntData();
+			
+			for (int value_index = 0; value_index < result_count; ++value_index)
+				dfe_script_values_[value_index] = (double)int_data[value_index];
+		}
+		
+		dfe_script_values_next_ = 0;
+		dfe_script_values_tick_ = species_.community_.Tick();
+	}
+	catch (...)
+	{
+		// If exceptions throw, then we want to set up the error information to highlight the
+		// executeLambda() that failed, since we can't highlight the actual error.  (If exceptions
+		// don't throw, this catch block will never be hit; exit() will already have been called
+		// and the error will have been reported from the context of the lambda script string.)
+		if (gEidosTerminateThrows)
+			gEidosErrorContext = error_context_save;
+		
+		dfe_script_executing_ = 0;
+		
+#ifdef DEBUG_LOCKS_ENABLED
+		RefillScriptDFEValues_InterpreterLock.end_critical();
+#endif
+		
+		throw;
+	}
+	
+	// Restore the normal error context in the event that no exception occurring within the lambda
+	gEidosErrorContext = error_context_save;
+	
+#ifdef DEBUG_LOCKS_ENABLED
+	RefillScriptDFEValues_InterpreterLock.end_critical();
+#endif
 }
 
 // This is unused except by debugging code and in the debugger itself
@@ -742,8 +840,7 @@ EidosValue_SP MutationType::ExecuteMethod_drawSelectionCoefficient(EidosGlobalSt
 	EidosValue_Float *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(num_draws);
 	result_SP = EidosValue_SP(float_result);
 	
-	for (int64_t draw_index = 0; draw_index < num_draws; ++draw_index)
-		float_result->set_float_no_check(DrawSelectionCoefficient(), draw_index);
+	DrawSelectionCoefficients(float_result->data_mutable(), num_draws);
 	
 	return result_SP;
 }
@@ -753,6 +850,10 @@ EidosValue_SP MutationType::ExecuteMethod_drawSelectionCoefficient(EidosGlobalSt
 EidosValue_SP MutationType::ExecuteMethod_setDistribution(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
 #pragma unused (p_method_id, p_arguments, p_interpreter)
+	// the cached script for a type 's' DFE is discarded below, so this can't be allowed while that script is running
+	if (dfe_script_executing_)
+		EIDOS_TERMINATION << "ERROR (MutationType::ExecuteMethod_setDistribution): setDistribution() may not be called on a mutation type from within its own type 's' DFE script." << EidosTerminate();
+	
 	EidosValue *distributionType_value = p_arguments[0].get();
 	std::string dfe_type_string = distributionType_value->StringAtIndex_NOCAST(0, nullptr);
 	
@@ -772,6 +873,12 @@ EidosValue_SP MutationType::ExecuteMethod_setDistribution(EidosGlobalStringID p_
 	dfe_parameters_ = dfe_parameters;
 	dfe_strings_ = dfe_strings;
 	
+	// Discard the cached script for a type 's' DFE, and any values it supplied that have not been used yet
+	delete cached_dfe_script_;
+	cached_dfe_script_ = nullptr;
+	dfe_script_values_.clear();
+	dfe_script_values_next_ = 0;
+	
 	// mark that mutation types changed, so they get redisplayed in SLiMgui
 	species_.community_.mutation_types_changed_ = true;
 	
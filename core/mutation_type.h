@@ -106,6 +106,10 @@ public:
 	slim_usertag_t tag_value_ = SLIM_TAG_UNSET_VALUE;			// a user-defined tag value
 
 	mutable EidosScript *cached_dfe_script_;	// used by DFE type 's' to hold a cached script for the DFE
+	mutable std::vector<double> dfe_script_values_;		// used by DFE type 's' to hold values returned by the script that are not yet used
+	mutable size_t dfe_script_values_next_ = 0;			// the index of the next unused value in dfe_script_values_
+	mutable slim_tick_t dfe_script_values_tick_ = -1;	// the tick in which dfe_script_values_ was filled; the values expire after that tick
+	mutable int dfe_script_executing_ = 0;				// the nesting depth of executions of cached_dfe_script_; it must not be deleted while > 0
 	
 #ifdef SLIM_KEEP_MUTTYPE_REGISTRIES
 	// MutationType now has the ability to (optionally) keep a registry of all extant mutations of its type in the simulation,
@@ -173,6 +177,8 @@ public:
 								   DFEType *p_dfe_type, std::vector<double> *p_dfe_parameters, std::vector<std::string> *p_dfe_strings);
 	
 	double DrawSelectionCoefficient(void) const;					// draw a selection coefficient from this mutation type's DFE
+	void DrawSelectionCoefficients(double *p_buffer, int64_t p_count) const;	// draw p_count selection coefficients into p_buffer
+	void _RefillScriptDFEValues(void) const;							// run a type 's' DFE's script to refill dfe_script_values_
 	
 	//
 	// Eidos support
@@ -55,6 +55,10 @@ Population::~Population(void)
 {
 	RemoveAllSubpopulationInfo();
 	
+	// if a keyed region was cut short by an error, stop logging new mutations
+	gSLiM_Mutation_LogKeyed = false;
+	gSLiM_Mutation_KeyedLog.clear();
+	
 #ifdef SLIMGUI
 	// release malloced storage for SLiMgui statistics collection
 	for (auto history_record_iter : fitness_histories_)
@@ -572,6 +576,15 @@ void Population::CheckForDeferralInIndividualsVector(Individual **p_individuals,
 // nonWF only:
 void Population::DoDeferredReproduction(void)
 {
+	if (!HasDeferredGenomes())
+		return;
+	
+	// nucleotide-based models need their mutation rate tables to be current before we draw anything (in parallel, perhaps)
+	species_.TheChromosome().PrepareNucleotideMutationDraws();
+	
+	// recombination() and mutation() callbacks cannot run in parallel, so first we run them serially and record their results
+	ResolveDeferredCallbacks();
+	
 	size_t deferred_count_nonrecombinant = deferred_reproduction_nonrecombinant_.size();
 	size_t deferred_count_recombinant = deferred_reproduction_recombinant_.size();
 	size_t deferred_count_total = deferred_count_nonrecombinant + deferred_count_recombinant;
@@ -604,13 +617,34 @@ void Population::DoDeferredReproduction(void)
 	} while (true);
 #endif
 	
+	// In deterministic mode, both loops below run in one keyed region, with one RNG stream per EIDOS_RNG_KEYED_CHUNK deferred offspring (the
+	// streams of the second loop follow those of the first); see Population::EvolveSubpopulation().  Tree-sequence recording is done inside
+	// critical regions, in an order that depends on thread scheduling, so in deterministic mode it prevents parallelization.
+	Eidos_RNG_KeyedRegion keyed_region(gEidosDeterministicParallel);
+	uint64_t rng_key = keyed_region.Key();
+	uint64_t recombinant_stream_base = (deferred_count_nonrecombinant + EIDOS_RNG_KEYED_CHUNK - 1) / EIDOS_RNG_KEYED_CHUNK;
+	
+#ifdef _OPENMP
+	bool can_parallelize = !(gEidosDeterministicParallel && species_.RecordingTreeSequence());
+	bool will_parallelize_nonrecombinant = can_parallelize && (deferred_count_nonrecombinant >= EIDOS_OMPMIN_DEFERRED_REPRO);
+	bool will_parallelize_recombinant = can_parallelize && (deferred_count_recombinant >= EIDOS_OMPMIN_DEFERRED_REPRO);
+	bool canonicalize_mutations = rng_key && (will_parallelize_nonrecombinant || will_parallelize_recombinant);
+	int schedule_chunk = (rng_key ? EIDOS_RNG_KEYED_CHUNK : 1);		// keyed streams need whole chunks; otherwise, the usual schedule
+	
+	if (canonicalize_mutations)
+		BeginKeyedMutationLog();
+#endif
+	
 	// now generate the genomes of the deferred offspring in parallel
 	EIDOS_BENCHMARK_START(EidosBenchmarkType::k_DEFERRED_REPRO);
 	
 	EIDOS_THREAD_COUNT(gEidos_OMP_threads_DEFERRED_REPRO);
-#pragma omp parallel for schedule(dynamic, 1) default(none) shared(deferred_count_nonrecombinant) if(deferred_count_nonrecombinant >= EIDOS_OMPMIN_DEFERRED_REPRO) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, schedule_chunk) default(none) shared(deferred_count_nonrecombinant, rng_key, schedule_chunk, gEidos_RNG_PERTHREAD) if(will_parallelize_nonrecombinant) num_threads(thread_count)
 	for (size_t deferred_index = 0; deferred_index < deferred_count_nonrecombinant; ++deferred_index)
 	{
+		if (rng_key && (deferred_index % EIDOS_RNG_KEYED_CHUNK == 0))
+			Eidos_RNG_SeedKeyedStream(EIDOS_STATE_RNG(omp_get_thread_num()), rng_key, deferred_index / EIDOS_RNG_KEYED_CHUNK);
+		
 		SLiM_DeferredReproduction_NonRecombinant &deferred_rec = deferred_reproduction_nonrecombinant_[deferred_index];
 		
 		if ((deferred_rec.type_ == SLiM_DeferredReproductionType::kCrossoverMutation) || (deferred_rec.type_ == SLiM_DeferredReproductionType::kSelfed))
@@ -628,28 +662,253 @@ void Population::DoDeferredReproduction(void)
 	}
 	
 	//EIDOS_THREAD_COUNT(gEidos_OMP_threads_DEFERRED_REPRO);	// this loop shares the same key
-#pragma omp parallel for schedule(dynamic, 1) default(none) shared(deferred_count_recombinant) if(deferred_count_recombinant >= EIDOS_OMPMIN_DEFERRED_REPRO) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, schedule_chunk) default(none) shared(deferred_count_recombinant, rng_key, schedule_chunk, recombinant_stream_base, gEidos_RNG_PERTHREAD) if(will_parallelize_recombinant) num_threads(thread_count)
 	for (size_t deferred_index = 0; deferred_index < deferred_count_recombinant; ++deferred_index)
 	{
+		if (rng_key && (deferred_index % EIDOS_RNG_KEYED_CHUNK == 0))
+			Eidos_RNG_SeedKeyedStream(EIDOS_STATE_RNG(omp_get_thread_num()), rng_key, recombinant_stream_base + deferred_index / EIDOS_RNG_KEYED_CHUNK);
+		
 		SLiM_DeferredReproduction_Recombinant &deferred_rec = deferred_reproduction_recombinant_[deferred_index];
 		
+		const std::vector<MutationIndex> *predrawn_mutations = (deferred_rec.mutations_predrawn_ ? &deferred_rec.predrawn_mutations_ : nullptr);
+		
 		if (deferred_rec.strand2_ == nullptr)
 		{
-			DoClonalMutation(deferred_rec.mutorigin_subpop_, *deferred_rec.child_genome_, *deferred_rec.strand1_, deferred_rec.sex_, nullptr);
+			DoClonalMutation(deferred_rec.mutorigin_subpop_, *deferred_rec.child_genome_, *deferred_rec.strand1_, deferred_rec.sex_, nullptr, predrawn_mutations);
 		}
 		else if (deferred_rec.type_ == SLiM_DeferredReproductionType::kRecombinant)
 		{
-			DoRecombinantMutation(deferred_rec.mutorigin_subpop_, *deferred_rec.child_genome_, deferred_rec.strand1_, deferred_rec.strand2_, deferred_rec.sex_, deferred_rec.break_vec_, nullptr);
+			DoRecombinantMutation(deferred_rec.mutorigin_subpop_, *deferred_rec.child_genome_, deferred_rec.strand1_, deferred_rec.strand2_, deferred_rec.sex_, deferred_rec.break_vec_, nullptr, predrawn_mutations);
 		}
 	}
 	
 	EIDOS_BENCHMARK_END(EidosBenchmarkType::k_DEFERRED_REPRO);
 	
+#ifdef _OPENMP
+	if (canonicalize_mutations)
+		EndKeyedMutationLog();
+#endif
+	
 	// Clear the deferred reproduction queue
 	deferred_reproduction_nonrecombinant_.clear();
 	deferred_reproduction_recombinant_.clear();
 }
 
+// nonWF only:
+// This is a serial pre-pass for DoDeferredReproduction().  Deferred offspring whose parents are subject to recombination() or mutation()
+// callbacks can't be generated in parallel, since callbacks run Eidos code.  Here we run those callbacks, in queue order, and record their
+// decisions – the initial copy strand, the final breakpoints, and the new mutations – in the recombinant queue, which DoDeferredReproduction()
+// then executes in parallel.  Deferred offspring not affected by callbacks are left in place.
+void Population::ResolveDeferredCallbacks(void)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ResolveDeferredCallbacks(): running Eidos callbacks");
+	
+	bool callbacks_present = false;
+	
+	for (std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)
+	{
+		Subpopulation *subpop = subpop_pair.second;
+		
+		if (subpop->registered_recombination_callbacks_.size() || subpop->registered_mutation_callbacks_.size())
+		{
+			callbacks_present = true;
+			break;
+		}
+	}
+	
+	if (!callbacks_present)
+		return;
+	
+	// addRecombinant() offspring have their breakpoints already, so only mutation() callbacks matter for them; we do them first, since
+	// the offspring resolved below get appended to the same queue.  Note the mutation() callbacks of the target subpop are used.
+	size_t deferred_count_recombinant = deferred_reproduction_recombinant_.size();
+	
+	for (size_t deferred_index = 0; deferred_index < deferred_count_recombinant; ++deferred_index)
+	{
+		SLiM_DeferredReproduction_Recombinant &deferred_rec = deferred_reproduction_recombinant_[deferred_index];
+		std::vector<SLiMEidosBlock*> *mutation_callbacks = &deferred_rec.mutorigin_subpop_->registered_mutation_callbacks_;
+		
+		if (mutation_callbacks->size())
+			PredrawDeferredMutations(deferred_rec, species_.TheChromosome().DrawMutationCount(deferred_rec.sex_), mutation_callbacks);
+	}
+	
+	// resolve addCrossed(), addSelfed(), and addCloned() offspring that need callbacks, compacting the remainder of the queue as we go
+	size_t deferred_count_nonrecombinant = deferred_reproduction_nonrecombinant_.size();
+	size_t kept_count = 0;
+	
+	for (size_t deferred_index = 0; deferred_index < deferred_count_nonrecombinant; ++deferred_index)
+	{
+		SLiM_DeferredReproduction_NonRecombinant &deferred_rec = deferred_reproduction_nonrecombinant_[deferred_index];
+		Individual *parent1 = deferred_rec.parent1_;
+		Individual *parent2 = deferred_rec.parent2_;
+		Subpopulation *parent1_subpop = parent1->subpopulation_;
+		Subpopulation *parent2_subpop = parent2->subpopulation_;
+		std::vector<SLiMEidosBlock*> *parent1_recombination_callbacks = &parent1_subpop->registered_recombination_callbacks_;
+		std::vector<SLiMEidosBlock*> *parent2_recombination_callbacks = &parent2_subpop->registered_recombination_callbacks_;
+		std::vector<SLiMEidosBlock*> *parent1_mutation_callbacks = &parent1_subpop->registered_mutation_callbacks_;
+		std::vector<SLiMEidosBlock*> *parent2_mutation_callbacks = &parent2_subpop->registered_mutation_callbacks_;
+		
+		if (!parent1_recombination_callbacks->size()) parent1_recombination_callbacks = nullptr;
+		if (!parent2_recombination_callbacks->size()) parent2_recombination_callbacks = nullptr;
+		if (!parent1_mutation_callbacks->size()) parent1_mutation_callbacks = nullptr;
+		if (!parent2_mutation_callbacks->size()) parent2_mutation_callbacks = nullptr;
+		
+		if (deferred_rec.type_ == SLiM_DeferredReproductionType::kClonal)
+		{
+			if (parent1_mutation_callbacks)
+			{
+				// cloning has no breakpoints, so only the new mutations need to be predrawn
+				Genome *parent_genomes[2] = {parent1->genome1_, parent1->genome2_};
+				Genome *child_genomes[2] = {deferred_rec.child_genome_1_, deferred_rec.child_genome_2_};
+				
+				for (int genome_index = 0; genome_index < 2; ++genome_index)
+				{
+					Genome *parent_genome = parent_genomes[genome_index];
+					Genome *child_genome = child_genomes[genome_index];
+					
+					if (child_genome->IsNull())
+						continue;
+					
+					std::vector<slim_position_t> no_breakpoints;
+					
+					deferred_reproduction_recombinant_.emplace_back(SLiM_DeferredReproductionType::kRecombinant, parent1_subpop, parent_genome, nullptr, no_breakpoints, child_genome, deferred_rec.child_sex_);
+					PredrawDeferredMutations(deferred_reproduction_recombinant_.back(), species_.TheChromosome().DrawMutationCount(deferred_rec.child_sex_), parent1_mutation_callbacks);
+				}
+				continue;
+			}
+		}
+		else if (parent1_recombination_callbacks || parent1_mutation_callbacks || parent2_recombination_callbacks || parent2_mutation_callbacks)
+		{
+			ResolveDeferredCrossover(parent1_subpop, deferred_rec.child_genome_1_, parent1->index_, deferred_rec.child_sex_, parent1->sex_, parent1_recombination_callbacks, parent1_mutation_callbacks);
+			ResolveDeferredCrossover(parent2_subpop, deferred_rec.child_genome_2_, parent2->index_, deferred_rec.child_sex_, parent2->sex_, parent2_recombination_callbacks, parent2_mutation_callbacks);
+			continue;
+		}
+		
+		// this offspring is not affected by callbacks, so keep it for parallel generation as usual
+		if (kept_count != deferred_index)
+			deferred_reproduction_nonrecombinant_[kept_count] = deferred_rec;
+		kept_count++;
+	}
+	
+	deferred_reproduction_nonrecombinant_.erase(deferred_reproduction_nonrecombinant_.begin() + kept_count, deferred_reproduction_nonrecombinant_.end());
+}
+
+// nonWF only:
+// The callback-dependent part of DoCrossoverMutation() for a deferred child genome; see ResolveDeferredCallbacks().  The result is
+// queued as a recombinant (or clonal, if no breakpoints result) child genome with explicit strands, breakpoints, and new mutations.
+void Population::ResolveDeferredCrossover(Subpopulation *p_source_subpop, Genome *p_child_genome, slim_popsize_t p_parent_index, IndividualSex p_child_sex, IndividualSex p_parent_sex, std::vector<SLiMEidosBlock*> *p_recombination_callbacks, std::vector<SLiMEidosBlock*> *p_mutation_callbacks)
+{
+	Chromosome &chromosome = species_.TheChromosome();
+	
+	// Sex-chromosome inheritance and null genomes have special-case logic in DoCrossoverMutation(), as do complex gene conversion tracts,
+	// which produce heteroduplex regions; we don't duplicate that logic here, we just generate such genomes immediately, serially
+	if ((p_child_genome->Type() != GenomeType::kAutosome) || p_child_genome->IsNull() || (chromosome.using_DSB_model_ && (chromosome.simple_conversion_fraction_ != 1.0)))
+	{
+		DoCrossoverMutation(p_source_subpop, *p_child_genome, p_parent_index, p_child_sex, p_parent_sex, p_recombination_callbacks, p_mutation_callbacks);
+		return;
+	}
+	
+	Genome *parent_genome_1 = p_source_subpop->parent_genomes_[(size_t)p_parent_index * 2];
+	Genome *parent_genome_2 = p_source_subpop->parent_genomes_[(size_t)p_parent_index * 2 + 1];
+	
+	// swap strands in half of cases to assure random assortment
+	if (Eidos_RandomBool(EIDOS_STATE_RNG(omp_get_thread_num())))
+		std::swap(parent_genome_1, parent_genome_2);
+	
+	// draw the breakpoints, and the number of mutations if we need to predraw them, as DoCrossoverMutation() would
+	int num_mutations = 0, num_breakpoints;
+	
+	if (p_mutation_callbacks)
+	{
+#ifdef USE_GSL_POISSON
+		num_mutations = chromosome.DrawMutationCount(p_parent_sex);
+		num_breakpoints = chromosome.DrawBreakpointCount(p_parent_sex);
+#else
+		chromosome.DrawMutationAndBreakpointCounts(p_parent_sex, &num_mutations, &num_breakpoints);
+#endif
+	}
+	else
+	{
+		num_breakpoints = chromosome.DrawBreakpointCount(p_parent_sex);
+	}
+	
+	std::vector<slim_position_t> breakpoints;
+	
+	if (num_breakpoints)
+	{
+		if (chromosome.using_DSB_model_)
+		{
+			std::vector<slim_position_t> heteroduplex;		// never actually used since simple_conversion_fraction_ must be 1.0
+			
+			chromosome.DrawDSBBreakpoints(p_parent_sex, num_breakpoints, breakpoints, heteroduplex);
+		}
+		else
+			chromosome.DrawCrossoverBreakpoints(p_parent_sex, num_breakpoints, breakpoints);
+	}
+	
+	if (p_recombination_callbacks)
+	{
+		ApplyRecombinationCallbacks(p_parent_index, parent_genome_1, parent_genome_2, p_source_subpop, breakpoints, *p_recombination_callbacks);
+		
+		if (breakpoints.size() > 1)
+		{
+			std::sort(breakpoints.begin(), breakpoints.end());
+			breakpoints.erase(unique(breakpoints.begin(), breakpoints.end()), breakpoints.end());
+		}
+	}
+	
+	// handle a breakpoint at position 0, which swaps the initial strand; DoRecombinantMutation() does not like this
+	if (breakpoints.size() && (breakpoints.front() == 0))
+	{
+		breakpoints.erase(breakpoints.begin());
+		std::swap(parent_genome_1, parent_genome_2);
+	}
+	
+	// TREE SEQUENCE RECORDING
+	if (species_.RecordingTreeSequence())
+		species_.RecordNewGenome(&breakpoints, p_child_genome, parent_genome_1, parent_genome_2);
+	
+	if (breakpoints.size() == 0)
+		parent_genome_2 = nullptr;		// queue a clonal copy of parent_genome_1
+	
+	deferred_reproduction_recombinant_.emplace_back(SLiM_DeferredReproductionType::kRecombinant, p_source_subpop, parent_genome_1, parent_genome_2, breakpoints, p_child_genome, p_parent_sex);
+	
+	if (p_mutation_callbacks)
+		PredrawDeferredMutations(deferred_reproduction_recombinant_.back(), num_mutations, p_mutation_callbacks);
+}
+
+// nonWF only:
+// Draw the new mutations for a deferred child genome ahead of time, running mutation() callbacks; see ResolveDeferredCallbacks().
+// This parallels the mutation-drawing code in DoRecombinantMutation() and DoClonalMutation(), which use the result.
+void Population::PredrawDeferredMutations(SLiM_DeferredReproduction_Recombinant &p_deferred_rec, int p_num_mutations, std::vector<SLiMEidosBlock*> *p_mutation_callbacks)
+{
+	p_deferred_rec.mutations_predrawn_ = true;
+	p_deferred_rec.predrawn_mutations_.clear();
+	
+	if (p_num_mutations == 0)
+		return;
+	
+	Chromosome &chromosome = species_.TheChromosome();
+	std::vector<std::pair<slim_position_t, GenomicElement *>> mut_positions;
+	
+	p_num_mutations = chromosome.DrawSortedUniquedMutationPositions(p_num_mutations, p_deferred_rec.sex_, mut_positions);
+	
+	// as for the strand2_ == nullptr case in DoDeferredReproduction(), a clonal record has no second strand and no breakpoints
+	bool is_clonal = (p_deferred_rec.strand2_ == nullptr);
+	Genome *parent_genome_2 = (is_clonal ? nullptr : p_deferred_rec.strand2_);
+	std::vector<slim_position_t> *breakpoints = (is_clonal ? nullptr : &p_deferred_rec.break_vec_);
+	slim_objectid_t mutorigin_subpop_id = p_deferred_rec.mutorigin_subpop_->subpopulation_id_;
+	slim_tick_t tick = community_.Tick();
+	
+	for (int k = 0; k < p_num_mutations; k++)
+	{
+		MutationIndex new_mutation = chromosome.DrawNewMutationExtended(mut_positions[k], mutorigin_subpop_id, tick, p_deferred_rec.strand1_, parent_genome_2, breakpoints, p_mutation_callbacks);
+		
+		if (new_mutation != -1)
+			p_deferred_rec.predrawn_mutations_.emplace_back(new_mutation);			// positions are already sorted
+	}
+}
+
 // WF only:
 // set fraction p_migrant_fraction of p_subpop_id that originates as migrants from p_source_subpop_id per cycle  
 void Population::SetMigration(Subpopulation &p_subpop, slim_objectid_t p_source_subpop_id, double p_migrant_fraction) 
@@ -1231,7 +1490,21 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 			EIDOS_TERMINATION << "ERROR (Population::EvolveSubpopulation): sex ratio " << sex_ratio << " results in a unisexual child population." << EidosTerminate();
 	}
 	
-	if (p_mate_choice_callbacks_present || p_modify_child_callbacks_present || p_recombination_callbacks_present || p_mutation_callbacks_present || p_type_s_dfe_present)
+	// If modifyChild() callbacks are the only callbacks present, and the model has opted in with initializeSLiMOptions(deferModifyChild=T),
+	// we generate all of the children without callbacks (possibly in parallel) and then run the modifyChild() callbacks afterwards, serially,
+	// regenerating any rejected children until all are accepted; see ApplyDeferredModifyChildCallbacks().  This is not done with tree-sequence
+	// recording, since retraction of a rejected child's recorded genomes is only possible for the most recently recorded child.  Otherwise, and
+	// with the other callback types, we use the serial callback path below.
+	bool two_phase_modify_child = (species_.DeferModifyChild() && p_modify_child_callbacks_present && !p_mate_choice_callbacks_present && !p_recombination_callbacks_present && !p_mutation_callbacks_present && !p_type_s_dfe_present && !recording_tree_sequence);
+	SLiM_WFMatingRecord *mating_records = nullptr;
+	
+	if (two_phase_modify_child)
+	{
+		wf_mating_records_.resize(total_children);
+		mating_records = wf_mating_records_.data();
+	}
+	
+	if (!two_phase_modify_child && (p_mate_choice_callbacks_present || p_modify_child_callbacks_present || p_recombination_callbacks_present || p_mutation_callbacks_present || p_type_s_dfe_present))
 	{
 		// CALLBACKS PRESENT: We need to generate offspring in a randomized order.  This way the callbacks are presented with potential offspring
 		// a random order, and so it is much easier to write a callback that runs for less than the full offspring generation phase (influencing a
@@ -2064,12 +2337,16 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 		// NO CALLBACKS PRESENT: offspring can be generated in a fixed (i.e. predetermined) order.  This is substantially faster, since it avoids
 		// some setup overhead, including the Eidos_ran_shuffle() call.  All code that accesses individuals within a subpopulation needs to be aware of
 		// the fact that the individuals might be in a non-random order, because of this code path.  BEWARE!
+		// If two_phase_modify_child is true, modifyChild() callbacks are present but deferred; we record each mating in mating_records, and the
+		// callbacks are called afterwards, in a shuffled order, by ApplyDeferredModifyChildCallbacks().
 		
 		// In some cases the code below parallelizes, when we're running multithreaded.  The main condition, already satisfied simply by virtue of
 		// being in this code path, is that there are no callbacks enabled, of any type, that influence the process of reproduction.  This is because
 		// we can't run Eidos code in parallel, at least for now.  At the moment, the DSB recombination model is also not allowed; it hasn't been tested.
+		// In deterministic mode (see parallelSetDeterministic()), tree-sequence recording also prevents parallelization, since the order of
+		// recording within critical regions would otherwise depend on thread scheduling.
 #ifdef _OPENMP
-		bool can_parallelize = (!species_.TheChromosome().using_DSB_model_);
+		bool can_parallelize = (!species_.TheChromosome().using_DSB_model_) && !(gEidosDeterministicParallel && recording_tree_sequence);
 #endif
 		
 		// We loop to generate females first (sex_index == 0) and males second (sex_index == 1).
@@ -2138,11 +2415,17 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 					slim_pedigreeid_t base_pedigree_id = SLiM_GetNextPedigreeID_Block(migrants_to_generate);
 					slim_popsize_t base_child_count = child_count;
 					
+					// In deterministic mode, the offspring are generated from keyed RNG streams, one for each EIDOS_RNG_KEYED_CHUNK offspring, so that the
+					// outcome does not depend upon the number of threads; if we run in parallel, the new mutations are renumbered into a canonical order.
+					Eidos_RNG_KeyedRegion keyed_region(gEidosDeterministicParallel);
+					uint64_t rng_key = keyed_region.Key();
+					
 					// We need to make sure we have adequate capacity in the global mutation block for new mutations before we go parallel;
 					// if SLiM_IncreaseMutationBlockCapacity() is called while parallel, it is a fatal error.  So we make a guess at how
 					// much free space we will need, and preallocate here as needed, regardless of will_parallelize; no reason not to.
 #ifdef _OPENMP
 					bool will_parallelize = can_parallelize && (migrants_to_generate >= EIDOS_OMPMIN_WF_REPRO);
+					int schedule_chunk = (rng_key ? EIDOS_RNG_KEYED_CHUNK : 1);		// keyed streams need whole chunks; otherwise, the usual schedule
 					size_t est_mutation_block_slots_remaining_PRE = 0;
 					//size_t actual_mutation_block_slots_remaining_PRE = 0;
 					double overall_mutation_rate = 0;
@@ -2174,6 +2457,9 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 						//std::cerr << "   before reproduction, " << actual_mutation_block_slots_remaining_PRE << " actual slots remaining (" << est_mutation_block_slots_remaining_PRE << " estimated)" << std::endl;
 						//std::cerr << "   demand for new mutations estimated at " << est_slots_needed << " (" << migrants_to_generate << " offspring, E(muts) == " << overall_mutation_rate << ")" << std::endl;
 					}
+					
+					if (rng_key && will_parallelize)
+						BeginKeyedMutationLog();
 #endif
 					
 					// generate all selfed, cloned, and autogamous offspring in one shared loop
@@ -2184,13 +2470,16 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 						{
 							EIDOS_BENCHMARK_START(EidosBenchmarkType::k_WF_REPRO);
 							EIDOS_THREAD_COUNT(gEidos_OMP_threads_WF_REPRO);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, migrants_to_generate, base_child_count, base_pedigree_id, pedigrees_enabled, p_subpop, source_subpop, child_sex, prevent_incidental_selfing) if(will_parallelize) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, migrants_to_generate, base_child_count, base_pedigree_id, pedigrees_enabled, p_subpop, source_subpop, child_sex, prevent_incidental_selfing, mating_records, rng_key, schedule_chunk) if(will_parallelize) num_threads(thread_count)
 							{
 								gsl_rng *parallel_rng = EIDOS_GSL_RNG(omp_get_thread_num());
 								
-#pragma omp for schedule(dynamic, 1)
+#pragma omp for schedule(dynamic, schedule_chunk)
 								for (slim_popsize_t migrant_count = 0; migrant_count < migrants_to_generate; migrant_count++)
 								{
+									if (rng_key && (migrant_count % EIDOS_RNG_KEYED_CHUNK == 0))
+										Eidos_RNG_SeedKeyedStream(EIDOS_STATE_RNG(omp_get_thread_num()), rng_key, (uint64_t)(migrant_count / EIDOS_RNG_KEYED_CHUNK));
+									
 									slim_popsize_t parent1 = source_subpop.DrawFemaleParentUsingFitness(parallel_rng);
 									slim_popsize_t parent2 = source_subpop.DrawMaleParentUsingFitness(parallel_rng);
 									
@@ -2211,6 +2500,9 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 									// recombination, gene-conversion, mutation
 									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * (size_t)this_child_index], parent1, child_sex, IndividualSex::kFemale, nullptr, nullptr);
 									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * (size_t)this_child_index + 1], parent2, child_sex, IndividualSex::kMale, nullptr, nullptr);
+									
+									if (mating_records)
+										mating_records[this_child_index] = SLiM_WFMatingRecord{&source_subpop, parent1, parent2, false, false};
 								}
 							}
 							EIDOS_BENCHMARK_END(EidosBenchmarkType::k_WF_REPRO);
@@ -2221,13 +2513,16 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 						{
 							EIDOS_BENCHMARK_START(EidosBenchmarkType::k_WF_REPRO);
 							EIDOS_THREAD_COUNT(gEidos_OMP_threads_WF_REPRO);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, migrants_to_generate, base_child_count, base_pedigree_id, pedigrees_enabled, p_subpop, source_subpop, child_sex, prevent_incidental_selfing) if(will_parallelize) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, migrants_to_generate, base_child_count, base_pedigree_id, pedigrees_enabled, p_subpop, source_subpop, child_sex, prevent_incidental_selfing, mating_records, rng_key, schedule_chunk) if(will_parallelize) num_threads(thread_count)
 							{
 								gsl_rng *parallel_rng = EIDOS_GSL_RNG(omp_get_thread_num());
 								
-#pragma omp for schedule(dynamic, 1)
+#pragma omp for schedule(dynamic, schedule_chunk)
 								for (slim_popsize_t migrant_count = 0; migrant_count < migrants_to_generate; migrant_count++)
 								{
+									if (rng_key && (migrant_count % EIDOS_RNG_KEYED_CHUNK == 0))
+										Eidos_RNG_SeedKeyedStream(EIDOS_STATE_RNG(omp_get_thread_num()), rng_key, (uint64_t)(migrant_count / EIDOS_RNG_KEYED_CHUNK));
+									
 									slim_popsize_t parent1 = source_subpop.DrawParentUsingFitness(parallel_rng);
 									slim_popsize_t parent2;
 									
@@ -2252,6 +2547,9 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 									// recombination, gene-conversion, mutation
 									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * (size_t)this_child_index], parent1, child_sex, IndividualSex::kHermaphrodite, nullptr, nullptr);
 									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * (size_t)this_child_index + 1], parent2, child_sex, IndividualSex::kHermaphrodite, nullptr, nullptr);
+									
+									if (mating_records)
+										mating_records[this_child_index] = SLiM_WFMatingRecord{&source_subpop, parent1, parent2, false, false};
 								}
 							}
 							EIDOS_BENCHMARK_END(EidosBenchmarkType::k_WF_REPRO);
@@ -2264,13 +2562,16 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 						// the full loop with support for selfing/cloning (but no callbacks, since we're in that overall branch)
 						EIDOS_BENCHMARK_START(EidosBenchmarkType::k_WF_REPRO);
 						EIDOS_THREAD_COUNT(gEidos_OMP_threads_WF_REPRO);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, migrants_to_generate, number_to_clone, number_to_self, base_child_count, base_pedigree_id, pedigrees_enabled, p_subpop, source_subpop, sex_enabled, child_sex, recording_tree_sequence, prevent_incidental_selfing) if(will_parallelize) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, migrants_to_generate, number_to_clone, number_to_self, base_child_count, base_pedigree_id, pedigrees_enabled, p_subpop, source_subpop, sex_enabled, child_sex, recording_tree_sequence, prevent_incidental_selfing, mating_records, rng_key, schedule_chunk) if(will_parallelize) num_threads(thread_count)
 						{
 							gsl_rng *parallel_rng = EIDOS_GSL_RNG(omp_get_thread_num());
 							
-#pragma omp for schedule(dynamic, 1)
+#pragma omp for schedule(dynamic, schedule_chunk)
 							for (slim_popsize_t migrant_count = 0; migrant_count < migrants_to_generate; migrant_count++)
 							{
+								if (rng_key && (migrant_count % EIDOS_RNG_KEYED_CHUNK == 0))
+									Eidos_RNG_SeedKeyedStream(EIDOS_STATE_RNG(omp_get_thread_num()), rng_key, (uint64_t)(migrant_count / EIDOS_RNG_KEYED_CHUNK));
+								
 								slim_popsize_t parent1, parent2;
 								
 								if (migrant_count < number_to_clone)
@@ -2311,6 +2612,9 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 									
 									DoClonalMutation(&source_subpop, child_genome_1, parent_genome_1, child_sex, nullptr);
 									DoClonalMutation(&source_subpop, child_genome_2, parent_genome_2, child_sex, nullptr);
+									
+									if (mating_records)
+										mating_records[this_child_index] = SLiM_WFMatingRecord{&source_subpop, parent1, parent1, false, true};
 								}
 								else
 								{
@@ -2369,6 +2673,9 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 									// recombination, gene-conversion, mutation
 									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * (size_t)this_child_index], parent1, child_sex, parent1_sex, nullptr, nullptr);
 									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * (size_t)this_child_index + 1], parent2, child_sex, parent2_sex, nullptr, nullptr);
+									
+									if (mating_records)
+										mating_records[this_child_index] = SLiM_WFMatingRecord{&source_subpop, parent1, parent2, (migrant_count < number_to_clone + number_to_self), false};
 								}
 							}
 						}
@@ -2378,6 +2685,9 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 					}
 					
 #ifdef _OPENMP
+					if (rng_key && will_parallelize)
+						EndKeyedMutationLog();
+					
 					//if (will_parallelize)
 					//{
 					//	size_t actual_mutation_block_slots_remaining_POST = SLiMMemoryUsageForFreeMutations() / sizeof(Mutation);
@@ -2389,9 +2699,374 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 				}
 			}
 		}
+		
+		// if modifyChild() callbacks were deferred, run them now; this regenerates rejected children until all children have been accepted
+		if (two_phase_modify_child)
+			ApplyDeferredModifyChildCallbacks(p_subpop, migrant_source_count, migration_rates, migration_sources);
 	}
 }
 
+// run deferred modifyChild() callbacks for the children of p_subpop, as recorded in wf_mating_records_ by EvolveSubpopulation(); the child
+// slots are first shuffled within each sex, and the callbacks are then called serially, in a shuffled order; rejected children are regenerated
+// (in parallel, when possible) and presented to the callbacks again, until every child has been accepted.  As in the serial callback path of EvolveSubpopulation(), a rejected child gets a
+// newly drawn source subpopulation, and is selfed/cloned according to the probabilities of that source; its sex is not redrawn.
+void Population::ApplyDeferredModifyChildCallbacks(Subpopulation &p_subpop, int p_migrant_source_count, double *p_migration_rates, Subpopulation **p_migration_sources)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ApplyDeferredModifyChildCallbacks(): running Eidos callbacks");
+	
+	gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());		// for use outside of parallel blocks
+	
+	bool pedigrees_enabled = species_.PedigreesEnabled();
+	bool prevent_incidental_selfing = species_.PreventIncidentalSelfing();
+	bool sex_enabled = p_subpop.sex_enabled_;
+	slim_popsize_t total_children = p_subpop.child_subpop_size_;
+	SLiM_WFMatingRecord *mating_records = wf_mating_records_.data();
+	unsigned int num_migrants[p_migrant_source_count + 1];
+	
+#ifdef _OPENMP
+	bool can_parallelize = (!species_.TheChromosome().using_DSB_model_);
+#endif
+	
+	// The children were generated in a fixed order (clones, then selfed, then biparental, grouped by source subpopulation), whereas the serial
+	// callback path fills the child slots in a shuffled order; so we shuffle the slots here to match, within each sex since females must come
+	// before males.  Each child's individual, genomes, and mating record move together, and index_ is fixed afterwards.
+	{
+		Individual **child_individuals = p_subpop.child_individuals_.data();
+		Genome **child_genomes = p_subpop.child_genomes_.data();
+		slim_popsize_t first_male_index = (sex_enabled ? p_subpop.child_first_male_index_ : total_children);
+		slim_popsize_t sex_ranges[3] = {0, first_male_index, total_children};
+		
+		for (int sex_index = 0; sex_index < 2; ++sex_index)
+		{
+			slim_popsize_t range_start = sex_ranges[sex_index];
+			
+			for (slim_popsize_t slot_i = sex_ranges[sex_index + 1] - 1; slot_i > range_start; --slot_i)
+			{
+				slim_popsize_t slot_j = range_start + (slim_popsize_t)Eidos_rng_uniform_int(rng, (uint32_t)(slot_i - range_start + 1));
+				
+				if (slot_j == slot_i)
+					continue;
+				
+				std::swap(child_individuals[slot_i], child_individuals[slot_j]);
+				std::swap(child_genomes[2 * (size_t)slot_i], child_genomes[2 * (size_t)slot_j]);
+				std::swap(child_genomes[2 * (size_t)slot_i + 1], child_genomes[2 * (size_t)slot_j + 1]);
+				std::swap(mating_records[slot_i], mating_records[slot_j]);
+			}
+		}
+		
+		for (slim_popsize_t child_index = 0; child_index < total_children; ++child_index)
+			child_individuals[child_index]->index_ = child_index;
+	}
+	
+	// each child gets at most 1 million attempts, as in the serial callback path
+	std::vector<slim_popsize_t> pending_children, rejected_children;
+	std::vector<int32_t> num_tries;
+	
+	pending_children.resize(total_children);
+	for (slim_popsize_t child_index = 0; child_index < total_children; ++child_index)
+		pending_children[child_index] = child_index;
+	
+	num_tries.resize(total_children, 0);
+	
+	do
+	{
+		// present the pending children to the callbacks in a random order, as the serial callback path does
+		if (pending_children.size() > 1)
+			Eidos_ran_shuffle(rng, pending_children.data(), (uint32_t)pending_children.size());
+		
+		rejected_children.clear();
+		
+		for (slim_popsize_t child_index : pending_children)
+		{
+			SLiM_WFMatingRecord &mating = mating_records[child_index];
+			Subpopulation *source_subpop = mating.source_subpop_;
+			
+			// callbacks come from the source, not the destination
+			if (source_subpop->registered_modify_child_callbacks_.size() == 0)
+				continue;
+			
+			Individual *child = p_subpop.child_individuals_[child_index];
+			Individual *parent1_ind = source_subpop->parent_individuals_[mating.parent1_];
+			Individual *parent2_ind = source_subpop->parent_individuals_[mating.parent2_];
+			
+			if (!ApplyModifyChildCallbacks(child, parent1_ind, parent2_ind, mating.selfed_, mating.cloned_, &p_subpop, source_subpop, source_subpop->registered_modify_child_callbacks_))
+			{
+				// back out child state we created; we could back out the assigned pedigree ID too
+				p_subpop.child_genomes_[(size_t)child_index * 2]->clear_to_nullptr();
+				p_subpop.child_genomes_[(size_t)child_index * 2 + 1]->clear_to_nullptr();
+				
+				if (pedigrees_enabled)
+				{
+					if (mating.cloned_ || mating.selfed_)
+						child->RevokeParentage_Uniparental(*parent1_ind);
+					else
+						child->RevokeParentage_Biparental(*parent1_ind, *parent2_ind);
+				}
+				
+				if (++num_tries[child_index] > 1000000)
+					EIDOS_TERMINATION << "ERROR (Population::ApplyDeferredModifyChildCallbacks): failed to generate child after 1 million attempts; terminating to avoid infinite loop." << EidosTerminate();
+				
+				rejected_children.emplace_back(child_index);
+			}
+		}
+		
+		if (rejected_children.size() == 0)
+			break;
+		
+		// plan a new mating for each rejected child; this is done serially with the main rng, so it does not depend on the thread count
+		for (slim_popsize_t child_index : rejected_children)
+		{
+			SLiM_WFMatingRecord &mating = mating_records[child_index];
+			IndividualSex child_sex = p_subpop.child_individuals_[child_index]->sex_;
+			Subpopulation *source_subpop = &p_subpop;
+			
+			if (p_migrant_source_count > 0)
+			{
+				gsl_ran_multinomial(rng, p_migrant_source_count + 1, 1, p_migration_rates, num_migrants);
+				
+				for (int pop_count = 0; pop_count < p_migrant_source_count + 1; ++pop_count)
+					if (num_migrants[pop_count] > 0)
+					{
+						source_subpop = p_migration_sources[pop_count];
+						break;
+					}
+			}
+			
+			double selfing_fraction = sex_enabled ? 0.0 : source_subpop->selfing_fraction_;
+			double cloning_fraction = (child_sex != IndividualSex::kMale) ? source_subpop->female_clone_fraction_ : source_subpop->male_clone_fraction_;
+			bool selfed = false, cloned = false;
+			
+			if ((selfing_fraction > 0) || (cloning_fraction > 0))
+			{
+				double draw = Eidos_rng_uniform(rng);
+				
+				if (draw < selfing_fraction)							selfed = true;
+				else if (draw < selfing_fraction + cloning_fraction)	cloned = true;
+			}
+			
+			slim_popsize_t parent1, parent2;
+			
+			if (cloned && sex_enabled)
+				parent1 = (child_sex == IndividualSex::kFemale) ? source_subpop->DrawFemaleParentUsingFitness(rng) : source_subpop->DrawMaleParentUsingFitness(rng);
+			else if (sex_enabled)
+				parent1 = source_subpop->DrawFemaleParentUsingFitness(rng);
+			else
+				parent1 = source_subpop->DrawParentUsingFitness(rng);
+			
+			if (cloned || selfed)
+				parent2 = parent1;
+			else if (sex_enabled)
+				parent2 = source_subpop->DrawMaleParentUsingFitness(rng);
+			else
+			{
+				do
+					parent2 = source_subpop->DrawParentUsingFitness(rng);	// selfing possible!
+				while (prevent_incidental_selfing && (parent2 == parent1));
+			}
+			
+			mating = SLiM_WFMatingRecord{source_subpop, parent1, parent2, selfed, cloned};
+		}
+		
+		// regenerate the rejected children according to their new matings, without callbacks
+		slim_popsize_t rejected_count = (slim_popsize_t)rejected_children.size();
+		slim_popsize_t *rejected_ptr = rejected_children.data();
+		slim_pedigreeid_t base_pedigree_id = SLiM_GetNextPedigreeID_Block(rejected_count);
+		
+		// in deterministic mode, regenerate from keyed RNG streams as EvolveSubpopulation() does; the region ends with this round
+		Eidos_RNG_KeyedRegion keyed_region(gEidosDeterministicParallel);
+		uint64_t rng_key = keyed_region.Key();
+		
+#ifdef _OPENMP
+		bool will_parallelize = can_parallelize && (rejected_count >= EIDOS_OMPMIN_WF_REPRO);
+		int schedule_chunk = (rng_key ? EIDOS_RNG_KEYED_CHUNK : 1);		// keyed streams need whole chunks; otherwise, the usual schedule
+		
+		// as in EvolveSubpopulation(), make sure we have adequate mutation block capacity before we go parallel
+		do {
+			int registry_size;
+			MutationRegistry(&registry_size);
+			
+			double overall_mutation_rate = std::max(species_.chromosome_->overall_mutation_rate_F_, species_.chromosome_->overall_mutation_rate_M_);	// already multiplied by L
+			size_t est_slots_needed = (size_t)ceil(2 * rejected_count * overall_mutation_rate);	// 2 because diploid, in the worst case
+			
+			if ((size_t)(gSLiM_Mutation_Block_Capacity - registry_size) <= 10 * est_slots_needed)
+				SLiM_IncreaseMutationBlockCapacity();
+			else
+				break;
+		} while (true);
+		
+		if (rng_key && will_parallelize)
+			BeginKeyedMutationLog();
+#endif
+		
+		EIDOS_BENCHMARK_START(EidosBenchmarkType::k_WF_REPRO);
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_WF_REPRO);
+#pragma omp parallel for schedule(dynamic, schedule_chunk) default(none) shared(gEidos_RNG_PERTHREAD, rejected_count, rejected_ptr, mating_records, base_pedigree_id, pedigrees_enabled, sex_enabled, p_subpop, rng_key, schedule_chunk) if(will_parallelize) num_threads(thread_count)
+		for (slim_popsize_t rejected_index = 0; rejected_index < rejected_count; ++rejected_index)
+		{
+			if (rng_key && (rejected_index % EIDOS_RNG_KEYED_CHUNK == 0))
+				Eidos_RNG_SeedKeyedStream(EIDOS_STATE_RNG(omp_get_thread_num()), rng_key, (uint64_t)(rejected_index / EIDOS_RNG_KEYED_CHUNK));
+			
+			slim_popsize_t child_index = rejected_ptr[rejected_index];
+			SLiM_WFMatingRecord &mating = mating_records[child_index];
+			Subpopulation *source_subpop = mating.source_subpop_;
+			Individual *new_child = p_subpop.child_individuals_[child_index];
+			IndividualSex child_sex = new_child->sex_;
+			Genome &child_genome_1 = *p_subpop.child_genomes_[2 * (size_t)child_index];
+			Genome &child_genome_2 = *p_subpop.child_genomes_[2 * (size_t)child_index + 1];
+			
+			new_child->migrant_ = (source_subpop != &p_subpop);
+			
+			if (pedigrees_enabled)
+			{
+				if (mating.cloned_ || mating.selfed_)
+					new_child->TrackParentage_Uniparental(base_pedigree_id + rejected_index, *source_subpop->parent_individuals_[mating.parent1_]);
+				else
+					new_child->TrackParentage_Biparental(base_pedigree_id + rejected_index, *source_subpop->parent_individuals_[mating.parent1_], *source_subpop->parent_individuals_[mating.parent2_]);
+			}
+			
+			// BCH 9/26/2023: inherit the spatial position of the first parent by default, to set up for deviatePositions()/pointDeviated()
+			new_child->InheritSpatialPosition(species_.SpatialDimensionality(), source_subpop->parent_individuals_[mating.parent1_]);
+			
+			if (mating.cloned_)
+			{
+				DoClonalMutation(source_subpop, child_genome_1, *source_subpop->parent_genomes_[2 * (size_t)mating.parent1_], child_sex, nullptr);
+				DoClonalMutation(source_subpop, child_genome_2, *source_subpop->parent_genomes_[2 * (size_t)mating.parent1_ + 1], child_sex, nullptr);
+			}
+			else
+			{
+				IndividualSex parent1_sex = (sex_enabled ? IndividualSex::kFemale : IndividualSex::kHermaphrodite);
+				IndividualSex parent2_sex = (mating.selfed_ ? parent1_sex : (sex_enabled ? IndividualSex::kMale : IndividualSex::kHermaphrodite));
+				
+				// recombination, gene-conversion, mutation
+				DoCrossoverMutation(source_subpop, child_genome_1, mating.parent1_, child_sex, parent1_sex, nullptr, nullptr);
+				DoCrossoverMutation(source_subpop, child_genome_2, mating.parent2_, child_sex, parent2_sex, nullptr, nullptr);
+			}
+		}
+		EIDOS_BENCHMARK_END(EidosBenchmarkType::k_WF_REPRO);
+		
+#ifdef _OPENMP
+		if (rng_key && will_parallelize)
+			EndKeyedMutationLog();
+#endif
+		
+		std::swap(pending_children, rejected_children);
+	}
+	while (true);
+}
+
+// In deterministic mode (see parallelSetDeterministic()), parallel reproduction draws its random numbers from keyed RNG streams, so each stream
+// creates the same mutations no matter which thread runs it; but the mutations get their ids, and their positions in the registry, in the order
+// in which threads happen to reach the MutationAlloc and MutationRegistryAdd critical regions.  These methods bracket such a parallel region;
+// afterwards, the new mutations get their final ids, and the tail of the registry is rebuilt, in canonical order: by stream, and by creation
+// order within each stream (each stream is consumed sequentially by a single thread).  Since a mutation's id is fixed at construction, each
+// new mutation is constructed again in place with its final id.  Tree-sequence recording, which would capture the provisional ids, does not
+// run in parallel in deterministic mode.
+void Population::BeginKeyedMutationLog(void)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Population::BeginKeyedMutationLog(): mutation registry change");
+	
+	keyed_log_base_id_ = gSLiM_next_mutation_id;
+	keyed_log_registry_size_ = mutation_registry_.size();
+	
+	gSLiM_Mutation_KeyedLog.clear();
+	gSLiM_Mutation_LogKeyed = true;
+}
+
+void Population::EndKeyedMutationLog(void)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Population::EndKeyedMutationLog(): mutation registry change");
+	
+	gSLiM_Mutation_LogKeyed = false;
+	
+	std::vector<SLiM_KeyedMutationRecord> &keyed_log = gSLiM_Mutation_KeyedLog;
+	
+	if (keyed_log.size() == 0)
+		return;
+	
+	if (gSLiM_next_mutation_id != keyed_log_base_id_ + (slim_mutationid_t)keyed_log.size())
+		EIDOS_TERMINATION << "ERROR (Population::EndKeyedMutationLog): (internal error) mutations were created outside of the keyed mutation log." << EidosTerminate();
+	
+	std::stable_sort(keyed_log.begin(), keyed_log.end(), [](const SLiM_KeyedMutationRecord &a, const SLiM_KeyedMutationRecord &b) { return a.stream_ < b.stream_; });
+	
+	// Find the mutations that made it into the registry, before renumbering anything; a mutation rejected by its stacking policy was released,
+	// and its block slot might then have been reused within the region, so we check that the slot still holds the mutation we logged
+	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	std::vector<MutationIndex> registered_mutations;
+	
+	for (SLiM_KeyedMutationRecord &record : keyed_log)
+	{
+		Mutation *mut = mut_block_ptr + record.mutation_index_;
+		
+		if ((mut->mutation_id_ == record.mutation_id_) && (mut->state_ == MutationState::kInRegistry))
+			registered_mutations.emplace_back(record.mutation_index_);
+		else
+			record.mutation_index_ = -1;
+	}
+	
+	// Assign the final ids; released mutations still consume an id, so that the ids of the others do not depend on slot reuse.  The new
+	// mutations are referenced only by index so far (no script has run since they were created), so reconstructing them is safe, as long
+	// as their state and refcount, which the constructor resets, are carried over.
+	slim_mutationid_t mutation_id = keyed_log_base_id_;
+	
+	for (SLiM_KeyedMutationRecord &record : keyed_log)
+	{
+		if (record.mutation_index_ != -1)
+		{
+			MutationIndex mut_index = record.mutation_index_;
+			Mutation *mut = mut_block_ptr + mut_index;
+			MutationType *mutation_type_ptr = mut->mutation_type_ptr_;
+			slim_position_t position = mut->position_;
+			double selection_coeff = mut->selection_coeff_;
+			slim_objectid_t subpop_index = mut->subpop_index_;
+			slim_tick_t origin_tick = mut->origin_tick_;
+			int8_t nucleotide = mut->nucleotide_;
+			int8_t state = mut->state_;
+			slim_refcount_t refcount = gSLiM_Mutation_Refcounts[mut_index];
+			
+			mut->~Mutation();
+			new (mut) Mutation(mutation_id, mutation_type_ptr, position, selection_coeff, subpop_index, origin_tick, nucleotide);
+			
+			mut->state_ = state;
+			gSLiM_Mutation_Refcounts[mut_index] = refcount;
+		}
+		
+		mutation_id++;
+	}
+	
+	// Rebuild the tail of the registry, which holds exactly the registered mutations, in canonical order
+	if (mutation_registry_.size() != keyed_log_registry_size_ + (int)registered_mutations.size())
+		EIDOS_TERMINATION << "ERROR (Population::EndKeyedMutationLog): (internal error) the mutation registry was modified outside of the keyed mutation log." << EidosTerminate();
+	
+	mutation_registry_.set_size(keyed_log_registry_size_);
+	
+	for (MutationIndex mut_index : registered_mutations)
+		mutation_registry_.emplace_back(mut_index);
+	
+#ifdef SLIM_KEEP_MUTTYPE_REGISTRIES
+	if (keeping_muttype_registries_)
+	{
+		// each muttype registry also ends with its registered mutations, so we pop them all and then push them back in order
+		for (MutationIndex mut_index : registered_mutations)
+		{
+			MutationType *mutation_type_ptr = mut_block_ptr[mut_index].mutation_type_ptr_;
+			
+			if (mutation_type_ptr->keeping_muttype_registry_)
+				mutation_type_ptr->muttype_registry_.set_size(mutation_type_ptr->muttype_registry_.size() - 1);
+		}
+		
+		for (MutationIndex mut_index : registered_mutations)
+		{
+			MutationType *mutation_type_ptr = mut_block_ptr[mut_index].mutation_type_ptr_;
+			
+			if (mutation_type_ptr->keeping_muttype_registry_)
+				mutation_type_ptr->muttype_registry_.emplace_back(mut_index);
+		}
+	}
+#endif
+	
+	keyed_log.clear();
+}
+
 // apply recombination() callbacks to a generated child; a return of true means breakpoints were changed
 bool Population::ApplyRecombinationCallbacks(slim_popsize_t p_parent_index, Genome *p_genome1, Genome *p_genome2, Subpopulation *p_source_subpop, std::vector<slim_position_t> &p_crossovers, std::vector<SLiMEidosBlock*> &p_recombination_callbacks)
 {
@@ -2541,6 +3216,25 @@ bool Population::ApplyRecombinationCallbacks(slim_popsize_t p_parent_index, Geno
 	return breakpoints_changed;
 }
 
+// find the first mutation at or after p_position in a position-sorted range of mutation indices, for splicing runs at a breakpoint in
+// DoCrossoverMutation(); most segments between breakpoints are short, so we check a few entries linearly before falling back to a binary search
+static inline __attribute__((always_inline)) const MutationIndex *FirstMutationAtOrAfterPosition(const MutationIndex *p_begin, const MutationIndex *p_end, slim_position_t p_position, const slim_position_t *p_mut_positions)
+{
+	const MutationIndex *linear_end = (p_end - p_begin > 32) ? (p_begin + 32) : p_end;
+	
+	while (p_begin != linear_end)
+	{
+		if (p_mut_positions[*p_begin] >= p_position)
+			return p_begin;
+		p_begin++;
+	}
+	
+	if (p_begin == p_end)
+		return p_end;
+	
+	return std::lower_bound(p_begin, p_end, p_position, [p_mut_positions](MutationIndex p_mut_index, slim_position_t p_pos) { return p_mut_positions[p_mut_index] < p_pos; });
+}
+
 // generate a child genome from parental genomes, with recombination, gene conversion, and mutation
 void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_child_genome, slim_popsize_t p_parent_index, IndividualSex p_child_sex, IndividualSex p_parent_sex, std::vector<SLiMEidosBlock*> *p_recombination_callbacks, std::vector<SLiMEidosBlock*> *p_mutation_callbacks)
 {
@@ -2861,7 +3555,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 			p_child_genome.check_cleared_to_nullptr();
 #endif
 			
-			Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+			const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
 			Genome *parent_genome = parent_genome_1;
 			slim_position_t mutrun_length = p_child_genome.mutrun_length_;
 			int mutrun_count = p_child_genome.mutrun_count_;
@@ -2890,61 +3584,88 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 				// The break occurs to the left of the base position of the breakpoint; check whether that is between runs
 				if (breakpoint > break_mutrun_index * mutrun_length)
 				{
-					// The breakpoint occurs *inside* the run, so process the run by copying mutations and switching strands
+					// The breakpoint occurs *inside* the run, so process the run by splicing the two parental runs and switching strands
 					int this_mutrun_index = first_uncompleted_mutrun;
-					const MutationIndex *parent1_iter		= parent_genome_1->mutruns_[this_mutrun_index]->begin_pointer_const();
-					const MutationIndex *parent2_iter		= parent_genome_2->mutruns_[this_mutrun_index]->begin_pointer_const();
-					const MutationIndex *parent1_iter_max	= parent_genome_1->mutruns_[this_mutrun_index]->end_pointer_const();
-					const MutationIndex *parent2_iter_max	= parent_genome_2->mutruns_[this_mutrun_index]->end_pointer_const();
-					const MutationIndex *parent_iter		= parent1_iter;
-					const MutationIndex *parent_iter_max	= parent1_iter_max;
-					MutationRunContext &mutrun_context_LOCKED = species_.SpeciesMutationRunContextForMutationRunIndex(this_mutrun_index);
-					MutationRun *child_mutrun = p_child_genome.WillCreateRun_LOCKED(this_mutrun_index, mutrun_context_LOCKED);
+					const MutationRun *parent1_run = parent_genome_1->MutationRunAtIndex(this_mutrun_index);
+					const MutationRun *parent2_run = parent_genome_2->MutationRunAtIndex(this_mutrun_index);
 					
-					while (true)
+					if ((parent1_run == parent2_run) || parent1_run->Identical(*parent2_run))
 					{
-						// while there are still old mutations in the parent before the current breakpoint...
-						while (parent_iter != parent_iter_max)
+						// The two parental runs are identical, so any splice of them is identical to them too; share the parental run instead of
+						// building a new one, just switching strands for each breakpoint in this run.  This is common when diversity is low.
+						p_child_genome.mutruns_[this_mutrun_index] = parent_genome->mutruns_[this_mutrun_index];
+						
+						while (true)
 						{
-							MutationIndex current_mutation = *parent_iter;
+							parent_genome_1 = parent_genome_2;
+							parent_genome_2 = parent_genome;
+							parent_genome = parent_genome_1;
 							
-							if ((mut_block_ptr + current_mutation)->position_ >= breakpoint)
+							// if we just handled the last breakpoint, which is guaranteed to be at or beyond lastPosition+1, then we are done
+							if (++break_index == break_index_max)
 								break;
 							
-							// add the old mutation; no need to check for a duplicate here since the parental genome is already duplicate-free
-							child_mutrun->emplace_back(current_mutation);
+							// if the next breakpoint is outside this mutation run, let the outer loop handle it at the mutation-run level
+							breakpoint = all_breakpoints[break_index];
 							
-							parent_iter++;
+							if ((slim_mutrun_index_t)(breakpoint / mutrun_length) > this_mutrun_index)
+							{
+								break_index--;
+								break;
+							}
 						}
+					}
+					else
+					{
+						// Splice the parental runs: for each breakpoint, find the end of the active strand's segment with a binary search on
+						// position and copy the whole segment at once, then skip the new active strand past the breakpoint the same way.
+						const MutationIndex *parent_iter		= parent1_run->begin_pointer_const();
+						const MutationIndex *parent_iter_max	= parent1_run->end_pointer_const();
+						const MutationIndex *other_iter			= parent2_run->begin_pointer_const();
+						const MutationIndex *other_iter_max		= parent2_run->end_pointer_const();
+						MutationRunContext &mutrun_context_LOCKED = species_.SpeciesMutationRunContextForMutationRunIndex(this_mutrun_index);
+						MutationRun *child_mutrun = p_child_genome.WillCreateRun_LOCKED(this_mutrun_index, mutrun_context_LOCKED);
 						
-						// we have reached the breakpoint, so swap parents; we want the "current strand" variables to change, so no std::swap()
-						parent1_iter = parent2_iter;	parent1_iter_max = parent2_iter_max;	parent_genome_1 = parent_genome_2;
-						parent2_iter = parent_iter;		parent2_iter_max = parent_iter_max;		parent_genome_2 = parent_genome;
-						parent_iter = parent1_iter;		parent_iter_max = parent1_iter_max;		parent_genome = parent_genome_1;
-						
-						// skip over anything in the new parent that occurs prior to the breakpoint; it was not the active strand
-						while (parent_iter != parent_iter_max && (mut_block_ptr + *parent_iter)->position_ < breakpoint)
-							parent_iter++;
-						
-						// we have now handled the current breakpoint, so move on to the next breakpoint; advance the enclosing for loop here
-						break_index++;
-						
-						// if we just handled the last breakpoint, which is guaranteed to be at or beyond lastPosition+1, then we are done
-						if (break_index == break_index_max)
-							break;
-						
-						// otherwise, figure out the new breakpoint, and continue looping on the current mutation run, which needs to be finished
-						breakpoint = all_breakpoints[break_index];
-						break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
-						
-						// if the next breakpoint is outside this mutation run, then finish the run and break out
-						if (break_mutrun_index > this_mutrun_index)
+						while (true)
 						{
-							while (parent_iter != parent_iter_max)
-								child_mutrun->emplace_back(*(parent_iter++));
+							// copy the active strand's mutations before the breakpoint; no need to check for duplicates since the parental genome is already duplicate-free
+							const MutationIndex *segment_end = FirstMutationAtOrAfterPosition(parent_iter, parent_iter_max, breakpoint, mut_positions);
 							
-							break_index--;	// the outer loop will want to handle the current breakpoint again at the mutation-run level
-							break;
+							if (segment_end != parent_iter)
+								child_mutrun->emplace_back_bulk(parent_iter, (int32_t)(segment_end - parent_iter));
+							
+							// we have reached the breakpoint, so swap parents; the old active strand resumes at segment_end if we come back to it
+							parent_iter = segment_end;
+							std::swap(parent_iter, other_iter);
+							std::swap(parent_iter_max, other_iter_max);
+							
+							parent_genome_1 = parent_genome_2;
+							parent_genome_2 = parent_genome;
+							parent_genome = parent_genome_1;
+							
+							// skip over anything in the new parent that occurs prior to the breakpoint; it was not the active strand
+							parent_iter = FirstMutationAtOrAfterPosition(parent_iter, parent_iter_max, breakpoint, mut_positions);
+							
+							// we have now handled the current breakpoint, so move on to the next breakpoint; advance the enclosing for loop here
+							break_index++;
+							
+							// if we just handled the last breakpoint, which is guaranteed to be at or beyond lastPosition+1, then we are done
+							if (break_index == break_index_max)
+								break;
+							
+							// otherwise, figure out the new breakpoint, and continue looping on the current mutation run, which needs to be finished
+							breakpoint = all_breakpoints[break_index];
+							break_mutrun_index = (slim_mutrun_index_t)(breakpoint / mutrun_length);
+							
+							// if the next breakpoint is outside this mutation run, then finish the run and break out
+							if (break_mutrun_index > this_mutrun_index)
+							{
+								if (parent_iter != parent_iter_max)
+									child_mutrun->emplace_back_bulk(parent_iter, (int32_t)(parent_iter_max - parent_iter));
+								
+								break_index--;	// the outer loop will want to handle the current breakpoint again at the mutation-run level
+								break;
+							}
 						}
 					}
 					
@@ -3099,8 +3820,8 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 				
 				// The mutation occurs *inside* the run, so process the run by copying mutations
 				int this_mutrun_index = first_uncompleted_mutrun;
-				const MutationIndex *parent_iter		= parent_genome->mutruns_[this_mutrun_index]->begin_pointer_const();
-				const MutationIndex *parent_iter_max	= parent_genome->mutruns_[this_mutrun_index]->end_pointer_const();
+				const MutationIndex *parent_iter		= parent_genome->MutationRunAtIndex(this_mutrun_index)->begin_pointer_const();
+				const MutationIndex *parent_iter_max	= parent_genome->MutationRunAtIndex(this_mutrun_index)->end_pointer_const();
 				MutationRunContext &mutrun_context_LOCKED = species_.SpeciesMutationRunContextForMutationRunIndex(this_mutrun_index);
 				MutationRun *child_mutrun = p_child_genome.WillCreateRun_LOCKED(this_mutrun_index, mutrun_context_LOCKED);
 				
@@ -3247,15 +3968,15 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 				int this_mutrun_index = first_uncompleted_mutrun;
 				MutationRunContext &mutrun_context_LOCKED = species_.SpeciesMutationRunContextForMutationRunIndex(this_mutrun_index);
 				MutationRun *child_mutrun = p_child_genome.WillCreateRun_LOCKED(this_mutrun_index, mutrun_context_LOCKED);
-				const MutationIndex *parent1_iter		= parent_genome_1->mutruns_[this_mutrun_index]->begin_pointer_const();
-				const MutationIndex *parent1_iter_max	= parent_genome_1->mutruns_[this_mutrun_index]->end_pointer_const();
+				const MutationIndex *parent1_iter		= parent_genome_1->MutationRunAtIndex(this_mutrun_index)->begin_pointer_const();
+				const MutationIndex *parent1_iter_max	= parent_genome_1->MutationRunAtIndex(this_mutrun_index)->end_pointer_const();
 				const MutationIndex *parent_iter		= parent1_iter;
 				const MutationIndex *parent_iter_max	= parent1_iter_max;
 				
 				if (break_mutrun_index == this_mutrun_index)
 				{
-					const MutationIndex *parent2_iter		= parent_genome_2->mutruns_[this_mutrun_index]->begin_pointer_const();
-					const MutationIndex *parent2_iter_max	= parent_genome_2->mutruns_[this_mutrun_index]->end_pointer_const();
+					const MutationIndex *parent2_iter		= parent_genome_2->MutationRunAtIndex(this_mutrun_index)->begin_pointer_const();
+					const MutationIndex *parent2_iter_max	= parent_genome_2->MutationRunAtIndex(this_mutrun_index)->end_pointer_const();
 					
 					if (mutation_mutrun_index == this_mutrun_index)
 					{
@@ -3843,7 +4564,7 @@ void Population::DoHeteroduplexRepair(std::vector<slim_position_t> &p_heterodupl
 			// Now we will process *all* additions and removals for run_index
 			MutationRunContext &mutrun_context_LOCKED = species_.SpeciesMutationRunContextForMutationRunIndex(run_index);
 			MutationRun *new_run = MutationRun::NewMutationRun_LOCKED(mutrun_context_LOCKED);
-			const MutationRun *old_run = p_child_genome->mutruns_[run_index];
+			const MutationRun *old_run = p_child_genome->MutationRunAtIndex(run_index);
 			const MutationIndex *old_run_iter		= old_run->begin_pointer_const();
 			const MutationIndex *old_run_iter_max	= old_run->end_pointer_const();
 			
@@ -3906,7 +4627,7 @@ void Population::DoHeteroduplexRepair(std::vector<slim_position_t> &p_heterodupl
 			}
 			
 			// replace the mutation run at run_index with the newly constructed run that has all additions and removals
-			p_child_genome->mutruns_[run_index] = new_run;
+			p_child_genome->SetMutationRunAtIndex(run_index, new_run);
 			
 			// go to the next run index that has changes
 			run_index = std::min(next_removal_mutrun_index, next_addition_mutrun_index);
@@ -3936,7 +4657,7 @@ void Population::DoHeteroduplexRepair(std::vector<slim_position_t> &p_heterodupl
 }
 
 // generate a child genome from parental genomes, with recombination, gene conversion, and mutation
-void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome &p_child_genome, Genome *p_parent_genome_1, Genome *p_parent_genome_2, IndividualSex p_parent_sex, std::vector<slim_position_t> &p_breakpoints, std::vector<SLiMEidosBlock*> *p_mutation_callbacks)
+void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome &p_child_genome, Genome *p_parent_genome_1, Genome *p_parent_genome_2, IndividualSex p_parent_sex, std::vector<slim_position_t> &p_breakpoints, std::vector<SLiMEidosBlock*> *p_mutation_callbacks, const std::vector<MutationIndex> *p_predrawn_mutations)
 {
 	// This method is designed to run in parallel, but only if no callbacks are enabled
 #if DEBUG
@@ -3945,7 +4666,8 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 #endif
 
 	// This is parallel to DoCrossoverMutation(), but is provided with parental genomes and breakpoints.
-	// It is called only by Subpopulation::ExecuteMethod_addRecombinant() to execute the user's plan.
+	// It is called by Subpopulation::ExecuteMethod_addRecombinant() to execute the user's plan, and by
+	// DoDeferredReproduction() to execute a plan worked out by ResolveDeferredCallbacks().
 #if DEBUG
 	if (p_breakpoints.size() == 0)
 		EIDOS_TERMINATION << "ERROR (Population::DoRecombinantMutation): (internal error) Called with an empty breakpoint array." << EidosTerminate();
@@ -3966,7 +4688,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 	
 	// determine how many mutations and breakpoints we have
 	Chromosome &chromosome = species_.TheChromosome();
-	int num_mutations = chromosome.DrawMutationCount(p_parent_sex);
+	int num_mutations = (p_predrawn_mutations ? (int)p_predrawn_mutations->size() : chromosome.DrawMutationCount(p_parent_sex));
 	
 	// we need a defined end breakpoint, so we add it now
 	p_breakpoints.emplace_back(chromosome.last_position_mutrun_ + 1);
@@ -4017,10 +4739,10 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 			{
 				// The breakpoint occurs *inside* the run, so process the run by copying mutations and switching strands
 				int this_mutrun_index = first_uncompleted_mutrun;
-				const MutationIndex *parent1_iter		= p_parent_genome_1->mutruns_[this_mutrun_index]->begin_pointer_const();
-				const MutationIndex *parent2_iter		= p_parent_genome_2->mutruns_[this_mutrun_index]->begin_pointer_const();
-				const MutationIndex *parent1_iter_max	= p_parent_genome_1->mutruns_[this_mutrun_index]->end_pointer_const();
-				const MutationIndex *parent2_iter_max	= p_parent_genome_2->mutruns_[this_mutrun_index]->end_pointer_const();
+				const MutationIndex *parent1_iter		= p_parent_genome_1->MutationRunAtIndex(this_mutrun_index)->begin_pointer_const();
+				const MutationIndex *parent2_iter		= p_parent_genome_2->MutationRunAtIndex(this_mutrun_index)->begin_pointer_const();
+				const MutationIndex *parent1_iter_max	= p_parent_genome_1->MutationRunAtIndex(this_mutrun_index)->end_pointer_const();
+				const MutationIndex *parent2_iter_max	= p_parent_genome_2->MutationRunAtIndex(this_mutrun_index)->end_pointer_const();
 				const MutationIndex *parent_iter		= parent1_iter;
 				const MutationIndex *parent_iter_max	= parent1_iter_max;
 				MutationRunContext &mutrun_context_LOCKED = species_.SpeciesMutationRunContextForMutationRunIndex(this_mutrun_index);
@@ -4094,19 +4816,6 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 		p_child_genome.check_cleared_to_nullptr();
 #endif
 		
-		// Generate all of the mutation positions as a separate stage, because we need to unique them.  See DrawSortedUniquedMutationPositions.
-#if defined(__GNUC__) && !defined(__clang__)
-		// Work around GCC bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=27557
-		static thread_local std::vector<std::pair<slim_position_t, GenomicElement *>> mut_positions;
-#else
-		static std::vector<std::pair<slim_position_t, GenomicElement *>> mut_positions;
-#pragma omp threadprivate (mut_positions)
-#endif
-		
-		mut_positions.clear();
-		
-		num_mutations = chromosome.DrawSortedUniquedMutationPositions(num_mutations, p_parent_sex, mut_positions);
-		
 		// Create vector with the mutations to be added
 #if defined(__GNUC__) && !defined(__clang__)
 		// Work around GCC bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=27557
@@ -4118,61 +4827,82 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 		
 		mutations_to_add.clear();
 		
+		if (p_predrawn_mutations)
+		{
+			// the new mutations were drawn, and passed through mutation() callbacks, ahead of time; see ResolveDeferredCallbacks()
+			mutations_to_add.assign(p_predrawn_mutations->begin(), p_predrawn_mutations->end());
+		}
+		else
+		{
+			// Generate all of the mutation positions as a separate stage, because we need to unique them.  See DrawSortedUniquedMutationPositions.
+#if defined(__GNUC__) && !defined(__clang__)
+			// Work around GCC bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=27557
+			static thread_local std::vector<std::pair<slim_position_t, GenomicElement *>> mut_positions;
+#else
+			static std::vector<std::pair<slim_position_t, GenomicElement *>> mut_positions;
+#pragma omp threadprivate (mut_positions)
+#endif
+			
+			mut_positions.clear();
+			
+			num_mutations = chromosome.DrawSortedUniquedMutationPositions(num_mutations, p_parent_sex, mut_positions);
+			
 #ifdef _OPENMP
-		bool saw_error_in_critical = false;
+			bool saw_error_in_critical = false;
 #endif
-		
+			
 #pragma omp critical (MutationAlloc)
-		{
-			try {
-				if (species_.IsNucleotideBased() || p_mutation_callbacks)
-				{
-					// In nucleotide-based models, chromosome.DrawNewMutationExtended() will return new mutations to us with nucleotide_ set correctly.
-					// To do that, and to adjust mutation rates correctly, it needs to know which parental genome the mutation occurred on the
-					// background of, so that it can get the original nucleotide or trinucleotide context.  This code path is also used if mutation()
-					// callbacks are enabled, since that also wants to be able to see the context of the mutation.
-					for (int k = 0; k < num_mutations; k++)
+			{
+				try {
+					if (species_.IsNucleotideBased() || p_mutation_callbacks)
 					{
-						MutationIndex new_mutation = chromosome.DrawNewMutationExtended(mut_positions[k], p_mutorigin_subpop->subpopulation_id_, community_.Tick(), p_parent_genome_1, p_parent_genome_2, &p_breakpoints, p_mutation_callbacks);
-						
-						if (new_mutation != -1)
-							mutations_to_add.emplace_back(new_mutation);			// positions are already sorted
-						
-						// see further comments below, in the non-nucleotide case; they apply here as well
+						// In nucleotide-based models, chromosome.DrawNewMutationExtended() will return new mutations to us with nucleotide_ set correctly.
+						// To do that, and to adjust mutation rates correctly, it needs to know which parental genome the mutation occurred on the
+						// background of, so that it can get the original nucleotide or trinucleotide context.  This code path is also used if mutation()
+						// callbacks are enabled, since that also wants to be able to see the context of the mutation.
+						for (int k = 0; k < num_mutations; k++)
+						{
+							MutationIndex new_mutation = chromosome.DrawNewMutationExtended(mut_positions[k], p_mutorigin_subpop->subpopulation_id_, community_.Tick(), p_parent_genome_1, p_parent_genome_2, &p_breakpoints, p_mutation_callbacks);
+							
+							if (new_mutation != -1)
+								mutations_to_add.emplace_back(new_mutation);			// positions are already sorted
+							
+							// see further comments below, in the non-nucleotide case; they apply here as well
+						}
 					}
-				}
-				else
-				{
-					// In non-nucleotide-based models, chromosome.DrawNewMutation() will return new mutations to us with nucleotide_ == -1
-					for (int k = 0; k < num_mutations; k++)
+					else
 					{
-						MutationIndex new_mutation = chromosome.DrawNewMutation(mut_positions[k], p_mutorigin_subpop->subpopulation_id_, community_.Tick());
-						
-						mutations_to_add.emplace_back(new_mutation);			// positions are already sorted
-						
-						// no need to worry about pure_neutral_ or all_pure_neutral_DFE_ here; the mutation is drawn from a registered genomic element type
-						// we can't handle the stacking policy here, since we don't yet know what the context of the new mutation will be; we do it below
-						// we add the new mutation to the registry below, if the stacking policy says the mutation can actually be added
+						// In non-nucleotide-based models, chromosome.DrawNewMutation() will return new mutations to us with nucleotide_ == -1
+						for (int k = 0; k < num_mutations; k++)
+						{
+							MutationIndex new_mutation = chromosome.DrawNewMutation(mut_positions[k], p_mutorigin_subpop->subpopulation_id_, community_.Tick());
+							
+							mutations_to_add.emplace_back(new_mutation);			// positions are already sorted
+							
+							// no need to worry about pure_neutral_ or all_pure_neutral_DFE_ here; the mutation is drawn from a registered genomic element type
+							// we can't handle the stacking policy here, since we don't yet know what the context of the new mutation will be; we do it below
+							// we add the new mutation to the registry below, if the stacking policy says the mutation can actually be added
+						}
 					}
-				}
-			} catch (...) {
-				// DrawNewMutation() / DrawNewMutationExtended() can raise, but it is (presumably) rare; we can leak mutations here
-				// It occurs primarily with type 's' DFEs; an error in the user's script can cause a raise through here.
+				} catch (...) {
+					// DrawNewMutation() / DrawNewMutationExtended() can raise, but it is (presumably) rare; we can leak mutations here
+					// It occurs primarily with type 's' DFEs; an error in the user's script can cause a raise through here.
 #ifdef _OPENMP
-				saw_error_in_critical = true;		// can't throw from a critical region, even when not inside a parallel region!
+					saw_error_in_critical = true;		// can't throw from a critical region, even when not inside a parallel region!
 #else
-				throw;
+					throw;
 #endif
-			}
-		}	// end #pragma omp critical (MutationAlloc)
-		
+				}
+			}	// end #pragma omp critical (MutationAlloc)
+			
 #ifdef _OPENMP
-		if (saw_error_in_critical)
-		{
-			// Note that the previous error message is still in gEidosTermination, so we just tack an addendum onto it and re-raise, in effect
-			EIDOS_TERMINATION << "ERROR (Population::DoRecombinantMutation): An exception was caught inside a critical region." << EidosTerminate();
-		}
+			if (saw_error_in_critical)
+			{
+				// Note that the previous error message is still in gEidosTermination, so we just tack an addendum onto it and re-raise, in effect
+				EIDOS_TERMINATION << "ERROR (Population::DoRecombinantMutation): An exception was caught inside a critical region." << EidosTerminate();
+			}
 #endif
+		}
 		
 		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
 		const MutationIndex *mutation_iter		= mutations_to_add.data();
@@ -4257,15 +4987,15 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 			int this_mutrun_index = first_uncompleted_mutrun;
 			MutationRunContext &mutrun_context_LOCKED = species_.SpeciesMutationRunContextForMutationRunIndex(this_mutrun_index);
 			MutationRun *child_mutrun = p_child_genome.WillCreateRun_LOCKED(this_mutrun_index, mutrun_context_LOCKED);
-			const MutationIndex *parent1_iter		= p_parent_genome_1->mutruns_[this_mutrun_index]->begin_pointer_const();
-			const MutationIndex *parent1_iter_max	= p_parent_genome_1->mutruns_[this_mutrun_index]->end_pointer_const();
+			const MutationIndex *parent1_iter		= p_parent_genome_1->MutationRunAtIndex(this_mutrun_index)->begin_pointer_const();
+			const MutationIndex *parent1_iter_max	= p_parent_genome_1->MutationRunAtIndex(this_mutrun_index)->end_pointer_const();
 			const MutationIndex *parent_iter		= parent1_iter;
 			const MutationIndex *parent_iter_max	= parent1_iter_max;
 			
 			if (break_mutrun_index == this_mutrun_index)
 			{
-				const MutationIndex *parent2_iter		= p_parent_genome_2->mutruns_[this_mutrun_index]->begin_pointer_const();
-				const MutationIndex *parent2_iter_max	= p_parent_genome_2->mutruns_[this_mutrun_index]->end_pointer_const();
+				const MutationIndex *parent2_iter		= p_parent_genome_2->MutationRunAtIndex(this_mutrun_index)->begin_pointer_const();
+				const MutationIndex *parent2_iter_max	= p_parent_genome_2->MutationRunAtIndex(this_mutrun_index)->end_pointer_const();
 				
 				if (mutation_mutrun_index == this_mutrun_index)
 				{
@@ -4564,7 +5294,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 #endif
 }
 
-void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_child_genome, Genome &p_parent_genome, IndividualSex p_child_sex, std::vector<SLiMEidosBlock*> *p_mutation_callbacks)
+void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_child_genome, Genome &p_parent_genome, IndividualSex p_child_sex, std::vector<SLiMEidosBlock*> *p_mutation_callbacks, const std::vector<MutationIndex> *p_predrawn_mutations)
 {
 #pragma unused(p_child_sex)
 	// This method is designed to run in parallel, but only if no callbacks are enabled
@@ -4600,7 +5330,7 @@ void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_c
 	
 	// determine how many mutations and breakpoints we have
 	Chromosome &chromosome = species_.TheChromosome();
-	int num_mutations = chromosome.DrawMutationCount(p_child_sex);	// the parent sex is the same as the child sex
+	int num_mutations = (p_predrawn_mutations ? (int)p_predrawn_mutations->size() : chromosome.DrawMutationCount(p_child_sex));	// the parent sex is the same as the child sex
 	
 	// mutations are usually rare, so let's streamline the case where none occur
 	if (num_mutations == 0)
@@ -4615,19 +5345,6 @@ void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_c
 		p_child_genome.check_cleared_to_nullptr();
 #endif
 		
-		// Generate all of the mutation positions as a separate stage, because we need to unique them.  See DrawSortedUniquedMutationPositions.
-#if defined(__GNUC__) && !defined(__clang__)
-		// Work around GCC bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=27557
-		static thread_local std::vector<std::pair<slim_position_t, GenomicElement *>> mut_positions;
-#else
-		static std::vector<std::pair<slim_position_t, GenomicElement *>> mut_positions;
-#pragma omp threadprivate (mut_positions)
-#endif
-		
-		mut_positions.clear();
-		
-		num_mutations = chromosome.DrawSortedUniquedMutationPositions(num_mutations, p_child_sex, mut_positions);
-		
 		// Create vector with the mutations to be added
 #if defined(__GNUC__) && !defined(__clang__)
 		// Work around GCC bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=27557
@@ -4639,61 +5356,82 @@ void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_c
 		
 		mutations_to_add.clear();
 		
+		if (p_predrawn_mutations)
+		{
+			// the new mutations were drawn, and passed through mutation() callbacks, ahead of time; see ResolveDeferredCallbacks()
+			mutations_to_add.assign(p_predrawn_mutations->begin(), p_predrawn_mutations->end());
+		}
+		else
+		{
+			// Generate all of the mutation positions as a separate stage, because we need to unique them.  See DrawSortedUniquedMutationPositions.
+#if defined(__GNUC__) && !defined(__clang__)
+			// Work around GCC bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=27557
+			static thread_local std::vector<std::pair<slim_position_t, GenomicElement *>> mut_positions;
+#else
+			static std::vector<std::pair<slim_position_t, GenomicElement *>> mut_positions;
+#pragma omp threadprivate (mut_positions)
+#endif
+			
+			mut_positions.clear();
+			
+			num_mutations = chromosome.DrawSortedUniquedMutationPositions(num_mutations, p_child_sex, mut_positions);
+			
 #ifdef _OPENMP
-		bool saw_error_in_critical = false;
+			bool saw_error_in_critical = false;
 #endif
-		
+			
 #pragma omp critical (MutationAlloc)
-		{
-			try {
-				if (species_.IsNucleotideBased() || p_mutation_callbacks)
-				{
-					// In nucleotide-based models, chromosome.DrawNewMutationExtended() will return new mutations to us with nucleotide_ set correctly.
-					// To do that, and to adjust mutation rates correctly, it needs to know which parental genome the mutation occurred on the
-					// background of, so that it can get the original nucleotide or trinucleotide context.  This code path is also used if mutation()
-					// callbacks are enabled, since that also wants to be able to see the context of the mutation.
-					for (int k = 0; k < num_mutations; k++)
+			{
+				try {
+					if (species_.IsNucleotideBased() || p_mutation_callbacks)
 					{
-						MutationIndex new_mutation = chromosome.DrawNewMutationExtended(mut_positions[k], p_mutorigin_subpop->subpopulation_id_, community_.Tick(), &p_parent_genome, nullptr, nullptr, p_mutation_callbacks);
-						
-						if (new_mutation != -1)
-							mutations_to_add.emplace_back(new_mutation);			// positions are already sorted
-						
-						// see further comments below, in the non-nucleotide case; they apply here as well
+						// In nucleotide-based models, chromosome.DrawNewMutationExtended() will return new mutations to us with nucleotide_ set correctly.
+						// To do that, and to adjust mutation rates correctly, it needs to know which parental genome the mutation occurred on the
+						// background of, so that it can get the original nucleotide or trinucleotide context.  This code path is also used if mutation()
+						// callbacks are enabled, since that also wants to be able to see the context of the mutation.
+						for (int k = 0; k < num_mutations; k++)
+						{
+							MutationIndex new_mutation = chromosome.DrawNewMutationExtended(mut_positions[k], p_mutorigin_subpop->subpopulation_id_, community_.Tick(), &p_parent_genome, nullptr, nullptr, p_mutation_callbacks);
+							
+							if (new_mutation != -1)
+								mutations_to_add.emplace_back(new_mutation);			// positions are already sorted
+							
+							// see further comments below, in the non-nucleotide case; they apply here as well
+						}
 					}
-				}
-				else
-				{
-					// In non-nucleotide-based models, chromosome.DrawNewMutation() will return new mutations to us with nucleotide_ == -1
-					for (int k = 0; k < num_mutations; k++)
+					else
 					{
-						MutationIndex new_mutation = chromosome.DrawNewMutation(mut_positions[k], p_mutorigin_subpop->subpopulation_id_, community_.Tick());	// the parent sex is the same as the child sex
-						
-						mutations_to_add.emplace_back(new_mutation);			// positions are already sorted
-						
-						// no need to worry about pure_neutral_ or all_pure_neutral_DFE_ here; the mutation is drawn from a registered genomic element type
-						// we can't handle the stacking policy here, since we don't yet know what the context of the new mutation will be; we do it below
-						// we add the new mutation to the registry below, if the stacking policy says the mutation can actually be added
+						// In non-nucleotide-based models, chromosome.DrawNewMutation() will return new mutations to us with nucleotide_ == -1
+						for (int k = 0; k < num_mutations; k++)
+						{
+							MutationIndex new_mutation = chromosome.DrawNewMutation(mut_positions[k], p_mutorigin_subpop->subpopulation_id_, community_.Tick());	// the parent sex is the same as the child sex
+							
+							mutations_to_add.emplace_back(new_mutation);			// positions are already sorted
+							
+							// no need to worry about pure_neutral_ or all_pure_neutral_DFE_ here; the mutation is drawn from a registered genomic element type
+							// we can't handle the stacking policy here, since we don't yet know what the context of the new mutation will be; we do it below
+							// we add the new mutation to the registry below, if the stacking policy says the mutation can actually be added
+						}
 					}
-				}
-			} catch (...) {
-				// DrawNewMutation() / DrawNewMutationExtended() can raise, but it is (presumably) rare; we can leak mutations here
-				// It occurs primarily with type 's' DFEs; an error in the user's script can cause a raise through here.
+				} catch (...) {
+					// DrawNewMutation() / DrawNewMutationExtended() can raise, but it is (presumably) rare; we can leak mutations here
+					// It occurs primarily with type 's' DFEs; an error in the user's script can cause a raise through here.
 #ifdef _OPENMP
-				saw_error_in_critical = true;		// can't throw from a critical region, even when not inside a parallel region!
+					saw_error_in_critical = true;		// can't throw from a critical region, even when not inside a parallel region!
 #else
-				throw;
+					throw;
 #endif
-			}
-		}	// end #pragma omp critical (MutationAlloc)
-		
+				}
+			}	// end #pragma omp critical (MutationAlloc)
+			
 #ifdef _OPENMP
-		if (saw_error_in_critical)
-		{
-			// Note that the previous error message is still in gEidosTermination, so we just tack an addendum onto it and re-raise, in effect
-			EIDOS_TERMINATION << "ERROR (Population::DoClonalMutation): An exception was caught inside a critical region." << EidosTerminate();
-		}
+			if (saw_error_in_critical)
+			{
+				// Note that the previous error message is still in gEidosTermination, so we just tack an addendum onto it and re-raise, in effect
+				EIDOS_TERMINATION << "ERROR (Population::DoClonalMutation): An exception was caught inside a critical region." << EidosTerminate();
+			}
 #endif
+		}
 		
 		// if there are no mutations, the child genome is just a copy of the parental genome
 		// this can happen with nucleotide-based models because -1 can be returned by DrawNewMutationExtended()
@@ -4727,7 +5465,7 @@ void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_c
 				// interleave the parental genome with the new mutations
 				MutationRunContext &mutrun_context_LOCKED = species_.SpeciesMutationRunContextForMutationRunIndex(run_index);
 				MutationRun *child_run = p_child_genome.WillCreateRun_LOCKED(run_index, mutrun_context_LOCKED);
-				const MutationRun *parent_run = p_parent_genome.mutruns_[run_index];
+				const MutationRun *parent_run = p_parent_genome.MutationRunAtIndex(run_index);
 				const MutationIndex *parent_iter		= parent_run->begin_pointer_const();
 				const MutationIndex *parent_iter_max	= parent_run->end_pointer_const();
 				
@@ -5003,6 +5741,9 @@ void Population::AddTallyForMutationTypeAndBinNumber(int p_mutation_type_index,
 void Population::ValidateMutationFitnessCaches(void)
 {
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	slim_selcoeff_t *mut_one_plus_sel = gSLiM_Mutation_OnePlusSel;
+	slim_selcoeff_t *mut_one_plus_dom_sel = gSLiM_Mutation_OnePlusDomSel;
+	slim_selcoeff_t *mut_one_plus_haploiddom_sel = gSLiM_Mutation_OnePlusHaploidDomSel;
 	int registry_size;
 	const MutationIndex *registry_iter = MutationRegistry(&registry_size);
 	const MutationIndex *registry_iter_end = registry_iter + registry_size;
@@ -5015,10 +5756,13 @@ void Population::ValidateMutationFitnessCaches(void)
 		slim_selcoeff_t dom_coeff = mut->mutation_type_ptr_->dominance_coeff_;
 		slim_selcoeff_t haploid_dom_coeff = mut->mutation_type_ptr_->haploid_dominance_coeff_;
 		
-		mut->cached_one_plus_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + sel_coeff);
-		mut->cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + dom_coeff * sel_coeff);
-		mut->cached_one_plus_haploiddom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + haploid_dom_coeff * sel_coeff);
+		mut_one_plus_sel[mut_index] = (slim_selcoeff_t)std::max(0.0, 1.0 + sel_coeff);
+		mut_one_plus_dom_sel[mut_index] = (slim_selcoeff_t)std::max(0.0, 1.0 + dom_coeff * sel_coeff);
+		mut_one_plus_haploiddom_sel[mut_index] = (slim_selcoeff_t)std::max(0.0, 1.0 + haploid_dom_coeff * sel_coeff);
 	}
+	
+	// the fitness products kept with MutationRun's nonneutral caches depend upon these values, so they need revalidation
+	species_.fitness_product_change_counter_++;
 }
 
 void Population::RecalculateFitness(slim_tick_t p_tick)
@@ -5347,7 +6091,7 @@ void Population::UniqueMutationRuns(void)
 				if (genome.IsNull())
 					continue;
 				
-				const MutationRun *mut_run = genome.mutruns_[mutrun_index];
+				const MutationRun *mut_run = genome.MutationRunAtIndex(mutrun_index);
 				
 				if (mut_run)
 				{
@@ -5398,7 +6142,7 @@ void Population::UniqueMutationRuns(void)
 							
 							if (mut_run->Identical(*hash_run))
 							{
-								genome.mutruns_[mutrun_index] = hash_run;
+								genome.SetMutationRunAtIndex(mutrun_index, hash_run);
 								total_identical++;
 								
 								// We will unique away all references to this mutrun, but we only want to count it once
@@ -5477,10 +6221,10 @@ void Population::SplitMutationRuns(int32_t p_new_mutrun_count)
 					if (new_mutrun_count <= SLIM_GENOME_MUTRUN_BUFSIZE)
 					{
 						genome.mutruns_ = genome.run_buffer_;
-						EIDOS_BZERO(genome.run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(const MutationRun *));
+						EIDOS_BZERO(genome.run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(MutationRunRef));
 					}
 					else
-						genome.mutruns_ = (const MutationRun **)calloc(new_mutrun_count, sizeof(const MutationRun *));
+						genome.mutruns_ = (MutationRunRef *)calloc(new_mutrun_count, sizeof(MutationRunRef));
 					
 					// Install empty MutationRun objects; I think this is not necessary, since this is the
 					// child generation, which will not be accessed by anybody until crossover-mutation
@@ -5531,7 +6275,7 @@ void Population::SplitMutationRuns(int32_t p_new_mutrun_count)
 					
 					for (int run_index = 0; run_index < old_mutrun_count; ++run_index)
 					{
-						const MutationRun *mutrun = genome.mutruns_[run_index];
+						const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 						MutationRunContext &mutrun_context = species_.SpeciesMutationRunContextForMutationRunIndex(run_index);
 						
 						if (mutrun->use_count() == 1)
@@ -5586,10 +6330,10 @@ void Population::SplitMutationRuns(int32_t p_new_mutrun_count)
 					if (new_mutrun_count <= SLIM_GENOME_MUTRUN_BUFSIZE)
 						genome.mutruns_ = genome.run_buffer_;
 					else
-						genome.mutruns_ = (const MutationRun **)malloc(new_mutrun_count * sizeof(const MutationRun *));	// not calloc() because overwritten below
+						genome.mutruns_ = (MutationRunRef *)malloc(new_mutrun_count * sizeof(MutationRunRef));	// not calloc() because overwritten below
 					
 					for (int run_index = 0; run_index < new_mutrun_count; ++run_index)
-						genome.mutruns_[run_index] = mutruns_buf[run_index];
+						genome.SetMutationRunAtIndex(run_index, mutruns_buf[run_index]);
 				}
 			}
 		}
@@ -5674,10 +6418,10 @@ void Population::JoinMutationRuns(int32_t p_new_mutrun_count)
 					if (new_mutrun_count <= SLIM_GENOME_MUTRUN_BUFSIZE)
 					{
 						genome.mutruns_ = genome.run_buffer_;
-						EIDOS_BZERO(genome.run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(const MutationRun *));
+						EIDOS_BZERO(genome.run_buffer_, SLIM_GENOME_MUTRUN_BUFSIZE * sizeof(MutationRunRef));
 					}
 					else
-						genome.mutruns_ = (const MutationRun **)calloc(new_mutrun_count, sizeof(const MutationRun *));
+						genome.mutruns_ = (MutationRunRef *)calloc(new_mutrun_count, sizeof(MutationRunRef));
 					
 					// Install empty MutationRun objects; I think this is not necessary, since this is the
 					// child generation, which will not be accessed by anybody until crossover-mutation
@@ -5727,8 +6471,8 @@ void Population::JoinMutationRuns(int32_t p_new_mutrun_count)
 					
 					for (int run_index = 0; run_index < old_mutrun_count; run_index += 2)
 					{
-						const MutationRun *mutrun1 = genome.mutruns_[run_index];
-						const MutationRun *mutrun2 = genome.mutruns_[run_index + 1];
+						const MutationRun *mutrun1 = genome.MutationRunAtIndex(run_index);
+						const MutationRun *mutrun2 = genome.MutationRunAtIndex(run_index + 1);
 						MutationRunContext &mutrun_context = species_.SpeciesMutationRunContextForMutationRunIndex(run_index);
 						
 						if ((mutrun1->use_count() == 1) || (mutrun2->use_count() == 1))
@@ -5780,10 +6524,10 @@ void Population::JoinMutationRuns(int32_t p_new_mutrun_count)
 					if (new_mutrun_count <= SLIM_GENOME_MUTRUN_BUFSIZE)
 						genome.mutruns_ = genome.run_buffer_;
 					else
-						genome.mutruns_ = (const MutationRun **)malloc(new_mutrun_count * sizeof(const MutationRun *));	// not calloc() because overwritten below
+						genome.mutruns_ = (MutationRunRef *)malloc(new_mutrun_count * sizeof(MutationRunRef));	// not calloc() because overwritten below
 					
 					for (int run_index = 0; run_index < new_mutrun_count; ++run_index)
-						genome.mutruns_[run_index] = mutruns_buf[run_index];
+						genome.SetMutationRunAtIndex(run_index, mutruns_buf[run_index]);
 				}
 			}
 		}
@@ -5886,7 +6630,7 @@ void Population::AssessMutationRuns(void)
 					
 					for (int run_index = 0; run_index < mutrun_count; ++run_index)
 					{
-						const MutationRun *mutrun = genome.mutruns_[run_index];
+						const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 						int mutrun_size = mutrun->size();
 						
 						total_mutrun_count++;
@@ -6002,7 +6746,7 @@ slim_refcount_t Population::TallyMutationRunReferencesForPopulation(void)
 					if (!genome.IsNull())
 					{
 						for (int run_index = first_mutrun_index; run_index <= last_mutrun_index; ++run_index)
-							genome.mutruns_[run_index]->increment_use_count();
+							genome.MutationRunAtIndex(run_index)->increment_use_count();
 						
 						total_genome_count++;
 					}
@@ -6016,7 +6760,7 @@ slim_refcount_t Population::TallyMutationRunReferencesForPopulation(void)
 					Genome &genome = *subpop_genomes[i];
 					
 					for (int run_index = first_mutrun_index; run_index <= last_mutrun_index; ++run_index)
-						genome.mutruns_[run_index]->increment_use_count();
+						genome.MutationRunAtIndex(run_index)->increment_use_count();
 				}
 				
 				total_genome_count += subpop_genome_count;
@@ -6055,7 +6799,7 @@ slim_refcount_t Population::TallyMutationRunReferencesForPopulation(void)
 					int mutrun_count = genome.mutrun_count_;
 					
 					for (int run_index = 0; run_index < mutrun_count; ++run_index)
-						genome.mutruns_[run_index]->use_count_CHECK_++;
+						genome.MutationRunAtIndex(run_index)->use_count_CHECK_++;
 					
 					total_genome_count_CHECK++;
 				}
@@ -6142,7 +6886,7 @@ slim_refcount_t Population::TallyMutationRunReferencesForSubpops(std::vector<Sub
 					if (!genome.IsNull())
 					{
 						for (int run_index = first_mutrun_index; run_index <= last_mutrun_index; ++run_index)
-							genome.mutruns_[run_index]->increment_use_count();
+							genome.MutationRunAtIndex(run_index)->increment_use_count();
 						
 						total_genome_count++;
 					}
@@ -6156,7 +6900,7 @@ slim_refcount_t Population::TallyMutationRunReferencesForSubpops(std::vector<Sub
 					Genome &genome = *subpop_genomes[i];
 					
 					for (int run_index = first_mutrun_index; run_index <= last_mutrun_index; ++run_index)
-						genome.mutruns_[run_index]->increment_use_count();
+						genome.MutationRunAtIndex(run_index)->increment_use_count();
 				}
 				
 				total_genome_count += subpop_genome_count;
@@ -6214,7 +6958,7 @@ slim_refcount_t Population::TallyMutationRunReferencesForGenomes(const Genome *
 			if (!genome->IsNull())
 			{
 				for (int run_index = first_mutrun_index; run_index <= last_mutrun_index; ++run_index)
-					genome->mutruns_[run_index]->increment_use_count();
+					genome->MutationRunAtIndex(run_index)->increment_use_count();
 				
 				total_genome_count++;
 			}
@@ -6266,6 +7010,44 @@ void Population::FreeUnusedMutationRuns(void)
 	}
 }
 
+void Population::RemapMutationIndices(const std::vector<MutationIndex> &p_remap)
+{
+	// SLiM_CompactMutationBlock() has renumbered all live mutations; rewrite every MutationIndex we hold to match.
+	// The mutation block is shared, so this must be done for every species, active or not, after any compaction.
+	const MutationIndex *remap = p_remap.data();
+	
+	mutation_registry_.remap_mutation_indices(remap);
+	
+#ifdef SLIM_KEEP_MUTTYPE_REGISTRIES
+	if (keeping_muttype_registries_)
+	{
+		for (auto muttype_iter : species_.MutationTypes())
+		{
+			MutationType *muttype = muttype_iter.second;
+			
+			if (muttype->keeping_muttype_registry_)
+				muttype->muttype_registry_.remap_mutation_indices(remap);
+		}
+	}
+#endif
+	
+	// Mutation runs are reached through the in-use pools rather than through genomes, so that each run is rewritten
+	// exactly once however many genomes share it; each thread handles its own MutationRunContext.  Runs in the free
+	// pools are empty, with invalid nonneutral caches, so they need no work.
+#ifdef _OPENMP
+	int mutrun_context_count = species_.SpeciesMutationRunContextCount();
+#endif
+	
+#pragma omp parallel default(none) shared(remap) num_threads(mutrun_context_count)
+	{
+		MutationRunContext &mutrun_context = species_.SpeciesMutationRunContextForThread(omp_get_thread_num());
+		
+		// runs in use are const to their clients, but rewriting their indices does not change their content
+		for (const MutationRun *mutrun : mutrun_context.in_use_pool_)
+			const_cast<MutationRun *>(mutrun)->remap_mutation_indices(remap);
+	}
+}
+
 // count the number of non-null genomes in the population
 slim_refcount_t Population::_CountNonNullGenomes(void)
 {
@@ -6457,7 +7239,7 @@ slim_refcount_t Population::TallyMutationReferencesAcrossPopulation(bool p_force
 						
 						for (int run_index = 0; run_index < mutrun_count; ++run_index)
 						{
-							const MutationRun *mutrun = genome.mutruns_[run_index];
+							const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 							const MutationIndex *genome_iter = mutrun->begin_pointer_const();
 							const MutationIndex *genome_end_iter = mutrun->end_pointer_const();
 							
@@ -6491,7 +7273,7 @@ slim_refcount_t Population::TallyMutationReferencesAcrossPopulation(bool p_force
 						
 						for (int run_index = 0; run_index < mutrun_count; ++run_index)
 						{
-							const MutationRun *mutrun = genome.mutruns_[run_index];
+							const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 							const MutationIndex *genome_iter = mutrun->begin_pointer_const();
 							const MutationIndex *genome_end_iter = mutrun->end_pointer_const();
 							
@@ -6623,7 +7405,7 @@ slim_refcount_t Population::TallyMutationReferencesAcrossSubpopulations(std::vec
 					
 					for (int run_index = 0; run_index < mutrun_count; ++run_index)
 					{
-						const MutationRun *mutrun = genome.mutruns_[run_index];
+						const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 						const MutationIndex *genome_iter = mutrun->begin_pointer_const();
 						const MutationIndex *genome_end_iter = mutrun->end_pointer_const();
 						
@@ -6689,7 +7471,7 @@ slim_refcount_t Population::TallyMutationReferencesAcrossGenomes(const Genome *
 				
 				for (int run_index = 0; run_index < mutrun_count; ++run_index)
 				{
-					const MutationRun *mutrun = genome.mutruns_[run_index];
+					const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 					const MutationIndex *genome_iter = mutrun->begin_pointer_const();
 					const MutationIndex *genome_end_iter = mutrun->end_pointer_const();
 					
@@ -6778,7 +7560,7 @@ void Population::_CheckMutationTallyAcrossGenomes(const Genome * const *genomes_
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
 		{
-			const MutationRun *mutrun = genome->mutruns_[run_index];
+			const MutationRun *mutrun = genome->MutationRunAtIndex(run_index);
 			const MutationIndex *genome_iter = mutrun->begin_pointer_const();
 			const MutationIndex *genome_end_iter = mutrun->end_pointer_const();
 			
@@ -7189,14 +7971,18 @@ void Population::RemoveAllFixedMutations(void)
 		// Nucleotide-based models also need to modify the ancestral sequence when a mutation fixes
 		if (species_.IsNucleotideBased())
 		{
-			NucleotideArray *ancestral_seq = species_.TheChromosome().ancestral_seq_buffer_;
+			Chromosome &chromosome = species_.TheChromosome();
+			NucleotideArray *ancestral_seq = chromosome.ancestral_seq_buffer_;
 			
 			for (int i = 0; i < fixed_mutation_accumulator.size(); i++)
 			{
 				Mutation *mut_to_remove = mut_block_ptr + fixed_mutation_accumulator[i];
 				
 				if (mut_to_remove->mutation_type_ptr_->nucleotide_based_)
+				{
 					ancestral_seq->SetNucleotideAtIndex(mut_to_remove->position_, mut_to_remove->nucleotide_);
+					chromosome.AncestralNucleotideSubstituted(mut_to_remove->position_);
+				}
 			}
 		}
 	}
@@ -7269,7 +8055,7 @@ void Population::CheckMutationRegistry(bool p_check_genomes)
 				
 				for (int run_index = 0; run_index < mutrun_count; ++run_index)
 				{
-					const MutationRun *mutrun = genome.mutruns_[run_index];
+					const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 					const MutationIndex *genome_iter = mutrun->begin_pointer_const();
 					const MutationIndex *genome_end_iter = mutrun->end_pointer_const();
 					
@@ -7388,7 +8174,7 @@ void Population::PrintAll(std::ostream &p_out, bool p_output_spatial_positions,
 			
 			for (int run_index = 0; run_index < mutrun_count; ++run_index)
 			{
-				const MutationRun *mutrun = genome.mutruns_[run_index];
+				const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 				int mut_count = mutrun->size();
 				const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 				
@@ -7523,7 +8309,7 @@ void Population::PrintAll(std::ostream &p_out, bool p_output_spatial_positions,
 				
 				for (int run_index = 0; run_index < mutrun_count; ++run_index)
 				{
-					const MutationRun *mutrun = genome.mutruns_[run_index];
+					const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 					int mut_count = mutrun->size();
 					const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 					
@@ -7719,7 +8505,7 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 			
 			for (int run_index = 0; run_index < mutrun_count; ++run_index)
 			{
-				const MutationRun *mutrun = genome.mutruns_[run_index];
+				const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 				int mut_count = mutrun->size();
 				const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 				
@@ -7855,7 +8641,7 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 					
 					for (int run_index = 0; run_index < mutrun_count; ++run_index)
 					{
-						const MutationRun *mutrun = genome.mutruns_[run_index];
+						const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 						int mut_count = mutrun->size();
 						const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 						
@@ -7886,7 +8672,7 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 					
 					for (int run_index = 0; run_index < mutrun_count; ++run_index)
 					{
-						const MutationRun *mutrun = genome.mutruns_[run_index];
+						const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 						int mut_count = mutrun->size();
 						const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 						
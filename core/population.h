@@ -86,6 +86,8 @@ public:
 	Genome *strand2_;
 	std::vector<slim_position_t> break_vec_;
 	IndividualSex sex_;
+	bool mutations_predrawn_ = false;				// if true, the new mutations were drawn serially by ResolveDeferredCallbacks()
+	std::vector<MutationIndex> predrawn_mutations_;	// the predrawn new mutations, sorted by position; may be empty
 	
 	SLiM_DeferredReproduction_Recombinant(SLiM_DeferredReproductionType p_type,
 							  Subpopulation *p_mutorigin_subpop,
@@ -100,6 +102,17 @@ public:
 	};
 };
 
+// This records the mating that produced a given WF child, so that modifyChild() callbacks can be run after the
+// children have been generated (possibly in parallel); see Population::ApplyDeferredModifyChildCallbacks()
+class SLiM_WFMatingRecord {
+public:
+	Subpopulation *source_subpop_;
+	slim_popsize_t parent1_;
+	slim_popsize_t parent2_;
+	bool selfed_;
+	bool cloned_;
+};
+
 
 #ifdef SLIMGUI
 // This struct is used to hold fitness values observed during a run, for display by GraphView_FitnessOverTime
@@ -155,6 +168,10 @@ public:
 	
 	std::vector<SLiM_DeferredReproduction_NonRecombinant> deferred_reproduction_nonrecombinant_;
 	std::vector<SLiM_DeferredReproduction_Recombinant> deferred_reproduction_recombinant_;
+	std::vector<SLiM_WFMatingRecord> wf_mating_records_;	// WF only: the matings for the children being generated, when modifyChild() callbacks are deferred
+	
+	slim_mutationid_t keyed_log_base_id_ = 0;				// the value of gSLiM_next_mutation_id when BeginKeyedMutationLog() was called
+	int keyed_log_registry_size_ = 0;						// the size of mutation_registry_ when BeginKeyedMutationLog() was called
 	
 	std::vector<Substitution*> substitutions_;				// OWNED POINTERS: Substitution objects for all fixed mutations
 	std::unordered_multimap<slim_position_t, Substitution*> treeseq_substitutions_map_;	// TREE SEQUENCE RECORDING; keeps all fixed mutations, hashed by position
@@ -235,10 +252,11 @@ public:
 	void DoHeteroduplexRepair(std::vector<slim_position_t> &p_heteroduplex, std::vector<slim_position_t> &p_breakpoints, Genome *p_parent_genome_1, Genome *p_parent_genome_2, Genome *p_child_genome);
 	
 	// generate a child genome from parental genomes, with predetermined recombination and mutation
-	void DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome &p_child_genome, Genome *p_parent_genome_1, Genome *p_parent_genome_2, IndividualSex p_parent_sex, std::vector<slim_position_t> &p_breakpoints, std::vector<SLiMEidosBlock*> *p_mutation_callbacks);
+	// if p_predrawn_mutations is non-NULL, it supplies the new mutations, which were drawn ahead of time; see ResolveDeferredCallbacks()
+	void DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome &p_child_genome, Genome *p_parent_genome_1, Genome *p_parent_genome_2, IndividualSex p_parent_sex, std::vector<slim_position_t> &p_breakpoints, std::vector<SLiMEidosBlock*> *p_mutation_callbacks, const std::vector<MutationIndex> *p_predrawn_mutations = nullptr);
 	
 	// generate a child genome from a single parental genome, without recombination or gene conversion, but with mutation
-	void DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_child_genome, Genome &p_parent_genome, IndividualSex p_child_sex, std::vector<SLiMEidosBlock*> *p_mutation_callbacks);
+	void DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_child_genome, Genome &p_parent_genome, IndividualSex p_child_sex, std::vector<SLiMEidosBlock*> *p_mutation_callbacks, const std::vector<MutationIndex> *p_predrawn_mutations = nullptr);
 	
 	// An internal method that validates cached fitness values kept by Mutation objects
 	void ValidateMutationFitnessCaches(void);
@@ -265,6 +283,7 @@ public:
 	slim_refcount_t TallyMutationRunReferencesForSubpops(std::vector<Subpopulation*> *p_subpops_to_tally);
 	slim_refcount_t TallyMutationRunReferencesForGenomes(const Genome * const *genomes_ptr, slim_popsize_t genomes_count);
 	void FreeUnusedMutationRuns(void);	// depends upon a previous tally by TallyMutationRunReferencesForPopulation()!
+	void RemapMutationIndices(const std::vector<MutationIndex> &p_remap);	// after SLiM_CompactMutationBlock(); rewrites runs and registries
 	
 	// Tally Mutation usage; these count the total number of times that each Mutation in the registry is referenced
 	// by a population (or a set of subpopulations, or a set of genomes), putting the usage counts into the refcount
@@ -324,6 +343,13 @@ public:
 	// generate children for subpopulation p_subpop_id, drawing from all source populations, handling crossover and mutation
 	void EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice_callbacks_present, bool p_modify_child_callbacks_present, bool p_recombination_callbacks_present, bool p_mutation_callbacks_present, bool p_type_s_dfe_present);
 	
+	// run deferred modifyChild() callbacks for the children generated by EvolveSubpopulation(), regenerating rejected children until all are accepted
+	void ApplyDeferredModifyChildCallbacks(Subpopulation &p_subpop, int p_migrant_source_count, double *p_migration_rates, Subpopulation **p_migration_sources);
+	
+	// bracket a parallel keyed RNG region that creates mutations; the mutations created are then given ids, and registry positions, in a canonical order
+	void BeginKeyedMutationLog(void);
+	void EndKeyedMutationLog(void);
+	
 	// step forward a generation: make the children become the parents
 	void SwapGenerations(void);
 	
@@ -345,6 +371,9 @@ public:
 	void CheckForDeferralInIndividualsVector(Individual **p_individuals, size_t p_elements_size, const std::string &p_caller);
 	
 	void DoDeferredReproduction(void);
+	void ResolveDeferredCallbacks(void);
+	void ResolveDeferredCrossover(Subpopulation *p_source_subpop, Genome *p_child_genome, slim_popsize_t p_parent_index, IndividualSex p_child_sex, IndividualSex p_parent_sex, std::vector<SLiMEidosBlock*> *p_recombination_callbacks, std::vector<SLiMEidosBlock*> *p_mutation_callbacks);
+	void PredrawDeferredMutations(SLiM_DeferredReproduction_Recombinant &p_deferred_rec, int p_num_mutations, std::vector<SLiMEidosBlock*> *p_mutation_callbacks);
 	
 	//********** methods for all models
 	
@@ -1946,8 +1946,21 @@ EidosValue_SP SLiM_ExecuteFunction_treeSeqMetadata(const std::vector<EidosValue_
 	std::string file_path = Eidos_ResolvedPath(Eidos_StripTrailingSlash(filePath_value->StringAtIndex_NOCAST(0, nullptr)));
 	
 	tsk_table_collection_t temp_tables;
+	int ret;
+	
+	if (Eidos_FileIsGzipCompressed(file_path))
+	{
+		// a .trees file compressed by treeSeqOutput(compress=T); tskit reads only uncompressed files, so decompress to a temporary file
+		std::string decompressed_path = Eidos_GunzipFileToTemporaryFile(file_path, ".trees");
+		
+		ret = tsk_table_collection_load(&temp_tables, decompressed_path.c_str(), TSK_LOAD_SKIP_TABLES | TSK_LOAD_SKIP_REFERENCE_SEQUENCE);
+		remove(decompressed_path.c_str());
+	}
+	else
+	{
+		ret = tsk_table_collection_load(&temp_tables, file_path.c_str(), TSK_LOAD_SKIP_TABLES | TSK_LOAD_SKIP_REFERENCE_SEQUENCE);
+	}
 	
-	int ret = tsk_table_collection_load(&temp_tables, file_path.c_str(), TSK_LOAD_SKIP_TABLES | TSK_LOAD_SKIP_REFERENCE_SEQUENCE);
 	if (ret != 0)
 		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_treeSeqMetadata): tree-sequence file at " << file_path << " could not be read; error " << ret << " from tsk_table_collection_load()." << EidosTerminate();
 	
@@ -509,6 +509,7 @@ void SumUpMemoryUsage_Community(SLiMMemoryUsage_Community &p_usage)
 	p_usage.totalMemoryUsage =
 		p_usage.communityObjects +
 		p_usage.mutationRefcountBuffer +
+		p_usage.mutationHotFieldBuffers +
 		p_usage.mutationUnusedPoolSpace +
 		p_usage.interactionTypeObjects +
 		p_usage.interactionTypeKDTrees +
@@ -584,6 +585,7 @@ void AccumulateMemoryUsageIntoTotal_Community(SLiMMemoryUsage_Community &p_usage
 	p_total.communityObjects += p_usage.communityObjects;
 	
 	p_total.mutationRefcountBuffer += p_usage.mutationRefcountBuffer;
+	p_total.mutationHotFieldBuffers += p_usage.mutationHotFieldBuffers;
 	p_total.mutationUnusedPoolSpace += p_usage.mutationUnusedPoolSpace;
 	
 	p_total.interactionTypeObjects_count += p_usage.interactionTypeObjects_count;
@@ -831,6 +833,7 @@ void NucleotideArray::SetNucleotideAtIndex(std::size_t p_index, uint64_t p_nuc)
 	uint64_t nucbits = (uint64_t)p_nuc << shift;
 	
 	chunk = (chunk & ~mask) | nucbits;
+	change_count_++;
 }
 
 EidosValue_SP NucleotideArray::NucleotidesAsIntegerVector(int64_t start, int64_t end)
@@ -1034,6 +1037,7 @@ void NucleotideArray::ReadCompressedNucleotides(char **buffer, char *end)
 	
 	memcpy(buffer_, (*buffer), size_bytes);
 	(*buffer) += size_bytes;
+	change_count_++;
 }
 
 std::ostream& operator<<(std::ostream& p_out, const NucleotideArray &p_nuc_array)
@@ -1344,6 +1348,10 @@ const std::string &gStr_simulationFinished = EidosRegisteredString("simulationFi
 const std::string &gStr_skipTick = EidosRegisteredString("skipTick", gID_skipTick);
 const std::string &gStr_subsetMutations = EidosRegisteredString("subsetMutations", gID_subsetMutations);
 const std::string &gStr_treeSeqCoalesced = EidosRegisteredString("treeSeqCoalesced", gID_treeSeqCoalesced);
+const std::string &gStr_treeSeqDiversity = EidosRegisteredString("treeSeqDiversity", gID_treeSeqDiversity);
+const std::string &gStr_treeSeqDivergence = EidosRegisteredString("treeSeqDivergence", gID_treeSeqDivergence);
+const std::string &gStr_treeSeqFST = EidosRegisteredString("treeSeqFST", gID_treeSeqFST);
+const std::string &gStr_treeSeqSFS = EidosRegisteredString("treeSeqSFS", gID_treeSeqSFS);
 const std::string &gStr_treeSeqSimplify = EidosRegisteredString("treeSeqSimplify", gID_treeSeqSimplify);
 const std::string &gStr_treeSeqRememberIndividuals = EidosRegisteredString("treeSeqRememberIndividuals", gID_treeSeqRememberIndividuals);
 const std::string &gStr_treeSeqOutput = EidosRegisteredString("treeSeqOutput", gID_treeSeqOutput);
@@ -2432,6 +2440,7 @@ void WriteProfileResults(std::string profile_output_path, std::string model_name
 		snprintf(buf, 256, "%0.2f", mem_tot_S.mutationObjects_count / ddiv);
 		fout << "<p><tt>" << ColoredSpanForByteCount(mem_tot_S.mutationObjects / div, average_total) << "</tt> / <tt>" << ColoredSpanForByteCount(mem_last_S.mutationObjects, final_total) << "</tt> : Mutation objects (" << buf << " / " << mem_last_S.mutationObjects_count << ")<BR>\n";
 		fout << "<tt>&nbsp;&nbsp;&nbsp;" << ColoredSpanForByteCount(mem_tot_C.mutationRefcountBuffer / div, average_total) << "</tt> / <tt>" << ColoredSpanForByteCount(mem_last_C.mutationRefcountBuffer, final_total) << "</tt> : refcount buffer<BR>\n";
+		fout << "<tt>&nbsp;&nbsp;&nbsp;" << ColoredSpanForByteCount(mem_tot_C.mutationHotFieldBuffers / div, average_total) << "</tt> / <tt>" << ColoredSpanForByteCount(mem_last_C.mutationHotFieldBuffers, final_total) << "</tt> : hot field buffers<BR>\n";
 		fout << "<tt>&nbsp;&nbsp;&nbsp;" << ColoredSpanForByteCount(mem_tot_C.mutationUnusedPoolSpace / div, average_total) << "</tt> / <tt>" << ColoredSpanForByteCount(mem_last_C.mutationUnusedPoolSpace, final_total) << "</tt> : unused pool space</p>\n\n";
 		
 		// MutationRun
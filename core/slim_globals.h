@@ -440,6 +440,7 @@ typedef struct
 	size_t communityObjects;
 	
 	size_t mutationRefcountBuffer;			// this pool is kept globally by Mutation
+	size_t mutationHotFieldBuffers;			// these pools are kept globally by Mutation
 	size_t mutationUnusedPoolSpace;			// this pool is kept globally by Mutation
 	
 	int64_t interactionTypeObjects_count;	// InteractionType is kept by Community now
@@ -646,6 +647,9 @@ private:
 	// The least-significant bits of each uint64_t are filled first.  Each uint64_t holds 32 nucleotides.
 	uint64_t *buffer_;
 	
+	// The number of modifications made to the array, so that clients caching information derived from it can detect changes
+	uint64_t change_count_ = 0;
+	
 public:
 	NucleotideArray(const NucleotideArray&) = delete;				// no copying
 	NucleotideArray& operator=(const NucleotideArray&) = delete;	// no copying
@@ -667,6 +671,7 @@ public:
 	NucleotideArray(std::size_t p_length, const std::string p_string_vector[]);
 	
 	std::size_t size() const { return length_; }
+	uint64_t ChangeCount() const { return change_count_; }
 	
 	inline int NucleotideAtIndex(std::size_t p_index) const {
 		uint64_t chunk = buffer_[p_index / 32];
@@ -938,6 +943,10 @@ extern const std::string &gStr_simulationFinished;
 extern const std::string &gStr_skipTick;
 extern const std::string &gStr_subsetMutations;
 extern const std::string &gStr_treeSeqCoalesced;
+extern const std::string &gStr_treeSeqDiversity;
+extern const std::string &gStr_treeSeqDivergence;
+extern const std::string &gStr_treeSeqFST;
+extern const std::string &gStr_treeSeqSFS;
 extern const std::string &gStr_treeSeqSimplify;
 extern const std::string &gStr_treeSeqRememberIndividuals;
 extern const std::string &gStr_treeSeqOutput;
@@ -1358,6 +1367,10 @@ enum _SLiMGlobalStringID : int {
 	gID_skipTick,
 	gID_subsetMutations,
 	gID_treeSeqCoalesced,
+	gID_treeSeqDiversity,
+	gID_treeSeqDivergence,
+	gID_treeSeqFST,
+	gID_treeSeqSFS,
 	gID_treeSeqSimplify,
 	gID_treeSeqRememberIndividuals,
 	gID_treeSeqOutput,
@@ -35,6 +35,9 @@
 #include <map>
 #include <utility>
 #include <ctime>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
 
 
 // Keeping records of test success / failure
@@ -298,6 +301,432 @@ void SLiMAssertScriptStop(const std::string &p_script_string, int p_lineNumber)
 	gEidos_DictionaryNonRetainReleaseReferenceCounter = 0;
 }
 
+// Sorts a table collection with the given node times and edges (parent, child, left, right) using SLiM's edge sorter, with
+// the first p_start edges taken to be the sorted output of a previous simplification, and prints an error if the result is
+// not in the order tskit requires, or does not contain the same edges as the table collection sorted by tskit's own sorter
+void SLiMAssertEdgeSort(const std::vector<double> &p_node_times, const std::vector<std::vector<double>> &p_edges, std::size_t p_start, int p_lineNumber)
+{
+	gSLiMTestFailureCount++;	// assume failure; we will fix this at the end if we succeed
+	
+	tsk_table_collection_t tables, expected;
+	std::string failure;
+	int ret;
+	
+	tsk_table_collection_init(&tables, 0);
+	tables.sequence_length = 100;
+	
+	for (double node_time : p_node_times)
+		tsk_node_table_add_row(&tables.nodes, 0, node_time, TSK_NULL, TSK_NULL, NULL, 0);
+	for (const std::vector<double> &edge : p_edges)
+		tsk_edge_table_add_row(&tables.edges, edge[2], edge[3], (tsk_id_t)edge[0], (tsk_id_t)edge[1], NULL, 0);
+	
+	tsk_table_collection_copy(&tables, &expected, 0);
+	ret = tsk_table_collection_sort(&expected, NULL, 0);
+	
+	if (ret < 0)
+		failure = std::string("tsk_table_collection_sort() failed: ") + tsk_strerror(ret);
+	
+	if (failure.length() == 0)
+	{
+		tsk_table_sorter_t sorter;
+		tsk_bookmark_t start;
+		
+		memset(&start, 0, sizeof(tsk_bookmark_t));
+		start.edges = (tsk_size_t)p_start;
+		
+		ret = tsk_table_sorter_init(&sorter, &tables, 0);
+		
+		if (ret == 0)
+		{
+			sorter.sort_edges = slim_sort_edges;
+			
+			try {
+				ret = tsk_table_sorter_run(&sorter, &start);
+			} catch (std::exception &e) {
+				failure = std::string("slim_sort_edges() raised: ") + e.what();
+			}
+		}
+		
+		tsk_table_sorter_free(&sorter);
+		
+		if ((failure.length() == 0) && (ret < 0))
+			failure = std::string("tsk_table_sorter_run() failed: ") + tsk_strerror(ret);
+	}
+	
+	if (failure.length() == 0)
+	{
+		ret = (int)tsk_table_collection_check_integrity(&tables, TSK_CHECK_EDGE_ORDERING);
+		
+		if (ret < 0)
+			failure = std::string("edges not in the required order: ") + tsk_strerror(ret);
+	}
+	
+	if (failure.length() == 0)
+	{
+		// the order within one parent time can differ from tskit's, so compare the edges as sets
+		std::vector<std::vector<double>> sorted_edges, expected_edges;
+		
+		for (tsk_size_t i = 0; i < tables.edges.num_rows; ++i)
+			sorted_edges.emplace_back(std::vector<double>{(double)tables.edges.parent[i], (double)tables.edges.child[i], tables.edges.left[i], tables.edges.right[i]});
+		for (tsk_size_t i = 0; i < expected.edges.num_rows; ++i)
+			expected_edges.emplace_back(std::vector<double>{(double)expected.edges.parent[i], (double)expected.edges.child[i], expected.edges.left[i], expected.edges.right[i]});
+		
+		std::sort(sorted_edges.begin(), sorted_edges.end());
+		std::sort(expected_edges.begin(), expected_edges.end());
+		
+		if (sorted_edges != expected_edges)
+			failure = "sorted edges differ from the edges sorted by tskit";
+	}
+	
+	tsk_table_collection_free(&tables);
+	tsk_table_collection_free(&expected);
+	
+	if (failure.length())
+	{
+		if (p_lineNumber != -1)
+			std::cerr << "[" << p_lineNumber << "] ";
+		
+		std::cerr << "edge sort with " << p_edges.size() << " edges, start " << p_start << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : " << failure << std::endl;
+	}
+	else
+	{
+		gSLiMTestFailureCount--;	// correct for our assumption of failure above
+		gSLiMTestSuccessCount++;
+	}
+}
+
+// Sorts a table collection with the given mutations (position, time, parent), in which a negative time denotes an unknown
+// time, using SLiM's mutation sorter, and prints an error if the mutations do not end up sorted by position, then by
+// decreasing time at sites whose times are all known, and otherwise by their original order, with parents remapped; where
+// tskit's order is defined (i.e., no site has both known and unknown times), it also must match tskit's own sorter
+void SLiMAssertMutationSort(const std::vector<std::vector<double>> &p_mutations, int p_lineNumber)
+{
+	gSLiMTestFailureCount++;	// assume failure; we will fix this at the end if we succeed
+	
+	tsk_table_collection_t tables, expected;
+	std::vector<double> positions;
+	std::vector<std::size_t> expected_order;
+	bool any_mixed_site = false;
+	std::string failure;
+	int ret;
+	
+	for (const std::vector<double> &mutation : p_mutations)
+		positions.emplace_back(mutation[0]);
+	
+	std::sort(positions.begin(), positions.end());
+	positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+	
+	// the mutations are expected in position order; within a site, by decreasing time if all times are known, else by id
+	for (double position : positions)
+	{
+		std::vector<std::size_t> site_mutations;
+		bool any_known = false, any_unknown = false;
+		
+		for (std::size_t i = 0; i < p_mutations.size(); ++i)
+			if (p_mutations[i][0] == position)
+			{
+				site_mutations.emplace_back(i);
+				
+				if (p_mutations[i][1] < 0)
+					any_unknown = true;
+				else
+					any_known = true;
+			}
+		
+		if (any_known && any_unknown)
+			any_mixed_site = true;
+		else if (any_known)
+			std::stable_sort(site_mutations.begin(), site_mutations.end(), [&p_mutations](std::size_t lhs, std::size_t rhs) { return p_mutations[lhs][1] > p_mutations[rhs][1]; });
+		
+		expected_order.insert(expected_order.end(), site_mutations.begin(), site_mutations.end());
+	}
+	
+	// the sites are added in reverse order, so that they need sorting too; each mutation's derived state is its original id
+	tsk_table_collection_init(&tables, 0);
+	tables.sequence_length = 100;
+	tsk_node_table_add_row(&tables.nodes, TSK_NODE_IS_SAMPLE, 0.0, TSK_NULL, TSK_NULL, NULL, 0);
+	
+	for (auto position_iter = positions.rbegin(); position_iter != positions.rend(); ++position_iter)
+		tsk_site_table_add_row(&tables.sites, *position_iter, NULL, 0, NULL, 0);
+	
+	for (std::size_t i = 0; i < p_mutations.size(); ++i)
+	{
+		const std::vector<double> &mutation = p_mutations[i];
+		tsk_id_t site = (tsk_id_t)(positions.end() - std::lower_bound(positions.begin(), positions.end(), mutation[0]) - 1);
+		std::string derived_state = std::to_string(i);
+		
+		tsk_mutation_table_add_row(&tables.mutations, site, 0, (tsk_id_t)mutation[2], (mutation[1] < 0) ? TSK_UNKNOWN_TIME : mutation[1], derived_state.c_str(), (tsk_size_t)derived_state.length(), NULL, 0);
+	}
+	
+	tsk_table_collection_copy(&tables, &expected, 0);
+	
+	if (!any_mixed_site)
+	{
+		ret = tsk_table_collection_sort(&expected, NULL, 0);
+		
+		if (ret < 0)
+			failure = std::string("tsk_table_collection_sort() failed: ") + tsk_strerror(ret);
+	}
+	
+	if (failure.length() == 0)
+	{
+		tsk_table_sorter_t sorter;
+		
+		ret = tsk_table_sorter_init(&sorter, &tables, 0);
+		
+		if (ret == 0)
+		{
+			sorter.sort_mutations = slim_sort_mutations;
+			ret = tsk_table_sorter_run(&sorter, NULL);
+		}
+		
+		tsk_table_sorter_free(&sorter);
+		
+		if (ret < 0)
+			failure = std::string("tsk_table_sorter_run() failed: ") + tsk_strerror(ret);
+	}
+	
+	if (failure.length() == 0)
+	{
+		// check each row against the expected order, reading the original id of each row and its parent from derived states
+		tsk_mutation_table_t &mutations = tables.mutations;
+		auto original_id = [&mutations](tsk_id_t row) {
+			return (std::size_t)std::stoul(std::string(mutations.derived_state + mutations.derived_state_offset[row], mutations.derived_state_offset[row + 1] - mutations.derived_state_offset[row]));
+		};
+		
+		for (std::size_t j = 0; (j < expected_order.size()) && (failure.length() == 0); ++j)
+		{
+			std::size_t id = original_id((tsk_id_t)j);
+			tsk_id_t parent = mutations.parent[j];
+			
+			if (id != expected_order[j])
+				failure = "mutation " + std::to_string(id) + " sorted to row " + std::to_string(j) + ", expected mutation " + std::to_string(expected_order[j]);
+			else if (tables.sites.position[mutations.site[j]] != p_mutations[id][0])
+				failure = "mutation " + std::to_string(id) + " has the wrong site";
+			else if ((parent == TSK_NULL) ? (p_mutations[id][2] != -1) : (original_id(parent) != (std::size_t)p_mutations[id][2]))
+				failure = "mutation " + std::to_string(id) + " has the wrong parent";
+		}
+	}
+	
+	if ((failure.length() == 0) && !any_mixed_site)
+	{
+		if (!tsk_mutation_table_equals(&tables.mutations, &expected.mutations, 0))
+			failure = "sorted mutations differ from the mutations sorted by tskit";
+	}
+	
+	tsk_table_collection_free(&tables);
+	tsk_table_collection_free(&expected);
+	
+	if (failure.length())
+	{
+		if (p_lineNumber != -1)
+			std::cerr << "[" << p_lineNumber << "] ";
+		
+		std::cerr << "mutation sort with " << p_mutations.size() << " mutations : " << EIDOS_OUTPUT_FAILURE_TAG << " : " << failure << std::endl;
+	}
+	else
+	{
+		gSLiMTestFailureCount--;	// correct for our assumption of failure above
+		gSLiMTestSuccessCount++;
+	}
+}
+
+// Instantiates and runs the script with the -mutrunCache option, and prints an error if the mutation run count at the end of
+// initialization is not the base count times p_expected_multiplier (i.e., if the cache file was not applied, or not ignored),
+// or if the run did not leave an entry for the model in the cache file
+void SLiMAssertMutationRunCacheCount(const std::string &p_script_string, const std::string &p_cache_path, int p_expected_multiplier, int p_lineNumber)
+{
+	{
+	gSLiMTestFailureCount++;	// assume failure; we will fix this at the end if we succeed
+	
+	Community *community = nullptr;
+	std::istringstream infile(p_script_string);
+	int32_t mutrun_count = 0, expected_count = 0;
+	std::string cache_key;
+	
+	try {
+		community = new Community();
+		community->InitializeFromFile(infile);
+		community->InitializeRNGFromSeed(nullptr);
+		community->FinishInitialization();
+		community->AllSpecies_MutrunCache_Enable(p_cache_path, std::vector<std::string>());
+		
+		// the first tick runs initialize() callbacks, at the end of which the cache is read
+		community->_RunOneTick();
+		
+		Chromosome &chromosome = community->AllSpecies()[0]->TheChromosome();
+		
+		mutrun_count = chromosome.mutrun_count_;
+		expected_count = chromosome.mutrun_count_base_ * p_expected_multiplier;
+		
+		// run to the end, which writes the cache file
+		while (community->_RunOneTick());
+		
+		cache_key = community->AllSpecies()[0]->MutationRunCacheKey();
+	}
+	catch (...)
+	{
+		if (community)
+			for (Species *species : community->AllSpecies())
+				species->DeleteAllMutationRuns();
+		
+		delete community;
+		InteractionType::DeleteSparseVectorFreeList();
+		
+		if (p_lineNumber != -1)
+			std::cerr << "[" << p_lineNumber << "] ";
+		
+		std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : raise during mutation run cache test: " << Eidos_GetTrimmedRaiseMessage() << std::endl;
+		
+		gEidosErrorContext.currentScript = nullptr;
+		gEidosErrorContext.executingRuntimeScript = false;
+		return;
+	}
+	
+	if (community)
+		for (Species *species : community->AllSpecies())
+			species->DeleteAllMutationRuns();
+	
+	delete community;
+	InteractionType::DeleteSparseVectorFreeList();
+	
+	gEidosErrorContext.currentScript = nullptr;
+	gEidosErrorContext.executingRuntimeScript = false;
+	
+	// every run should leave an entry for its model in the cache file
+	bool cache_written = false;
+	
+	{
+		std::ifstream cache_file(p_cache_path);
+		std::string line;
+		
+		while (std::getline(cache_file, line))
+			if (line.compare(0, cache_key.length() + 1, cache_key + " ") == 0)
+				cache_written = true;
+	}
+	
+	if (mutrun_count != expected_count)
+	{
+		if (p_lineNumber != -1)
+			std::cerr << "[" << p_lineNumber << "] ";
+		
+		std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : mutation run count " << mutrun_count << " after initialization, expected " << expected_count << std::endl;
+	}
+	else if (!cache_written)
+	{
+		if (p_lineNumber != -1)
+			std::cerr << "[" << p_lineNumber << "] ";
+		
+		std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : no entry written to the mutation run cache file " << p_cache_path << std::endl;
+	}
+	else
+	{
+		gSLiMTestFailureCount--;	// correct for our assumption of failure above
+		gSLiMTestSuccessCount++;
+	}
+	
+	if (gEidos_DictionaryNonRetainReleaseReferenceCounter > 0)
+		std::cerr << "WARNING (SLiMAssertMutationRunCacheCount): gEidos_DictionaryNonRetainReleaseReferenceCounter == " << gEidos_DictionaryNonRetainReleaseReferenceCounter << " at end of test!" << std::endl;
+	}
+	
+	gEidos_DictionaryNonRetainReleaseReferenceCounter = 0;
+}
+
+
+// Runs the script single-threaded and then with the maximum number of threads, and checks that both runs leave the same string in
+// the global variable RESULT; the script should set its own seed, and turn on parallelSetDeterministic(), in initialize()
+void SLiMAssertScriptSameAcrossThreadCounts(const std::string &p_script_string, int p_lineNumber)
+{
+	{
+	gSLiMTestFailureCount++;	// assume failure; we will fix this at the end if we succeed
+	
+	int saved_num_threads = gEidosNumThreads;
+	bool saved_num_threads_override = gEidosNumThreadsOverride;
+	int thread_counts[2] = {1, gEidosMaxThreads};
+	std::string results[2];
+	
+	for (int run_index = 0; run_index < 2; ++run_index)
+	{
+		Community *community = nullptr;
+		std::istringstream infile(p_script_string);
+		
+		gEidosNumThreads = thread_counts[run_index];
+		gEidosNumThreadsOverride = true;
+		omp_set_num_threads(thread_counts[run_index]);
+		
+		// ids are handed out from process-wide counters, so both runs need to start them from the same place
+		gSLiM_next_mutation_id = 0;
+		gSLiM_next_pedigree_id = 0;
+		
+		try {
+			community = new Community();
+			community->InitializeFromFile(infile);
+			community->InitializeRNGFromSeed(nullptr);
+			community->FinishInitialization();
+			
+			while (community->_RunOneTick());
+			
+			EidosValue_SP result = community->SymbolTable().GetValueOrRaiseForSymbol(EidosStringRegistry::GlobalStringIDForString("RESULT"));
+			
+			results[run_index] = result->StringAtIndex_NOCAST(0, nullptr);
+		}
+		catch (...)
+		{
+			if (community)
+				for (Species *species : community->AllSpecies())
+					species->DeleteAllMutationRuns();
+			
+			delete community;
+			InteractionType::DeleteSparseVectorFreeList();
+			
+			gEidosNumThreads = saved_num_threads;
+			gEidosNumThreadsOverride = saved_num_threads_override;
+			omp_set_num_threads(saved_num_threads);
+			
+			if (p_lineNumber != -1)
+				std::cerr << "[" << p_lineNumber << "] ";
+			
+			std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : raise with " << thread_counts[run_index] << " thread(s): " << Eidos_GetTrimmedRaiseMessage() << std::endl;
+			
+			gEidosErrorContext.currentScript = nullptr;
+			gEidosErrorContext.executingRuntimeScript = false;
+			return;
+		}
+		
+		if (community)
+			for (Species *species : community->AllSpecies())
+				species->DeleteAllMutationRuns();
+		
+		delete community;
+		InteractionType::DeleteSparseVectorFreeList();
+		
+		gEidosErrorContext.currentScript = nullptr;
+		gEidosErrorContext.executingRuntimeScript = false;
+	}
+	
+	gEidosNumThreads = saved_num_threads;
+	gEidosNumThreadsOverride = saved_num_threads_override;
+	omp_set_num_threads(saved_num_threads);
+	
+	if (results[0] != results[1])
+	{
+		if (p_lineNumber != -1)
+			std::cerr << "[" << p_lineNumber << "] ";
+		
+		std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : results differ between 1 thread and " << thread_counts[1] << " thread(s)" << std::endl;
+	}
+	else
+	{
+		gSLiMTestFailureCount--;	// correct for our assumption of failure above
+		gSLiMTestSuccessCount++;
+	}
+	
+	if (gEidos_DictionaryNonRetainReleaseReferenceCounter > 0)
+		std::cerr << "WARNING (SLiMAssertScriptSameAcrossThreadCounts): gEidos_DictionaryNonRetainReleaseReferenceCounter == " << gEidos_DictionaryNonRetainReleaseReferenceCounter << " at end of test!" << std::endl;
+	}
+	
+	gEidos_DictionaryNonRetainReleaseReferenceCounter = 0;
+}
 
 // Test subfunction prototypes
 static void _RunBasicTests(void);
@@ -22,6 +22,7 @@
 
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 
 int RunSLiMTests(void);
@@ -31,6 +32,10 @@ int RunSLiMTests(void);
 extern void SLiMAssertScriptSuccess(const std::string &p_script_string, int p_lineNumber = -1);
 extern void SLiMAssertScriptRaise(const std::string &p_script_string, const std::string &p_reason_snip, int p_lineNumber, bool p_expect_error_position = true);
 extern void SLiMAssertScriptStop(const std::string &p_script_string, int p_lineNumber = -1);
+extern void SLiMAssertEdgeSort(const std::vector<double> &p_node_times, const std::vector<std::vector<double>> &p_edges, std::size_t p_start, int p_lineNumber = -1);
+extern void SLiMAssertMutationSort(const std::vector<std::vector<double>> &p_mutations, int p_lineNumber = -1);
+extern void SLiMAssertMutationRunCacheCount(const std::string &p_script_string, const std::string &p_cache_path, int p_expected_multiplier, int p_lineNumber = -1);
+extern void SLiMAssertScriptSameAcrossThreadCounts(const std::string &p_script_string, int p_lineNumber = -1);
 
 
 // Conceptually, all the slim_test_X.cpp stuff is a single source file, and all the details below are private.
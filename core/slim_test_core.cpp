@@ -23,6 +23,9 @@
 #include "eidos_globals.h"
 
 #include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
 
 
 #pragma mark initialize() tests
@@ -235,10 +238,13 @@ void _RunInitTests(void)
 	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(mutationRuns=100); stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(preventIncidentalSelfing=F); stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(preventIncidentalSelfing=T); stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(deferModifyChild=F); stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(deferModifyChild=T); stop(); }", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(keepPedigrees=NULL); stop(); }", "cannot be type NULL", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(dimensionality=NULL); stop(); }", "cannot be type NULL", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(mutationRuns=NULL); stop(); }", "cannot be type NULL", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(preventIncidentalSelfing=NULL); stop(); }", "cannot be type NULL", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(deferModifyChild=NULL); stop(); }", "cannot be type NULL", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(dimensionality='foo'); stop(); }", "legal non-empty values", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(dimensionality='y'); stop(); }", "legal non-empty values", __LINE__);
 	SLiMAssertScriptRaise("initialize() { initializeSLiMOptions(dimensionality='z'); stop(); }", "legal non-empty values", __LINE__);
@@ -356,6 +362,15 @@ void _RunCommunityTests(void)
 	SLiMAssertScriptRaise(gen1_setup_p1 + "2 early() { community.subpopulationsWithIDs(2); } ", "did not find", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1 + "2 early() { community.subpopulationsWithIDs(c(2,3)); } ", "did not find", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "2 early() { if (identical(community.subpopulationsWithIDs(c(1,1)), c(p1,p1))) stop(); } ", __LINE__);
+	
+	// deterministic parallel mode; it should not leak from one model into the next
+	SLiMAssertScriptStop(gen1_setup_highmut_p1 + "1 late() { parallelSetDeterministic(T); p1.setCloningRate(0.2); } 20 late() { m = sim.mutations; if (parallelGetDeterministic() & (size(unique(m.id)) == size(m))) stop(); } ", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { if (!parallelGetDeterministic()) stop(); } ", __LINE__);
+	
+	// in deterministic mode, a given seed must give the same result with one thread as with many
+	std::string deterministic_result(" 20 late() { m = sim.mutations; defineGlobal('RESULT', paste(c(m.id, m.position, m.selectionCoeff, sapply(p1.genomes, 'paste(applyValue.mutations.id, sep=\",\");'), p1.individuals.pedigreeID), sep=' ')); } ");
+	SLiMAssertScriptSameAcrossThreadCounts("initialize() { setSeed(7); parallelSetDeterministic(T); initializeSLiMOptions(keepPedigrees=T); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'n', 0.0, 0.01); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 999999); initializeRecombinationRate(1e-8); } 1 early() { sim.addSubpop('p1', 2000); p1.setCloningRate(0.1); p1.setSelfingRate(0.1); } " + deterministic_result, __LINE__);
+	SLiMAssertScriptSameAcrossThreadCounts("initialize() { setSeed(7); parallelSetDeterministic(T); initializeSLiMModelType('nonWF'); initializeSLiMOptions(keepPedigrees=T); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'n', 0.0, 0.01); m1.convertToSubstitution = T; initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 999999); initializeRecombinationRate(1e-8); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1), defer=T); } 1 early() { sim.addSubpop('p1', 2000); } early() { p1.fitnessScaling = 2000 / p1.individualCount; } " + deterministic_result, __LINE__);
 }
 
 #pragma mark Species tests
@@ -825,6 +840,52 @@ void _RunSpeciesTests(const std::string &temp_path)
 	}
 	)V0G0N", __LINE__);
 	
+	// Test the -mutrunCache option: a cache file is written at the end of a run, and its count is applied to the next run
+	// of the same model; entries for other models, and entries with counts the experiments could not reach, are ignored
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		std::string cache_script = gen1_setup_p1 + "20 late() { }";
+		std::string cache_path = temp_path + "/slimMutrunCacheTest.txt";
+		std::string cache_key;
+		
+		std::remove(cache_path.c_str());
+		SLiMAssertMutationRunCacheCount(cache_script, cache_path, 1, __LINE__);			// no cache file yet; written at the end
+		
+		{
+			std::ifstream cache_file(cache_path);
+			std::string line;
+			
+			if (std::getline(cache_file, line))
+				std::istringstream(line) >> cache_key;
+		}
+		
+		// the key ends with the base mutation run count, which cached counts must be a power-of-two multiple of
+		if (cache_key.length())
+		{
+			int base = std::stoi(cache_key.substr(cache_key.rfind(':') + 1));
+			
+			std::ofstream(cache_path, std::ios_base::trunc) << cache_key << " " << base * 4 << " 1.0 0.0" << std::endl;
+			SLiMAssertMutationRunCacheCount(cache_script, cache_path, 4, __LINE__);		// the cached count is applied
+			
+			std::ofstream(cache_path, std::ios_base::trunc) << "x" << cache_key << " " << base * 4 << " 1.0 0.0" << std::endl;
+			SLiMAssertMutationRunCacheCount(cache_script, cache_path, 1, __LINE__);		// mismatched key
+			
+			std::ofstream(cache_path, std::ios_base::trunc) << cache_key << " garbage" << std::endl;
+			SLiMAssertMutationRunCacheCount(cache_script, cache_path, 1, __LINE__);		// corrupt entry
+			
+			std::ofstream(cache_path, std::ios_base::trunc) << cache_key << " " << base * 3 << " 1.0 0.0" << std::endl;
+			SLiMAssertMutationRunCacheCount(cache_script, cache_path, 1, __LINE__);		// not base x a power of two
+			
+			std::ofstream(cache_path, std::ios_base::trunc) << cache_key << " " << base * 4096 << " 1.0 0.0" << std::endl;
+			SLiMAssertMutationRunCacheCount(cache_script, cache_path, 1, __LINE__);		// above SLIM_MUTRUN_MAXIMUM_COUNT
+			
+			std::ofstream(cache_path, std::ios_base::trunc) << "\x01\xFF not a cache file" << std::endl;
+			SLiMAssertMutationRunCacheCount(cache_script, cache_path, 1, __LINE__);		// not a cache file at all
+		}
+		
+		std::remove(cache_path.c_str());
+	}
+	
 	// Test sim EidosDictionaryUnretained functionality: - (+)getValue(is$ key) and - (void)setValue(is$ key, + value)
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { sim.setValue('foo', 7:9); sim.setValue('bar', 'baz'); } 10 early() { if (identical(sim.getValue('foo'), 7:9) & identical(sim.getValue('bar'), 'baz')) stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { sim.setValue('foo', 3:5); sim.setValue('foo', 'foobar'); } 10 early() { if (identical(sim.getValue('foo'), 'foobar')) stop(); }", __LINE__);
@@ -2187,6 +2248,16 @@ void _RunSLiMEidosBlockTests(void)
 	
 	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "modifyChild(p1) { child; parent1; isCloning; isSelfing; parent2; subpop; sourceSubpop; return T; } 10 early() { stop(); }", __LINE__);
 	
+	// modifyChild() rejections; rejected children must be regenerated with new matings, both with the callbacks run during generation and with them deferred
+	SLiMAssertScriptStop(gen1_setup_p1 + "modifyChild(p1) { child.tag = parent1.index; return (parent1.index % 2 == 0); } 10 early() { if (all(p1.individuals.tag % 2 == 0)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(pedigrees_prefix + gen1_setup_p1 + "1 early() { p1.setCloningRate(0.3); p1.setSelfingRate(0.3); } modifyChild(p1) { if (parent1.index % 2) return F; child.tag = parent1.pedigreeID; return T; } 10 early() { if (all(p1.individuals.tag == p1.individuals.pedigreeParentIDs[seq(0, 18, by=2)])) stop(); }", __LINE__);
+	SLiMAssertScriptStop(pedigrees_prefix + gen1_setup_sex_p1 + "1 early() { p1.setCloningRate(0.3); } modifyChild(p1) { if (parent1.index % 2) return F; child.tag = parent1.pedigreeID; return T; } 10 early() { if (all(p1.individuals.tag == p1.individuals.pedigreeParentIDs[seq(0, 18, by=2)]) & (sum(p1.individuals.sex == 'M') == 5)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "1 early() { p1.setMigrationRates(p2, 0.5); } modifyChild(p2) { return (subpop == p2); } 10 early() { if (!any(p1.individuals.migrant) & all(p2.individuals.migrant == F)) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(deferModifyChild=T); } " + gen1_setup_p1 + "modifyChild(p1) { child.tag = parent1.index; return (parent1.index % 2 == 0); } 10 early() { if (all(p1.individuals.tag % 2 == 0)) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(keepPedigrees=T, deferModifyChild=T); } " + gen1_setup_p1 + "1 early() { p1.setCloningRate(0.3); p1.setSelfingRate(0.3); } modifyChild(p1) { if (parent1.index % 2) return F; child.tag = parent1.pedigreeID; return T; } 10 early() { if (all(p1.individuals.tag == p1.individuals.pedigreeParentIDs[seq(0, 18, by=2)])) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(keepPedigrees=T, deferModifyChild=T); } " + gen1_setup_sex_p1 + "1 early() { p1.setCloningRate(0.3); } modifyChild(p1) { if (parent1.index % 2) return F; child.tag = parent1.pedigreeID; return T; } 10 early() { if (all(p1.individuals.tag == p1.individuals.pedigreeParentIDs[seq(0, 18, by=2)]) & (sum(p1.individuals.sex == 'M') == 5)) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(deferModifyChild=T); } " + gen1_setup_p1p2p3 + "1 early() { p1.setMigrationRates(p2, 0.5); } modifyChild(p2) { return (subpop == p2); } 10 early() { if (!any(p1.individuals.migrant) & all(p2.individuals.migrant == F)) stop(); }", __LINE__);
+	
 	// recombination() callbacks
 	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "recombination() { return F; } 10 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1p2p3 + "recombination() { return T; } 10 early() { stop(); }", __LINE__);
@@ -77,6 +77,7 @@ void _RunMutationTypeTests(void)
 	SLiMAssertScriptStop(gen1_setup + "1 early() { m1.setDistribution('p', 3.1, 7.5); if (m1.distributionType == 'p' & identical(m1.distributionParams, c(3.1, 7.5))) stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup + "1 early() { m1.setDistribution('w', 3.1, 7.5); if (m1.distributionType == 'w' & identical(m1.distributionParams, c(3.1, 7.5))) stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup + "1 early() { m1.setDistribution('s', 'return 1;'); if (m1.distributionType == 's' & identical(m1.distributionParams, 'return 1;')) stop(); }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup + "1 early() { m1.setDistribution('s', \"m1.setDistribution('f', 0.0); 0.1;\"); m1.drawSelectionCoefficient(1); stop(); }", "from within its own type 's' DFE script", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup + "1 early() { m1.setDistribution('x', 1.5); stop(); }", "must be 'f', 'g', 'e', 'n', 'w', or 's'", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup + "1 early() { m1.setDistribution('f', 'foo'); stop(); }", "must be of type numeric", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup + "1 early() { m1.setDistribution('g', 'foo', 7.5); stop(); }", "must be of type numeric", __LINE__);
@@ -142,6 +143,14 @@ void _RunMutationTypeTests(void)
 	SLiMAssertScriptStop(gen1_setup + "1 early() { m1.setDistribution('w', 3.1, 7.5); if (abs(mean(m1.drawSelectionCoefficient(2000)) - 2.910106) < 0.1) stop(); }", __LINE__);
 	SLiMAssertScriptSuccess(gen1_setup + "1 early() { m1.setDistribution('s', 'rbinom(1, 4, 0.5);'); m1.drawSelectionCoefficient(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup + "1 early() { m1.setDistribution('s', 'rbinom(1, 4, 0.5);'); if (abs(mean(m1.drawSelectionCoefficient(5000)) - 2.0) < 0.1) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup + "1 early() { m1.setDistribution('n', 3.1, 0.5); setSeed(3); x = m1.drawSelectionCoefficient(500); setSeed(3); y = sapply(1:500, 'm1.drawSelectionCoefficient();'); if (identical(x, y)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup + "1 early() { m1.setDistribution('e', -3.0); setSeed(3); x = m1.drawSelectionCoefficient(500); setSeed(3); y = sapply(1:500, 'm1.drawSelectionCoefficient();'); if (identical(x, y)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup + "1 early() { m1.setDistribution('s', 'c(1.0, 2, 3);'); x = m1.drawSelectionCoefficient(7); y = m1.drawSelectionCoefficient(2); if (identical(c(x, y), c(1.0, 2, 3, 1, 2, 3, 1, 2, 3))) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup + "1 early() { m1.setDistribution('s', 'c(1, 2);'); x = m1.drawSelectionCoefficient(); m1.setDistribution('s', '5.0;'); y = m1.drawSelectionCoefficient(); if (identical(c(x, y), c(1.0, 5.0))) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup + "1 early() { m1.setDistribution('s', 'c(1, 2, 3);'); defineGlobal('X', m1.drawSelectionCoefficient()); } 2 early() { y = m1.drawSelectionCoefficient(); if (identical(c(X, y), c(1.0, 1.0))) stop(); }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup + "1 early() { m1.setDistribution('s', 'float(0);'); m1.drawSelectionCoefficient(); }", "of length one or more", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup + "1 early() { m1.setDistribution('s', 'c(T, F);'); m1.drawSelectionCoefficient(); }", "of length one or more", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_highmut_p1 + "1 early() { m1.setDistribution('s', 'rep(c(0.5, 0.25), 50);'); } 20 late() { s = unique(sim.mutations.selectionCoeff); if (size(s) == 2 & all(match(s, c(0.5, 0.25)) >= 0)) stop(); }", __LINE__);
 }
 
 #pragma mark GenomicElementType tests
@@ -618,6 +627,20 @@ void _RunChromosomeTests(void)
 	SLiMAssertScriptStop(gen1_setup + "1 early() { sim.chromosome.setGeneConversion(0.2, 1234.5, 0.75); if (sim.chromosome.geneConversionMeanLength == 1234.5) stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup + "1 early() { sim.chromosome.setGeneConversion(0.2, 1234.5, 0.75); if (sim.chromosome.geneConversionSimpleConversionFraction == 0.75) stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup + "1 early() { sim.chromosome.setGeneConversion(0.2, 1234.5, 0.75); if (sim.chromosome.geneConversionGCBias == 0.0) stop(); }", __LINE__);
+	
+	// rate maps with many intervals are drawn from with a cumulative-rate index instead of an alias table; test that draws land only in intervals with a nonzero rate
+	std::string large_map_setup("initialize() { initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 199999); ends = (1:20000) * 10 - 1; ");
+	
+	SLiMAssertScriptStop(large_map_setup + "initializeMutationRate(0.0); rates = rep(0.0, 20000); rates[12345] = 0.5; initializeRecombinationRate(rates, ends); } 1 early() { sim.addSubpop('p1', 100); defineGlobal('COUNT', 0); defineGlobal('BAD', 0); } recombination() { COUNT = COUNT + size(breakpoints); BAD = BAD + sum((breakpoints < 123450) | (breakpoints > 123459)); defineGlobal('COUNT', COUNT); defineGlobal('BAD', BAD); return F; } 5 late() { if ((COUNT > 0) & (BAD == 0)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(large_map_setup + "initializeRecombinationRate(1e-8); rates = rep(0.0, 20000); rates[777] = 0.1; initializeMutationRate(rates, ends); } 1 early() { sim.addSubpop('p1', 100); } 5 late() { pos = sim.mutations.position; if ((size(pos) > 0) & all((pos >= 7770) & (pos <= 7779))) stop(); }", __LINE__);
+	SLiMAssertScriptStop(large_map_setup + "initializeRecombinationRate(1e-8); initializeMutationRate(0.0); } 1 early() { sim.addSubpop('p1', 100); rates = rep(0.0, 20000); rates[19999] = 0.1; sim.chromosome.setMutationRate(rates, (1:20000) * 10 - 1); } 5 late() { pos = sim.mutations.position; if ((size(pos) > 0) & all(pos >= 199990)) stop(); }", __LINE__);
+	
+	// crossover splices mutation runs at breakpoints, and shares a parental run when both parental runs are identical; two founder haplotypes
+	// with mutations at the same positions give recombinants that must still carry exactly one mutation at each of those positions
+	std::string splice_test_string(" initializeMutationRate(0); initializeMutationType('m1', 0.5, 'f', 0.0); initializeMutationType('m2', 0.5, 'f', 0.0); m1.convertToSubstitution = F; m2.convertToSubstitution = F; initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 9999); initializeRecombinationRate(1e-3); } 1 early() { sim.addSubpop('p1', 20); p1.genomes[seq(0, 39, by=2)].addNewDrawnMutation(m1, seq(0, 9990, by=10)); p1.genomes[seq(1, 39, by=2)].addNewDrawnMutation(m2, seq(0, 9990, by=10)); } 10 late() { bad = F; for (g in p1.genomes) { pos = g.mutations.position; if (size(pos) != 1000) bad = T; else if (any(pos != seq(0, 9990, by=10))) bad = T; } if (!bad & (size(unique(p1.genomes.countOfMutationsOfType(m1))) > 1)) stop(); }");
+	
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(mutationRuns=1);" + splice_test_string, __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(mutationRuns=7);" + splice_test_string, __LINE__);
 }
 
 #pragma mark Mutation tests
@@ -653,6 +676,23 @@ void _RunMutationTests(void)
 	SLiMAssertScriptRaise(gen1_setup_highmut_p1 + "10 early() { mut = sim.mutations[0]; mut.setSelectionCoeff(1); if (mut.selectionCoeff == 1) stop(); }", "cannot be type integer", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 early() { mut = sim.mutations[0]; mut.setSelectionCoeff(-500.0); if (mut.selectionCoeff == -500.0) stop(); }", __LINE__);	// legal; no lower bound
 	SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 early() { mut = sim.mutations[0]; mut.setSelectionCoeff(500.0); if (mut.selectionCoeff == 500.0) stop(); }", __LINE__);		// legal; no upper bound
+	
+	// Test compaction of the mutation block after a burst of mutations is removed; retained references, and surviving mutations, must remain valid
+	std::string compaction_setup("initialize() { initializeMutationRate(0); initializeMutationType('m1', 0.5, 'f', 0.0); initializeMutationType('m2', 0.5, 'f', 0.1); initializeGenomicElementType('g1', c(m1,m2), c(1.0,1.0)); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 early() { sim.addSubpop('p1', 20); } 1 late() { p1.genomes[0:9].addNewMutation(m1, 0.0, 100:40099); p1.genomes[0:9].addNewMutation(m2, 0.01, 0:99); defineGlobal('M', sim.mutations[c(3, 17000, 39000)]); defineGlobal('IDS', M.id); defineGlobal('KEPT', sim.mutations[sim.mutations.position < 100].id); } 2 late() { p1.genomes.removeMutations(sim.mutations[sim.mutations.position >= 100]); } ");
+	SLiMAssertScriptStop(compaction_setup + "3 late() { if (identical(M.id, IDS) & identical(M.position, c(103, 17100, 39100)) & all(M.mutationType == m1)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(compaction_setup + "3 late() { muts = sim.mutations; if (identical(sort(muts.id), sort(KEPT)) & all(muts.mutationType == m2) & all(sim.mutationCounts(p1, muts) > 0)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(compaction_setup + "3 late() { p1.genomes[0:4].addNewMutation(m1, 0.0, 50000:50999); } 4 late() { if (size(sim.mutations) == size(KEPT) + 1000) stop(); }", __LINE__);
+	SLiMAssertScriptStop(compaction_setup + "2 early() { sim.mutations[sim.mutations.mutationType == m2][0].setSelectionCoeff(0.02); } 3 late() { p1.genomes[0:9].addNewMutation(m1, 0.0, 100:40099); } 4 early() { sim.mutations[sim.mutations.mutationType == m2][1].setSelectionCoeff(0.03); } 4 late() { p1.genomes.removeMutations(sim.mutations[sim.mutations.position >= 100]); } 6 early() { if (identical(sort(sim.mutations.id), sort(KEPT)) & all(p1.cachedFitness(NULL) > 0)) stop(); }", __LINE__);	// two compactions, with stale nonneutral caches
+	
+	// Test that fitness follows changes to selection and dominance coefficients, which must invalidate the fitness products cached with mutation runs
+	std::string fitness_setup("initialize() { initializeMutationRate(0); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(0); } 1 early() { sim.addSubpop('p1', 10); p1.setCloningRate(1.0); m1.convertToSubstitution = F; } 1 late() { p1.individuals.genome1.addNewMutation(m1, 0.1, 600); } ");
+	SLiMAssertScriptStop(fitness_setup + "2 early() { if (all(abs(p1.cachedFitness(NULL) - 1.05) < 1e-6)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(fitness_setup + "2 early() { sim.mutations.setSelectionCoeff(0.2); } 3 early() { if (all(abs(p1.cachedFitness(NULL) - 1.1) < 1e-6)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(fitness_setup + "2 early() { m1.dominanceCoeff = 1.0; } 3 early() { if (all(abs(p1.cachedFitness(NULL) - 1.1) < 1e-6)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(fitness_setup + "2 early() { sim.mutations.setSelectionCoeff(0.0); } 3 early() { if (all(p1.cachedFitness(NULL) == 1.0)) stop(); } 3 late() { sim.mutations.setSelectionCoeff(-0.2); } 4 early() { if (all(abs(p1.cachedFitness(NULL) - 0.9) < 1e-6)) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeMutationRate(0); initializeMutationType('m1', 0.5, 'f', 0.0); initializeMutationType('m2', 1.0, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(0); } 1 early() { sim.addSubpop('p1', 10); p1.setCloningRate(1.0); m1.convertToSubstitution = F; m2.convertToSubstitution = F; } 1 late() { p1.individuals.genome1.addNewMutation(m1, 0.1, 600); } 2 early() { sim.mutations.setMutationType(m2); } 3 early() { if (all(abs(p1.cachedFitness(NULL) - 1.1) < 1e-6)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(fitness_setup + "2 late() { p1.individuals.genome2.addNewMutation(m1, 0.0, 600); } 3 early() { if (all(abs(p1.cachedFitness(NULL) - 1.05) < 1e-6)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(fitness_setup + "2 late() { p1.individuals.genome2.addMutations(sim.mutations); } 3 early() { if (all(abs(p1.cachedFitness(NULL) - 1.1) < 1e-6)) stop(); }", __LINE__);
 }
 
 #pragma mark Substitution tests
@@ -21,8 +21,12 @@
 #include "slim_test.h"
 
 #include "eidos_globals.h"
+#include "../treerec/tskit/tables.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 
 #pragma mark InteractionType tests
@@ -2048,9 +2052,58 @@ void _RunNonWFTests(void)
 	SLiMAssertScriptRaise(nonWF_prefix + gen1_setup_p1 + "2 reproduction() { offspring = p1.addCloned(individual, defer=T); offspring.genomes.readFromVCF('foo'); }", "deferred genomes", __LINE__);
 	SLiMAssertScriptRaise(nonWF_prefix + gen1_setup_p1 + "2 reproduction() { offspring = p1.addCloned(individual, defer=T); offspring.genomes.removeMutations(); }", "deferred genomes", __LINE__);
 	SLiMAssertScriptRaise(nonWF_prefix + gen1_setup_p1 + "2 reproduction() { offspring = p1.addCloned(individual, defer=T); offspring.genomes.sumOfMutationsOfType(m1); }", "deferred genomes", __LINE__);
+	
+	// Test that deferred generation of offspring genomes runs recombination() and mutation() callbacks and obeys their results
+	std::string defer_marker_setup("initialize() { initializeSLiMModelType('nonWF'); initializeMutationRate(0); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-8); } 1 early() { sim.addSubpop('p1', 10); p1.genomes[seq(0,19,by=2)].addNewMutation(m1, 0.0, 10); p1.genomes[seq(1,19,by=2)].addNewMutation(m1, 0.0, 90000); } recombination() { breakpoints = 50000; return T; } ");
+	std::string defer_marker_check("2 early() { kids = p1.individuals[p1.individuals.age == 0]; counts = kids.genomes.countOfMutationsOfType(m1); if ((size(kids) == 10) & all((counts == 0) | (counts == 2))) stop(); }");
+	
+	SLiMAssertScriptStop(defer_marker_setup + "2 reproduction() { p1.addSelfed(individual, defer=T); } " + defer_marker_check, __LINE__);
+	SLiMAssertScriptStop(defer_marker_setup + "2 reproduction() { p1.addCrossed(individual, individual, defer=T); } " + defer_marker_check, __LINE__);
+	SLiMAssertScriptStop(defer_marker_setup + "initialize() { initializeTreeSeq(runCrosschecks=T); } 2 reproduction() { p1.addSelfed(individual, defer=T); } 2 early() { sim.treeSeqSimplify(); } " + defer_marker_check, __LINE__);
+	SLiMAssertScriptStop(nonWF_prefix + gen1_setup_highmut_p1 + "2 reproduction() { p1.addCrossed(individual, p1.sampleIndividuals(1), defer=T); } mutation() { return F; } 2 early() { if (size(sim.mutations) == 0) stop(); }", __LINE__);
+	SLiMAssertScriptStop(nonWF_prefix + gen1_setup_highmut_p1 + "2 reproduction() { p1.addSelfed(individual, defer=T); } mutation() { mut.tag = 7; return T; } 2 early() { if ((size(sim.mutations) > 0) & all(sim.mutations.tag == 7)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(nonWF_prefix + gen1_setup_highmut_p1 + "2 reproduction() { p1.addCloned(individual, defer=T); } mutation() { mut.tag = 7; return T; } 2 early() { if ((size(sim.mutations) > 0) & all(sim.mutations.tag == 7)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(nonWF_prefix + gen1_setup_highmut_p1 + "2 reproduction() { g = individual.genomes; p1.addRecombinant(g[0], g[1], 50000, g[1], g[0], 50000, defer=T); } mutation() { mut.tag = 7; return T; } 2 early() { if ((size(sim.mutations) > 0) & all(sim.mutations.tag == 7)) stop(); }", __LINE__);
 }
 
 #pragma mark treeseq tests
+// Rewrites a .trees file so that the ancestral state of the site at p_position is the derived state of that site's first
+// mutation (by mutation id), as SLiM never writes it; genomes with no mutation at the site then carry that mutation.  The
+// derived states in the file are ASCII, but only those are translated on load, so the ancestral state is written as binary.
+static void _SetAncestralStateToFirstMutation(const std::string &p_path, double p_position)
+{
+	tsk_table_collection_t tables;
+	
+	if (tsk_table_collection_load(&tables, p_path.c_str(), 0) == 0)
+	{
+		tsk_site_table_t &sites = tables.sites;
+		tsk_mutation_table_t &mutations = tables.mutations;
+		tsk_site_table_t sites_copy;
+		int64_t first_id = INT64_MAX;
+		
+		for (tsk_size_t j = 0; j < mutations.num_rows; ++j)
+			if (sites.position[mutations.site[j]] == p_position)
+				first_id = std::min(first_id, (int64_t)std::stoll(std::string(mutations.derived_state + mutations.derived_state_offset[j], mutations.derived_state_offset[j + 1] - mutations.derived_state_offset[j])));
+		
+		tsk_site_table_copy(&sites, &sites_copy, 0);
+		tsk_site_table_clear(&sites);
+		
+		for (tsk_size_t j = 0; j < sites_copy.num_rows; ++j)
+		{
+			bool replace = (sites_copy.position[j] == p_position);
+			const char *ancestral_state = (replace ? (const char *)&first_id : sites_copy.ancestral_state + sites_copy.ancestral_state_offset[j]);
+			tsk_size_t ancestral_state_length = (replace ? sizeof(int64_t) : sites_copy.ancestral_state_offset[j + 1] - sites_copy.ancestral_state_offset[j]);
+			
+			tsk_site_table_add_row(&sites, sites_copy.position[j], ancestral_state, ancestral_state_length, sites_copy.metadata + sites_copy.metadata_offset[j], sites_copy.metadata_offset[j + 1] - sites_copy.metadata_offset[j]);
+		}
+		
+		tsk_site_table_free(&sites_copy);
+		tsk_table_collection_dump(&tables, p_path.c_str(), 0);
+	}
+	
+	tsk_table_collection_free(&tables);
+}
+
 void _RunTreeSeqTests(const std::string &temp_path)
 {
 	// initializeTreeSeq()
@@ -2079,10 +2132,74 @@ void _RunTreeSeqTests(const std::string &temp_path)
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=T, simplificationRatio=INF, checkCoalescence=T, runCrosschecks=T); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=F, simplificationRatio=0.0, checkCoalescence=T, runCrosschecks=T); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=T, simplificationRatio=0.0, checkCoalescence=T, runCrosschecks=T); } " + gen1_setup_p1 + "100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationInterval=5, checkCoalescence=T, runCrosschecks=T, backgroundSimplify=T); } " + gen1_setup_p1 + "1: early() { sim.treeSeqCoalesced(); } 100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationRatio=2.0, runCrosschecks=T, backgroundSimplify=T); } " + gen1_setup_p1 + "23 late() { sim.treeSeqRememberIndividuals(p1.sampleIndividuals(5)); } 61 late() { sim.treeSeqSimplify(); } 100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMModelType('nonWF'); initializeTreeSeq(simplificationInterval=3, runCrosschecks=T, backgroundSimplify=T); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 50); } early() { p1.fitnessScaling = 50 / p1.individualCount; } 17 late() { sim.treeSeqRememberIndividuals(p1.sampleIndividuals(3), permanent=F); } 60 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationInterval=4, runCrosschecks=T); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 early() { sim.addSubpop('p1', 50); p1.setCloningRate(0.8); p1.setSelfingRate(0.15); } 23 late() { sim.treeSeqRememberIndividuals(p1.sampleIndividuals(3)); } 37 late() { sim.treeSeqRememberIndividuals(p1.sampleIndividuals(3), permanent=F); } 60 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMModelType('nonWF'); initializeTreeSeq(simplificationInterval=3, runCrosschecks=T, retainCoalescentOnly=F); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } reproduction() { subpop.addCloned(individual); } 1 early() { sim.addSubpop('p1', 50); } early() { p1.fitnessScaling = 50 / p1.individualCount; } 17 late() { sim.treeSeqRememberIndividuals(p1.sampleIndividuals(3), permanent=F); } 60 early() { stop(); }", __LINE__);
+	
+	// slim_sort_edges(): nodes 0-3 are at time 0, 4/5/7/8 at time 1, 6 at time 2, and 9-12 at time -1; the prefix has the
+	// simplifier's order, in which parents of one time are not in id order, and the new edges are for nodes 9-11
+	{
+		std::vector<double> node_times{0, 0, 0, 0, 1, 1, 2, 1, 1, -1, -1, -1, -1};
+		std::vector<std::vector<double>> prefix{{5, 0, 0, 100}, {5, 1, 0, 100}, {4, 2, 0, 50}, {4, 3, 0, 100}, {6, 4, 0, 100}, {6, 5, 0, 100}};
+		std::vector<std::vector<double>> prefix_noncontiguous{{4, 2, 0, 50}, {5, 0, 0, 100}, {4, 3, 0, 100}, {5, 1, 0, 100}, {6, 4, 0, 100}, {6, 5, 0, 100}};
+		std::vector<std::vector<double>> prefix_descending{{6, 4, 0, 100}, {6, 5, 0, 100}, {5, 0, 0, 100}, {5, 1, 0, 100}, {4, 2, 0, 50}, {4, 3, 0, 100}};
+		std::vector<std::vector<double>> new_edges{{1, 9, 0, 30}, {2, 9, 30, 100}, {4, 10, 0, 100}, {7, 11, 0, 60}, {1, 11, 60, 100}};
+		std::vector<std::vector<double>> new_edges_unordered{{1, 11, 60, 100}, {7, 11, 0, 60}, {1, 9, 0, 30}, {2, 9, 30, 100}, {4, 10, 0, 100}};
+		auto concat = [](std::vector<std::vector<double>> a, const std::vector<std::vector<double>> &b) { a.insert(a.end(), b.begin(), b.end()); return a; };
+		
+		SLiMAssertEdgeSort(node_times, concat(prefix, new_edges), prefix.size(), __LINE__);								// new edges bucketed by parent
+		SLiMAssertEdgeSort(node_times, concat(prefix, new_edges_unordered), prefix.size(), __LINE__);					// new edges need a sort
+		SLiMAssertEdgeSort(node_times, concat(prefix_noncontiguous, new_edges), prefix.size(), __LINE__);				// prefix check fails; full sort
+		SLiMAssertEdgeSort(node_times, concat(prefix_descending, new_edges), prefix.size(), __LINE__);					// prefix check fails; full sort
+		SLiMAssertEdgeSort(node_times, concat(prefix_descending, new_edges_unordered), 0, __LINE__);						// no prefix, as after a load
+		SLiMAssertEdgeSort(node_times, prefix, prefix.size(), __LINE__);													// no new edges
+	}
+	
+	// sorting only the new edges at each simplification, with crosschecks, in WF and nonWF models
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationInterval=4, runCrosschecks=T); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } 1 early() { sim.addSubpop('p1', 100); } 30 late() { sim.treeSeqRememberIndividuals(p1.sampleIndividuals(5)); } 50 early() { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMModelType('nonWF'); initializeTreeSeq(simplificationInterval=4, runCrosschecks=T); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 100); } early() { p1.fitnessScaling = 100 / p1.individualCount; } 30 late() { sim.treeSeqRememberIndividuals(p1.sampleIndividuals(5)); } 50 early() { stop(); }", __LINE__);
+	
+	// slim_sort_mutations(): mutations are (position, time, parent), with a negative time for an unknown time; the sites are
+	// out of order, some mutations are stacked at one site with tied times, and mutation 7's parent comes after it
+	{
+		std::vector<std::vector<double>> known{{50, 2, -1}, {10, 5, -1}, {10, 3, 1}, {50, 7, -1}, {10, 5, -1}, {10, 9, -1}, {50, 2, 3}, {30, 1, 8}, {30, 4, -1}};
+		std::vector<std::vector<double>> unknown{{50, -1, -1}, {10, -1, -1}, {10, -1, 1}, {50, -1, -1}, {10, -1, -1}, {10, -1, -1}, {50, -1, 3}, {30, -1, 8}, {30, -1, -1}};
+		std::vector<std::vector<double>> mixed{{10, 3, -1}, {50, 1, -1}, {10, -1, -1}, {50, 2, -1}, {10, 5, -1}, {30, -1, -1}};
+		
+		SLiMAssertMutationSort(known, __LINE__);			// by site, then decreasing time, then id
+		SLiMAssertMutationSort(unknown, __LINE__);			// by site, then id
+		SLiMAssertMutationSort(mixed, __LINE__);			// by site, then id at site 10, which has both known and unknown times
+		SLiMAssertMutationSort({}, __LINE__);
+	}
+	
+	// stacked mutations, sorted at each simplification, with crosschecks; this stops once some genome has a stack, which happens within a few ticks
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationInterval=3, runCrosschecks=T); initializeMutationRate(1e-1); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 9); initializeRecombinationRate(1e-2); } 1 early() { sim.addSubpop('p1', 20); } 10:200 early() { if (max(sapply(p1.genomes, 'length(applyValue.mutations.position) - length(unique(applyValue.mutations.position));')) > 0) stop(); }", __LINE__);
 	
 	// treeSeqCoalesced()
 	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "1: early() { sim.treeSeqCoalesced(); } 100 early() { stop(); }", "coalescence checking is enabled", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(trackCoalescence=T); } " + gen1_setup_p1 + "100 early() { stop(); }", "requires checkCoalescence=T", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(checkCoalescence=T); } " + gen1_setup_p1 + "1: early() { sim.treeSeqCoalesced(); } 100 early() { stop(); }", __LINE__);
+	SLiMAssertScriptSuccess("initialize() { initializeTreeSeq(simplificationRatio=INF, checkCoalescence=T, trackCoalescence=T); } " + gen1_setup_p1 + "1 early() { if (sim.treeSeqCoalesced()) stop(); } 2: early() { if (sim.treeSeqCoalesced()) { sim.addSubpop('p2', 5); if (sim.treeSeqCoalesced()) stop(); community.simulationFinished(); } } 1000 early() { stop(); }", __LINE__);
+	SLiMAssertScriptSuccess("initialize() { initializeSLiMModelType('nonWF'); initializeTreeSeq(simplificationInterval=7, checkCoalescence=T, trackCoalescence=T); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 10); } early() { p1.fitnessScaling = 10 / p1.individualCount; } late() { if (sim.treeSeqCoalesced()) community.simulationFinished(); } 1000 late() { stop(); }", __LINE__);
+	SLiMAssertScriptSuccess("initialize() { initializeSLiMModelType('nonWF'); initializeTreeSeq(simplificationInterval=7, checkCoalescence=T); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 10); } early() { p1.fitnessScaling = 10 / p1.individualCount; } late() { if (sim.treeSeqCoalesced()) community.simulationFinished(); } 1000 late() { stop(); }", __LINE__);
+	SLiMAssertScriptSuccess("initialize() { initializeSLiMModelType('nonWF'); initializeTreeSeq(simplificationInterval=7, checkCoalescence=T, backgroundSimplify=T, trackCoalescence=T); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 10); } early() { p1.fitnessScaling = 10 / p1.individualCount; } late() { if (sim.treeSeqCoalesced()) community.simulationFinished(); } 1000 late() { stop(); }", __LINE__);
+	
+	// a long, recombining chromosome, for which tract tracking is costly, with each way of checking
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(checkCoalescence=T); initializeMutationRate(1e-10); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 1e8 - 1); initializeRecombinationRate(1e-8); } 1 early() { sim.addSubpop('p1', 50); } 300 late() { sim.treeSeqCoalesced(); stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(checkCoalescence=T, trackCoalescence=T); initializeMutationRate(1e-10); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 1e8 - 1); initializeRecombinationRate(1e-8); } 1 early() { sim.addSubpop('p1', 50); } 300 late() { sim.treeSeqCoalesced(); stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(checkCoalescence=T, backgroundSimplify=T, trackCoalescence=T); initializeMutationRate(1e-10); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 1e8 - 1); initializeRecombinationRate(1e-8); } 1 early() { sim.addSubpop('p1', 50); } 300 late() { sim.treeSeqCoalesced(); stop(); }", __LINE__);
+	
+	// treeSeqDiversity(), treeSeqDivergence(), treeSeqFST(), treeSeqSFS()
+	SLiMAssertScriptRaise(gen1_setup_p1 + "10 early() { sim.treeSeqDiversity(); }", "tree recording is enabled", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 early() { sim.treeSeqDiversity(mode='node'); }", "mode to be 'site' or 'branch'", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 early() { sim.treeSeqDiversity(windows=c(0, 50000)); }", "windows to start at 0", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 early() { sim.treeSeqDiversity(windows=c(0, 50000, 50000, 100000)); }", "strictly increasing", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 early() { sim.treeSeqDivergence(p1.genomes[0:1], p1.genomes[c(2, 2)]); }", "more than once", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 early() { sim.treeSeqSFS(p1.genomes[integer(0)]); }", "at least one genome", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "10 early() { sim.treeSeqDiversity(); } modifyChild() { sim.treeSeqDiversity(); return T; }", "may only be called from", __LINE__);
+	SLiMAssertScriptSuccess("initialize() { initializeTreeSeq(simplificationInterval=20); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 early() { sim.addSubpop('p1', 20); sim.addSubpop('p2', 20); } 50 late() { g = sim.subpopulations.genomes; if (abs(sim.treeSeqDiversity() / calcPi(g) - 1.0) > 0.01) stop(); if (abs(sim.treeSeqDiversity(p1.genomes) / calcPi(p1.genomes) - 1.0) > 0.01) stop(); if (size(sim.treeSeqDiversity(mode='branch', windows=c(0, 25000, 100000))) != 2) stop(); d = sim.treeSeqDivergence(p1.genomes, p2.genomes); f = sim.treeSeqFST(p1.genomes, p2.genomes); if (!isFloat(d) | size(d) != 1 | d <= 0.0 | !isFinite(f)) stop(); s = sim.treeSeqSFS(p1.genomes[0:9]); if (size(s) != 11) stop(); s = sim.treeSeqSFS(p1.genomes[0:9], windows=c(0, 10000, 20000, 100000)); if (!identical(dim(s), c(3, 11))) stop(); }", __LINE__);
 	
 	// treeSeqSimplify()
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "50 early() { sim.treeSeqSimplify(); } 100 early() { stop(); }", __LINE__);
@@ -2107,6 +2224,36 @@ void _RunTreeSeqTests(const std::string &temp_path)
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_2.trees', simplify=T, includeModel=F, _binary=F); stop(); }", __LINE__);
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_3.trees', simplify=F, includeModel=F, _binary=T); stop(); }", __LINE__);
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_4.trees', simplify=T, includeModel=F, _binary=T); stop(); }", __LINE__);
+		
+		// overlaid neutral mutations; m2 is neutral and unused forward in time, m3 is not neutral, and m1 is used by g1
+		std::string overlay_setup("initialize() { initializeTreeSeq(); initializeMutationType('m2', 0.5, 'f', 0.0); initializeMutationType('m3', 0.5, 'f', 0.1); } ");
+		
+		SLiMAssertScriptStop(overlay_setup + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_5.trees', overlayMutationType=m2, overlayMutationRate=1e-6); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_5.trees'); m2s = sim.mutationsOfType(m2); if ((size(m2s) > 0) & all(m2s.selectionCoeff == 0.0) & (size(unique(m2s.position)) == size(m2s)) & all(m2s.originTick <= 100)) stop(); }", __LINE__);
+		SLiMAssertScriptStop(overlay_setup + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_6.trees', simplify=F, overlayMutationType=2, overlayMutationRate=1e-6, _binary=F); stop(); }", __LINE__);
+		SLiMAssertScriptStop(overlay_setup + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_7.trees', overlayMutationType=m2, overlayMutationRate=0.0); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_7.trees'); if (size(sim.mutationsOfType(m2)) == 0) stop(); }", __LINE__);
+		SLiMAssertScriptRaise(overlay_setup + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_8.trees', overlayMutationType=m1, overlayMutationRate=1e-6); }", "not be used by any genomic element type", __LINE__);
+		SLiMAssertScriptRaise(overlay_setup + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_8.trees', overlayMutationType=m3, overlayMutationRate=1e-6); }", "to be neutral", __LINE__);
+		SLiMAssertScriptRaise(overlay_setup + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_8.trees', overlayMutationType=m2, overlayMutationRate=-1e-6); }", "finite and >= 0.0", __LINE__);
+		SLiMAssertScriptRaise(overlay_setup + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_8.trees', overlayMutationRate=1e-6); }", "to be supplied if overlayMutationRate", __LINE__);
+		SLiMAssertScriptRaise(overlay_setup + gen1_setup_p1 + "100 early() { p1.genomes[0].addNewDrawnMutation(m2, 500); sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_8.trees', overlayMutationType=m2, overlayMutationRate=1e-6); }", "no mutations of overlayMutationType exist", __LINE__);
+		SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationInterval=3, backgroundSimplify=T); } " + gen1_setup_p1 + "41 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_bg.trees', simplify=F); } 42 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_bg.trees'); } 100 early() { stop(); }", __LINE__);
+		
+		// unsimplified output and reload between automatic simplifications, in WF and nonWF models; after the reload, none of
+		// the edges are known to be sorted, and they are not in the order in which SLiM records them
+		SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationInterval=4, runCrosschecks=T); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } 1 early() { sim.addSubpop('p1', 100); } 18 late() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_sort_WF.trees', simplify=F); } 22 late() { if (!exists('RELOADED')) { defineConstant('RELOADED', T); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_sort_WF.trees'); } } 40 early() { if (exists('RELOADED')) stop(); }", __LINE__);
+		SLiMAssertScriptStop("initialize() { initializeSLiMModelType('nonWF'); initializeTreeSeq(simplificationInterval=4, runCrosschecks=T); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 100); } early() { p1.fitnessScaling = 100 / p1.individualCount; } 18 late() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_sort_nonWF.trees', simplify=F); } 22 late() { if (!exists('RELOADED')) { defineConstant('RELOADED', T); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_sort_nonWF.trees'); } } 40 early() { if (exists('RELOADED')) stop(); }", __LINE__);
+		
+		// reload with stacked mutations, in several mutation runs and with more mutations than are bucketed at once; each genome must get back the same mutations, in position order
+		SLiMAssertScriptSuccess("initialize() { initializeSLiMOptions(mutationRuns=4); initializeTreeSeq(); initializeMutationRate(2e-2); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 999); initializeRecombinationRate(1e-2); } 1 early() { sim.addSubpop('p1', 200); } 20 late() { if (!exists('RELOADED')) { defineConstant('RELOADED', T); before = sapply(p1.genomes, 'paste(sort(applyValue.mutations.id));'); stacked = sum(sapply(p1.genomes, 'size(applyValue.mutations) - size(unique(applyValue.mutations.position));')); sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_stacked.trees'); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_stacked.trees'); if ((stacked == 0) | !identical(before, sapply(p1.genomes, 'paste(sort(applyValue.mutations.id));')) | !all(sapply(p1.genomes, 'p = applyValue.mutations.position; identical(p, sort(p));'))) stop(); } } 30 late() { }", __LINE__);
+		
+		// reload with a non-empty ancestral state: mutation x is made ancestral at its site, so every genome without y carries it
+		SLiMAssertScriptStop("initialize() { initializeSLiMOptions(mutationRuns=4); initializeTreeSeq(); initializeMutationRate(0); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99); initializeRecombinationRate(1e-2); } 1 early() { sim.addSubpop('p1', 10); } 10 late() { g = p1.genomes; g[0:4].addNewDrawnMutation(m1, 50); g[10:12].addNewDrawnMutation(m1, 50); sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_ancestral.trees'); stop(); }", __LINE__);
+		_SetAncestralStateToFirstMutation(temp_path + "/SLiM_treeSeq_ancestral.trees", 50);
+		SLiMAssertScriptStop("initialize() { initializeSLiMOptions(mutationRuns=4); initializeTreeSeq(); initializeMutationRate(0); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99); initializeRecombinationRate(1e-2); } 1 early() { sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_ancestral.trees'); m = sim.mutations; x = m[m.id == min(m.id)]; y = m[m.id == max(m.id)]; g = p1.genomes; if ((size(m) == 2) & all(g.containsMutations(x) == !g.containsMutations(y)) & (sum(g.containsMutations(y)) == 3)) stop(); }", __LINE__);
+		
+		// compressed output; ".gz" is appended to the path, and the file can be read back by readFromPopulationFile() and treeSeqMetadata()
+		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_gz.trees', metadata=Dictionary('a', 7), compress=T); if (!fileExists('" + temp_path + "/SLiM_treeSeq_gz.trees.gz')) return; if (treeSeqMetadata('" + temp_path + "/SLiM_treeSeq_gz.trees.gz').getValue('a') != 7) return; sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_gz.trees.gz'); if ((sim.cycle == 100) & (p1.individualCount == 10)) stop(); }", __LINE__);
+		SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 early() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_gz2.trees', compress=T, _binary=F); }", "only for binary output", __LINE__);
 	}
 }
 
@@ -2683,6 +2830,20 @@ void _RunNucleotideMethodTests(void)
 	SLiMAssertScriptRaise(nuc_model_init + "1 early() { sim.chromosome.setGeneConversion(0.5, 1000, 0.0, -1.001); stop(); }", "bias must be between -1.0 and 1.0", __LINE__);
 	SLiMAssertScriptRaise(nuc_model_init + "1 early() { sim.chromosome.setGeneConversion(0.5, 1000, 0.0, 1.001); stop(); }", "bias must be between -1.0 and 1.0", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup + "1 early() { sim.chromosome.setGeneConversion(0.5, 1000, 0.0, 0.1); stop(); }", "must be 0.0 in non-nucleotide-based models", __LINE__);
+	
+	// context-dependent mutation rates; only C->T in a CpG context can occur here, so every new mutation must be a T at an ancestral C followed by G
+	std::string nuc_cpg_init("initialize() { initializeSLiMOptions(nucleotideBased=T); initializeAncestralNucleotides(randomNucleotides(1e4)); initializeMutationTypeNuc('m1', 0.5, 'f', 0.0); mm = matrix(rep(0.0, 256), ncol=4); mm[c(6,22,38,54), 3] = 1e-3; initializeGenomicElementType('g1', m1, 1.0, mm); initializeGenomicElement(g1, 0, 1e4-1); initializeRecombinationRate(1e-4); ");
+	std::string nuc_cpg_check("muts = sim.mutations; pos = muts.position; anc = sim.chromosome.ancestralNucleotides(format='char'); if ((size(muts) > 0) & all(muts.nucleotide == 'T') & all(anc[pos] == 'C') & all(pos < 1e4-1)) if (all(anc[pos + 1] == 'G')) stop(); ");
+	
+	SLiMAssertScriptStop(nuc_cpg_init + "} 1 early() { sim.addSubpop('p1', 50); } 10 late() { " + nuc_cpg_check + "}", __LINE__);
+	SLiMAssertScriptStop(nuc_cpg_init + "initializeHotspotMap(c(5.0, 0.2), c(4999, 1e4-1)); } 1 early() { sim.addSubpop('p1', 50); } 10 late() { " + nuc_cpg_check + "}", __LINE__);
+	SLiMAssertScriptStop(nuc_cpg_init + "initializeSex('A'); initializeHotspotMap(c(2.0, 0.5), c(4999, 1e4-1), sex='M'); initializeHotspotMap(c(0.5, 2.0), c(4999, 1e4-1), sex='F'); } 1 early() { sim.addSubpop('p1', 50); } 10 late() { " + nuc_cpg_check + "}", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMModelType('nonWF'); } " + nuc_cpg_init + "initializeSex('A'); initializeHotspotMap(c(2.0, 0.5), c(4999, 1e4-1), sex='M'); initializeHotspotMap(c(0.5, 2.0), c(4999, 1e4-1), sex='F'); } reproduction(NULL, 'F') { subpop.addCrossed(individual, subpop.sampleIndividuals(1, sex='M')); } 1 early() { sim.addSubpop('p1', 50); } early() { p1.fitnessScaling = 50 / p1.individualCount; } 10 late() { " + nuc_cpg_check + "}", __LINE__);
+	SLiMAssertScriptStop(nuc_cpg_init + "} 1 early() { sim.addSubpop('p1', 50); } 5 early() { sim.chromosome.setAncestralNucleotides(paste(rep('A', 1e4), sep='')); } 10 late() { if ((size(sim.mutations) > 0) & all(sim.mutations.originTick < 5)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(nuc_cpg_init + "initializeGenomicElementType('g2', m1, 1.0, matrix(rep(0.0, 256), ncol=4)); } 1 early() { sim.addSubpop('p1', 50); } 5 early() { sim.chromosome.genomicElements.setGenomicElementType(g2); } 10 late() { if ((size(sim.mutations) > 0) & all(sim.mutations.originTick < 5)) stop(); }", __LINE__);
+	
+	// here only an A with a T to its left can mutate, to T; the chain of mutations rightward from the seed tests backgrounds that differ from the ancestral sequence, and the seed's substitution
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(nucleotideBased=T); initializeAncestralNucleotides(paste(rep('A', 1e3), sep='')); initializeMutationTypeNuc('m1', 0.5, 'f', 0.0); mm = matrix(rep(0.0, 256), ncol=4); mm[48:51, 3] = 0.05; initializeGenomicElementType('g1', m1, 1.0, mm); initializeGenomicElement(g1, 0, 1e3-1); initializeRecombinationRate(0); } 1 early() { sim.addSubpop('p1', 50); p1.genomes.addNewDrawnMutation(m1, 500, nucleotide='T'); } 20 late() { muts = sim.mutations; pos = muts.position; anc = sim.chromosome.ancestralNucleotides(format='char'); if ((size(muts) > 0) & all(muts.nucleotide == 'T') & all(pos > 500) & (anc[500] == 'T')) { for (p in pos) if ((anc[p-1] != 'T') & !any(pos == p-1)) return; stop(); } }", __LINE__);
 }
 
 
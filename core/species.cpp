@@ -281,6 +281,8 @@ SLiMFileFormat Species::FormatOfPopulationFile(const std::string &p_file_string)
 					return SLiMFileFormat::kFormatTskitBinary_HDF5;
 				else if (file_endianness_tag == 0x53414B89)			// 'âKAS', the prefix for kastore files apparently; reinterpreted via endianness
 					return SLiMFileFormat::kFormatTskitBinary_kastore;
+				else if ((file_chars[0] == '\x1f') && (file_chars[1] == '\x8b'))		// the gzip magic number; we only write gzip-compressed .trees files
+					return SLiMFileFormat::kFormatTskitBinary_kastore_gzip;
 			}
 		}
 	}
@@ -416,6 +418,7 @@ slim_tick_t Species::InitializePopulationFromFile(const std::string &p_file_stri
 	
 	// then we dispose of all existing subpopulations, mutations, etc.
 	population_.RemoveAllSubpopulationInfo();
+	chromosome_->InvalidateNucleotideMutationDraws();
     
     // Forget remembered subpop IDs and names since we are resetting our state.  We need to do this
     // to add in subpopulations we will load after resetting; however, it does leave open a window
@@ -464,7 +467,8 @@ slim_tick_t Species::InitializePopulationFromFile(const std::string &p_file_stri
 			// set up all of the mutations we just read in with the tree-seq recording code
 			RecordAllDerivedStatesFromSLiM();
 			
-			// reset our tree-seq auto-simplification interval so we don't simplify immediately
+			// reset our tree-seq auto-simplification interval so we don't simplify immediately; the new genomes were
+			// recorded without parents, so for coalescence tracking each of them is a root
 			simplify_elapsed_ = 0;
 			
 			// reset our last coalescence state; we don't know whether we're coalesced now or not
@@ -479,6 +483,26 @@ slim_tick_t Species::InitializePopulationFromFile(const std::string &p_file_stri
 	{
 		new_tick = _InitializePopulationFromTskitBinaryFile(file_cstr, p_interpreter, p_subpop_remap);
 	}
+	else if (file_format == SLiMFileFormat::kFormatTskitBinary_kastore_gzip)
+	{
+		// tskit and kastore read only uncompressed files, so we decompress into a temporary file and read that
+		std::string decompressed_path = Eidos_GunzipFileToTemporaryFile(p_file_string, ".trees");
+		
+		if (FormatOfPopulationFile(decompressed_path) != SLiMFileFormat::kFormatTskitBinary_kastore)
+		{
+			remove(decompressed_path.c_str());
+			EIDOS_TERMINATION << "ERROR (Species::InitializePopulationFromFile): gzip-compressed initialization files must contain a binary tree sequence (.trees) file." << EidosTerminate();
+		}
+		
+		try {
+			new_tick = _InitializePopulationFromTskitBinaryFile(decompressed_path.c_str(), p_interpreter, p_subpop_remap);
+		} catch (...) {
+			remove(decompressed_path.c_str());
+			throw;
+		}
+		
+		remove(decompressed_path.c_str());
+	}
 	else if (file_format == SLiMFileFormat::kFormatTskitBinary_HDF5)
 		EIDOS_TERMINATION << "ERROR (Species::InitializePopulationFromFile): msprime HDF5 binary files are not supported; that file format has been superseded by kastore." << EidosTerminate();
 	else
@@ -2221,6 +2245,11 @@ void Species::EmptyGraveyard(void)
 void Species::WF_GenerateOffspring(void)
 {
 	slim_tick_t tick = community_.Tick();
+	
+	// in nucleotide-based models, bring the mutation rate tables up to date for the parental generation, before going parallel
+	chromosome_->InvalidateNucleotideMutationDraws();
+	chromosome_->PrepareNucleotideMutationDraws();
+	
 	std::vector<SLiMEidosBlock*> mate_choice_callbacks = CallbackBlocksMatching(tick, SLiMEidosBlockType::SLiMEidosMateChoiceCallback, -1, -1, -1);
 	std::vector<SLiMEidosBlock*> modify_child_callbacks = CallbackBlocksMatching(tick, SLiMEidosBlockType::SLiMEidosModifyChildCallback, -1, -1, -1);
 	std::vector<SLiMEidosBlock*> recombination_callbacks = CallbackBlocksMatching(tick, SLiMEidosBlockType::SLiMEidosRecombinationCallback, -1, -1, -1);
@@ -2373,6 +2402,11 @@ void Species::WF_SwapGenerations(void)
 void Species::nonWF_GenerateOffspring(void)
 {
 	slim_tick_t tick = community_.Tick();
+	
+	// in nucleotide-based models, bring the mutation rate tables up to date for the parental generation
+	chromosome_->InvalidateNucleotideMutationDraws();
+	chromosome_->PrepareNucleotideMutationDraws();
+	
 	std::vector<SLiMEidosBlock*> reproduction_callbacks = CallbackBlocksMatching(tick, SLiMEidosBlockType::SLiMEidosReproductionCallback, -1, -1, -1);
 	std::vector<SLiMEidosBlock*> modify_child_callbacks = CallbackBlocksMatching(tick, SLiMEidosBlockType::SLiMEidosModifyChildCallback, -1, -1, -1);
 	std::vector<SLiMEidosBlock*> recombination_callbacks = CallbackBlocksMatching(tick, SLiMEidosBlockType::SLiMEidosRecombinationCallback, -1, -1, -1);
@@ -2605,35 +2639,16 @@ void Species::SimulationHasFinished(void)
 	}
 #endif
 	
+	// Remember the converged mutation run count for the next run of this model, if -mutrunCache was given
+	if (x_experiments_enabled_ && x_cache_path_.length())
+		WriteMutationRunCache();
+	
 	// If verbose output is enabled and we've been running mutation run experiments,
 	// figure out the modal mutation run count and print that, for the user's benefit.
 	if ((SLiM_verbosity_level >= 2) && x_experiments_enabled_)
 	{
-		int modal_index, modal_tally;
-		int power_tallies[20];	// we only go up to 1024 mutruns right now, but this gives us some headroom
-		
-		for (int i = 0; i < 20; ++i)		// NOLINT(*-loop-convert) : parallel to the loop below
-			power_tallies[i] = 0;
-		
-		for (int32_t count : x_mutcount_history_)
-		{
-			int32_t power = (int32_t)round(log2(count));
-			
-			power_tallies[power]++;
-		}
-		
-		modal_index = -1;
-		modal_tally = -1;
-		
-		for (int i = 0; i < 20; ++i)
-			if (power_tallies[i] > modal_tally)
-			{
-				modal_tally = power_tallies[i];
-				modal_index = i;
-			}
-		
-		int modal_count = (int)round(pow(2.0, modal_index));
-		double modal_fraction = power_tallies[modal_index] / (double)(x_mutcount_history_.size());
+		double modal_fraction;
+		int modal_count = ModalMutationRunCount(&modal_fraction);
 		
 		SLIM_OUTSTREAM << std::endl;
 		SLIM_OUTSTREAM << "// Mutation run modal count: " << modal_count << " (" << (modal_fraction * 100) << "% of cycles)" << std::endl;
@@ -3260,6 +3275,34 @@ void Species::InitiateMutationRunExperiments(void)
 	
 	x_experiments_enabled_ = true;
 	
+	// If -mutrunCache has a converged mutation run count for this model, start out at that count instead of
+	// the base count; no genomes exist yet, so we can just adjust the chromosome's layout directly.  The count
+	// is always the base count times a power of two, so the run length stays evenly divisible as usual.
+	if (x_cache_path_.length())
+	{
+		int32_t cached_mutcount = ReadMutationRunCache();
+		
+		if (cached_mutcount > chromosome_->mutrun_count_)
+		{
+			int32_t multiplier = cached_mutcount / chromosome_->mutrun_count_base_;
+			
+			chromosome_->mutrun_count_multiplier_ = multiplier;
+			chromosome_->mutrun_count_ = cached_mutcount;
+			chromosome_->mutrun_length_ /= multiplier;
+		}
+		
+		if (cached_mutcount)
+		{
+			x_cache_hit_ = true;
+			
+			if (SLiM_verbosity_level >= 2)
+			{
+				SLIM_OUTSTREAM << std::endl;
+				SLIM_OUTSTREAM << "// Mutation run count of " << cached_mutcount << " loaded from mutation run cache, run length = " << chromosome_->mutrun_length_ << std::endl;
+			}
+		}
+	}
+	
 	x_current_mutcount_ = chromosome_->mutrun_count_;
 	x_current_runtimes_ = (double *)malloc(SLIM_MUTRUN_EXPERIMENT_LENGTH * sizeof(double));
 	x_current_buflen_ = 0;
@@ -3279,6 +3322,15 @@ void Species::InitiateMutationRunExperiments(void)
 	x_prev1_stasis_mutcount_ = 0;		// we have never reached stasis before, so we have no memory of it
 	x_prev2_stasis_mutcount_ = 0;		// we have never reached stasis before, so we have no memory of it
 	
+	if (x_cache_hit_)
+	{
+		// A previous run of this model converged on the cached count, so we skip the exploration phase and begin
+		// in stasis there; if the model's behavior diverges, stasis will be broken and exploration will resume.
+		// With no previous experiment data, the first stasis experiment is run without a test, as usual.
+		x_previous_mutcount_ = x_current_mutcount_;
+		EnterStasisForMutationRunExperiments();
+	}
+	
 	if (SLiM_verbosity_level >= 2)
 	{
 		SLIM_OUTSTREAM << std::endl;
@@ -3715,6 +3767,157 @@ void Species::MaintainMutationRunExperiments(double p_last_gen_runtime)
 	}
 }
 
+int32_t Species::ModalMutationRunCount(double *p_modal_fraction)
+{
+	// Find the mutation run count used in the most cycles; ties go to the smaller count
+	std::map<int32_t, int64_t> count_tallies;
+	
+	for (int32_t count : x_mutcount_history_)
+		count_tallies[count]++;
+	
+	int32_t modal_count = 0;
+	int64_t modal_tally = 0;
+	
+	for (auto &count_tally : count_tallies)
+		if (count_tally.second > modal_tally)
+		{
+			modal_count = count_tally.first;
+			modal_tally = count_tally.second;
+		}
+	
+	if (p_modal_fraction)
+		*p_modal_fraction = (x_mutcount_history_.size() ? modal_tally / (double)(x_mutcount_history_.size()) : 0.0);
+	
+	return modal_count;
+}
+
+void Species::MutationRunCache_Enable(const std::string &p_cache_path, const std::string &p_model_hash)
+{
+	// This is called by command-line slim if a -mutrunCache command-line option is supplied.  The converged result of
+	// the mutation run experiments is saved to the cache file at the end of the run, and read back at the start of the
+	// next run of the same model, so that replicate runs can skip the exploration phase of the experiments.
+	x_cache_path_ = Eidos_ResolvedPath(p_cache_path);
+	x_cache_model_hash_ = p_model_hash;
+}
+
+std::string Species::MutationRunCacheKey(void)
+{
+	// The key includes everything that determines which mutation run counts are legal; the model hash covers the
+	// script and -d[efine] constants, which should determine everything else that matters (but not the seed)
+	return x_cache_model_hash_ + ":" + name_ + ":" + std::to_string(chromosome_->last_position_) + ":" + std::to_string(chromosome_->mutrun_count_base_);
+}
+
+int32_t Species::ReadMutationRunCache(void)
+{
+	// Returns the cached mutation run count for this model, or 0 if there is no usable cache entry.  The cache file
+	// has one line per model/species: the key, the converged mutation run count, the fraction of cycles spent at that
+	// count, and the mean cycle runtime (in seconds) measured at that count.  The last two are informational only.
+	std::ifstream cache_file(x_cache_path_);
+	
+	if (!cache_file.is_open())
+		return 0;
+	
+	std::string key = MutationRunCacheKey();
+	std::string line;
+	
+	while (std::getline(cache_file, line))
+	{
+		std::istringstream line_stream(line);
+		std::string line_key;
+		int64_t mutcount = 0;
+		
+		if (!(line_stream >> line_key >> mutcount) || (line_key != key))
+			continue;
+		
+		// Only counts that the experiments could have reached are usable: the base count times a power of two
+		int32_t base = chromosome_->mutrun_count_base_;
+		
+		if ((mutcount < base) || (mutcount > SLIM_MUTRUN_MAXIMUM_COUNT) || (mutcount % base != 0))
+			return 0;
+		
+		int64_t multiplier = mutcount / base;
+		
+		if ((multiplier & (multiplier - 1)) != 0)
+			return 0;
+		
+		return (int32_t)mutcount;
+	}
+	
+	return 0;
+}
+
+void Species::WriteMutationRunCache(void)
+{
+	if (x_mutcount_history_.size() == 0)
+		return;
+	
+	double modal_fraction;
+	int32_t modal_count = ModalMutationRunCount(&modal_fraction);
+	
+	// Measure the mean runtime at the modal count from the most recent experiment that used it, if any
+	double mean_runtime = 0.0;
+	
+	if ((x_current_mutcount_ == modal_count) && (x_current_buflen_ > 0))
+		mean_runtime = std::accumulate(x_current_runtimes_, x_current_runtimes_ + x_current_buflen_, 0.0) / x_current_buflen_;
+	else if ((x_previous_mutcount_ == modal_count) && (x_previous_buflen_ > 0))
+		mean_runtime = std::accumulate(x_previous_runtimes_, x_previous_runtimes_ + x_previous_buflen_, 0.0) / x_previous_buflen_;
+	
+	// Keep the entries for other models/species, replacing our own entry
+	std::string key = MutationRunCacheKey();
+	std::vector<std::string> lines;
+	
+	{
+		std::ifstream cache_file(x_cache_path_);
+		std::string line;
+		
+		while (std::getline(cache_file, line))
+		{
+			std::istringstream line_stream(line);
+			std::string line_key;
+			
+			if ((line_stream >> line_key) && (line_key != key))
+				lines.emplace_back(line);
+		}
+	}
+	
+	std::ostringstream entry;
+	
+	entry << key << " " << modal_count << " " << modal_fraction << " " << mean_runtime;
+	lines.emplace_back(entry.str());
+	
+	// Write to a temporary file and then rename it into place, so that concurrent replicates never see a partial file
+	std::string temp_path = x_cache_path_ + ".tmp" + std::to_string((long)getpid());
+	
+	{
+		std::ofstream temp_file(temp_path, std::ios_base::out | std::ios_base::trunc);
+		
+		if (!temp_file.is_open())
+		{
+			if (!gEidosSuppressWarnings)
+				SLIM_ERRSTREAM << "#WARNING (Species::WriteMutationRunCache): could not write to the mutation run cache file " << x_cache_path_ << "." << std::endl;
+			return;
+		}
+		
+		for (const std::string &line : lines)
+			temp_file << line << std::endl;
+	}
+	
+	if (rename(temp_path.c_str(), x_cache_path_.c_str()) != 0)
+	{
+		remove(temp_path.c_str());
+		
+		if (!gEidosSuppressWarnings)
+			SLIM_ERRSTREAM << "#WARNING (Species::WriteMutationRunCache): could not replace the mutation run cache file " << x_cache_path_ << "." << std::endl;
+		return;
+	}
+	
+	if (SLiM_verbosity_level >= 2)
+	{
+		SLIM_OUTSTREAM << std::endl;
+		SLIM_OUTSTREAM << "// Mutation run count of " << modal_count << " saved to mutation run cache" << std::endl;
+	}
+}
+
 #if (SLIMPROFILING == 1)
 // PROFILING
 #if SLIM_USE_NONNEUTRAL_CACHES
@@ -3740,14 +3943,13 @@ void Species::CollectMutationProfileInfo(void)
 		
 		for (Genome *genome : subpop_genomes)
 		{
-			const MutationRun **mutruns = genome->mutruns_;
 			int32_t mutrun_count = genome->mutrun_count_;
 			
 			profile_mutrun_total_usage_ += mutrun_count;
 			
 			for (int32_t mutrun_index = 0; mutrun_index < mutrun_count; ++mutrun_index)
 			{
-				const MutationRun *mutrun = mutruns[mutrun_index];
+				const MutationRun *mutrun = genome->MutationRunAtIndex(mutrun_index);
 				
 				if (mutrun)
 				{
@@ -4027,13 +4229,209 @@ static void _Eidos_ParallelQuicksort_ASCENDING(edge_plus_time *values, int64_t l
 }
 #endif
 
-static int
+// Sorts with std::sort when not running parallel, or if the task is small; sorts in parallel for big tasks if we can, with
+// the thread count for SIMPLIFY_SORT.  This is used for the sorts other than the full edge sort in slim_sort_edges() below,
+// which has its own quicksort; the comparator is a template parameter here, so it still gets inlined.
+template <typename T, typename Compare>
+static void slim_sort_for_simplify(T *values, int64_t nelements, const Compare &comparator)
+{
+#ifdef _OPENMP
+	if (nelements >= EIDOS_OMPMIN_SIMPLIFY_SORT)
+	{
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_SORT);
+#pragma omp parallel default(none) shared(values, nelements, comparator) num_threads(thread_count)
+		{
+			// see Eidos_ParallelSort_Comparator() regarding the fall-through size
+			int64_t fallthrough = nelements / (EIDOS_FALLTHROUGH_FACTOR * omp_get_num_threads());
+			
+			if (fallthrough < 1000)
+				fallthrough = 1000;
+			
+#pragma omp single nowait
+			{
+				_Eidos_ParallelQuicksort_Comparator(values, 0, nelements - 1, comparator, fallthrough);
+			}
+		} // End of parallel region
+		
+		return;
+	}
+#endif
+	
+	std::sort(values, values + nelements, comparator);
+}
+
+// The edge sorter also runs on a worker thread for background simplification, where the EIDOS_BENCHMARK_START/END macros
+// can't be used since they share globals with the main thread; these variants skip benchmarking when benchmark is false.
+#define SLIM_SORT_BENCHMARK_START(x)	eidos_profile_t slim__benchmark_start = ((benchmark && (gEidosBenchmarkType == (x))) ? Eidos_BenchmarkTime() : 0);
+#define SLIM_SORT_BENCHMARK_END(x)	if (benchmark && (gEidosBenchmarkType == (x))) gEidosBenchmarkAccumulator += (Eidos_BenchmarkTime() - slim__benchmark_start);
+
+// Used by slim_sort_edges_incremental(); see below.  The order field replaces the parent id as the secondary sort key.
+struct edge_plus_order {
+	double time;
+	int64_t order;
+	tsk_id_t parent, child;
+	double left, right;
+};
+
+static inline bool edge_plus_order_less(const edge_plus_order &lhs, const edge_plus_order &rhs)
+{
+	if (lhs.time == rhs.time) {
+		if (lhs.order == rhs.order) {
+			if (lhs.child == rhs.child) {
+				return lhs.left < rhs.left;
+			}
+			return lhs.child < rhs.child;
+		}
+		return lhs.order < rhs.order;
+	}
+	return lhs.time < rhs.time;
+}
+
+// The first start edges in the table are the output of the previous simplification, which is already sorted; this sorts
+// only the edges recorded since then, and merges them into that sorted prefix in linear time, so that the cost of sorting
+// is proportional to the new edges rather than to the whole table.  tskit requires edges to be sorted by parent time, with
+// the edges for each parent contiguous and sorted by child and left; but within one time, the simplifier does not emit
+// parents in id order, so we can't simply merge using our usual comparator.  Instead, each parent with edges in the prefix
+// is keyed by the index of its first edge there, and parents seen only in the new edges are keyed after all of those, by
+// id.  New edges from a parent that already has edges in the prefix thus join the end of its existing block (their children
+// are new nodes, with higher ids than any child in the prefix).  Returns false, leaving the table untouched, if the prefix
+// turns out not to be in the expected order, in which case the caller should sort the whole table instead.
+//
+// The new edges themselves don't need a comparison sort.  RecordNewGenome() adds a new node and then its edges, in order of
+// increasing left, so the new edges for any one parent are already in child/left order; they just need to be gathered into
+// per-parent buckets, with a stable counting pass, and only the distinct parents need to be sorted.  If the new edges were
+// not recorded that way (for a table loaded from a file, for example), we fall back to sorting them.
+static bool
+slim_sort_edges_incremental(tsk_table_sorter_t *sorter, std::size_t start, bool benchmark)
+{
+	tsk_edge_table_t *edges = &sorter->tables->edges;
+	double *node_times = sorter->tables->nodes.time;
+	std::size_t num_rows = static_cast<std::size_t>(edges->num_rows);
+	std::size_t num_nodes = static_cast<std::size_t>(sorter->tables->nodes.num_rows);
+	std::vector<int64_t> parent_order(num_nodes, -1);
+	std::vector<edge_plus_order> temp_edge_data(num_rows);
+	
+	for (std::size_t i = 0; i < start; ++i)
+	{
+		tsk_id_t parent = edges->parent[i];
+		
+		if (parent_order[parent] == -1)
+			parent_order[parent] = (int64_t)i;
+	}
+	
+	// assemble the keys for the prefix, and check that it is in order; a parent whose edges are not contiguous shows up
+	// in the check too, since its key is lower than that of the edge before
+	bool prefix_sorted = true;
+	
+	{
+		SLIM_SORT_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT_PRE);
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_SORT_PRE);
+#pragma omp parallel default(none) shared(start, temp_edge_data, edges, node_times, parent_order, prefix_sorted) if(start >= EIDOS_OMPMIN_SIMPLIFY_SORT_PRE) num_threads(thread_count)
+		{
+#pragma omp for schedule(static)
+			for (std::size_t i = 0; i < start; ++i)
+			{
+				tsk_id_t parent = edges->parent[i];
+				
+				temp_edge_data[i] = edge_plus_order{ node_times[parent], parent_order[parent], parent, edges->child[i], edges->left[i], edges->right[i] };
+			}
+			
+#pragma omp for schedule(static) reduction(&&: prefix_sorted)
+			for (std::size_t i = 1; i < start; ++i)
+			{
+				if (edge_plus_order_less(temp_edge_data[i], temp_edge_data[i - 1]))
+					prefix_sorted = false;
+			}
+		}
+		SLIM_SORT_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_SORT_PRE);
+	}
+	
+	if (!prefix_sorted)
+		return false;
+	
+	SLIM_SORT_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT);
+	
+	// count the new edges for each parent, and collect the distinct parents of the new edges
+	std::vector<tsk_size_t> bucket_position(num_nodes, 0);
+	std::vector<tsk_id_t> new_parents;
+	
+	for (std::size_t i = start; i < num_rows; ++i)
+	{
+		tsk_id_t parent = edges->parent[i];
+		
+		if (bucket_position[parent]++ == 0)
+		{
+			new_parents.emplace_back(parent);
+			
+			if (parent_order[parent] == -1)
+				parent_order[parent] = (int64_t)start + parent;
+		}
+	}
+	
+	// sort the distinct parents, and lay out their buckets one after another in that order
+	const int64_t *parent_order_data = parent_order.data();
+	
+	slim_sort_for_simplify(new_parents.data(), (int64_t)new_parents.size(), [node_times, parent_order_data](tsk_id_t lhs, tsk_id_t rhs) {
+		if (node_times[lhs] == node_times[rhs])
+			return parent_order_data[lhs] < parent_order_data[rhs];
+		return node_times[lhs] < node_times[rhs];
+	});
+	
+	tsk_size_t bucket_start = (tsk_size_t)start;
+	
+	for (tsk_id_t parent : new_parents)
+	{
+		tsk_size_t bucket_size = bucket_position[parent];
+		
+		bucket_position[parent] = bucket_start;
+		bucket_start += bucket_size;
+	}
+	
+	// scatter the new edges into their buckets; the buckets are in order, so the new edges are sorted if each bucket is
+	for (std::size_t i = start; i < num_rows; ++i)
+	{
+		tsk_id_t parent = edges->parent[i];
+		
+		temp_edge_data[bucket_position[parent]++] = edge_plus_order{ node_times[parent], parent_order[parent], parent, edges->child[i], edges->left[i], edges->right[i] };
+	}
+	
+	if (!std::is_sorted(temp_edge_data.begin() + start, temp_edge_data.end(), edge_plus_order_less))
+		slim_sort_for_simplify(temp_edge_data.data() + start, (int64_t)(num_rows - start), [](const edge_plus_order &lhs, const edge_plus_order &rhs) { return edge_plus_order_less(lhs, rhs); });
+	
+	std::inplace_merge(temp_edge_data.begin(), temp_edge_data.begin() + start, temp_edge_data.end(), edge_plus_order_less);
+	
+	SLIM_SORT_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_SORT);
+	
+	// copy the sorted temp_edge_data vector back into the edge table
+	{
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_SORT_POST);
+#pragma omp parallel for schedule(static) default(none) shared(num_rows, temp_edge_data, edges) if(num_rows >= EIDOS_OMPMIN_SIMPLIFY_SORT_POST) num_threads(thread_count)
+		for (std::size_t i = 0; i < num_rows; ++i)
+		{
+			edges->left[i] = temp_edge_data[i].left;
+			edges->right[i] = temp_edge_data[i].right;
+			edges->parent[i] = temp_edge_data[i].parent;
+			edges->child[i] = temp_edge_data[i].child;
+		}
+	}
+	
+	return true;
+}
+
+int
 slim_sort_edges(tsk_table_sorter_t *sorter, tsk_size_t start)
 {
 	if (sorter->tables->edges.metadata_length != 0)
 		throw std::invalid_argument("the sorter does not currently handle edge metadata");
-	if (start != 0)
-		throw std::invalid_argument("the sorter requires start==0");
+	if (start > sorter->tables->edges.num_rows)
+		throw std::invalid_argument("the sorter requires start <= num_rows");
+	
+	// slim_sort_tables() passes a flag in user_data when sorting on a worker thread; see SLIM_SORT_BENCHMARK_START()
+	const bool *off_main_thread = static_cast<const bool *>(sorter->user_data);
+	bool benchmark = !(off_main_thread && *off_main_thread);
+	
+	if (slim_sort_edges_incremental(sorter, static_cast<std::size_t>(start), benchmark))
+		return 0;
 	
 	std::size_t num_rows = static_cast<std::size_t>(sorter->tables->edges.num_rows);
 	//std::cout << num_rows << " edge table rows to be sorted" << std::endl;
@@ -4047,21 +4445,21 @@ slim_sort_edges(tsk_table_sorter_t *sorter, tsk_size_t start)
 	
 	// pre-sort: assemble the temp_edge_data vector
 	{
-		EIDOS_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT_PRE);
+		SLIM_SORT_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT_PRE);
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_SORT_PRE);
 #pragma omp parallel for schedule(static) default(none) shared(num_rows, temp_edge_data, edges, node_times) if(num_rows >= EIDOS_OMPMIN_SIMPLIFY_SORT_PRE) num_threads(thread_count)
 		for (tsk_size_t i = 0; i < num_rows; ++i)
 		{
 			temp_edge_data[i] = edge_plus_time{ node_times[edges->parent[i]], edges->parent[i], edges->child[i], edges->left[i], edges->right[i] };
 		}
-		EIDOS_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_SORT_PRE);
+		SLIM_SORT_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_SORT_PRE);
 	}
 	
 	// sort with std::sort when not running parallel, or if the task is small;
 	// sort in parallel for big tasks if we can; see Eidos_ParallelSort() which
 	// this is patterned after, but we want the (faster) inlined comparator...
 	{
-		EIDOS_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT);
+		SLIM_SORT_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT);
 		
 #ifdef _OPENMP
 		if (num_rows >= EIDOS_OMPMIN_SIMPLIFY_SORT)
@@ -4110,12 +4508,12 @@ slim_sort_edges(tsk_table_sorter_t *sorter, tsk_size_t start)
 		// If we did a parallel sort, we jump here to skip the single-threaded sort
 	didParallelSort:
 #endif
-		EIDOS_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_SORT);
+		SLIM_SORT_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_SORT);
 	}
 	
 	// post-sort: copy the sorted temp_edge_data vector back into the edge table
 	{
-		EIDOS_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT_POST);
+		SLIM_SORT_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT_POST);
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_SORT_POST);
 #pragma omp parallel for schedule(static) default(none) shared(num_rows, temp_edge_data, edges) if(num_rows >= EIDOS_OMPMIN_SIMPLIFY_SORT_POST) num_threads(thread_count)
 		for (std::size_t i = 0; i < num_rows; ++i)
@@ -4125,7 +4523,7 @@ slim_sort_edges(tsk_table_sorter_t *sorter, tsk_size_t start)
 			edges->parent[i] = temp_edge_data[i].parent;
 			edges->child[i] = temp_edge_data[i].child;
 		}
-		EIDOS_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_SORT_POST);
+		SLIM_SORT_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_SORT_POST);
 	}
 	
 	free(temp_edge_data);
@@ -4133,50 +4531,411 @@ slim_sort_edges(tsk_table_sorter_t *sorter, tsk_size_t start)
 	return 0;
 }
 
-void Species::SimplifyTreeSequence(void)
+struct mutation_sort_key {
+	tsk_id_t site;
+	tsk_id_t id;
+	double time;
+};
+
+// This replaces tskit's tsk_table_sorter_sort_mutations(), with the same result: mutations are sorted by site (after the
+// sites have been sorted), then by decreasing time where times are known, then by id, and parent references are remapped.
+// (Where one site has both known and unknown times, tskit's order is undefined, and ours is by id; see below.)
+// Rather than qsort() whole rows with a comparison function, it sorts small keys with an inlined comparator, and then
+// gathers the columns directly; the sort and the gather are done in parallel for big tables if we can.
+int
+slim_sort_mutations(tsk_table_sorter_t *sorter)
 {
-#if DEBUG
-	if (!recording_tree_)
-		EIDOS_TERMINATION << "ERROR (Species::SimplifyTreeSequence): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
-#endif
+	tsk_mutation_table_t *mutations = &sorter->tables->mutations;
+	tsk_id_t *site_id_map = sorter->site_id_map;
+	std::size_t num_mutations = static_cast<std::size_t>(mutations->num_rows);
+	tsk_mutation_table_t copy;
 	
-	if (tables_.nodes.num_rows == 0)
-		return;
+	int ret = tsk_mutation_table_copy(mutations, &copy, 0);
+	if (ret != 0)
+	{
+		tsk_mutation_table_free(&copy);
+		return ret;
+	}
 	
-	std::vector<tsk_id_t> samples;
+	std::vector<mutation_sort_key> keys(num_mutations);
+	std::vector<tsk_id_t> mutation_id_map(num_mutations);
+	bool any_unknown_time = false;
 	
-	// BCH 7/27/2019: We now build a hash table containing all of the entries of remembered_genomes_,
-	// so that the find() operations in the loop below can be done in constant time instead of O(N) time.
-	// We need to be able to find out the index of an entry, in remembered_genomes_, once we have found it;
-	// that is what the mapped value provides, whereas the key value is the tsk_id_t we need to find below.
-	// We do all this inside a block so the map gets deallocated as soon as possible, to minimize footprint.
 	{
-#if EIDOS_ROBIN_HOOD_HASHING
-		robin_hood::unordered_flat_map<tsk_id_t, uint32_t> remembered_genomes_lookup;
-		//typedef robin_hood::pair<tsk_id_t, uint32_t> MAP_PAIR;
-#elif STD_UNORDERED_MAP_HASHING
-		std::unordered_map<tsk_id_t, uint32_t> remembered_genomes_lookup;
-		//typedef std::pair<tsk_id_t, uint32_t> MAP_PAIR;
-#endif
-		
-		// the remembered_genomes_ come first in the list of samples
-		uint32_t index = 0;
-		
-		for (tsk_id_t sid : remembered_genomes_)
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_SORT_PRE);
+#pragma omp parallel for schedule(static) default(none) shared(num_mutations, keys, copy, site_id_map) reduction(||: any_unknown_time) if(num_mutations >= EIDOS_OMPMIN_SIMPLIFY_SORT_PRE) num_threads(thread_count)
+		for (std::size_t j = 0; j < num_mutations; ++j)
 		{
-			samples.emplace_back(sid);
-			remembered_genomes_lookup.emplace(sid, index);
-			index++;
+			keys[j] = mutation_sort_key{ site_id_map[copy.site[j]], (tsk_id_t)j, copy.time[j] };
+			
+			if (tsk_is_unknown_time(copy.time[j]))
+				any_unknown_time = true;
 		}
+	}
+	
+	if (!any_unknown_time)
+	{
+		// SLiM always records mutation times, so this is the usual case
+		slim_sort_for_simplify(keys.data(), (int64_t)num_mutations, [](const mutation_sort_key &lhs, const mutation_sort_key &rhs) {
+			if (lhs.site != rhs.site)
+				return lhs.site < rhs.site;
+			if (lhs.time != rhs.time)
+				return lhs.time > rhs.time;
+			return lhs.id < rhs.id;
+		});
+	}
+	else
+	{
+		// tskit's comparator ignores unknown times, which is not a strict weak ordering if one site has both known and unknown
+		// times (a table that tskit rejects after sorting, but which can reach the sort); so we sort by site and id, and then
+		// sort by time only within the sites whose times are all known, which gives tskit's order for every other table
+		slim_sort_for_simplify(keys.data(), (int64_t)num_mutations, [](const mutation_sort_key &lhs, const mutation_sort_key &rhs) {
+			if (lhs.site != rhs.site)
+				return lhs.site < rhs.site;
+			return lhs.id < rhs.id;
+		});
 		
-		// and then come all the genomes of the extant individuals
-		tsk_id_t newValueInNodeTable = (tsk_id_t)remembered_genomes_.size();
-		
-		for (auto it : population_.subpops_)
+		for (std::size_t site_start = 0, site_end; site_start < num_mutations; site_start = site_end)
 		{
-			std::vector<Genome *> &subpopulationGenomes = it.second->parent_genomes_;
+			bool site_times_known = !tsk_is_unknown_time(keys[site_start].time);
 			
-			for (Genome *genome : subpopulationGenomes)
+			for (site_end = site_start + 1; (site_end < num_mutations) && (keys[site_end].site == keys[site_start].site); ++site_end)
+				if (tsk_is_unknown_time(keys[site_end].time))
+					site_times_known = false;
+			
+			if (site_times_known && (site_end - site_start > 1))
+				std::stable_sort(keys.begin() + site_start, keys.begin() + site_end, [](const mutation_sort_key &lhs, const mutation_sort_key &rhs) { return lhs.time > rhs.time; });
+		}
+	}
+	
+	// build the id map and the new offsets for the ragged columns; the total lengths are unchanged
+	mutations->derived_state_offset[0] = 0;
+	mutations->metadata_offset[0] = 0;
+	
+	for (std::size_t j = 0; j < num_mutations; ++j)
+	{
+		tsk_id_t id = keys[j].id;
+		
+		mutation_id_map[id] = (tsk_id_t)j;
+		mutations->derived_state_offset[j + 1] = mutations->derived_state_offset[j] + (copy.derived_state_offset[id + 1] - copy.derived_state_offset[id]);
+		mutations->metadata_offset[j + 1] = mutations->metadata_offset[j] + (copy.metadata_offset[id + 1] - copy.metadata_offset[id]);
+	}
+	
+	{
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_SORT_POST);
+#pragma omp parallel for schedule(static) default(none) shared(num_mutations, keys, mutation_id_map, copy, mutations) if(num_mutations >= EIDOS_OMPMIN_SIMPLIFY_SORT_POST) num_threads(thread_count)
+		for (std::size_t j = 0; j < num_mutations; ++j)
+		{
+			tsk_id_t id = keys[j].id;
+			tsk_id_t parent = copy.parent[id];
+			
+			mutations->site[j] = keys[j].site;
+			mutations->node[j] = copy.node[id];
+			mutations->parent[j] = ((parent == TSK_NULL) ? TSK_NULL : mutation_id_map[parent]);
+			mutations->time[j] = copy.time[id];
+			memcpy(mutations->derived_state + mutations->derived_state_offset[j], copy.derived_state + copy.derived_state_offset[id], copy.derived_state_offset[id + 1] - copy.derived_state_offset[id]);
+			memcpy(mutations->metadata + mutations->metadata_offset[j], copy.metadata + copy.metadata_offset[id], copy.metadata_offset[id + 1] - copy.metadata_offset[id]);
+		}
+	}
+	
+	tsk_mutation_table_free(&copy);
+	
+	return 0;
+}
+
+// Sorts p_tables for simplification; p_sorted_position gives the sizes of its tables after the last simplification, below
+// which rows are already sorted.  This is safe to call on a worker thread, if p_off_main_thread is true; a tskit error code is
+// returned, with the name of the failing call in p_error_source, and exceptions from the edge sorter are left to the caller.
+static int
+slim_sort_tables(tsk_table_collection_t *p_tables, tsk_flags_t p_flags, const tsk_bookmark_t &p_sorted_position, bool p_off_main_thread, const char **p_error_source)
+{
+#if 0
+	// sort the tables using tsk_table_collection_sort() to get the default behavior
+	*p_error_source = "tsk_table_collection_sort";
+	return tsk_table_collection_sort(p_tables, /* edge_start */ NULL, /* flags */ p_flags);
+#else
+	// sort the tables using our own custom edge sorter, for additional speed through inlining of the comparison function
+	// see https://github.com/tskit-dev/tskit/pull/627, https://github.com/tskit-dev/tskit/pull/711
+	tsk_table_sorter_t sorter;
+	int ret = tsk_table_sorter_init(&sorter, p_tables, /* flags */ p_flags);
+	if (ret != 0) { *p_error_source = "tsk_table_sorter_init"; return ret; }
+	
+	sorter.sort_edges = slim_sort_edges;
+	sorter.sort_mutations = slim_sort_mutations;
+	sorter.user_data = &p_off_main_thread;
+	
+	// edges below the position recorded after the last simplification are already sorted, and slim_sort_edges() only
+	// needs to sort the edges added since then; tskit can also skip sorting sites and mutations if none have been added
+	tsk_bookmark_t sort_start;
+	
+	memset(&sort_start, 0, sizeof(tsk_bookmark_t));
+	
+	if (p_sorted_position.edges <= p_tables->edges.num_rows)
+		sort_start.edges = p_sorted_position.edges;
+	
+	if ((p_sorted_position.sites == p_tables->sites.num_rows) && (p_sorted_position.mutations == p_tables->mutations.num_rows))
+	{
+		sort_start.sites = p_tables->sites.num_rows;
+		sort_start.mutations = p_tables->mutations.num_rows;
+	}
+	
+	try {
+		ret = tsk_table_sorter_run(&sorter, &sort_start);
+	} catch (...) {
+		tsk_table_sorter_free(&sorter);
+		throw;
+	}
+	
+	tsk_table_sorter_free(&sorter);
+	
+	if (ret != 0) *p_error_source = "tsk_table_sorter_run";
+	return ret;
+#endif
+}
+
+// Removes, before sorting for simplification, edges recorded since the last simplification that simplify would discard
+// anyway, so that they don't have to be sorted and then processed by the simplifier.  This matters most for clonal and
+// selfing models, in which most new nodes are either extinct lineages or links in unary chains.  Two kinds of edges go:
+// edges into new nodes that have no descendants and are not samples (extinct lineages; removing them can leave their
+// parents childless too, so this cascades), and, if p_collapse_unary is true, the edges into new nodes that are unary over
+// the whole chromosome (a single full-length edge as child, and a single edge as parent), with the edge below such a node
+// re-pointed to its nearest ancestor that is not collapsed.  Collapsing would remove nodes that TSK_SIMPLIFY_KEEP_UNARY
+// keeps, so it is done only when retaining coalescent nodes only.  Nodes that are samples, that carry mutations, or that
+// belong to a tabled individual are never touched, and neither are nodes or edges from before the last simplification,
+// so the simplified result is the same as without this pass.  The surviving edges keep their order, which matters for
+// slim_sort_edges_incremental().
+static void
+slim_prune_new_edges(tsk_table_collection_t *p_tables, const tsk_bookmark_t &p_sorted_position, const std::vector<tsk_id_t> &p_samples, bool p_collapse_unary)
+{
+	tsk_node_table_t &nodes = p_tables->nodes;
+	tsk_edge_table_t &edges = p_tables->edges;
+	tsk_mutation_table_t &mutations = p_tables->mutations;
+	std::size_t num_nodes = static_cast<std::size_t>(nodes.num_rows);
+	std::size_t num_edges = static_cast<std::size_t>(edges.num_rows);
+	std::size_t base_node = static_cast<std::size_t>(p_sorted_position.nodes);
+	std::size_t start = static_cast<std::size_t>(p_sorted_position.edges);
+	
+	if ((base_node >= num_nodes) || (start >= num_edges) || (edges.metadata_length != 0))
+		return;
+	
+	std::size_t new_node_count = num_nodes - base_node;
+	std::size_t new_edge_count = num_edges - start;
+	
+	// nodes that must be kept as they are
+	std::vector<uint8_t> pinned(new_node_count, 0);
+	
+	for (tsk_id_t sample : p_samples)
+		if ((sample >= (tsk_id_t)base_node) && (sample < (tsk_id_t)num_nodes))
+			pinned[sample - base_node] = 1;
+	
+	for (tsk_size_t row = 0; row < mutations.num_rows; ++row)
+	{
+		tsk_id_t node = mutations.node[row];
+		
+		if (node >= (tsk_id_t)base_node)
+			pinned[node - base_node] = 1;
+	}
+	
+	for (std::size_t node = base_node; node < num_nodes; ++node)
+		if (nodes.individual[node] != TSK_NULL)
+			pinned[node - base_node] = 1;
+	
+	// count the new edges above and below each new node, and gather the new edges by child; a new node that is a child in
+	// an older edge would not be safe to change, so it is pinned too
+	std::vector<uint32_t> edges_as_parent(new_node_count, 0);
+	std::vector<std::size_t> child_edge_offset(new_node_count + 1, 0);
+	
+	for (std::size_t row = 0; row < start; ++row)
+	{
+		tsk_id_t child = edges.child[row];
+		
+		if (child >= (tsk_id_t)base_node)
+			pinned[child - base_node] = 1;
+	}
+	
+	for (std::size_t row = start; row < num_edges; ++row)
+	{
+		tsk_id_t parent = edges.parent[row];
+		tsk_id_t child = edges.child[row];
+		
+		if (parent >= (tsk_id_t)base_node)
+			edges_as_parent[parent - base_node]++;
+		if (child >= (tsk_id_t)base_node)
+			child_edge_offset[child - base_node + 1]++;
+	}
+	
+	for (std::size_t index = 0; index < new_node_count; ++index)
+		child_edge_offset[index + 1] += child_edge_offset[index];
+	
+	std::vector<std::size_t> child_edges(child_edge_offset[new_node_count]);
+	
+	{
+		std::vector<std::size_t> fill(child_edge_offset.begin(), child_edge_offset.end() - 1);
+		
+		for (std::size_t row = start; row < num_edges; ++row)
+		{
+			tsk_id_t child = edges.child[row];
+			
+			if (child >= (tsk_id_t)base_node)
+				child_edges[fill[child - base_node]++] = row;
+		}
+	}
+	
+	std::vector<uint8_t> removed(new_edge_count, 0);
+	std::size_t removed_count = 0;
+	
+	// prune the extinct lineages, working up from the new nodes that have no edges below them
+	{
+		std::vector<std::size_t> childless;
+		
+		for (std::size_t index = 0; index < new_node_count; ++index)
+			if (!pinned[index] && (edges_as_parent[index] == 0))
+				childless.emplace_back(index);
+		
+		while (childless.size())
+		{
+			std::size_t index = childless.back();
+			
+			childless.pop_back();
+			
+			for (std::size_t position = child_edge_offset[index]; position < child_edge_offset[index + 1]; ++position)
+			{
+				std::size_t row = child_edges[position];
+				tsk_id_t parent = edges.parent[row];
+				
+				removed[row - start] = 1;
+				removed_count++;
+				
+				if ((parent >= (tsk_id_t)base_node) && (--edges_as_parent[parent - base_node] == 0) && !pinned[parent - base_node])
+					childless.emplace_back(parent - base_node);
+			}
+		}
+	}
+	
+	// collapse the unary chains; the edge above a collapsed node is removed, and the edge below it is re-pointed
+	if (p_collapse_unary)
+	{
+		double sequence_length = p_tables->sequence_length;
+		
+		auto collapsible = [&](tsk_id_t p_node) {
+			if (p_node < (tsk_id_t)base_node)
+				return false;
+			
+			std::size_t index = p_node - base_node;
+			
+			if (pinned[index] || (edges_as_parent[index] != 1) || (child_edge_offset[index + 1] - child_edge_offset[index] != 1))
+				return false;
+			
+			std::size_t row = child_edges[child_edge_offset[index]];
+			
+			return ((edges.left[row] == 0.0) && (edges.right[row] == sequence_length));
+		};
+		
+		for (std::size_t row = start; row < num_edges; ++row)
+		{
+			if (removed[row - start])
+				continue;
+			
+			if (collapsible(edges.child[row]))
+			{
+				removed[row - start] = 1;
+				removed_count++;
+				continue;
+			}
+			
+			tsk_id_t parent = edges.parent[row];
+			
+			while (collapsible(parent))
+				parent = edges.parent[child_edges[child_edge_offset[parent - base_node]]];
+			
+			edges.parent[row] = parent;
+		}
+	}
+	
+	if (removed_count == 0)
+		return;
+	
+	// compact the surviving new edges, in their original order
+	std::size_t kept = start;
+	
+	for (std::size_t row = start; row < num_edges; ++row)
+	{
+		if (removed[row - start])
+			continue;
+		
+		edges.left[kept] = edges.left[row];
+		edges.right[kept] = edges.right[row];
+		edges.parent[kept] = edges.parent[row];
+		edges.child[kept] = edges.child[row];
+		kept++;
+	}
+	
+	int ret = tsk_edge_table_truncate(&edges, (tsk_size_t)kept);
+	if (ret < 0) Species::handle_error("tsk_edge_table_truncate", ret);
+}
+
+void Species::SortTreeSequenceTables(tsk_table_collection_t *p_tables, tsk_flags_t p_flags)
+{
+	// p_tables is either tables_ or a copy of it, so simplified_table_position_ applies to it either way
+	const char *error_source = nullptr;
+	int ret = 0;
+	
+	try {
+		ret = slim_sort_tables(p_tables, p_flags, simplified_table_position_, /* p_off_main_thread */ false, &error_source);
+	} catch (std::exception &e) {
+		EIDOS_TERMINATION << "ERROR (Species::SortTreeSequenceTables): (internal error) exception raised during tsk_table_sorter_run(): " << e.what() << "." << EidosTerminate();
+	}
+	if (ret != 0) handle_error(error_source, ret);
+}
+
+void Species::SimplifyTreeSequence(void)
+{
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (Species::SimplifyTreeSequence): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+#endif
+	
+	// a simplification in progress on a worker thread needs to be merged in first
+	if (background_simplify_job_)
+		FinishBackgroundSimplification();
+	
+	if (tables_.nodes.num_rows == 0)
+		return;
+	
+	std::vector<tsk_id_t> samples;
+	
+	// BCH 7/27/2019: We now build a hash table containing all of the entries of remembered_genomes_,
+	// so that the find() operations in the loop below can be done in constant time instead of O(N) time.
+	// We need to be able to find out the index of an entry, in remembered_genomes_, once we have found it;
+	// that is what the mapped value provides, whereas the key value is the tsk_id_t we need to find below.
+	// We do all this inside a block so the map gets deallocated as soon as possible, to minimize footprint.
+	{
+#if EIDOS_ROBIN_HOOD_HASHING
+		robin_hood::unordered_flat_map<tsk_id_t, uint32_t> remembered_genomes_lookup;
+		//typedef robin_hood::pair<tsk_id_t, uint32_t> MAP_PAIR;
+#elif STD_UNORDERED_MAP_HASHING
+		std::unordered_map<tsk_id_t, uint32_t> remembered_genomes_lookup;
+		//typedef std::pair<tsk_id_t, uint32_t> MAP_PAIR;
+#endif
+		
+		// the remembered_genomes_ come first in the list of samples
+		uint32_t index = 0;
+		
+		for (tsk_id_t sid : remembered_genomes_)
+		{
+			samples.emplace_back(sid);
+			remembered_genomes_lookup.emplace(sid, index);
+			index++;
+		}
+		
+		// and then come all the genomes of the extant individuals
+		tsk_id_t newValueInNodeTable = (tsk_id_t)remembered_genomes_.size();
+		
+		for (auto it : population_.subpops_)
+		{
+			std::vector<Genome *> &subpopulationGenomes = it.second->parent_genomes_;
+			
+			for (Genome *genome : subpopulationGenomes)
 			{
 				tsk_id_t M = genome->tsk_node_id_;
 				
@@ -4197,6 +4956,9 @@ void Species::SimplifyTreeSequence(void)
 		}
 	}
 	
+	// drop new edges that simplify would discard anyway, so they need not be sorted and simplified
+	slim_prune_new_edges(&tables_, simplified_table_position_, samples, retain_coalescent_only_);
+	
 	// the tables need to have a population table to be able to sort it
 	WritePopulationTable(&tables_);
 	
@@ -4211,31 +4973,7 @@ void Species::SimplifyTreeSequence(void)
 		flags = 0;
 #endif
 		
-#if 0
-		// sort the tables using tsk_table_collection_sort() to get the default behavior
-		int ret = tsk_table_collection_sort(&tables_, /* edge_start */ NULL, /* flags */ flags);
-		if (ret < 0) handle_error("tsk_table_collection_sort", ret);
-#else
-		// sort the tables using our own custom edge sorter, for additional speed through inlining of the comparison function
-		// see https://github.com/tskit-dev/tskit/pull/627, https://github.com/tskit-dev/tskit/pull/711
-		// FIXME for additional speed we could perhaps be smart about only sorting the portions of the edge table
-		// that need it, but the tricky thing is that all the old stuff has to be at the bottom of the table, not the top...
-		tsk_table_sorter_t sorter;
-		int ret = tsk_table_sorter_init(&sorter, &tables_, /* flags */ flags);
-		if (ret != 0) handle_error("tsk_table_sorter_init", ret);
-		
-		sorter.sort_edges = slim_sort_edges;
-		
-		try {
-			ret = tsk_table_sorter_run(&sorter, NULL);
-		} catch (std::exception &e) {
-			EIDOS_TERMINATION << "ERROR (Species::SimplifyTreeSequence): (internal error) exception raised during tsk_table_sorter_run(): " << e.what() << "." << EidosTerminate();
-		}
-		if (ret != 0) handle_error("tsk_table_sorter_run", ret);
-		
-		tsk_table_sorter_free(&sorter);
-		if (ret != 0) handle_error("tsk_table_sorter_free", ret);
-#endif
+		SortTreeSequenceTables(&tables_, flags);
 	}
 	
 	// remove redundant sites we added
@@ -4266,118 +5004,837 @@ void Species::SimplifyTreeSequence(void)
 	// reset current position, used to rewind individuals that are rejected by modifyChild()
 	RecordTablePosition();
 	
+	// the simplified tables are sorted, so the next sort only needs to handle rows added after this point
+	tsk_table_collection_record_num_rows(&tables_, &simplified_table_position_);
+	
 	// and reset our elapsed time since last simplification, for auto-simplification
 	simplify_elapsed_ = 0;
 	
-	// as a side effect of simplification, update a "model has coalesced" flag that the user can consult, if requested
+	// as a side effect of simplification, update a "model has coalesced" flag that the user can consult, if requested; when
+	// tracking coalescence tracts, this relabels the positions that have coalesced, so tracts merge even if nobody checks
 	if (running_coalescence_checks_)
-		CheckCoalescenceAfterSimplification();
+	{
+		if (tracking_coalescence_)
+			last_coalescence_state_ = CheckCoalescence();
+		else
+			CheckCoalescenceAfterSimplification();
+	}
 }
 
-void Species::CheckCoalescenceAfterSimplification(void)
+// Background simplification.  StartBackgroundSimplification() takes a snapshot of tables_ and hands it to a worker thread,
+// which sorts and simplifies it while the simulation continues to record into tables_.  FinishBackgroundSimplification()
+// then joins the worker and builds the new tables_: the simplified snapshot, followed by the rows recorded since the
+// snapshot with their node references remapped.  This is valid because rows recorded since the snapshot only refer to
+// nodes of genomes that were alive at the snapshot (which are samples, and so survive simplification) or to nodes recorded
+// since.  Individuals are only added to tables_ by AddIndividualsToTable(), which therefore finishes any job in progress
+// first; SimplifyTreeSequence() does too, so explicit simplification and output see the merged tables.  The cost is the
+// memory for the snapshot copy, and that the coalescence state is updated at the merge, not at the snapshot.
+void Species::StartBackgroundSimplification(void)
 {
 #if DEBUG
-	if (!recording_tree_ || !running_coalescence_checks_)
-		EIDOS_TERMINATION << "ERROR (Species::CheckCoalescenceAfterSimplification): (internal error) coalescence check called with recording or checking off." << EidosTerminate();
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (Species::StartBackgroundSimplification): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
 #endif
 	
-	// Copy the table collection; Jerome says this is unnecessary since tsk_table_collection_build_index()
-	// does not modify the core information in the table collection, but just adds some separate indices.
-	// However, we also need to add a population table, so really it is best to make a copy I think.
-	tsk_table_collection_t tables_copy;
-	int ret;
+	// only one job runs at a time; if the previous one is still running we wait for it here
+	if (background_simplify_job_)
+		FinishBackgroundSimplification();
 	
-	ret = tsk_table_collection_copy(&tables_, &tables_copy, 0);
-	if (ret < 0) handle_error("tsk_table_collection_copy", ret);
+	simplify_elapsed_ = 0;
 	
-	// Our tables copy needs to have a population table now, since this is required to build a tree sequence
-	WritePopulationTable(&tables_copy);
+	// coalescence tracts don't depend on the tables, so they are relabeled now rather than when the job is merged
+	if (running_coalescence_checks_ && tracking_coalescence_)
+		last_coalescence_state_ = CheckCoalescence();
 	
-	ret = tsk_table_collection_build_index(&tables_copy, 0);
-	if (ret < 0) handle_error("tsk_table_collection_build_index", ret);
+	if (tables_.nodes.num_rows == 0)
+		return;
 	
-	tsk_treeseq_t ts;
+	BackgroundSimplifyJob *job = new BackgroundSimplifyJob();
 	
-	ret = tsk_treeseq_init(&ts, &tables_copy, 0);
-	if (ret < 0) handle_error("tsk_treeseq_init", ret);
+	// collect the samples just as SimplifyTreeSequence() does, remembered genomes first; we don't renumber the genomes'
+	// tsk_node_id_ here, since they still refer to tables_ until the job is finished
+	{
+#if EIDOS_ROBIN_HOOD_HASHING
+		robin_hood::unordered_flat_set<tsk_id_t> remembered_genomes_lookup;
+#elif STD_UNORDERED_MAP_HASHING
+		std::unordered_set<tsk_id_t> remembered_genomes_lookup;
+#endif
+		
+		for (tsk_id_t sid : remembered_genomes_)
+		{
+			job->samples_.emplace_back(sid);
+			remembered_genomes_lookup.emplace(sid);
+		}
+		
+		for (auto it : population_.subpops_)
+		{
+			std::vector<Genome *> &subpopulationGenomes = it.second->parent_genomes_;
+			
+			for (Genome *genome : subpopulationGenomes)
+			{
+				tsk_id_t M = genome->tsk_node_id_;
+				
+				if (remembered_genomes_lookup.find(M) == remembered_genomes_lookup.end())
+					job->samples_.emplace_back(M);
+				
+				if (running_coalescence_checks_ && !tracking_coalescence_)
+					job->extant_nodes_.emplace_back(M);
+			}
+		}
+	}
 	
-	// Collect a vector of all extant genome node IDs
-	std::vector<tsk_id_t> all_extant_nodes;
+	// the automatic simplification interval is adjusted from the table sizes before pruning, as in CheckAutoSimplification()
+	job->old_table_size_ = (uint64_t)tables_.nodes.num_rows;
+	job->old_table_size_ += (uint64_t)tables_.edges.num_rows;
+	job->old_table_size_ += (uint64_t)tables_.sites.num_rows;
+	job->old_table_size_ += (uint64_t)tables_.mutations.num_rows;
 	
-	for (auto subpop_iter : population_.subpops_)
+	// drop new edges that simplify would discard anyway, as SimplifyTreeSequence() does; this changes tables_, so the
+	// position for rewinding rejected children has to be reset, as it is after simplifying
+	slim_prune_new_edges(&tables_, simplified_table_position_, job->samples_, retain_coalescent_only_);
+	RecordTablePosition();
+	
+	// the tables need to have a population table to be able to sort it
+	WritePopulationTable(&tables_);
+	
+	int ret = tsk_table_collection_copy(&tables_, &job->tables_, 0);
+	if (ret < 0)
 	{
-		Subpopulation *subpop = subpop_iter.second;
-		std::vector<Genome *> &genomes = subpop->parent_genomes_;
-		slim_popsize_t genome_count = subpop->parent_subpop_size_ * 2;
-		Genome **genome_ptr = genomes.data();
-		
-		for (slim_popsize_t genome_index = 0; genome_index < genome_count; ++genome_index)
-			all_extant_nodes.emplace_back(genome_ptr[genome_index]->tsk_node_id_);
+		delete job;
+		handle_error("tsk_table_collection_copy", ret);
 	}
 	
-	int64_t extant_node_count = (int64_t)all_extant_nodes.size();
+	tsk_table_collection_record_num_rows(&tables_, &job->snapshot_position_);
+	job->sorted_position_ = simplified_table_position_;
+	job->node_map_.resize(tables_.nodes.num_rows, TSK_NULL);
 	
-	// Iterate through the trees to check coalescence; this is a bit tricky because of keeping first-gen nodes and nodes
-	// in remembered individuals.  We use the sparse tree's "tracked samples" feature, tracking extant individuals
-	// only, to find out whether all extant individuals are under a single root (coalesced), or under multiple roots
-	// (not coalesced).  Doing this requires a scan through all the roots at each site, which is very slow if we have
-	// indeed coalesced, but if we are far from coalescence we will usually be able to determine that in the scan of the
-	// first tree (because every site will probably be uncoalesced), which seems like the right performance trade-off.
-	tsk_tree_t t;
-	bool fully_coalesced = true;
+	// use the same flags as SimplifyTreeSequence()
+	job->sort_flags_ = TSK_NO_CHECK_INTEGRITY;
+#if DEBUG
+	job->sort_flags_ = 0;
+#endif
 	
-	tsk_tree_init(&t, &ts, 0);
-	if (ret < 0) handle_error("tsk_tree_init", ret);
+	job->simplify_flags_ = TSK_SIMPLIFY_FILTER_SITES | TSK_SIMPLIFY_FILTER_INDIVIDUALS | TSK_SIMPLIFY_KEEP_INPUT_ROOTS;
+	if (!retain_coalescent_only_) job->simplify_flags_ |= TSK_SIMPLIFY_KEEP_UNARY;
 	
-	tsk_tree_set_tracked_samples(&t, extant_node_count, all_extant_nodes.data());
-	if (ret < 0) handle_error("tsk_tree_set_tracked_samples", ret);
+	job->finished_.store(false);
 	
-	ret = tsk_tree_first(&t);
-	if (ret < 0) handle_error("tsk_tree_first", ret);
+	try {
+		job->thread_ = std::thread(_RunBackgroundSimplification, job);
+	} catch (std::exception &e) {
+		tsk_table_collection_free(&job->tables_);
+		delete job;
+		EIDOS_TERMINATION << "ERROR (Species::StartBackgroundSimplification): could not start a thread for background simplification: " << e.what() << "." << EidosTerminate();
+	}
+	
+	background_simplify_job_ = job;
+}
+
+void Species::_RunBackgroundSimplification(BackgroundSimplifyJob *p_job)
+{
+	// this runs on the worker thread; it touches nothing but p_job, and must not raise, so errors are left in p_job
+	try {
+		int ret = slim_sort_tables(&p_job->tables_, p_job->sort_flags_, p_job->sorted_position_, /* p_off_main_thread */ true, &p_job->error_source_);
+		
+		if (ret == 0)
+		{
+			ret = tsk_table_collection_deduplicate_sites(&p_job->tables_, 0);
+			if (ret < 0) p_job->error_source_ = "tsk_table_collection_deduplicate_sites";
+		}
+		
+		if (ret == 0)
+		{
+			ret = tsk_table_collection_simplify(&p_job->tables_, p_job->samples_.data(), (tsk_size_t)p_job->samples_.size(), p_job->simplify_flags_, p_job->node_map_.data());
+			if (ret != 0) p_job->error_source_ = "tsk_table_collection_simplify";
+		}
+		
+		p_job->error_ = ret;
+	} catch (std::exception &e) {
+		p_job->exception_message_ = e.what();
+		if (p_job->exception_message_.empty())
+			p_job->exception_message_ = "unknown exception";
+	} catch (...) {
+		p_job->exception_message_ = "unknown exception";
+	}
+	
+	p_job->finished_.store(true);
+}
+
+void Species::FinishBackgroundSimplification(void)
+{
+	BackgroundSimplifyJob *job = background_simplify_job_;
+	
+	if (!job)
+		return;
+	
+	background_simplify_job_ = nullptr;
+	job->thread_.join();
+	
+	if ((job->error_ != 0) || !job->exception_message_.empty())
+	{
+		std::string message = job->exception_message_;
+		int error = job->error_;
+		const char *error_source = job->error_source_;
+		
+		tsk_table_collection_free(&job->tables_);
+		delete job;
+		
+		if (!message.empty())
+			EIDOS_TERMINATION << "ERROR (Species::FinishBackgroundSimplification): (internal error) exception raised during background simplification: " << message << "." << EidosTerminate();
+		
+		handle_error(error_source, error);
+	}
+	
+	tsk_table_collection_t &merged = job->tables_;
+	const tsk_bookmark_t &snapshot = job->snapshot_position_;
+	tsk_id_t simplified_node_count = (tsk_id_t)merged.nodes.num_rows;
+	tsk_id_t simplified_site_count = (tsk_id_t)merged.sites.num_rows;
+	tsk_id_t snapshot_node_count = (tsk_id_t)snapshot.nodes;
+	tsk_id_t current_node_count = (tsk_id_t)tables_.nodes.num_rows;
+	int ret;
+	
+	// snapshot nodes go through the simplification node map; nodes recorded since then are appended after the simplified nodes
+	auto map_node = [&](tsk_id_t p_node) -> tsk_id_t {
+		if ((p_node >= 0) && (p_node < snapshot_node_count))
+			return job->node_map_[p_node];
+		if ((p_node >= snapshot_node_count) && (p_node < current_node_count))
+			return p_node - snapshot_node_count + simplified_node_count;
+		return TSK_NULL;
+	};
+	
+	// the tree-based coalescence check looks at the simplified snapshot, so it lags the current state by the duration of the job
+	if (running_coalescence_checks_ && !tracking_coalescence_)
+	{
+		for (tsk_id_t &node : job->extant_nodes_)
+			node = job->node_map_[node];
+		
+		CheckCoalescenceAfterSimplification(&merged, &job->extant_nodes_);
+	}
+	
+	// the simplified snapshot is sorted, so the next sort only needs to handle rows appended after it
+	tsk_table_collection_record_num_rows(&merged, &simplified_table_position_);
+	
+	// append the rows recorded since the snapshot, remapping their references
+	{
+		tsk_node_table_t &nodes = tables_.nodes;
+		
+		for (tsk_size_t row = snapshot.nodes; row < nodes.num_rows; ++row)
+		{
+			ret = tsk_node_table_add_row(&merged.nodes, nodes.flags[row], nodes.time[row], nodes.population[row], nodes.individual[row],
+				nodes.metadata + nodes.metadata_offset[row], nodes.metadata_offset[row + 1] - nodes.metadata_offset[row]);
+			if (ret < 0) handle_error("tsk_node_table_add_row", ret);
+		}
+	}
+	{
+		tsk_edge_table_t &edges = tables_.edges;
+		
+		for (tsk_size_t row = snapshot.edges; row < edges.num_rows; ++row)
+		{
+			tsk_id_t parent = map_node(edges.parent[row]);
+			tsk_id_t child = map_node(edges.child[row]);
+			
+			if ((parent == TSK_NULL) || (child == TSK_NULL))
+				EIDOS_TERMINATION << "ERROR (Species::FinishBackgroundSimplification): (internal error) an edge recorded during background simplification refers to a node that was simplified away." << EidosTerminate();
+			
+			ret = tsk_edge_table_add_row(&merged.edges, edges.left[row], edges.right[row], parent, child, NULL, 0);
+			if (ret < 0) handle_error("tsk_edge_table_add_row", ret);
+		}
+	}
+	{
+		tsk_site_table_t &sites = tables_.sites;
+		
+		for (tsk_size_t row = snapshot.sites; row < sites.num_rows; ++row)
+		{
+			ret = tsk_site_table_add_row(&merged.sites, sites.position[row],
+				sites.ancestral_state + sites.ancestral_state_offset[row], sites.ancestral_state_offset[row + 1] - sites.ancestral_state_offset[row],
+				sites.metadata + sites.metadata_offset[row], sites.metadata_offset[row + 1] - sites.metadata_offset[row]);
+			if (ret < 0) handle_error("tsk_site_table_add_row", ret);
+		}
+	}
+	{
+		tsk_mutation_table_t &mutations = tables_.mutations;
+		tsk_id_t site_offset = simplified_site_count - (tsk_id_t)snapshot.sites;
+		
+		for (tsk_size_t row = snapshot.mutations; row < mutations.num_rows; ++row)
+		{
+			tsk_id_t node = map_node(mutations.node[row]);
+			
+			if (node == TSK_NULL)
+				EIDOS_TERMINATION << "ERROR (Species::FinishBackgroundSimplification): (internal error) a mutation recorded during background simplification refers to a node that was simplified away." << EidosTerminate();
+			
+			// mutations recorded since the snapshot are always at sites recorded since the snapshot
+			ret = tsk_mutation_table_add_row(&merged.mutations, mutations.site[row] + site_offset, node, TSK_NULL, mutations.time[row],
+				mutations.derived_state + mutations.derived_state_offset[row], mutations.derived_state_offset[row + 1] - mutations.derived_state_offset[row],
+				mutations.metadata + mutations.metadata_offset[row], mutations.metadata_offset[row + 1] - mutations.metadata_offset[row]);
+			if (ret < 0) handle_error("tsk_mutation_table_add_row", ret);
+		}
+	}
+	
+	// the merged tables replace tables_; tsk_table_collection_t owns its buffers through pointers, so it can simply be moved
+	ret = tsk_table_collection_free(&tables_);
+	if (ret < 0) handle_error("tsk_table_collection_free", ret);
+	
+	tables_ = merged;
+	
+	// renumber the genomes' node ids to refer to the merged tables
+	for (auto it : population_.subpops_)
+	{
+		Subpopulation *subpop = it.second;
+		
+		for (Genome *genome : subpop->parent_genomes_)
+			genome->tsk_node_id_ = map_node(genome->tsk_node_id_);
+		for (Genome *genome : subpop->child_genomes_)
+			genome->tsk_node_id_ = map_node(genome->tsk_node_id_);
+		for (Genome *genome : subpop->nonWF_offspring_genomes_)
+			genome->tsk_node_id_ = map_node(genome->tsk_node_id_);
+	}
+	
+	// update map of remembered_genomes_, which are now the first n entries in the node table
+	for (tsk_id_t i = 0; i < (tsk_id_t)remembered_genomes_.size(); i++)
+		remembered_genomes_[i] = i;
+	
+	// remake our hash table of pedigree ids to tsk_ids, since simplify reordered the individuals table
+	BuildTabledIndividualsHash(&tables_, &tabled_individuals_hash_);
+	
+	// reset current position, used to rewind individuals that are rejected by modifyChild()
+	RecordTablePosition();
+	
+	// adjust the automatic simplification interval from the table sizes before and after simplifying the snapshot
+	if ((simplification_interval_ == -1) && !std::isinf(simplification_ratio_))
+	{
+		uint64_t new_table_size = (uint64_t)simplified_table_position_.nodes;
+		new_table_size += (uint64_t)simplified_table_position_.edges;
+		new_table_size += (uint64_t)simplified_table_position_.sites;
+		new_table_size += (uint64_t)simplified_table_position_.mutations;
+		
+		AdjustSimplificationInterval(job->old_table_size_, new_table_size);
+	}
+	
+	delete job;
+}
+
+void Species::DiscardBackgroundSimplification(void)
+{
+	// wait for a job in progress and throw its result away; used when tables_ is being freed
+	BackgroundSimplifyJob *job = background_simplify_job_;
+	
+	if (!job)
+		return;
+	
+	background_simplify_job_ = nullptr;
+	job->thread_.join();
+	
+	tsk_table_collection_free(&job->tables_);
+	delete job;
+}
+
+void Species::CheckCoalescenceAfterSimplification(tsk_table_collection_t *p_tables, std::vector<tsk_id_t> *p_extant_nodes)
+{
+#if DEBUG
+	if (!recording_tree_ || !running_coalescence_checks_)
+		EIDOS_TERMINATION << "ERROR (Species::CheckCoalescenceAfterSimplification): (internal error) coalescence check called with recording or checking off." << EidosTerminate();
+#endif
+	
+	// Copy the table collection; Jerome says this is unnecessary since tsk_table_collection_build_index()
+	// does not modify the core information in the table collection, but just adds some separate indices.
+	// However, we also need to add a population table, so really it is best to make a copy I think.
+	// By default we check tables_ and the genomes alive now; background simplification passes its simplified tables
+	// and the nodes of the genomes that were alive when its snapshot was taken.
+	tsk_table_collection_t tables_copy;
+	int ret;
+	
+	if (!p_tables)
+		p_tables = &tables_;
+	
+	ret = tsk_table_collection_copy(p_tables, &tables_copy, 0);
+	if (ret < 0) handle_error("tsk_table_collection_copy", ret);
+	
+	// Our tables copy needs to have a population table now, since this is required to build a tree sequence
+	WritePopulationTable(&tables_copy);
+	
+	ret = tsk_table_collection_build_index(&tables_copy, 0);
+	if (ret < 0) handle_error("tsk_table_collection_build_index", ret);
+	
+	tsk_treeseq_t ts;
+	
+	ret = tsk_treeseq_init(&ts, &tables_copy, 0);
+	if (ret < 0) handle_error("tsk_treeseq_init", ret);
+	
+	// Collect a vector of all extant genome node IDs
+	std::vector<tsk_id_t> extant_nodes_buffer;
+	std::vector<tsk_id_t> &all_extant_nodes = (p_extant_nodes ? *p_extant_nodes : extant_nodes_buffer);
+	
+	if (!p_extant_nodes)
+	{
+		for (auto subpop_iter : population_.subpops_)
+		{
+			Subpopulation *subpop = subpop_iter.second;
+			std::vector<Genome *> &genomes = subpop->parent_genomes_;
+			slim_popsize_t genome_count = subpop->parent_subpop_size_ * 2;
+			Genome **genome_ptr = genomes.data();
+			
+			for (slim_popsize_t genome_index = 0; genome_index < genome_count; ++genome_index)
+				all_extant_nodes.emplace_back(genome_ptr[genome_index]->tsk_node_id_);
+		}
+	}
+	
+	int64_t extant_node_count = (int64_t)all_extant_nodes.size();
+	
+	// Iterate through the trees to check coalescence; this is a bit tricky because of keeping first-gen nodes and nodes
+	// in remembered individuals.  We use the sparse tree's "tracked samples" feature, tracking extant individuals
+	// only, to find out whether all extant individuals are under a single root (coalesced), or under multiple roots
+	// (not coalesced).  Doing this requires a scan through all the roots at each site, which is very slow if we have
+	// indeed coalesced, but if we are far from coalescence we will usually be able to determine that in the scan of the
+	// first tree (because every site will probably be uncoalesced), which seems like the right performance trade-off.
+	tsk_tree_t t;
+	bool fully_coalesced = true;
+	
+	tsk_tree_init(&t, &ts, 0);
+	if (ret < 0) handle_error("tsk_tree_init", ret);
+	
+	tsk_tree_set_tracked_samples(&t, extant_node_count, all_extant_nodes.data());
+	if (ret < 0) handle_error("tsk_tree_set_tracked_samples", ret);
+	
+	ret = tsk_tree_first(&t);
+	if (ret < 0) handle_error("tsk_tree_first", ret);
+	
+	for (; (ret == 1) && fully_coalesced; ret = tsk_tree_next(&t))
+	{
+#if 0
+		// If we didn't keep first-generation lineages, or remember genomes, >1 root would mean not coalesced
+		if (tsk_tree_get_num_roots(&t) > 1)
+		{
+			fully_coalesced = false;
+			break;
+		}
+#else
+		// But we do have retained/remembered nodes in the tree, so we need to be smarter; nodes for the first gen
+		// ancestors will always be present, giving >1 root in each tree even when we have coalesced, and the
+		// remembered individuals may mean that more than one root node has children, too, even when we have
+		// coalesced.  What we need to know is: how many roots are there that have >0 *extant* children?  This
+		// is what we use the tracked samples for; they are extant individuals.
+		for (tsk_id_t root = tsk_tree_get_left_root(&t); root != TSK_NULL; root = t.right_sib[root])
+		{
+			int64_t num_tracked = t.num_tracked_samples[root];
+			
+			if ((num_tracked > 0) && (num_tracked < extant_node_count))
+			{
+				fully_coalesced = false;
+				break;
+			}
+		}
+#endif
+	}
+	if (ret < 0) handle_error("tsk_tree_next", ret);
+	
+	ret = tsk_tree_free(&t);
+	if (ret < 0) handle_error("tsk_tree_free", ret);
+	
+	ret = tsk_treeseq_free(&ts);
+	if (ret < 0) handle_error("tsk_treeseq_free", ret);
+	
+	if (&tables_copy != &tables_)
+	{
+		ret = tsk_table_collection_free(&tables_copy);
+		if (ret < 0) handle_error("tsk_table_collection_free", ret);
+	}
+	
+	//std::cout << "tick " << community->Tick() << ": fully_coalesced == " << (fully_coalesced ? "TRUE" : "false") << std::endl;
+	last_coalescence_state_ = fully_coalesced;
+}
+
+// Coalescence tracking, for trackCoalescence=T.  Rather than inspecting the trees after each simplification, as
+// CheckCoalescenceAfterSimplification() does, we track, for every genome, the root of the tree sequence that each tract of
+// the genome descends from.  RecordNewGenome() calls RecordCoalescenceTracts() to build a new genome's tracts from those of
+// its parents, following the same breakpoints as its edges; a genome with no parents is a root itself, labeled with its
+// genome id.  The population has coalesced when all extant genomes descend from the same root at every position, which is
+// what the trees would show after simplification (roots are kept by simplification, so the extant genomes are under more
+// than one root exactly when they have not coalesced).  Once all extant genomes agree at a position, all of their
+// descendants will too, so CheckCoalescence() relabels such positions with a common label, and tracts then merge away; it
+// is called at each simplification as well as by treeSeqCoalesced().  Until a position has coalesced, though, the number of
+// tracts per genome grows with the recombination rate, the chromosome length, and the elapsed ticks, and every new genome
+// copies its parents' tracts; so this is opt-in, and is best for short chromosomes or for checking coalescence very often.
+void Species::RecordCoalescenceTracts(Genome *p_new_genome, const Genome *p_initial_parental_genome, const Genome *p_second_parental_genome, const std::vector<slim_position_t> *p_breakpoints, size_t p_breakpoint_count)
+{
+	std::vector<CoalescenceTract> &tracts = coalescence_tracts_[p_new_genome];	// a recycled genome's entry is reused
+	
+	tracts.clear();
+	
+	if (!p_initial_parental_genome)
+	{
+		tracts.emplace_back(CoalescenceTract{0, p_new_genome->genome_id_});
+		return;
+	}
+	
+	if (!p_second_parental_genome || (p_breakpoint_count == 0))
+	{
+		tracts = coalescence_tracts_[p_initial_parental_genome];
+		return;
+	}
+	
+	// take the tracts of each parent over the intervals between breakpoints, merging adjacent tracts with the same root
+	slim_position_t left = 0;
+	bool polarity = true;
+	
+	for (size_t i = 0; i <= p_breakpoint_count; i++)
+	{
+		slim_position_t right = ((i < p_breakpoint_count) ? (*p_breakpoints)[i] : chromosome_->last_position_ + 1);
+		
+		if (right > left)
+		{
+			const std::vector<CoalescenceTract> &source = coalescence_tracts_[polarity ? p_initial_parental_genome : p_second_parental_genome];
+			auto tract_iter = std::upper_bound(source.begin(), source.end(), left, [](slim_position_t position, const CoalescenceTract &tract) { return position < tract.left_; });
+			
+			if (tract_iter != source.begin())
+				--tract_iter;
+			
+			for (; (tract_iter != source.end()) && (tract_iter->left_ < right); ++tract_iter)
+				if (tracts.empty() || (tracts.back().root_ != tract_iter->root_))
+					tracts.emplace_back(CoalescenceTract{std::max(tract_iter->left_, left), tract_iter->root_});
+			
+			left = right;
+		}
+		
+		polarity = !polarity;
+	}
+}
+
+void Species::SeedCoalescenceTractsFromTables(void)
+{
+#if DEBUG
+	if (!recording_tree_ || !tracking_coalescence_)
+		EIDOS_TERMINATION << "ERROR (Species::SeedCoalescenceTractsFromTables): (internal error) coalescence tracking called with recording or checking off." << EidosTerminate();
+#endif
+	
+	// After a tree sequence is loaded, the extant genomes already have ancestry, and their tracts come from the trees: each
+	// tract is labeled with the root it descends from (with labels below -1, so they can't collide with genome ids).  We
+	// work on a copy of the tables, since we need a population table and an index to build a tree sequence, and we mark
+	// only the extant genomes as samples, so that the sample lists of the roots give us exactly the genomes we need.
+	tsk_table_collection_t tables_copy;
+	int ret;
+	
+	ret = tsk_table_collection_copy(&tables_, &tables_copy, 0);
+	if (ret < 0) handle_error("tsk_table_collection_copy", ret);
+	
+	WritePopulationTable(&tables_copy);
+	
+	std::vector<Genome *> node_to_genome(tables_copy.nodes.num_rows, nullptr);
+	
+	for (tsk_size_t node = 0; node < tables_copy.nodes.num_rows; ++node)
+		tables_copy.nodes.flags[node] &= ~TSK_NODE_IS_SAMPLE;
+	
+	coalescence_tracts_.clear();
+	
+	for (auto subpop_iter : population_.subpops_)
+	{
+		for (Genome *genome : subpop_iter.second->parent_genomes_)
+		{
+			if ((genome->tsk_node_id_ >= 0) && (genome->tsk_node_id_ < (tsk_id_t)node_to_genome.size()))
+			{
+				node_to_genome[genome->tsk_node_id_] = genome;
+				tables_copy.nodes.flags[genome->tsk_node_id_] |= TSK_NODE_IS_SAMPLE;
+			}
+		}
+	}
+	
+	ret = tsk_table_collection_build_index(&tables_copy, 0);
+	if (ret < 0) handle_error("tsk_table_collection_build_index", ret);
+	
+	tsk_treeseq_t ts;
+	
+	ret = tsk_treeseq_init(&ts, &tables_copy, 0);
+	if (ret < 0) handle_error("tsk_treeseq_init", ret);
+	
+	const tsk_id_t *samples = tsk_treeseq_get_samples(&ts);
+	tsk_tree_t t;
+	
+	ret = tsk_tree_init(&t, &ts, TSK_SAMPLE_LISTS);
+	if (ret < 0) handle_error("tsk_tree_init", ret);
+	
+	for (ret = tsk_tree_first(&t); ret == TSK_TREE_OK; ret = tsk_tree_next(&t))
+	{
+		slim_position_t left = (slim_position_t)t.interval.left;
+		
+		for (tsk_id_t root = tsk_tree_get_left_root(&t); root != TSK_NULL; root = t.right_sib[root])
+		{
+			tsk_id_t sample_index = t.left_sample[root];
+			
+			if (sample_index == TSK_NULL)
+				continue;
+			
+			tsk_id_t stop_index = t.right_sample[root];
+			slim_genomeid_t label = -2 - (slim_genomeid_t)root;
+			
+			while (true)
+			{
+				std::vector<CoalescenceTract> &tracts = coalescence_tracts_[node_to_genome[samples[sample_index]]];
+				
+				if (tracts.empty() || (tracts.back().root_ != label))
+					tracts.emplace_back(CoalescenceTract{left, label});
+				
+				if (sample_index == stop_index)
+					break;
+				
+				sample_index = t.next_sample[sample_index];
+			}
+		}
+	}
+	if (ret < 0) handle_error("tsk_tree_next", ret);
+	
+	ret = tsk_tree_free(&t);
+	if (ret < 0) handle_error("tsk_tree_free", ret);
+	
+	ret = tsk_treeseq_free(&ts);
+	if (ret < 0) handle_error("tsk_treeseq_free", ret);
+	
+	ret = tsk_table_collection_free(&tables_copy);
+	if (ret < 0) handle_error("tsk_table_collection_free", ret);
+}
+
+bool Species::CheckCoalescence(void)
+{
+#if DEBUG
+	if (!recording_tree_ || !tracking_coalescence_)
+		EIDOS_TERMINATION << "ERROR (Species::CheckCoalescence): (internal error) coalescence check called with recording or tracking off." << EidosTerminate();
+#endif
+	
+	// Collect the extant genomes; with none, we follow the old tree-based check, which found no uncoalesced root
+	std::vector<Genome *> extant_genomes;
+	
+	for (auto subpop_iter : population_.subpops_)
+	{
+		Subpopulation *subpop = subpop_iter.second;
+		Genome **genome_ptr = subpop->parent_genomes_.data();
+		slim_popsize_t genome_count = subpop->parent_subpop_size_ * 2;
+		
+		for (slim_popsize_t genome_index = 0; genome_index < genome_count; ++genome_index)
+			extant_genomes.emplace_back(genome_ptr[genome_index]);
+	}
+	
+	if (extant_genomes.size() == 0)
+		return true;
+	
+	// Find the intervals where some extant genome's root differs from that of the first extant genome
+	slim_position_t chromosome_end = chromosome_->last_position_ + 1;
+	const std::vector<CoalescenceTract> &reference = coalescence_tracts_[extant_genomes[0]];
+	std::vector<std::pair<slim_position_t, slim_position_t>> disagreements;
+	
+	for (size_t genome_index = 1; genome_index < extant_genomes.size(); ++genome_index)
+	{
+		const std::vector<CoalescenceTract> &tracts = coalescence_tracts_[extant_genomes[genome_index]];
+		size_t ref_index = 0, tract_index = 0;
+		slim_position_t position = 0;
+		
+		while ((ref_index < reference.size()) && (tract_index < tracts.size()))
+		{
+			slim_position_t ref_end = ((ref_index + 1 < reference.size()) ? reference[ref_index + 1].left_ : chromosome_end);
+			slim_position_t tract_end = ((tract_index + 1 < tracts.size()) ? tracts[tract_index + 1].left_ : chromosome_end);
+			slim_position_t end = std::min(ref_end, tract_end);
+			
+			if (reference[ref_index].root_ != tracts[tract_index].root_)
+			{
+				if (disagreements.size() && (disagreements.back().second == position))
+					disagreements.back().second = end;
+				else
+					disagreements.emplace_back(position, end);
+			}
+			
+			position = end;
+			
+			if (ref_end == end)
+				ref_index++;
+			if (tract_end == end)
+				tract_index++;
+		}
+	}
+	
+	if (disagreements.size() > 1)
+	{
+		std::sort(disagreements.begin(), disagreements.end());
+		
+		size_t merged_count = 0;
+		
+		for (size_t index = 1; index < disagreements.size(); ++index)
+		{
+			if (disagreements[index].first <= disagreements[merged_count].second)
+				disagreements[merged_count].second = std::max(disagreements[merged_count].second, disagreements[index].second);
+			else
+				disagreements[++merged_count] = disagreements[index];
+		}
+		
+		disagreements.resize(merged_count + 1);
+	}
+	
+	// Relabel the positions where all extant genomes agree, in those genomes and in any offspring already generated from
+	// them (in child_genomes_ or nonWF_offspring_genomes_), since their tracts descend from the same roots there; the
+	// relabeled tracts go into a new table, which drops the entries of genomes that have been freed since the last check
+	std::unordered_map<const Genome *, std::vector<CoalescenceTract>> relabeled_tracts;
+	
+	auto relabel = [&](Genome *p_genome) {
+		auto tracts_iter = coalescence_tracts_.find(p_genome);
+		
+		if (tracts_iter == coalescence_tracts_.end())
+			return;
+		
+		auto inserted = relabeled_tracts.emplace(p_genome, std::vector<CoalescenceTract>());
+		
+		if (!inserted.second)
+			return;
+		
+		const std::vector<CoalescenceTract> &tracts = tracts_iter->second;
+		std::vector<CoalescenceTract> &relabeled = inserted.first->second;
+		size_t disagreement_index = 0;
+		
+		for (size_t tract_index = 0; tract_index < tracts.size(); ++tract_index)
+		{
+			slim_position_t start = tracts[tract_index].left_;
+			slim_position_t end = ((tract_index + 1 < tracts.size()) ? tracts[tract_index + 1].left_ : chromosome_end);
+			
+			while (start < end)
+			{
+				while ((disagreement_index < disagreements.size()) && (disagreements[disagreement_index].second <= start))
+					disagreement_index++;
+				
+				bool in_disagreement = ((disagreement_index < disagreements.size()) && (disagreements[disagreement_index].first <= start));
+				slim_position_t segment_end = end;
+				slim_genomeid_t root = (in_disagreement ? tracts[tract_index].root_ : -1);
+				
+				if (in_disagreement)
+					segment_end = std::min(end, disagreements[disagreement_index].second);
+				else if (disagreement_index < disagreements.size())
+					segment_end = std::min(end, disagreements[disagreement_index].first);
+				
+				if (relabeled.empty() || (relabeled.back().root_ != root))
+					relabeled.emplace_back(CoalescenceTract{start, root});
+				
+				start = segment_end;
+			}
+		}
+	};
+	
+	for (auto subpop_iter : population_.subpops_)
+	{
+		Subpopulation *subpop = subpop_iter.second;
+		
+		for (Genome *genome : subpop->parent_genomes_)
+			relabel(genome);
+		for (Genome *genome : subpop->child_genomes_)
+			relabel(genome);
+		for (Genome *genome : subpop->nonWF_offspring_genomes_)
+			relabel(genome);
+	}
+	
+	coalescence_tracts_.swap(relabeled_tracts);
+	
+	return (disagreements.size() == 0);
+}
+
+void Species::ComputeTreeSequenceStatistic(EidosGlobalStringID p_statistic, const std::vector<std::vector<tsk_id_t>> &p_sample_sets, bool p_branch_mode, const std::vector<double> &p_windows, std::vector<double> &p_result)
+{
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (Species::ComputeTreeSequenceStatistic): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+#endif
+	
+	// a simplification in progress would leave us computing on tables_ with its unsimplified prefix, so merge it in first
+	if (background_simplify_job_)
+		FinishBackgroundSimplification();
+	
+	// Build a tree sequence from a copy of tables_, prepared as WriteTreeSequence() does for output; the tables need not be
+	// simplified, since every extant genome is a sample in any case.  The tree sequence takes ownership of the copy, so that
+	// tsk_treeseq_init() doesn't make a second one.  Node times are still negative ticks, which branch lengths don't care about.
+	tsk_table_collection_t *tables_copy = (tsk_table_collection_t *)malloc(sizeof(tsk_table_collection_t));
+	int ret;
+	
+	if (!tables_copy)
+		EIDOS_TERMINATION << "ERROR (Species::ComputeTreeSequenceStatistic): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+	
+	ret = tsk_table_collection_copy(&tables_, tables_copy, 0);
+	if (ret < 0) handle_error("tsk_table_collection_copy", ret);
+	
+	WritePopulationTable(tables_copy);
+	SortTreeSequenceTables(tables_copy, TSK_NO_CHECK_INTEGRITY);
+	
+	ret = tsk_table_collection_deduplicate_sites(tables_copy, 0);
+	if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
+	ret = tsk_table_collection_build_index(tables_copy, 0);
+	if (ret < 0) handle_error("tsk_table_collection_build_index", ret);
+	ret = tsk_table_collection_compute_mutation_parents(tables_copy, 0);
+	if (ret < 0) handle_error("tsk_table_collection_compute_mutation_parents", ret);
+	
+	tsk_treeseq_t ts;
+	
+	ret = tsk_treeseq_init(&ts, tables_copy, TSK_TAKE_OWNERSHIP);
+	if (ret < 0) handle_error("tsk_treeseq_init", ret);
+	
+	// flatten the sample sets as tskit wants them
+	std::vector<tsk_size_t> sample_set_sizes;
+	std::vector<tsk_id_t> sample_sets;
+	
+	for (const std::vector<tsk_id_t> &sample_set : p_sample_sets)
+	{
+		sample_set_sizes.emplace_back((tsk_size_t)sample_set.size());
+		sample_sets.insert(sample_sets.end(), sample_set.begin(), sample_set.end());
+	}
+	
+	tsk_size_t num_sample_sets = (tsk_size_t)p_sample_sets.size();
+	tsk_size_t num_windows = (tsk_size_t)p_windows.size() - 1;
+	tsk_flags_t options = TSK_STAT_SPAN_NORMALISE | (p_branch_mode ? TSK_STAT_BRANCH : TSK_STAT_SITE);
 	
-	for (; (ret == 1) && fully_coalesced; ret = tsk_tree_next(&t))
+	switch (p_statistic)
 	{
-#if 0
-		// If we didn't keep first-generation lineages, or remember genomes, >1 root would mean not coalesced
-		if (tsk_tree_get_num_roots(&t) > 1)
+		case gID_treeSeqDiversity:
 		{
-			fully_coalesced = false;
+			p_result.resize(num_windows);
+			ret = tsk_treeseq_diversity(&ts, num_sample_sets, sample_set_sizes.data(), sample_sets.data(), num_windows, p_windows.data(), options, p_result.data());
+			if (ret < 0) handle_error("tsk_treeseq_diversity", ret);
 			break;
 		}
-#else
-		// But we do have retained/remembered nodes in the tree, so we need to be smarter; nodes for the first gen
-		// ancestors will always be present, giving >1 root in each tree even when we have coalesced, and the
-		// remembered individuals may mean that more than one root node has children, too, even when we have
-		// coalesced.  What we need to know is: how many roots are there that have >0 *extant* children?  This
-		// is what we use the tracked samples for; they are extant individuals.
-		for (tsk_id_t root = tsk_tree_get_left_root(&t); root != TSK_NULL; root = t.right_sib[root])
+		case gID_treeSeqDivergence:
 		{
-			int64_t num_tracked = t.num_tracked_samples[root];
+			tsk_id_t index_tuple[2] = {0, 1};
 			
-			if ((num_tracked > 0) && (num_tracked < extant_node_count))
+			p_result.resize(num_windows);
+			ret = tsk_treeseq_divergence(&ts, num_sample_sets, sample_set_sizes.data(), sample_sets.data(), 1, index_tuple, num_windows, p_windows.data(), options, p_result.data());
+			if (ret < 0) handle_error("tsk_treeseq_divergence", ret);
+			break;
+		}
+		case gID_treeSeqFST:
+		{
+			// tskit has no C implementation of Fst; like tskit's Python API, we compute it from the diversity within each
+			// sample set and the divergence between them, as 1 - 2(d1 + d2) / (d1 + d2 + 2 d12), which is NaN if all are zero
+			std::vector<double> diversity(num_windows * 2);
+			std::vector<double> divergence(num_windows);
+			tsk_id_t index_tuple[2] = {0, 1};
+			
+			ret = tsk_treeseq_diversity(&ts, num_sample_sets, sample_set_sizes.data(), sample_sets.data(), num_windows, p_windows.data(), options, diversity.data());
+			if (ret < 0) handle_error("tsk_treeseq_diversity", ret);
+			ret = tsk_treeseq_divergence(&ts, num_sample_sets, sample_set_sizes.data(), sample_sets.data(), 1, index_tuple, num_windows, p_windows.data(), options, divergence.data());
+			if (ret < 0) handle_error("tsk_treeseq_divergence", ret);
+			
+			p_result.resize(num_windows);
+			for (tsk_size_t window = 0; window < num_windows; ++window)
 			{
-				fully_coalesced = false;
-				break;
+				double within = diversity[window * 2] + diversity[window * 2 + 1];
+				
+				p_result[window] = 1.0 - 2.0 * within / (within + 2.0 * divergence[window]);
 			}
+			break;
 		}
-#endif
+		case gID_treeSeqSFS:
+		{
+			// the ancestral state of every site is known, so the spectrum is polarised; it has one entry per derived allele count
+			p_result.resize(num_windows * (sample_set_sizes[0] + 1));
+			ret = tsk_treeseq_allele_frequency_spectrum(&ts, num_sample_sets, sample_set_sizes.data(), sample_sets.data(), num_windows, p_windows.data(), options | TSK_STAT_POLARISED, p_result.data());
+			if (ret < 0) handle_error("tsk_treeseq_allele_frequency_spectrum", ret);
+			break;
+		}
+		default:
+			EIDOS_TERMINATION << "ERROR (Species::ComputeTreeSequenceStatistic): (internal error) unrecognized statistic." << EidosTerminate();
 	}
-	if (ret < 0) handle_error("tsk_tree_next", ret);
-	
-	ret = tsk_tree_free(&t);
-	if (ret < 0) handle_error("tsk_tree_free", ret);
 	
 	ret = tsk_treeseq_free(&ts);
 	if (ret < 0) handle_error("tsk_treeseq_free", ret);
-	
-	if (&tables_copy != &tables_)
-	{
-		ret = tsk_table_collection_free(&tables_copy);
-		if (ret < 0) handle_error("tsk_table_collection_free", ret);
-	}
-	
-	//std::cout << "tick " << community->Tick() << ": fully_coalesced == " << (fully_coalesced ? "TRUE" : "false") << std::endl;
-	last_coalescence_state_ = fully_coalesced;
 }
 
 bool Species::_SubpopulationIDInUse(slim_objectid_t p_subpop_id)
@@ -4434,6 +5891,7 @@ void Species::AllocateTreeSequenceTables(void)
 	tables_.sequence_length = (double)chromosome_->last_position_ + 1;
 	
 	RecordTablePosition();
+	memset(&simplified_table_position_, 0, sizeof(tsk_bookmark_t));
 }
 
 void Species::SetCurrentNewIndividual(__attribute__((unused))Individual *p_individual)
@@ -4503,7 +5961,11 @@ void Species::RecordNewGenome(std::vector<slim_position_t> *p_breakpoints, Genom
 	
 	// if there is no parent then no need to record edges
 	if (!p_initial_parental_genome && !p_second_parental_genome)
+	{
+		if (tracking_coalescence_)
+			RecordCoalescenceTracts(p_new_genome, nullptr, nullptr, nullptr, 0);
 		return;
+	}
 	
 	assert(p_initial_parental_genome);	// this cannot be nullptr if p_second_parental_genome is non-null, so now it is guaranteed non-null
 	
@@ -4517,6 +5979,9 @@ void Species::RecordNewGenome(std::vector<slim_position_t> *p_breakpoints, Genom
 	if (breakpoint_count && (p_breakpoints->back() > chromosome_->last_position_))
 		breakpoint_count--;
 	
+	if (tracking_coalescence_)
+		RecordCoalescenceTracts(p_new_genome, p_initial_parental_genome, p_second_parental_genome, p_breakpoints, breakpoint_count);
+	
 	// add an edge for each interval between breakpoints
 	double left = 0.0;
 	double right;
@@ -4646,19 +6111,33 @@ void Species::CheckAutoSimplification(void)
 	// automatically"; we check for that up front.
 	++simplify_elapsed_;
 	
+	// If a background simplification has finished, merge its result in now; this is a safe point to do so
+	if (background_simplify_job_ && background_simplify_job_->finished_.load())
+		FinishBackgroundSimplification();
+	
 	if (simplification_interval_ != -1)
 	{
 		// BCH 4/5/2019: Adding support for a chosen simplification interval rather than a ratio.  A value of -1
 		// means the simplification ratio is being used, as implemented below; any other value is a target interval.
 		if ((simplify_elapsed_ >= 1) && (simplify_elapsed_ >= simplification_interval_))
 		{
-			SimplifyTreeSequence();
+			if (background_simplify_)
+				StartBackgroundSimplification();
+			else
+				SimplifyTreeSequence();
 		}
 	}
 	else if (!std::isinf(simplification_ratio_))
 	{
 		if (simplify_elapsed_ >= simplify_interval_)
 		{
+			// With background simplification, the interval is adjusted when the result is merged in
+			if (background_simplify_)
+			{
+				StartBackgroundSimplification();
+				return;
+			}
+			
 			// We could, in principle, calculate actual memory used based on number of rows * sizeof(column), etc.,
 			// but that seems like overkill; adding together the number of rows in all the tables should be a
 			// reasonable proxy, and this whole thing is just a heuristic that needs to be tailored anyway.
@@ -4673,41 +6152,47 @@ void Species::CheckAutoSimplification(void)
 			new_table_size += (uint64_t)tables_.edges.num_rows;
 			new_table_size += (uint64_t)tables_.sites.num_rows;
 			new_table_size += (uint64_t)tables_.mutations.num_rows;
-			double ratio = old_table_size / (double)new_table_size;
-			
-			//std::cout << "auto-simplified in tick " << community->Tick() << "; old size " << old_table_size << ", new size " << new_table_size;
-			//std::cout << "; ratio " << ratio << ", target " << simplification_ratio_ << std::endl;
-			//std::cout << "old interval " << simplify_interval_ << ", new interval ";
-			
-			// Adjust our automatic simplification interval based upon the observed change in storage space used.
-			// Not sure if this is exactly what we want to do; this will hunt around a lot without settling on a value,
-			// but that seems harmless.  The scaling factor of 1.2 is chosen somewhat arbitrarily; we want it to be
-			// large enough that we will arrive at the optimum interval before too terribly long, but small enough
-			// that we have some granularity, so that once we reach the optimum we don't fluctuate too much.
-			if (ratio < simplification_ratio_)
-			{
-				// We simplified too soon; wait a little longer next time
-				simplify_interval_ *= 1.2;
-				
-				// Impose a maximum interval of 1000, so we don't get caught flat-footed if model demography changes
-				if (simplify_interval_ > 1000.0)
-					simplify_interval_ = 1000.0;
-			}
-			else if (ratio > simplification_ratio_)
-			{
-				// We simplified too late; wait a little less long next time
-				simplify_interval_ /= 1.2;
-				
-				// Impose a minimum interval of 1.0, just to head off weird underflow issues
-				if (simplify_interval_ < 1.0)
-					simplify_interval_ = 1.0;
-			}
 			
-			//std::cout << simplify_interval_ << std::endl;
+			AdjustSimplificationInterval(old_table_size, new_table_size);
 		}
 	}
 }
 
+void Species::AdjustSimplificationInterval(uint64_t p_old_table_size, uint64_t p_new_table_size)
+{
+	double ratio = p_old_table_size / (double)p_new_table_size;
+	
+	//std::cout << "auto-simplified in tick " << community->Tick() << "; old size " << p_old_table_size << ", new size " << p_new_table_size;
+	//std::cout << "; ratio " << ratio << ", target " << simplification_ratio_ << std::endl;
+	//std::cout << "old interval " << simplify_interval_ << ", new interval ";
+	
+	// Adjust our automatic simplification interval based upon the observed change in storage space used.
+	// Not sure if this is exactly what we want to do; this will hunt around a lot without settling on a value,
+	// but that seems harmless.  The scaling factor of 1.2 is chosen somewhat arbitrarily; we want it to be
+	// large enough that we will arrive at the optimum interval before too terribly long, but small enough
+	// that we have some granularity, so that once we reach the optimum we don't fluctuate too much.
+	if (ratio < simplification_ratio_)
+	{
+		// We simplified too soon; wait a little longer next time
+		simplify_interval_ *= 1.2;
+		
+		// Impose a maximum interval of 1000, so we don't get caught flat-footed if model demography changes
+		if (simplify_interval_ > 1000.0)
+			simplify_interval_ = 1000.0;
+	}
+	else if (ratio > simplification_ratio_)
+	{
+		// We simplified too late; wait a little less long next time
+		simplify_interval_ /= 1.2;
+		
+		// Impose a minimum interval of 1.0, just to head off weird underflow issues
+		if (simplify_interval_ < 1.0)
+			simplify_interval_ = 1.0;
+	}
+	
+	//std::cout << simplify_interval_ << std::endl;
+}
+
 void Species::TreeSequenceDataFromAscii(const std::string &NodeFileName,
 										const std::string &EdgeFileName,
 										const std::string &SiteFileName,
@@ -5270,6 +6755,10 @@ void Species::AddIndividualsToTable(Individual * const *p_individual, size_t p_n
 	if (p_tables == nullptr)
 		p_tables = &tables_;
 	
+	// adding individuals to tables_ would invalidate a simplification in progress, so merge it in first
+	if ((p_tables == &tables_) && background_simplify_job_)
+		FinishBackgroundSimplification();
+	
 	// loop over individuals and add entries to the individual table; if they are already
 	// there, we just need to update their flags, metadata, location, etc.
 	for (size_t j = 0; j < p_num_individuals; j++)
@@ -6264,7 +7753,202 @@ void Species::ReadTreeSequenceMetadata(tsk_table_collection_t *p_tables, slim_ti
 #endif
 }
 
-void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify, bool p_include_model, EidosDictionaryUnretained *p_metadata_dict)
+void Species::OverlayNeutralMutations(tsk_table_collection_t *p_tables, MutationType *p_mut_type, double p_rate)
+{
+	// This overlays neutral mutations of type p_mut_type onto the recorded genealogy in p_tables, at a rate of p_rate per base position
+	// per tick of branch length, as an alternative to simulating them forward in time; this is the usual tree-sequence "recipe" of
+	// recording without neutral mutations and adding them afterwards (with msprime.sim_mutations(), for example), built into SLiM.
+	// Each edge gets a Poisson number of new mutations given its span and the time between its parent and child nodes, at uniformly
+	// drawn integer positions within the edge and times along the branch.  We keep to an infinite-sites model: a new mutation is
+	// dropped if its position already has a site (from SLiM's own mutations) or was drawn already, so no derived-state stacking is
+	// needed; at the low rates where an overlay makes sense this is very rare.  The caller has checked that the mutation type is
+	// neutral and unused forward in time, and p_tables must be sorted and deduplicated; the site and mutation tables are re-sorted here.
+	// Note that only the recorded genealogy is covered; the time above the roots is not, unless the tree sequence was recapitated.
+	typedef struct {
+		slim_position_t position_;
+		tsk_id_t node_;
+		double time_;
+	} OverlaidMutation;
+	
+	std::vector<OverlaidMutation> overlaid_mutations;
+	gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
+	Eidos_MT_State *mt = EIDOS_MT_RNG(omp_get_thread_num());
+	tsk_edge_table_t &edges = p_tables->edges;
+	tsk_node_table_t &nodes = p_tables->nodes;
+	
+	for (tsk_size_t edge_index = 0; edge_index < edges.num_rows; ++edge_index)
+	{
+		slim_position_t first_position = (slim_position_t)std::ceil(edges.left[edge_index]);
+		slim_position_t end_position = (slim_position_t)std::ceil(edges.right[edge_index]);
+		tsk_id_t child = edges.child[edge_index];
+		double child_time = nodes.time[child];
+		double branch_length = nodes.time[edges.parent[edge_index]] - child_time;
+		
+		if ((end_position <= first_position) || (branch_length <= 0.0))
+			continue;
+		
+		unsigned int mutation_count = Eidos_FastRandomPoisson(rng, p_rate * (end_position - first_position) * branch_length);
+		
+		for (unsigned int mutation_index = 0; mutation_index < mutation_count; ++mutation_index)
+		{
+			slim_position_t position = first_position + (slim_position_t)Eidos_rng_uniform_int_MT64(mt, (uint64_t)(end_position - first_position));
+			double time = child_time + Eidos_rng_uniform(rng) * branch_length;		// in [child_time, parent_time), as tskit requires
+			
+			overlaid_mutations.push_back(OverlaidMutation{position, child, time});
+		}
+	}
+	
+	// unique by position, dropping any that land on an existing site; the site table is sorted by position, so we can binary search it
+	std::stable_sort(overlaid_mutations.begin(), overlaid_mutations.end(), [](const OverlaidMutation &p1, const OverlaidMutation &p2) { return p1.position_ < p2.position_; });
+	
+	tsk_site_table_t &sites = p_tables->sites;
+	tsk_size_t original_site_count = sites.num_rows;		// the table may be reallocated as we add rows, so we re-fetch sites.position below
+	slim_position_t previous_position = -1;
+	size_t overlaid_count = 0, dropped_count = 0;
+	slim_tick_t tick = community_.Tick();
+	MutationMetadataRec metadata_rec;
+	int ret;
+	
+	metadata_rec.mutation_type_id_ = p_mut_type->mutation_type_id_;
+	metadata_rec.selection_coeff_ = 0.0;
+	metadata_rec.nucleotide_ = -1;
+	
+	for (OverlaidMutation &overlaid_mutation : overlaid_mutations)
+	{
+		slim_position_t position = overlaid_mutation.position_;
+		
+		if ((position == previous_position) || std::binary_search(sites.position, sites.position + original_site_count, (double)position))
+		{
+			dropped_count++;
+			continue;
+		}
+		
+		previous_position = position;
+		
+		tsk_id_t site_id = tsk_site_table_add_row(&sites, (double)position, NULL, 0, NULL, 0);
+		if (site_id < 0) handle_error("tsk_site_table_add_row", site_id);
+		
+		// the derived state is the new mutation's id, as in RecordNewDerivedState(); the origin tick comes from the time along the branch,
+		// which is still in SLiM's internal time convention (the negative of tree_seq_tick_) since the tables have not been rebased yet
+		slim_mutationid_t mutation_id = gSLiM_next_mutation_id++;
+		double ticks_ago = overlaid_mutation.time_ + community_.tree_seq_tick_ + community_.tree_seq_tick_offset_;
+		
+		metadata_rec.subpop_index_ = nodes.population[overlaid_mutation.node_];
+		metadata_rec.origin_tick_ = tick - (slim_tick_t)std::floor(ticks_ago);
+		
+		ret = tsk_mutation_table_add_row(&p_tables->mutations, site_id, overlaid_mutation.node_, TSK_NULL, overlaid_mutation.time_,
+										 (char *)&mutation_id, (tsk_size_t)sizeof(slim_mutationid_t),
+										 (char *)&metadata_rec, (tsk_size_t)sizeof(MutationMetadataRec));
+		if (ret < 0) handle_error("tsk_mutation_table_add_row", ret);
+		
+		overlaid_count++;
+	}
+	
+	// re-sort the site and mutation tables, without re-sorting edges and migrations, which are already sorted
+	tsk_bookmark_t start;
+	
+	memset(&start, 0, sizeof(start));
+	start.edges = edges.num_rows;
+	start.migrations = p_tables->migrations.num_rows;
+	
+	ret = tsk_table_collection_sort(p_tables, &start, TSK_NO_CHECK_INTEGRITY);
+	if (ret < 0) handle_error("tsk_table_collection_sort", ret);
+	
+	if (SLiM_verbosity_level >= 2)
+		SLIM_OUTSTREAM << "// OverlayNeutralMutations(): overlaid " << overlaid_count << " mutations of type m" << p_mut_type->mutation_type_id_ << " (" << dropped_count << " dropped at already occupied positions)" << std::endl;
+}
+
+// Copies p_tables into p_output_tables for binary output, except for the node table's columns other than time and
+// individual (the only node columns modified for output) and, if p_borrow_edges is true, the edge table; those are borrowed
+// from p_tables instead, so that output does not need memory for a second copy of the biggest tables.  The metadata schemas
+// of the borrowed tables are copied, since WriteTreeSequenceMetadata() replaces them.  p_tables must not be modified while
+// p_output_tables exists, and p_output_tables must be freed with slim_free_output_tables().
+static int
+slim_copy_tables_for_output(tsk_table_collection_t *p_tables, tsk_table_collection_t *p_output_tables, bool p_borrow_edges)
+{
+	// copy everything else the usual way, with the borrowed tables temporarily swapped out for empty ones
+	tsk_node_table_t empty_nodes;
+	tsk_edge_table_t empty_edges;
+	int ret;
+	
+	ret = tsk_node_table_init(&empty_nodes, 0);
+	if (ret != 0) return ret;
+	ret = tsk_edge_table_init(&empty_edges, p_tables->edges.options);
+	if (ret != 0) { tsk_node_table_free(&empty_nodes); return ret; }
+	
+	std::swap(p_tables->nodes, empty_nodes);
+	if (p_borrow_edges)
+		std::swap(p_tables->edges, empty_edges);
+	
+	ret = tsk_table_collection_copy(p_tables, p_output_tables, 0);
+	
+	std::swap(p_tables->nodes, empty_nodes);
+	if (p_borrow_edges)
+		std::swap(p_tables->edges, empty_edges);
+	
+	tsk_node_table_free(&empty_nodes);
+	tsk_edge_table_free(&empty_edges);
+	
+	if (ret != 0) return ret;
+	
+	// borrow the node table, with private time and individual columns
+	std::size_t num_nodes = static_cast<std::size_t>(p_tables->nodes.num_rows);
+	double *time = (double *)malloc(std::max(num_nodes, (std::size_t)1) * sizeof(double));
+	tsk_id_t *individual = (tsk_id_t *)malloc(std::max(num_nodes, (std::size_t)1) * sizeof(tsk_id_t));
+	
+	if (!time || !individual)
+	{
+		free(time);
+		free(individual);
+		return TSK_ERR_NO_MEMORY;
+	}
+	
+	memcpy(time, p_tables->nodes.time, num_nodes * sizeof(double));
+	memcpy(individual, p_tables->nodes.individual, num_nodes * sizeof(tsk_id_t));
+	
+	tsk_node_table_free(&p_output_tables->nodes);
+	p_output_tables->nodes = p_tables->nodes;
+	p_output_tables->nodes.time = time;
+	p_output_tables->nodes.individual = individual;
+	p_output_tables->nodes.metadata_schema = NULL;
+	p_output_tables->nodes.metadata_schema_length = 0;
+	
+	ret = tsk_node_table_set_metadata_schema(&p_output_tables->nodes, p_tables->nodes.metadata_schema, p_tables->nodes.metadata_schema_length);
+	if (ret != 0) return ret;
+	
+	if (p_borrow_edges)
+	{
+		tsk_edge_table_free(&p_output_tables->edges);
+		p_output_tables->edges = p_tables->edges;
+		p_output_tables->edges.metadata_schema = NULL;
+		p_output_tables->edges.metadata_schema_length = 0;
+		
+		ret = tsk_edge_table_set_metadata_schema(&p_output_tables->edges, p_tables->edges.metadata_schema, p_tables->edges.metadata_schema_length);
+		if (ret != 0) return ret;
+	}
+	
+	return 0;
+}
+
+static int
+slim_free_output_tables(tsk_table_collection_t *p_output_tables, bool p_borrowed_edges)
+{
+	// free our private node columns and schemas, and forget the borrowed columns so they are not freed with the rest
+	free(p_output_tables->nodes.time);
+	free(p_output_tables->nodes.individual);
+	free(p_output_tables->nodes.metadata_schema);
+	memset(&p_output_tables->nodes, 0, sizeof(tsk_node_table_t));
+	
+	if (p_borrowed_edges)
+	{
+		free(p_output_tables->edges.metadata_schema);
+		memset(&p_output_tables->edges, 0, sizeof(tsk_edge_table_t));
+	}
+	
+	return tsk_table_collection_free(p_output_tables);
+}
+
+void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify, bool p_include_model, EidosDictionaryUnretained *p_metadata_dict, MutationType *p_overlay_mut_type, double p_overlay_rate, bool p_compress)
 {
 #if DEBUG
 	if (!recording_tree_)
@@ -6293,10 +7977,23 @@ void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 		SimplifyTreeSequence();
 	}
 	
-	// Copy the table collection so that modifications we do for writing don't affect the original tables
+	// Copy the table collection so that modifications we do for writing don't affect the original tables.  For binary
+	// output, the node and edge tables are mostly borrowed from tables_ rather than copied, to keep down peak memory usage;
+	// the edge table is copied only if it needs to be sorted.  Text output rewrites the node table, so it gets a full copy.
 	tsk_table_collection_t output_tables;
-	ret = tsk_table_collection_copy(&tables_, &output_tables, 0);
-	if (ret < 0) handle_error("tsk_table_collection_copy", ret);
+	bool borrowed_tables = p_binary;
+	bool borrowed_edges = p_binary && p_simplify;
+	
+	if (borrowed_tables)
+	{
+		ret = slim_copy_tables_for_output(&tables_, &output_tables, borrowed_edges);
+		if (ret < 0) handle_error("slim_copy_tables_for_output", ret);
+	}
+	else
+	{
+		ret = tsk_table_collection_copy(&tables_, &output_tables, 0);
+		if (ret < 0) handle_error("tsk_table_collection_copy", ret);
+	}
 	
 	// Sort and deduplicate; we don't need to do this if we simplified above, since simplification does these steps
 	if (!p_simplify)
@@ -6305,14 +8002,17 @@ void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 #if DEBUG
 		flags = 0;
 #endif
-		ret = tsk_table_collection_sort(&output_tables, /* edge_start */ NULL, /* flags */ flags);
-		if (ret < 0) handle_error("tsk_table_collection_sort", ret);
+		SortTreeSequenceTables(&output_tables, flags);
 		
 		// Remove redundant sites we added
 		ret = tsk_table_collection_deduplicate_sites(&output_tables, 0);
 		if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
 	}
 	
+	// Overlay neutral mutations onto the output tables, if requested; this needs sorted, deduplicated tables, and must precede mutation parents
+	if (p_overlay_mut_type && (p_overlay_rate > 0.0))
+		OverlayNeutralMutations(&output_tables, p_overlay_mut_type, p_overlay_rate);
+	
 	// Add in the mutation.parent information; valid tree sequences need parents, but we don't keep them while running
 	ret = tsk_table_collection_build_index(&output_tables, 0);
 	if (ret < 0) handle_error("tsk_table_collection_build_index", ret);
@@ -6409,8 +8109,29 @@ void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 			if (ret < 0) handle_error("tsk_reference_sequence_takeset_data", ret);
 		}
 		
-		ret = tsk_table_collection_dump(&output_tables, path.c_str(), 0);
-		if (ret < 0) handle_error("tsk_table_collection_dump", ret);
+		if (p_compress)
+		{
+			// tskit writes only uncompressed files, so we dump to an anonymous temporary file and gzip that to the final path
+			FILE *dump_file = tmpfile();
+			
+			if (!dump_file)
+				EIDOS_TERMINATION << "ERROR (Species::WriteTreeSequence): treeSeqOutput() could not create a temporary file for compression." << EidosTerminate();
+			
+			ret = tsk_table_collection_dumpf(&output_tables, dump_file, 0);
+			if (ret < 0) { fclose(dump_file); handle_error("tsk_table_collection_dumpf", ret); }
+			
+			bool success = Eidos_GzipStreamToFile(dump_file, path);
+			
+			fclose(dump_file);
+			
+			if (!success)
+				EIDOS_TERMINATION << "ERROR (Species::WriteTreeSequence): treeSeqOutput() could not write compressed output to " << path << "." << EidosTerminate();
+		}
+		else
+		{
+			ret = tsk_table_collection_dump(&output_tables, path.c_str(), 0);
+			if (ret < 0) handle_error("tsk_table_collection_dump", ret);
+		}
 	}
 	else
 	{
@@ -6475,7 +8196,10 @@ void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 	}
 	
 	// Done with our tables copy
-	ret = tsk_table_collection_free(&output_tables);
+	if (borrowed_tables)
+		ret = slim_free_output_tables(&output_tables, borrowed_edges);
+	else
+		ret = tsk_table_collection_free(&output_tables);
 	if (ret < 0) handle_error("tsk_table_collection_free", ret);
 }
 
@@ -6489,8 +8213,11 @@ void Species::FreeTreeSequence()
 	{
 		// Free any tree-sequence recording stuff that has been allocated; called when Species is getting deallocated,
 		// and also when we're wiping the slate clean with something like readFromPopulationFile().
+		DiscardBackgroundSimplification();
+		
 		tsk_table_collection_free(&tables_);
 		tables_initialized_ = false;
+		memset(&simplified_table_position_, 0, sizeof(tsk_bookmark_t));
 		
 		remembered_genomes_.clear();
 		tabled_individuals_hash_.clear();
@@ -7791,7 +9518,7 @@ void Species::__TabulateSubpopulationsFromTreeSequence(std::unordered_map<slim_o
 	}
 }
 
-void Species::__CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::unordered_map<tsk_id_t, Genome *> &p_nodeToGenomeMap)
+void Species::__CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::vector<Genome *> &p_nodeToGenomeMap)
 {
 	// We will keep track of all pedigree IDs used, and check at the end that they do not collide; faster than checking as we go
 	// This could be done with a hash table, but I imagine that would be slower until the number of individuals becomes very large
@@ -7800,7 +9527,7 @@ void Species::__CreateSubpopulationsFromTabulation(std::unordered_map<slim_objec
 	
 	gSLiM_next_pedigree_id = 0;
 	
-	for (auto subpop_info_iter : p_subpopInfoMap)
+	for (auto &subpop_info_iter : p_subpopInfoMap)
 	{
 		slim_objectid_t subpop_id = subpop_info_iter.first;
 		ts_subpop_info &subpop_info = subpop_info_iter.second;
@@ -7857,8 +9584,8 @@ void Species::__CreateSubpopulationsFromTabulation(std::unordered_map<slim_objec
 				individual->genome1_->tsk_node_id_ = node_id_0;
 				individual->genome2_->tsk_node_id_ = node_id_1;
 				
-				p_nodeToGenomeMap.emplace(node_id_0, individual->genome1_);
-				p_nodeToGenomeMap.emplace(node_id_1, individual->genome2_);
+				p_nodeToGenomeMap[node_id_0] = individual->genome1_;
+				p_nodeToGenomeMap[node_id_1] = individual->genome2_;
 				
 				slim_pedigreeid_t pedigree_id = subpop_info.pedigreeID_[tabulation_index];
 				individual->SetPedigreeID(pedigree_id);
@@ -8166,6 +9893,8 @@ void Species::__TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t
 	if ((mut_count > 0) && !recording_mutations_)
 		EIDOS_TERMINATION << "ERROR (Species::__TabulateMutationsFromTables): cannot load mutations when mutation recording is disabled." << EidosTerminate();
 	
+	p_mutMap.reserve(mut_count);
+	
 	for (tsk_size_t mut_index = 0; mut_index < mut_count; ++mut_index)
 	{
 		const char *derived_state_bytes = mut_table.derived_state + mut_table.derived_state_offset[mut_index];
@@ -8240,87 +9969,137 @@ void Species::__TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t
 	}
 }
 
-void Species::__TallyMutationReferencesWithTreeSequence(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts)
+// Walks the sites of p_ts in order, calling p_site_func(site, allele_of_sample, listed_samples) for each site.  Alleles are numbered
+// as in tsk_variant_t, except that identical states are not merged: allele 0 is the site's ancestral state, and allele j is the derived
+// state of the site's mutation j-1.  allele_of_sample gives each sample's allele, and is 0 for every sample not in listed_samples; all
+// samples are listed if the ancestral state is not empty.  Unlike tsk_variant_decode(), this visits only the samples below each mutation,
+// using tskit's sample lists, so the cost of a site scales with the frequency of its mutations rather than with the number of samples.
+template <typename F>
+static int slim_walk_site_alleles(tsk_treeseq_t *p_ts, const F &p_site_func)
 {
-	// allocate and set up the tsk_variant object we'll use to walk through sites
-	tsk_variant_t *variant;
-	variant = (tsk_variant_t *)malloc(sizeof(tsk_variant_t));
-	if (!variant)
-		EIDOS_TERMINATION << "ERROR (Species::__TallyMutationReferencesWithTreeSequence): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+	tsk_tree_t tree;
+	int ret = tsk_tree_init(&tree, p_ts, TSK_SAMPLE_LISTS);
+	
+	if (ret != 0)
+	{
+		tsk_tree_free(&tree);
+		return ret;
+	}
+	
+	tsk_size_t sample_count = tsk_treeseq_get_num_samples(p_ts);
+	std::vector<int32_t> allele_of_sample(sample_count, 0);
+	std::vector<tsk_id_t> listed_samples;
 	
-	int ret = tsk_variant_init(
-			variant, p_ts, NULL, 0, NULL, TSK_ISOLATED_NOT_MISSING);
-	if (ret != 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_variant_init()", ret);
+	for (ret = tsk_tree_first(&tree); ret == TSK_TREE_OK; ret = tsk_tree_next(&tree))
+	{
+		for (tsk_size_t site_index = 0; site_index < tree.sites_length; ++site_index)
+		{
+			const tsk_site_t &site = tree.sites[site_index];
+			bool list_all = (site.ancestral_state_length > 0);
+			
+			if (list_all)
+				for (tsk_size_t sample_index = 0; sample_index < sample_count; ++sample_index)
+					listed_samples.emplace_back((tsk_id_t)sample_index);
+			
+			// mutations are ordered with parents before children, so later mutations overwrite the states set by earlier ones
+			for (tsk_size_t mut_index = 0; mut_index < site.mutations_length; ++mut_index)
+			{
+				tsk_id_t sample_index = tree.left_sample[site.mutations[mut_index].node];
+				
+				if (sample_index == TSK_NULL)
+					continue;
+				
+				tsk_id_t stop_index = tree.right_sample[site.mutations[mut_index].node];
+				
+				while (true)
+				{
+					if (!list_all && (allele_of_sample[sample_index] == 0))
+						listed_samples.emplace_back(sample_index);
+					
+					allele_of_sample[sample_index] = (int32_t)mut_index + 1;
+					
+					if (sample_index == stop_index)
+						break;
+					
+					sample_index = tree.next_sample[sample_index];
+				}
+			}
+			
+			p_site_func(site, allele_of_sample, listed_samples);
+			
+			for (tsk_id_t sample_index : listed_samples)
+				allele_of_sample[sample_index] = 0;
+			
+			listed_samples.clear();
+		}
+	}
 	
-	// set up a map from sample indices in the variant to Genome objects; the sample
+	int free_ret = tsk_tree_free(&tree);
+	
+	return (ret < 0) ? ret : free_ret;
+}
+
+void Species::__TallyMutationReferencesWithTreeSequence(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, std::vector<Genome *> &p_nodeToGenomeMap, tsk_treeseq_t *p_ts)
+{
+	// set up a map from sample indices in the tree sequence to Genome objects; the sample
 	// may contain nodes that are ancestral and need to be excluded
 	std::vector<Genome *> indexToGenomeMap;
-	size_t sample_count = variant->num_samples;
+	size_t sample_count = tsk_treeseq_get_num_samples(p_ts);
+	const tsk_id_t *samples = tsk_treeseq_get_samples(p_ts);
+	
+	indexToGenomeMap.reserve(sample_count);
 	
 	for (size_t sample_index = 0; sample_index < sample_count; ++sample_index)
-	{
-		tsk_id_t sample_node_id = variant->samples[sample_index];
-		auto sample_nodeToGenome_iter = p_nodeToGenomeMap.find(sample_node_id);
-		
-		if (sample_nodeToGenome_iter != p_nodeToGenomeMap.end())
-			indexToGenomeMap.emplace_back(sample_nodeToGenome_iter->second);
-		else
-			indexToGenomeMap.emplace_back(nullptr);	// this sample is not extant; no corresponding genome
-	}
+		indexToGenomeMap.emplace_back(p_nodeToGenomeMap[samples[sample_index]]);	// nullptr if this sample is not extant
 	
-	// add mutations to genomes by looping through variants
-	for (tsk_size_t i = 0; i < p_ts->tables->sites.num_rows; i++)
-	{
-		ret = tsk_variant_decode(variant, (tsk_id_t)i, 0);
-		if (ret < 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_variant_decode()", ret);
+	// tally mutation references by walking through the sites
+	std::vector<int32_t> allele_refs_vec;
+	
+	int ret = slim_walk_site_alleles(p_ts, [&](const tsk_site_t &site, const std::vector<int32_t> &allele_of_sample, const std::vector<tsk_id_t> &listed_samples) {
+		// The site tells us all the allelic states involved, and allele_of_sample tells us which genomes are using them.
+		// We want to find any mutations that are shared across all non-null genomes.  First calculate the number of
+		// extant genomes that reference each allele, in a single pass over the samples that do not have the ancestral state.
+		tsk_size_t allele_count = site.mutations_length + 1;
+		
+		allele_refs_vec.assign(allele_count, 0);
 		
-		// We have a new variant; set it into SLiM.  A variant represents a site at which a tracked mutation exists.
-		// The tsk_variant_t will tell us all the allelic states involved at that site, what the alleles are, and which genomes
-		// in the sample are using them.  We want to find any mutations that are shared across all non-null genomes.
-		for (tsk_size_t allele_index = 0; allele_index < variant->num_alleles; ++allele_index)
+		for (tsk_id_t sample_index : listed_samples)
+			if (indexToGenomeMap[sample_index] != nullptr)
+				allele_refs_vec[allele_of_sample[sample_index]]++;
+		
+		for (tsk_size_t allele_index = 0; allele_index < allele_count; ++allele_index)
 		{
-			tsk_size_t allele_length = variant->allele_lengths[allele_index];
+			int32_t allele_refs = allele_refs_vec[allele_index];
 			
-			if (allele_length > 0)
+			// If that count is greater than zero (might be zero if only non-extant nodes reference the allele), tally it
+			if (allele_refs)
 			{
-				// Calculate the number of extant genomes that reference this allele
-				int32_t allele_refs = 0;
+				const char *allele_bytes = ((allele_index == 0) ? site.ancestral_state : site.mutations[allele_index - 1].derived_state);
+				tsk_size_t allele_length = ((allele_index == 0) ? site.ancestral_state_length : site.mutations[allele_index - 1].derived_state_length);
+				
+				if (allele_length % sizeof(slim_mutationid_t) != 0)
+					EIDOS_TERMINATION << "ERROR (Species::__TallyMutationReferencesWithTreeSequence): (internal error) variant allele had length that was not a multiple of sizeof(slim_mutationid_t)." << EidosTerminate();
+				allele_length /= sizeof(slim_mutationid_t);
 				
-				for (size_t sample_index = 0; sample_index < sample_count; sample_index++)
-					if ((variant->genotypes[sample_index] == (int32_t)allele_index) && (indexToGenomeMap[sample_index] != nullptr))
-						allele_refs++;
+				const slim_mutationid_t *allele = (const slim_mutationid_t *)allele_bytes;
 				
-				// If that count is greater than zero (might be zero if only non-extant nodes reference the allele), tally it
-				if (allele_refs)
+				for (tsk_size_t mutid_index = 0; mutid_index < allele_length; ++mutid_index)
 				{
-					if (allele_length % sizeof(slim_mutationid_t) != 0)
-						EIDOS_TERMINATION << "ERROR (Species::__TallyMutationReferencesWithTreeSequence): (internal error) variant allele had length that was not a multiple of sizeof(slim_mutationid_t)." << EidosTerminate();
-					allele_length /= sizeof(slim_mutationid_t);
+					slim_mutationid_t mut_id = allele[mutid_index];
+					auto mut_info_iter = p_mutMap.find(mut_id);
 					
-					slim_mutationid_t *allele = (slim_mutationid_t *)variant->alleles[allele_index];
+					if (mut_info_iter == p_mutMap.end())
+						EIDOS_TERMINATION << "ERROR (Species::__TallyMutationReferencesWithTreeSequence): mutation id " << mut_id << " was referenced but does not exist." << EidosTerminate();
 					
-					for (tsk_size_t mutid_index = 0; mutid_index < allele_length; ++mutid_index)
-					{
-						slim_mutationid_t mut_id = allele[mutid_index];
-						auto mut_info_iter = p_mutMap.find(mut_id);
-						
-						if (mut_info_iter == p_mutMap.end())
-							EIDOS_TERMINATION << "ERROR (Species::__TallyMutationReferencesWithTreeSequence): mutation id " << mut_id << " was referenced but does not exist." << EidosTerminate();
-						
-						// Add allele_refs to the refcount for this mutation
-						ts_mut_info &mut_info = mut_info_iter->second;
-						
-						mut_info.ref_count += allele_refs;
-					}
+					// Add allele_refs to the refcount for this mutation
+					ts_mut_info &mut_info = mut_info_iter->second;
+					
+					mut_info.ref_count += allele_refs;
 				}
 			}
 		}
-	}
-	
-	// free
-	ret = tsk_variant_free(variant);
-	if (ret != 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_variant_free()", ret);
-	free(variant);
+	});
+	if (ret < 0) handle_error("__TallyMutationReferencesWithTreeSequence slim_walk_site_alleles()", ret);
 }
 
 void Species::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutInfoMap, std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap)
@@ -8333,8 +10112,10 @@ void Species::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid
 			if (!genome->IsNull())
 				fixation_count++;
 	
+	p_mutIndexMap.reserve(p_mutInfoMap.size());
+	
 	// instantiate mutations
-	for (auto mut_info_iter : p_mutInfoMap)
+	for (auto &mut_info_iter : p_mutInfoMap)
 	{
 		slim_mutationid_t mutation_id = mut_info_iter.first;
 		ts_mut_info &mut_info = mut_info_iter.second;
@@ -8402,70 +10183,111 @@ void Species::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid
 	}
 }
 
-void Species::__AddMutationsFromTreeSequenceToGenomes(std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts)
+void Species::__AddMutationsFromTreeSequenceToGenomes(std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap, std::vector<Genome *> &p_nodeToGenomeMap, tsk_treeseq_t *p_ts)
 {
 	// This code is based on Species::CrosscheckTreeSeqIntegrity(), but it can be much simpler.
 	// We also don't need to sort/deduplicate/simplify; the tables read in should be simplified already.
 	if (!recording_mutations_)
 		return;
 	
-	// allocate and set up the variant object we'll use to walk through sites
-	tsk_variant_t *variant;
-
-	variant = (tsk_variant_t *)malloc(sizeof(tsk_variant_t));
-	if (!variant)
-		EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
-	
-	int ret = tsk_variant_init(variant, p_ts, NULL, 0, NULL, TSK_ISOLATED_NOT_MISSING);
-	if (ret != 0) handle_error("__AddMutationsFromTreeSequenceToGenomes tsk_variant_init()", ret);
-	
-	// set up a map from sample indices in the variant to Genome objects; the sample
+	// set up a map from sample indices in the tree sequence to Genome objects; the sample
 	// may contain nodes that are ancestral and need to be excluded
 	std::vector<Genome *> indexToGenomeMap;
-	size_t sample_count = variant->num_samples;
+	size_t sample_count = tsk_treeseq_get_num_samples(p_ts);
+	const tsk_id_t *samples = tsk_treeseq_get_samples(p_ts);
+	
+	indexToGenomeMap.reserve(sample_count);
 	
 	for (size_t sample_index = 0; sample_index < sample_count; ++sample_index)
-	{
-		tsk_id_t sample_node_id = variant->samples[sample_index];
-		auto sample_nodeToGenome_iter = p_nodeToGenomeMap.find(sample_node_id);
+		indexToGenomeMap.emplace_back(p_nodeToGenomeMap[samples[sample_index]]);	// nullptr if this sample is not extant
+	
+	// We walk through the sites, which come in order of position, and collect (sample index, mutation index) pairs for every
+	// mutation carried by an extant genome.  Adding each mutation directly to its genome's mutation run would touch a
+	// different genome, scattered through memory, for each pair; instead we collect the pairs for one mutation run index at a
+	// time, and when the walk moves past that run, or the pairs reach flush_pair_count, we bucket them by sample and append
+	// them to each genome's mutation run in bulk.  This keeps a bounded number of pairs in memory, rather than the pairs for
+	// every mutation in the file.  The mutation indices for each allele at a site are looked up once, the first time a genome
+	// uses the allele; allele_ranges holds each allele's [start, end) in allele_mut_indices, or -1 if unresolved.
+	const std::size_t flush_pair_count = 65536;
+	std::vector<std::pair<int32_t, MutationIndex>> run_mutations;
+	std::vector<MutationIndex> run_sorted_mutations;
+	std::vector<int32_t> run_touched_samples;						// the samples with mutations in the current run, in first-use order
+	std::vector<int32_t> sample_counts(sample_count, 0);			// mutations per sample in the current run; all zero between runs
+	std::vector<MutationIndex> allele_mut_indices;
+	std::vector<std::pair<int64_t, int64_t>> allele_ranges;
+	slim_position_t mutrun_length = chromosome_->mutrun_length_;
+	slim_mutrun_index_t current_run_index = -1;
+#ifndef _OPENMP
+	MutationRunContext &mutrun_context = SpeciesMutationRunContextForThread(omp_get_thread_num());	// when not parallel, we have only one MutationRunContext
+#endif
+	
+	auto flush_run_mutations = [&]() {
+		if (run_mutations.size() == 0)
+			return;
+		
+#ifdef _OPENMP
+		// When parallel, the MutationRunContext depends upon the position in the genome
+		MutationRunContext &mutrun_context = SpeciesMutationRunContextForMutationRunIndex(current_run_index);
+#endif
+		
+		// Bucket the mutations by sample with a counting sort, which keeps each sample's mutations in order by position;
+		// sample_counts becomes each touched sample's cursor, and then its end, in run_sorted_mutations
+		int32_t run_offset = 0;
 		
-		if (sample_nodeToGenome_iter != p_nodeToGenomeMap.end())
+		for (int32_t sample_index : run_touched_samples)
 		{
-			// we found a genome for this sample, so record it
-			indexToGenomeMap.emplace_back(sample_nodeToGenome_iter->second);
+			int32_t count = sample_counts[sample_index];
+			
+			sample_counts[sample_index] = run_offset;
+			run_offset += count;
 		}
-		else
+		
+		run_sorted_mutations.resize(run_mutations.size());
+		
+		for (const std::pair<int32_t, MutationIndex> &sample_mutation : run_mutations)
+			run_sorted_mutations[sample_counts[sample_mutation.first]++] = sample_mutation.second;
+		
+		// Then append each genome's mutations to its run in bulk; we use WillModifyRun_UNSHARED() because we know that these
+		// runs are unshared (unless empty); we created them empty, and nobody has modified them but us.
+		run_offset = 0;
+		
+		for (int32_t sample_index : run_touched_samples)
 		{
-			// this sample is not extant; no corresponding genome, so record nullptr
-			indexToGenomeMap.emplace_back(nullptr);
+			int32_t run_end = sample_counts[sample_index];
+			MutationRun *mutrun = indexToGenomeMap[sample_index]->WillModifyRun_UNSHARED(current_run_index, mutrun_context);
+			
+			mutrun->emplace_back_bulk(run_sorted_mutations.data() + run_offset, run_end - run_offset);
+			sample_counts[sample_index] = 0;
+			run_offset = run_end;
 		}
-	}
-	
-	// add mutations to genomes by looping through variants
-#ifndef _OPENMP
-	MutationRunContext &mutrun_context = SpeciesMutationRunContextForThread(omp_get_thread_num());	// when not parallel, we have only one MutationRunContext
-#endif
+		
+		run_mutations.clear();
+		run_touched_samples.clear();
+	};
 	
-	for (tsk_size_t i = 0; i < p_ts->tables->sites.num_rows; i++)
-	{
-		ret = tsk_variant_decode(variant, (tsk_id_t)i, 0);
-		if (ret < 0) handle_error("__AddMutationsFromTreeSequenceToGenomes tsk_variant_decode()", ret);
+	int ret = slim_walk_site_alleles(p_ts, [&](const tsk_site_t &site, const std::vector<int32_t> &allele_of_sample, const std::vector<tsk_id_t> &listed_samples) {
+		// The site tells us all the allelic states involved, and allele_of_sample tells us which genomes are using them.
+		// We will then set all the genomes that do not have the (empty) ancestral state to have the allele attributed to them.
+		slim_mutrun_index_t run_index = (slim_mutrun_index_t)((slim_position_t)site.position / mutrun_length);
 		
-		// We have a new variant; set it into SLiM.  A variant represents a site at which a tracked mutation exists.
-		// The tsk_variant_t will tell us all the allelic states involved at that site, what the alleles are, and which genomes
-		// in the sample are using them.  We will then set all the genomes that the variant claims to involve to have
-		// the allele the variant attributes to them.  The variants are returned in sorted order by position, so we can
-		// always add new mutations to the ends of genomes.
-		slim_position_t variant_pos_int = (slim_position_t)variant->site.position;
+		if ((run_index != current_run_index) || (run_mutations.size() >= flush_pair_count))
+		{
+			flush_run_mutations();
+			current_run_index = run_index;
+		}
 		
-		for (size_t sample_index = 0; sample_index < sample_count; sample_index++)
+		allele_mut_indices.clear();
+		allele_ranges.assign(site.mutations_length + 1, std::pair<int64_t, int64_t>(-1, -1));
+		
+		for (tsk_id_t sample_index : listed_samples)
 		{
 			Genome *genome = indexToGenomeMap[sample_index];
 			
 			if (genome)
 			{
-				int32_t genome_variant = variant->genotypes[sample_index];
-				tsk_size_t genome_allele_length = variant->allele_lengths[genome_variant];
+				int32_t genome_variant = allele_of_sample[sample_index];
+				const char *genome_allele_bytes = ((genome_variant == 0) ? site.ancestral_state : site.mutations[genome_variant - 1].derived_state);
+				tsk_size_t genome_allele_length = ((genome_variant == 0) ? site.ancestral_state_length : site.mutations[genome_variant - 1].derived_state_length);
 				
 				if (genome_allele_length % sizeof(slim_mutationid_t) != 0)
 					EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): (internal error) variant allele had length that was not a multiple of sizeof(slim_mutationid_t)." << EidosTerminate();
@@ -8476,41 +10298,49 @@ void Species::__AddMutationsFromTreeSequenceToGenomes(std::unordered_map<slim_mu
 					if (genome->IsNull())
 						EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): (internal error) null genome has non-zero treeseq allele length " << genome_allele_length << "." << EidosTerminate();
 					
-					slim_mutationid_t *genome_allele = (slim_mutationid_t *)variant->alleles[genome_variant];
-					slim_mutrun_index_t run_index = (slim_mutrun_index_t)(variant_pos_int / genome->mutrun_length_);
-					
-#ifdef _OPENMP
-					// When parallel, the MutationRunContext depends upon the position in the genome
-					MutationRunContext &mutrun_context = SpeciesMutationRunContextForMutationRunIndex(run_index);
-#endif
-					
-					// We use WillModifyRun_UNSHARED() because we know that these runs are unshared (unless empty);
-					// we created them empty, nobody has modified them but us, and we process each genome separately.
-					MutationRun *mutrun = genome->WillModifyRun_UNSHARED(run_index, mutrun_context);
+					std::pair<int64_t, int64_t> &allele_range = allele_ranges[genome_variant];
 					
-					for (tsk_size_t mutid_index = 0; mutid_index < genome_allele_length; ++mutid_index)
+					if (allele_range.first == -1)
 					{
-						slim_mutationid_t mut_id = genome_allele[mutid_index];
-						auto mut_index_iter = p_mutIndexMap.find(mut_id);
+						const slim_mutationid_t *genome_allele = (const slim_mutationid_t *)genome_allele_bytes;
+						
+						allele_range.first = (int64_t)allele_mut_indices.size();
+						
+						for (tsk_size_t mutid_index = 0; mutid_index < genome_allele_length; ++mutid_index)
+						{
+							slim_mutationid_t mut_id = genome_allele[mutid_index];
+							auto mut_index_iter = p_mutIndexMap.find(mut_id);
+							
+							if (mut_index_iter == p_mutIndexMap.end())
+								EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): mutation id " << mut_id << " was referenced but does not exist." << EidosTerminate();
+							
+							// Add the mutation to the genome unless it is fixed (mut_index == -1)
+							MutationIndex mut_index = mut_index_iter->second;
+							
+							if (mut_index != -1)
+								allele_mut_indices.emplace_back(mut_index);
+						}
 						
-						if (mut_index_iter == p_mutIndexMap.end())
-							EIDOS_TERMINATION << "ERROR (Species::__AddMutationsFromTreeSequenceToGenomes): mutation id " << mut_id << " was referenced but does not exist." << EidosTerminate();
+						allele_range.second = (int64_t)allele_mut_indices.size();
+					}
+					
+					if (allele_range.second > allele_range.first)
+					{
+						if (sample_counts[sample_index] == 0)
+							run_touched_samples.emplace_back(sample_index);
 						
-						// Add the mutation to the genome unless it is fixed (mut_index == -1)
-						MutationIndex mut_index = mut_index_iter->second;
+						for (int64_t allele_mut_index = allele_range.first; allele_mut_index < allele_range.second; ++allele_mut_index)
+							run_mutations.emplace_back(sample_index, allele_mut_indices[allele_mut_index]);
 						
-						if (mut_index != -1)
-							mutrun->emplace_back(mut_index);
+						sample_counts[sample_index] += (int32_t)(allele_range.second - allele_range.first);
 					}
 				}
 			}
 		}
-	}
+	});
+	if (ret < 0) handle_error("__AddMutationsFromTreeSequenceToGenomes slim_walk_site_alleles()", ret);
 	
-	// free
-	ret = tsk_variant_free(variant);
-	if (ret != 0) handle_error("__AddMutationsFromTreeSequenceToGenomes tsk_variant_free()", ret);
-	free(variant);
+	flush_run_mutations();
 }
 
 void Species::__CheckNodePedigreeIDs(EidosInterpreter *p_interpreter)
@@ -8607,7 +10437,7 @@ void Species::_InstantiateSLiMObjectsFromTables(EidosInterpreter *p_interpreter,
 	ret = tsk_treeseq_init(ts, &tables_, TSK_TS_INIT_BUILD_INDEXES);
 	if (ret != 0) handle_error("_InstantiateSLiMObjectsFromTables tsk_treeseq_init()", ret);
 	
-	std::unordered_map<tsk_id_t, Genome *> nodeToGenomeMap;
+	std::vector<Genome *> nodeToGenomeMap(tables_.nodes.num_rows, nullptr);		// indexed by node id; nullptr for nodes without an extant genome
 	
 	{
 		std::unordered_map<slim_objectid_t, ts_subpop_info> subpopInfoMap;
@@ -8709,6 +10539,10 @@ void Species::_InstantiateSLiMObjectsFromTables(EidosInterpreter *p_interpreter,
 	
 	// Reset our last coalescence state; we don't know whether we're coalesced now or not
 	last_coalescence_state_ = false;
+	
+	// The extant genomes' root ancestry for coalescence tracking comes from the loaded trees
+	if (recording_tree_ && tracking_coalescence_)
+		SeedCoalescenceTractsFromTables();
 }
 
 slim_tick_t Species::_InitializePopulationFromTskitTextFile(const char *p_file, EidosInterpreter *p_interpreter, SUBPOP_REMAP_HASH &p_subpop_map)
@@ -9004,6 +10838,7 @@ void Species::TSXC_Enable(void)
 	simplification_interval_ = -1;			// this means "use the ratio, not a fixed interval"
 	simplify_interval_ = 20;				// this is the initial simplification interval
 	running_coalescence_checks_ = false;
+	tracking_coalescence_ = false;
 	running_treeseq_crosschecks_ = true;
 	treeseq_crosschecks_interval_ = 50;		// check every 50th cycle, otherwise it is just too slow
 	
@@ -9022,6 +10857,7 @@ void Species::TSF_Enable(void)
 	simplification_interval_ = -1;            // this means "use the ratio, not a fixed interval"
 	simplify_interval_ = 20;                // this is the initial simplification interval
 	running_coalescence_checks_ = false;
+	tracking_coalescence_ = false;
 	running_treeseq_crosschecks_ = false;
 	
 	pedigrees_enabled_ = true;
@@ -31,6 +31,9 @@
 #include <map>
 #include <ctime>
 #include <unordered_set>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
 
 #include "slim_globals.h"
 #include "population.h"
@@ -60,6 +63,35 @@ class InteractionType;
 struct ts_subpop_info;
 struct ts_mut_info;
 
+// A tract of a genome that descends from a single root of the tree sequence, used for coalescence checking; see
+// Species::CheckCoalescence().  A genome's tracts are in order, and each one extends to the start of the next.
+struct CoalescenceTract {
+	slim_position_t left_;			// the first position of the tract
+	slim_genomeid_t root_;			// a label for the root the tract descends from, or -1 where all extant genomes are known to agree
+};
+
+// A simplification running on a worker thread; see Species::StartBackgroundSimplification().  The worker owns
+// tables_ until finished_ is set; everything else is set up before the thread starts and read after it is joined.
+struct BackgroundSimplifyJob
+{
+	tsk_table_collection_t tables_;				// a copy of the species' tables at the snapshot, sorted and simplified by the worker
+	tsk_bookmark_t snapshot_position_;			// the sizes of the species' tables at the snapshot; rows past this are recorded during the job
+	tsk_bookmark_t sorted_position_;			// the rows of tables_ that were already sorted at the snapshot
+	std::vector<tsk_id_t> samples_;				// the sample nodes for simplification, remembered genomes first
+	std::vector<tsk_id_t> extant_nodes_;		// the nodes of the genomes alive at the snapshot, for the coalescence check
+	std::vector<tsk_id_t> node_map_;			// filled in by the worker: snapshot node id -> simplified node id, or TSK_NULL
+	tsk_flags_t sort_flags_;
+	tsk_flags_t simplify_flags_;
+	uint64_t old_table_size_;					// the table size at the snapshot, for the simplification ratio heuristic
+	
+	int error_ = 0;								// a tskit error code from the worker, with the name of the call that produced it
+	const char *error_source_ = nullptr;
+	std::string exception_message_;				// the message of an exception caught on the worker, if any
+	
+	std::atomic<bool> finished_;
+	std::thread thread_;
+};
+
 extern EidosClass *gSLiM_Species_Class;
 
 enum class SLiMFileFormat
@@ -71,6 +103,7 @@ enum class SLiMFileFormat
 	kFormatTskitText,				// as saved by treeSeqOutput(path, binary=F)
 	kFormatTskitBinary_HDF5,		// old file format, no longer supported
 	kFormatTskitBinary_kastore,	// as saved by treeSeqOutput(path, binary=T)
+	kFormatTskitBinary_kastore_gzip,	// as saved by treeSeqOutput(path, binary=T, compress=T)
 };
 
 
@@ -261,6 +294,9 @@ private:
 	// preventing incidental selfing in hermaphroditic models
 	bool prevent_incidental_selfing_ = false;
 	
+	// running WF modifyChild() callbacks after offspring generation; see Population::ApplyDeferredModifyChildCallbacks()
+	bool defer_modify_child_ = false;
+	
 	// nucleotide-based models
 	bool nucleotide_based_ = false;
 	double max_nucleotide_mut_rate_;				// the highest rate for any genetic background in any genomic element type
@@ -296,6 +332,10 @@ private:
 	
 	std::vector<int32_t> x_mutcount_history_;	// a record of the mutation run count used in each cycle
 	
+	std::string x_cache_path_;					// the mutation run cache file given by -mutrunCache, or empty if no cache is used
+	std::string x_cache_model_hash_;			// a hash of the model script and command-line defines, used to key the cache
+	bool x_cache_hit_ = false;					// true if our initial mutation run count came from the cache
+	
 	std::clock_t x_total_gen_clocks_ = 0;		// a counter of clocks accumulated for the current cycle's runtime (across measured code blocks)
 												// look at MUTRUNEXP_START_TIMING() / MUTRUNEXP_END_TIMING() usage to see which blocks are measured
 	
@@ -320,6 +360,7 @@ private:
 	bool tables_initialized_ = false;			// not checked everywhere, just when allocing and freeing, to avoid crashes
 	tsk_table_collection_t tables_;
 	tsk_bookmark_t table_position_;
+	tsk_bookmark_t simplified_table_position_ = {};	// table sizes just after the last simplification; rows below this are already sorted
 	
     std::vector<tsk_id_t> remembered_genomes_;
 	//Individual *current_new_individual_;
@@ -331,7 +372,12 @@ private:
  #endif
 	INDIVIDUALS_HASH tabled_individuals_hash_;	// look up individuals table row numbers from pedigree IDs
 
+	bool background_simplify_ = false;			// true if automatic simplification runs on a worker thread, overlapping the simulation
+	BackgroundSimplifyJob *background_simplify_job_ = nullptr;	// the simplification in progress on the worker thread, if any
+	
 	bool running_coalescence_checks_ = false;	// true if we check for coalescence after each simplification
+	bool tracking_coalescence_ = false;			// true if we instead track the root ancestry of each genome; see CheckCoalescence()
+	std::unordered_map<const Genome *, std::vector<CoalescenceTract>> coalescence_tracts_;	// if tracking_coalescence_==true, the tracts of each genome
 	bool last_coalescence_state_ = false;		// if running_coalescence_checks_==true, updated every simplification
 	
 	bool running_treeseq_crosschecks_ = false;	// true if crosschecks between our tree sequence tables and SLiM's data are enabled
@@ -371,6 +417,7 @@ public:
 	// cache of non-neutral mutations is invalid (because their counter is not equal to this counter).  The caches will be re-validated the next time they are used.  Other
 	// code can also increment this counter in order to trigger a re-validation of all non-neutral mutation caches; it is a general-purpose mechanism.
 	int32_t nonneutral_change_counter_ = 0;
+	int32_t fitness_product_change_counter_ = 0;	// similarly, signals that the fitness products cached with the non-neutral caches are stale; see mutation_run.h
 	int32_t last_nonneutral_regime_ = 0;		// see mutation_run.h; 1 = no mutationEffect() callbacks, 2 = only constant-effect neutral callbacks, 3 = arbitrary callbacks
 	
 	// this flag is set if the dominance coeff (regular or haploid) changes on any mutation type, as a signal that recaching needs to occur in Subpopulation::UpdateFitness()
@@ -448,6 +495,13 @@ public:
 	void TransitionToNewExperimentAgainstPreviousExperiment(int32_t p_new_mutrun_count);
 	void EnterStasisForMutationRunExperiments(void);
 	void MaintainMutationRunExperiments(double p_last_gen_runtime);
+	int32_t ModalMutationRunCount(double *p_modal_fraction);
+	
+	// Mutation run experiment cache, enabled by the -mutrunCache command-line option
+	void MutationRunCache_Enable(const std::string &p_cache_path, const std::string &p_model_hash);
+	std::string MutationRunCacheKey(void);
+	int32_t ReadMutationRunCache(void);
+	void WriteMutationRunCache(void);
 	
 	// Mutation stack policy checking
 	inline __attribute__((always_inline)) void MutationStackPolicyChanged(void)												{ mutation_stack_policy_changed_ = true; }
@@ -540,6 +594,7 @@ public:
 	inline __attribute__((always_inline)) bool PedigreesEnabled(void) const													{ return pedigrees_enabled_; }
 	inline __attribute__((always_inline)) bool PedigreesEnabledByUser(void) const											{ return pedigrees_enabled_by_user_; }
 	inline __attribute__((always_inline)) bool PreventIncidentalSelfing(void) const											{ return prevent_incidental_selfing_; }
+	inline __attribute__((always_inline)) bool DeferModifyChild(void) const													{ return defer_modify_child_; }
 	inline __attribute__((always_inline)) GenomeType ModeledChromosomeType(void) const										{ return modeled_chromosome_type_; }
 	inline __attribute__((always_inline)) int SpatialDimensionality(void) const												{ return spatial_dimensionality_; }
 	inline __attribute__((always_inline)) void SpatialPeriodicity(bool *p_x, bool *p_y, bool *p_z) const
@@ -583,12 +638,23 @@ public:
 	void WriteProvenanceTable(tsk_table_collection_t *p_tables, bool p_use_newlines, bool p_include_model);
 	void WriteTreeSequenceMetadata(tsk_table_collection_t *p_tables, EidosDictionaryUnretained *p_metadata_dict);
 	void ReadTreeSequenceMetadata(tsk_table_collection_t *p_tables, slim_tick_t *p_tick, slim_tick_t *p_cycle, SLiMModelType *p_model_type, int *p_file_version);
-	void WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify, bool p_include_model, EidosDictionaryUnretained *p_metadata_dict);
+	void OverlayNeutralMutations(tsk_table_collection_t *p_tables, MutationType *p_mut_type, double p_rate);
+	void WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify, bool p_include_model, EidosDictionaryUnretained *p_metadata_dict, MutationType *p_overlay_mut_type = nullptr, double p_overlay_rate = 0.0, bool p_compress = false);
     void ReorderIndividualTable(tsk_table_collection_t *p_tables, std::vector<int> p_individual_map, bool p_keep_unmapped);
 	void AddParentsColumnForOutput(tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash);
 	void BuildTabledIndividualsHash(tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash);
+	void SortTreeSequenceTables(tsk_table_collection_t *p_tables, tsk_flags_t p_flags);
 	void SimplifyTreeSequence(void);
-	void CheckCoalescenceAfterSimplification(void);
+	void StartBackgroundSimplification(void);
+	static void _RunBackgroundSimplification(BackgroundSimplifyJob *p_job);
+	void FinishBackgroundSimplification(void);
+	void DiscardBackgroundSimplification(void);
+	void CheckCoalescenceAfterSimplification(tsk_table_collection_t *p_tables = nullptr, std::vector<tsk_id_t> *p_extant_nodes = nullptr);
+	void RecordCoalescenceTracts(Genome *p_new_genome, const Genome *p_initial_parental_genome, const Genome *p_second_parental_genome, const std::vector<slim_position_t> *p_breakpoints, size_t p_breakpoint_count);
+	void SeedCoalescenceTractsFromTables(void);
+	bool CheckCoalescence(void);
+	void ComputeTreeSequenceStatistic(EidosGlobalStringID p_statistic, const std::vector<std::vector<tsk_id_t>> &p_sample_sets, bool p_branch_mode, const std::vector<double> &p_windows, std::vector<double> &p_result);
+	void AdjustSimplificationInterval(uint64_t p_old_table_size, uint64_t p_new_table_size);
 	void CheckAutoSimplification(void);
     void TreeSequenceDataFromAscii(const std::string &NodeFileName, const std::string &EdgeFileName, const std::string &SiteFileName, const std::string &MutationFileName, const std::string &IndividualsFileName, const std::string &PopulationFileName, const std::string &ProvenanceFileName);
 	void FreeTreeSequence();
@@ -602,12 +668,12 @@ public:
 	void __RemapSubpopulationIDs(SUBPOP_REMAP_HASH &p_subpop_map, int p_file_version);
 	void __PrepareSubpopulationsFromTables(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap);
 	void __TabulateSubpopulationsFromTreeSequence(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, tsk_treeseq_t *p_ts, SLiMModelType p_file_model_type);
-	void __CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::unordered_map<tsk_id_t, Genome *> &p_nodeToGenomeMap);
+	void __CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::vector<Genome *> &p_nodeToGenomeMap);
 	void __ConfigureSubpopulationsFromTables(EidosInterpreter *p_interpreter);
 	void __TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, int p_file_version);
-	void __TallyMutationReferencesWithTreeSequence(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts);
+	void __TallyMutationReferencesWithTreeSequence(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, std::vector<Genome *> &p_nodeToGenomeMap, tsk_treeseq_t *p_ts);
 	void __CreateMutationsFromTabulation(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutInfoMap, std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap);
-	void __AddMutationsFromTreeSequenceToGenomes(std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts);
+	void __AddMutationsFromTreeSequenceToGenomes(std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap, std::vector<Genome *> &p_nodeToGenomeMap, tsk_treeseq_t *p_ts);
 	void __CheckNodePedigreeIDs(EidosInterpreter *p_interpreter);
 	void _InstantiateSLiMObjectsFromTables(EidosInterpreter *p_interpreter, slim_tick_t p_metadata_tick, slim_tick_t p_metadata_cycle, SLiMModelType p_file_model_type, int p_file_version, SUBPOP_REMAP_HASH &p_subpop_map);	// given tree-seq tables, makes individuals, genomes, and mutations
 	slim_tick_t _InitializePopulationFromTskitTextFile(const char *p_file, EidosInterpreter *p_interpreter, SUBPOP_REMAP_HASH &p_subpop_map);	// initialize the population from an tskit text file
@@ -667,6 +733,7 @@ public:
 	EidosValue_SP ExecuteMethod_skipTick(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_subsetMutations(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_treeSeqCoalesced(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
+	EidosValue_SP ExecuteMethod_treeSeqStatistic(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_treeSeqSimplify(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_treeSeqRememberIndividuals(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter);
@@ -687,6 +754,10 @@ public:
 	virtual const std::vector<EidosMethodSignature_CSP> *Methods(void) const override;
 };
 
+// SLiM's edge and mutation sorters, used in place of tskit's for simplification; declared here only so that slim_test.cpp can test them
+int slim_sort_edges(tsk_table_sorter_t *sorter, tsk_size_t start);
+int slim_sort_mutations(tsk_table_sorter_t *sorter);
+
 
 #endif /* defined(__SLiM__species__) */
 
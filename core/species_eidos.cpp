@@ -979,7 +979,7 @@ EidosValue_SP Species::ExecuteContextFunction_initializeSex(const std::string &p
 	return gStaticEidosValueVOID;
 }
 
-//	*********************	(void)initializeSLiMOptions([logical$ keepPedigrees = F], [string$ dimensionality = ""], [string$ periodicity = ""], [integer$ mutationRuns = 0], [logical$ preventIncidentalSelfing = F], [logical$ nucleotideBased = F], [logical$ randomizeCallbacks = T])
+//	*********************	(void)initializeSLiMOptions([logical$ keepPedigrees = F], [string$ dimensionality = ""], [string$ periodicity = ""], [integer$ mutationRuns = 0], [logical$ preventIncidentalSelfing = F], [logical$ nucleotideBased = F], [logical$ randomizeCallbacks = T], [logical$ deferModifyChild = F])
 //
 EidosValue_SP Species::ExecuteContextFunction_initializeSLiMOptions(const std::string &p_function_name, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -991,6 +991,7 @@ EidosValue_SP Species::ExecuteContextFunction_initializeSLiMOptions(const std::s
 	EidosValue *arg_preventIncidentalSelfing_value = p_arguments[4].get();
 	EidosValue *arg_nucleotideBased_value = p_arguments[5].get();
 	EidosValue *arg_randomizeCallbacks_value = p_arguments[6].get();
+	EidosValue *arg_deferModifyChild_value = p_arguments[7].get();
 	std::ostream &output_stream = p_interpreter.ExecutionOutputStream();
 	
 	if (num_options_declarations_ > 0)
@@ -1107,6 +1108,13 @@ EidosValue_SP Species::ExecuteContextFunction_initializeSLiMOptions(const std::s
 		shuffle_buf_is_enabled_ = randomize_callbacks;
 	}
 	
+	{
+		// [logical$ deferModifyChild = F]
+		bool defer_modify_child = arg_deferModifyChild_value->LogicalAtIndex_NOCAST(0, nullptr);
+		
+		defer_modify_child_ = defer_modify_child;
+	}
+	
 	if (SLiM_verbosity_level >= 1)
 	{
 		output_stream << "initializeSLiMOptions(";
@@ -1171,6 +1179,13 @@ EidosValue_SP Species::ExecuteContextFunction_initializeSLiMOptions(const std::s
 			if (previous_params) output_stream << ", ";
 			output_stream << "randomizeCallbacks = " << (shuffle_buf_is_enabled_ ? "T" : "F");
 			previous_params = true;
+		}
+		
+		if (defer_modify_child_)
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "deferModifyChild = " << (defer_modify_child_ ? "T" : "F");
+			previous_params = true;
 			(void)previous_params;	// dead store above is deliberate
 		}
 		
@@ -1266,7 +1281,7 @@ EidosValue_SP Species::ExecuteContextFunction_initializeSpecies(const std::strin
 }
 
 // TREE SEQUENCE RECORDING
-//	*********************	(void)initializeTreeSeq([logical$ recordMutations = T], [Nif$ simplificationRatio = NULL], [Ni$ simplificationInterval = NULL], [logical$ checkCoalescence = F], [logical$ runCrosschecks = F], [logical$ retainCoalescentOnly = T], [Ns$ timeUnit = NULL])
+//	*********************	(void)initializeTreeSeq([logical$ recordMutations = T], [Nif$ simplificationRatio = NULL], [Ni$ simplificationInterval = NULL], [logical$ checkCoalescence = F], [logical$ runCrosschecks = F], [logical$ retainCoalescentOnly = T], [Ns$ timeUnit = NULL], [logical$ backgroundSimplify = F], [logical$ trackCoalescence = F])
 //
 EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::string &p_function_name, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -1278,6 +1293,8 @@ EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::strin
 	EidosValue *arg_runCrosschecks_value = p_arguments[4].get();
 	EidosValue *arg_retainCoalescentOnly_value = p_arguments[5].get();
 	EidosValue *arg_timeUnit_value = p_arguments[6].get();
+	EidosValue *arg_backgroundSimplify_value = p_arguments[7].get();
+	EidosValue *arg_trackCoalescence_value = p_arguments[8].get();
 	std::ostream &output_stream = p_interpreter.ExecutionOutputStream();
 	
 	if (num_treeseq_declarations_ > 0)
@@ -1291,6 +1308,15 @@ EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::strin
 	running_coalescence_checks_ = arg_checkCoalescence_value->LogicalAtIndex_NOCAST(0, nullptr);
 	running_treeseq_crosschecks_ = arg_runCrosschecks_value->LogicalAtIndex_NOCAST(0, nullptr);
 	retain_coalescent_only_ = arg_retainCoalescentOnly_value->LogicalAtIndex_NOCAST(0, nullptr);
+	background_simplify_ = arg_backgroundSimplify_value->LogicalAtIndex_NOCAST(0, nullptr);
+	tracking_coalescence_ = arg_trackCoalescence_value->LogicalAtIndex_NOCAST(0, nullptr);
+	
+	if (tracking_coalescence_ && !running_coalescence_checks_)
+		EIDOS_TERMINATION << "ERROR (Species::ExecuteContextFunction_initializeTreeSeq): trackCoalescence=T requires checkCoalescence=T." << EidosTerminate();
+	
+	// a worker thread can only compete with the simulation for a single core, so simplify synchronously in that case
+	if (background_simplify_ && (std::thread::hardware_concurrency() == 1))
+		background_simplify_ = false;
 	treeseq_crosschecks_interval_ = 1;		// this interval is presently not exposed in the Eidos API
 	
 	if ((arg_simplificationRatio_value->Type() == EidosValueType::kValueNULL) && (arg_simplificationInterval_value->Type() == EidosValueType::kValueNULL))
@@ -1412,6 +1438,20 @@ EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::strin
 			if (previous_params) output_stream << ", ";
 			output_stream << "timeUnit = '" << community_.treeseq_time_unit_ << "'";	// assumes a simple string with no quotes
 			previous_params = true;
+		}
+		
+		if (arg_backgroundSimplify_value->LogicalAtIndex_NOCAST(0, nullptr))
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "backgroundSimplify = T";
+			previous_params = true;
+		}
+		
+		if (tracking_coalescence_)
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "trackCoalescence = T";
+			previous_params = true;
 			(void)previous_params;	// dead store above is deliberate
 		}
 		
@@ -1702,6 +1742,10 @@ EidosValue_SP Species::ExecuteInstanceMethod(EidosGlobalStringID p_method_id, co
 		case gID_skipTick:							return ExecuteMethod_skipTick(p_method_id, p_arguments, p_interpreter);
 		case gID_subsetMutations:					return ExecuteMethod_subsetMutations(p_method_id, p_arguments, p_interpreter);
 		case gID_treeSeqCoalesced:					return ExecuteMethod_treeSeqCoalesced(p_method_id, p_arguments, p_interpreter);
+		case gID_treeSeqDiversity:
+		case gID_treeSeqDivergence:
+		case gID_treeSeqFST:
+		case gID_treeSeqSFS:						return ExecuteMethod_treeSeqStatistic(p_method_id, p_arguments, p_interpreter);
 		case gID_treeSeqSimplify:					return ExecuteMethod_treeSeqSimplify(p_method_id, p_arguments, p_interpreter);
 		case gID_treeSeqRememberIndividuals:		return ExecuteMethod_treeSeqRememberIndividuals(p_method_id, p_arguments, p_interpreter);
 		case gID_treeSeqOutput:						return ExecuteMethod_treeSeqOutput(p_method_id, p_arguments, p_interpreter);
@@ -2581,7 +2625,7 @@ EidosValue_SP Species::ExecuteMethod_outputMutations(EidosGlobalStringID p_metho
 				
 				for (int run_index = 0; run_index < mutrun_count; ++run_index)
 				{
-					const MutationRun *mutrun = genome.mutruns_[run_index];
+					const MutationRun *mutrun = genome.MutationRunAtIndex(run_index);
 					int mut_count = mutrun->size();
 					const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 					
@@ -3187,9 +3231,147 @@ EidosValue_SP Species::ExecuteMethod_treeSeqCoalesced(EidosGlobalStringID p_meth
 	if (!running_coalescence_checks_)
 		EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqCoalesced): treeSeqCoalesced() may only be called when coalescence checking is enabled; pass checkCoalescence=T to initializeTreeSeq() to enable this feature." << EidosTerminate();
 	
+	// when tracking coalescence tracts, the state is always up to date; otherwise it is as of the last simplification
+	if (tracking_coalescence_)
+		last_coalescence_state_ = CheckCoalescence();
+	
 	return (last_coalescence_state_ ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
 }
 
+// TREE SEQUENCE RECORDING
+//	*********************	- (float)treeSeqDiversity([No<Genome> genomes = NULL], [string$ mode = "site"], [Nif windows = NULL])
+//	*********************	- (float)treeSeqDivergence(object<Genome> genomes1, object<Genome> genomes2, [string$ mode = "site"], [Nif windows = NULL])
+//	*********************	- (float)treeSeqFST(object<Genome> genomes1, object<Genome> genomes2, [string$ mode = "site"], [Nif windows = NULL])
+//	*********************	- (float)treeSeqSFS([No<Genome> genomes = NULL], [string$ mode = "site"], [Nif windows = NULL])
+//
+EidosValue_SP Species::ExecuteMethod_treeSeqStatistic(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
+{
+#pragma unused (p_interpreter)
+	bool two_way = ((p_method_id == gID_treeSeqDivergence) || (p_method_id == gID_treeSeqFST));
+	int argument_offset = (two_way ? 1 : 0);
+	EidosValue *mode_value = p_arguments[1 + argument_offset].get();
+	EidosValue *windows_value = p_arguments[2 + argument_offset].get();
+	std::string method_name = EidosStringRegistry::StringForGlobalStringID(p_method_id);
+	
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqStatistic): " << method_name << "() may only be called when tree recording is enabled." << EidosTerminate();
+	
+	SLiMCycleStage cycle_stage = community_.CycleStage();
+	
+	// TIMING RESTRICTION
+	if ((cycle_stage != SLiMCycleStage::kWFStage0ExecuteFirstScripts) && (cycle_stage != SLiMCycleStage::kWFStage1ExecuteEarlyScripts) && (cycle_stage != SLiMCycleStage::kWFStage5ExecuteLateScripts) &&
+		(cycle_stage != SLiMCycleStage::kNonWFStage0ExecuteFirstScripts) && (cycle_stage != SLiMCycleStage::kNonWFStage2ExecuteEarlyScripts) && (cycle_stage != SLiMCycleStage::kNonWFStage6ExecuteLateScripts))
+		EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqStatistic): " << method_name << "() may only be called from a first(), early(), or late() event." << EidosTerminate();
+	if ((community_.executing_block_type_ != SLiMEidosBlockType::SLiMEidosEventFirst) &&
+		(community_.executing_block_type_ != SLiMEidosBlockType::SLiMEidosEventEarly) &&
+		(community_.executing_block_type_ != SLiMEidosBlockType::SLiMEidosEventLate))
+		EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqStatistic): " << method_name << "() may not be called from inside a callback." << EidosTerminate();
+	
+	// mode
+	std::string mode = mode_value->StringAtIndex_NOCAST(0, nullptr);
+	bool branch_mode = (mode == "branch");
+	
+	if (!branch_mode && (mode != "site"))
+		EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqStatistic): " << method_name << "() requires mode to be 'site' or 'branch'." << EidosTerminate();
+	
+	// windows; NULL means a single window spanning the whole chromosome
+	double sequence_length = (double)chromosome_->last_position_ + 1;
+	std::vector<double> windows;
+	
+	if (windows_value->Type() == EidosValueType::kValueNULL)
+	{
+		windows.emplace_back(0.0);
+		windows.emplace_back(sequence_length);
+	}
+	else
+	{
+		int windows_count = windows_value->Count();
+		
+		for (int window_index = 0; window_index < windows_count; ++window_index)
+			windows.emplace_back(windows_value->NumericAtIndex_NOCAST(window_index, nullptr));
+		
+		if ((windows_count < 2) || (windows.front() != 0.0) || (windows.back() != sequence_length))
+			EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqStatistic): " << method_name << "() requires windows to start at 0 and end at the chromosome length (the last position plus one)." << EidosTerminate();
+		
+		for (int window_index = 1; window_index < windows_count; ++window_index)
+			if (!(windows[window_index] > windows[window_index - 1]))
+				EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqStatistic): " << method_name << "() requires windows to be strictly increasing." << EidosTerminate();
+	}
+	
+	// sample sets; a NULL genomes argument means all extant non-null genomes
+	std::vector<std::vector<tsk_id_t>> sample_sets;
+	
+	for (int set_index = 0; set_index < (two_way ? 2 : 1); ++set_index)
+	{
+		EidosValue *genomes_value = p_arguments[set_index].get();
+		std::vector<tsk_id_t> sample_set;
+		
+		if (genomes_value->Type() == EidosValueType::kValueNULL)
+		{
+			for (auto subpop_iter : population_.subpops_)
+				for (Genome *genome : subpop_iter.second->parent_genomes_)
+					if (!genome->IsNull())
+						sample_set.emplace_back(genome->tsk_node_id_);
+		}
+		else
+		{
+			int genomes_count = genomes_value->Count();
+			
+			// SPECIES CONSISTENCY CHECK
+			if (genomes_count > 0)
+			{
+				Species *species = Community::SpeciesForGenomes(genomes_value);
+				
+				if (species != this)
+					EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqStatistic): " << method_name << "() requires that all genomes belong to the target species." << EidosTerminate();
+			}
+			
+			for (int genome_index = 0; genome_index < genomes_count; ++genome_index)
+			{
+				Genome *genome = (Genome *)genomes_value->ObjectElementAtIndex_NOCAST(genome_index, nullptr);
+				
+				if (genome->IsNull())
+					EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqStatistic): " << method_name << "() does not allow null genomes." << EidosTerminate();
+				
+				sample_set.emplace_back(genome->tsk_node_id_);
+			}
+			
+			// a genome listed twice would be counted twice; tskit rejects that, but we can give a better error
+			std::vector<tsk_id_t> sorted_set(sample_set);
+			
+			std::sort(sorted_set.begin(), sorted_set.end());
+			if (std::adjacent_find(sorted_set.begin(), sorted_set.end()) != sorted_set.end())
+				EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqStatistic): " << method_name << "() does not allow a genome to be included more than once in a set of genomes." << EidosTerminate();
+		}
+		
+		if (sample_set.size() == 0)
+			EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqStatistic): " << method_name << "() requires at least one genome in each set of genomes." << EidosTerminate();
+		
+		sample_sets.emplace_back(std::move(sample_set));
+	}
+	
+	// compute; tskit's result is one row per window, which we return as a vector unless a windowed SFS needs a matrix
+	std::vector<double> result;
+	
+	ComputeTreeSequenceStatistic(p_method_id, sample_sets, branch_mode, windows, result);
+	
+	int64_t windows_count = (int64_t)windows.size() - 1;
+	int64_t columns_count = (int64_t)result.size() / windows_count;
+	EidosValue_Float *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(result.size());
+	
+	for (int64_t window_index = 0; window_index < windows_count; ++window_index)
+		for (int64_t column_index = 0; column_index < columns_count; ++column_index)
+			float_result->set_float_no_check(result[window_index * columns_count + column_index], window_index + column_index * windows_count);
+	
+	if ((p_method_id == gID_treeSeqSFS) && (windows_value->Type() != EidosValueType::kValueNULL))
+	{
+		const int64_t dims[2] = {windows_count, columns_count};
+		float_result->SetDimensions(2, dims);
+	}
+	
+	return EidosValue_SP(float_result);
+}
+
 // TREE SEQUENCE RECORDING
 //	*********************	- (void)treeSeqSimplify(void)
 //
@@ -3254,7 +3436,7 @@ EidosValue_SP Species::ExecuteMethod_treeSeqRememberIndividuals(EidosGlobalStrin
 }
 
 // TREE SEQUENCE RECORDING
-//	*********************	- (void)treeSeqOutput(string$ path, [logical$ simplify = T], [logical$ includeModel = T], [No$ metadata = NULL], [logical$ _binary = T]) (note the _binary flag is undocumented)
+//	*********************	- (void)treeSeqOutput(string$ path, [logical$ simplify = T], [logical$ includeModel = T], [No$ metadata = NULL], [Nio<MutationType>$ overlayMutationType = NULL], [numeric$ overlayMutationRate = 0.0], [logical$ compress = F], [logical$ _binary = T]) (note the _binary flag is undocumented)
 //
 EidosValue_SP Species::ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_id, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -3263,7 +3445,10 @@ EidosValue_SP Species::ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_
 	EidosValue *simplify_value = p_arguments[1].get();
 	EidosValue *includeModel_value = p_arguments[2].get();
 	EidosValue *metadata_value = p_arguments[3].get();
-	EidosValue *binary_value = p_arguments[4].get();
+	EidosValue *overlayMutationType_value = p_arguments[4].get();
+	EidosValue *overlayMutationRate_value = p_arguments[5].get();
+	EidosValue *compress_value = p_arguments[6].get();
+	EidosValue *binary_value = p_arguments[7].get();
 	
 	if (!recording_tree_)
 		EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() may only be called when tree recording is enabled." << EidosTerminate();
@@ -3281,6 +3466,7 @@ EidosValue_SP Species::ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_
 	
 	std::string path_string = path_value->StringAtIndex_NOCAST(0, nullptr);
 	bool binary = binary_value->LogicalAtIndex_NOCAST(0, nullptr);
+	bool compress = compress_value->LogicalAtIndex_NOCAST(0, nullptr);
 	bool simplify = simplify_value->LogicalAtIndex_NOCAST(0, nullptr);
 	EidosDictionaryUnretained *metadata_dict = nullptr;
 	bool includeModel = includeModel_value->LogicalAtIndex_NOCAST(0, nullptr);
@@ -3301,7 +3487,61 @@ EidosValue_SP Species::ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_
 			EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): (internal) metadata object did not convert to EidosDictionaryUnretained." << EidosTerminate();	// should never happen
 	}
 	
-	WriteTreeSequence(path_string, binary, simplify, includeModel, metadata_dict);
+	// Neutral mutations can be overlaid onto the output tables, in place of being simulated forward in time; see OverlayNeutralMutations().
+	// We check here that the overlay is consistent with the forward simulation: the overlaid mutation type must be neutral, and it must
+	// not have been used forward in time (by a genomic element type, or by the script adding mutations of that type), or the overlaid
+	// mutations would double-count that part of the mutation process and might collide with mutations that SLiM knows about.
+	MutationType *overlay_mut_type = nullptr;
+	double overlay_rate = overlayMutationRate_value->NumericAtIndex_NOCAST(0, nullptr);
+	
+	if (overlayMutationType_value->Type() != EidosValueType::kValueNULL)
+	{
+		overlay_mut_type = SLiM_ExtractMutationTypeFromEidosValue_io(overlayMutationType_value, 0, &community_, this, "treeSeqOutput()");	// SPECIES CONSISTENCY CHECK
+		
+		if (!std::isfinite(overlay_rate) || (overlay_rate < 0.0))
+			EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() requires overlayMutationRate to be finite and >= 0.0." << EidosTerminate();
+		if (nucleotide_based_)
+			EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() does not support overlayMutationType in nucleotide-based models." << EidosTerminate();
+		if ((overlay_mut_type->dfe_type_ != DFEType::kFixed) || (overlay_mut_type->dfe_parameters_[0] != 0.0))
+			EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() requires overlayMutationType to be neutral, with a fixed DFE of 0.0." << EidosTerminate();
+		
+		for (const std::pair<const slim_objectid_t,GenomicElementType*> &getype_pair : genomic_element_types_)
+		{
+			GenomicElementType *getype = getype_pair.second;
+			
+			for (size_t muttype_index = 0; muttype_index < getype->mutation_type_ptrs_.size(); ++muttype_index)
+				if ((getype->mutation_type_ptrs_[muttype_index] == overlay_mut_type) && (getype->mutation_fractions_[muttype_index] > 0.0))
+					EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() requires that overlayMutationType not be used by any genomic element type, since its mutations are overlaid instead of being simulated." << EidosTerminate();
+		}
+		
+		int registry_size;
+		const MutationIndex *registry = population_.MutationRegistry(&registry_size);
+		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+		
+		for (int registry_index = 0; registry_index < registry_size; ++registry_index)
+			if ((mut_block_ptr + registry[registry_index])->mutation_type_ptr_ == overlay_mut_type)
+				EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() requires that no mutations of overlayMutationType exist in the simulation, since its mutations are overlaid instead of being simulated." << EidosTerminate();
+		
+		for (Substitution *substitution : population_.substitutions_)
+			if (substitution->mutation_type_ptr_ == overlay_mut_type)
+				EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() requires that no mutations of overlayMutationType exist in the simulation, since its mutations are overlaid instead of being simulated." << EidosTerminate();
+	}
+	else if (overlay_rate != 0.0)
+	{
+		EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() requires overlayMutationType to be supplied if overlayMutationRate is nonzero." << EidosTerminate();
+	}
+	
+	// like writeFile(), we add ".gz" to the filename if compression is specified and it is not already present
+	if (compress)
+	{
+		if (!binary)
+			EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_treeSeqOutput): treeSeqOutput() supports compress=T only for binary output." << EidosTerminate();
+		
+		if (!Eidos_string_hasSuffix(path_string, ".gz"))
+			path_string.append(".gz");
+	}
+	
+	WriteTreeSequence(path_string, binary, simplify, includeModel, metadata_dict, overlay_mut_type, overlay_rate, compress);
 	
 	return gStaticEidosValueVOID;
 }
@@ -3411,9 +3651,13 @@ const std::vector<EidosMethodSignature_CSP> *Species_Class::Methods(void) const
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_skipTick, kEidosValueMaskVOID)));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_subsetMutations, kEidosValueMaskObject, gSLiM_Mutation_Class))->AddObject_OSN("exclude", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddIntObject_OSN("mutType", gSLiM_MutationType_Class, gStaticEidosValueNULL)->AddInt_OSN("position", gStaticEidosValueNULL)->AddIntString_OSN("nucleotide", gStaticEidosValueNULL)->AddInt_OSN("tag", gStaticEidosValueNULL)->AddInt_OSN("id", gStaticEidosValueNULL));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqCoalesced, kEidosValueMaskLogical | kEidosValueMaskSingleton)));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqDiversity, kEidosValueMaskFloat))->AddObject_ON("genomes", gSLiM_Genome_Class, gStaticEidosValueNULL)->AddString_OS("mode", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("site")))->AddNumeric_ON("windows", gStaticEidosValueNULL));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqDivergence, kEidosValueMaskFloat))->AddObject("genomes1", gSLiM_Genome_Class)->AddObject("genomes2", gSLiM_Genome_Class)->AddString_OS("mode", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("site")))->AddNumeric_ON("windows", gStaticEidosValueNULL));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqFST, kEidosValueMaskFloat))->AddObject("genomes1", gSLiM_Genome_Class)->AddObject("genomes2", gSLiM_Genome_Class)->AddString_OS("mode", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("site")))->AddNumeric_ON("windows", gStaticEidosValueNULL));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqSFS, kEidosValueMaskFloat))->AddObject_ON("genomes", gSLiM_Genome_Class, gStaticEidosValueNULL)->AddString_OS("mode", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("site")))->AddNumeric_ON("windows", gStaticEidosValueNULL));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqSimplify, kEidosValueMaskVOID)));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqRememberIndividuals, kEidosValueMaskVOID))->AddObject("individuals", gSLiM_Individual_Class)->AddLogical_OS("permanent", gStaticEidosValue_LogicalT));
-		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqOutput, kEidosValueMaskVOID))->AddString_S("path")->AddLogical_OS("simplify", gStaticEidosValue_LogicalT)->AddLogical_OS("includeModel", gStaticEidosValue_LogicalT)->AddObject_OSN("metadata", nullptr, gStaticEidosValueNULL)->AddLogical_OS("_binary", gStaticEidosValue_LogicalT));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqOutput, kEidosValueMaskVOID))->AddString_S("path")->AddLogical_OS("simplify", gStaticEidosValue_LogicalT)->AddLogical_OS("includeModel", gStaticEidosValue_LogicalT)->AddObject_OSN("metadata", nullptr, gStaticEidosValueNULL)->AddIntObject_OSN("overlayMutationType", gSLiM_MutationType_Class, gStaticEidosValueNULL)->AddNumeric_OS("overlayMutationRate", gStaticEidosValue_Float0)->AddLogical_OS("compress", gStaticEidosValue_LogicalF)->AddLogical_OS("_binary", gStaticEidosValue_LogicalT));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr__debug, kEidosValueMaskVOID)));
 		
 		std::sort(methods->begin(), methods->end(), CompareEidosCallSignatures);
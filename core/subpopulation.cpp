@@ -599,28 +599,28 @@ void Subpopulation::CheckIndividualIntegrity(void)
 		{
 			// When the child generation is valid, all parental genomes should have null mutrun pointers, so mutrun refcounts are correct
 			for (int mutrun_index = 0; mutrun_index < genome1->mutrun_count_; ++mutrun_index)
-				if (genome1->mutruns_[mutrun_index] != nullptr)
+				if (genome1->MutationRunAtIndex(mutrun_index) != nullptr)
 					EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) a parental genome has a nonnull mutrun pointer." << EidosTerminate();
 			
 			for (int mutrun_index = 0; mutrun_index < genome2->mutrun_count_; ++mutrun_index)
-				if (genome2->mutruns_[mutrun_index] != nullptr)
+				if (genome2->MutationRunAtIndex(mutrun_index) != nullptr)
 					EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) a parental genome has a nonnull mutrun pointer." << EidosTerminate();
 		}
 		else
 		{
 			// When the parental generation is valid, all parental genomes should have non-null mutrun pointers
 			for (int mutrun_index = 0; mutrun_index < genome1->mutrun_count_; ++mutrun_index)
-				if (genome1->mutruns_[mutrun_index] == nullptr)
+				if (genome1->MutationRunAtIndex(mutrun_index) == nullptr)
 					EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) a parental genome has a null mutrun pointer." << EidosTerminate();
 			
 			for (int mutrun_index = 0; mutrun_index < genome2->mutrun_count_; ++mutrun_index)
-				if (genome2->mutruns_[mutrun_index] == nullptr)
+				if (genome2->MutationRunAtIndex(mutrun_index) == nullptr)
 					EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) a parental genome has a null mutrun pointer." << EidosTerminate();
 			
 			// check that every mutrun is used at only one mutrun index (particularly salient for empty mutruns)
 			for (int mutrun_index = 0; mutrun_index < genome1->mutrun_count_; ++mutrun_index)
 			{
-				const MutationRun *mutrun = genome1->mutruns_[mutrun_index];
+				const MutationRun *mutrun = genome1->MutationRunAtIndex(mutrun_index);
 				auto found_iter = mutrun_position_map.find(mutrun);
 				
 				if (found_iter == mutrun_position_map.end())
@@ -630,7 +630,7 @@ void Subpopulation::CheckIndividualIntegrity(void)
 			}
 			for (int mutrun_index = 0; mutrun_index < genome2->mutrun_count_; ++mutrun_index)
 			{
-				const MutationRun *mutrun = genome2->mutruns_[mutrun_index];
+				const MutationRun *mutrun = genome2->MutationRunAtIndex(mutrun_index);
 				auto found_iter = mutrun_position_map.find(mutrun);
 				
 				if (found_iter == mutrun_position_map.end())
@@ -745,17 +745,17 @@ void Subpopulation::CheckIndividualIntegrity(void)
 			{
 				// When the child generation is active, child genomes should have non-null mutrun pointers
 				for (int mutrun_index = 0; mutrun_index < genome1->mutrun_count_; ++mutrun_index)
-					if (genome1->mutruns_[mutrun_index] == nullptr)
+					if (genome1->MutationRunAtIndex(mutrun_index) == nullptr)
 						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) a child genome has a null mutrun pointer." << EidosTerminate();
 				
 				for (int mutrun_index = 0; mutrun_index < genome2->mutrun_count_; ++mutrun_index)
-					if (genome2->mutruns_[mutrun_index] == nullptr)
+					if (genome2->MutationRunAtIndex(mutrun_index) == nullptr)
 						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) a child genome has a null mutrun pointer." << EidosTerminate();
 				
 				// check that every mutrun is used at only one mutrun index (particularly salient for empty mutruns)
 				for (int mutrun_index = 0; mutrun_index < genome1->mutrun_count_; ++mutrun_index)
 				{
-					const MutationRun *mutrun = genome1->mutruns_[mutrun_index];
+					const MutationRun *mutrun = genome1->MutationRunAtIndex(mutrun_index);
 					auto found_iter = mutrun_position_map.find(mutrun);
 					
 					if (found_iter == mutrun_position_map.end())
@@ -765,7 +765,7 @@ void Subpopulation::CheckIndividualIntegrity(void)
 				}
 				for (int mutrun_index = 0; mutrun_index < genome2->mutrun_count_; ++mutrun_index)
 				{
-					const MutationRun *mutrun = genome2->mutruns_[mutrun_index];
+					const MutationRun *mutrun = genome2->MutationRunAtIndex(mutrun_index);
 					auto found_iter = mutrun_position_map.find(mutrun);
 					
 					if (found_iter == mutrun_position_map.end())
@@ -778,11 +778,11 @@ void Subpopulation::CheckIndividualIntegrity(void)
 			{
 				// When the parental generation is active, child genomes should have null mutrun pointers, so mutrun refcounts are correct
 				for (int mutrun_index = 0; mutrun_index < genome1->mutrun_count_; ++mutrun_index)
-					if (genome1->mutruns_[mutrun_index] != nullptr)
+					if (genome1->MutationRunAtIndex(mutrun_index) != nullptr)
 						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) a child genome has a nonnull mutrun pointer." << EidosTerminate();
 				
 				for (int mutrun_index = 0; mutrun_index < genome2->mutrun_count_; ++mutrun_index)
-					if (genome2->mutruns_[mutrun_index] != nullptr)
+					if (genome2->MutationRunAtIndex(mutrun_index) != nullptr)
 						EIDOS_TERMINATION << "ERROR (Subpopulation::CheckIndividualIntegrity): (internal error) a child genome has a nonnull mutrun pointer." << EidosTerminate();
 			}
 		}
@@ -1062,6 +1062,7 @@ void Subpopulation::FixNonNeutralCaches_OMP(void)
 #pragma omp single
 		{
 			int32_t nonneutral_change_counter = species_.nonneutral_change_counter_;
+			int32_t fitness_product_counter = species_.fitness_product_change_counter_;
 			int32_t nonneutral_regime = species_.last_nonneutral_regime_;
 			slim_popsize_t genomeCount = parent_subpop_size_ * 2;
 			
@@ -1072,11 +1073,11 @@ void Subpopulation::FixNonNeutralCaches_OMP(void)
 				
 				for (int run_index = 0; run_index < mutrun_count; ++run_index)
 				{
-					const MutationRun *mutrun = genome->mutruns_[run_index];
+					const MutationRun *mutrun = genome->MutationRunAtIndex(run_index);
 					
 					// This will start a new task if the mutrun needs to validate
 					// its nonneutral cache.  It avoids doing so more than once.
-					mutrun->validate_nonneutral_cache(nonneutral_change_counter, nonneutral_regime);
+					mutrun->validate_nonneutral_cache(nonneutral_change_counter, fitness_product_counter, nonneutral_regime);
 				}
 			}
 		}
@@ -2457,10 +2458,16 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 	
 #if SLIM_USE_NONNEUTRAL_CACHES
 	int32_t nonneutral_change_counter = species_.nonneutral_change_counter_;
+	int32_t fitness_product_counter = species_.fitness_product_change_counter_;
 	int32_t nonneutral_regime = species_.last_nonneutral_regime_;
 #endif
 	
-	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
+	const slim_selcoeff_t *mut_one_plus_sel = gSLiM_Mutation_OnePlusSel;
+	const slim_selcoeff_t *mut_one_plus_dom_sel = gSLiM_Mutation_OnePlusDomSel;
+#if !SLIM_USE_NONNEUTRAL_CACHES
+	const slim_selcoeff_t *mut_one_plus_haploiddom_sel = gSLiM_Mutation_OnePlusHaploidDomSel;
+#endif
 	Genome *genome1 = parent_genomes_[(size_t)p_individual_index * 2];
 	Genome *genome2 = parent_genomes_[(size_t)p_individual_index * 2 + 1];
 	bool genome1_null = genome1->IsNull();
@@ -2479,22 +2486,25 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
 		{
-			const MutationRun *mutrun = genome->mutruns_[run_index];
+			const MutationRun *mutrun = genome->MutationRunAtIndex(run_index);
 			
 #if SLIM_USE_NONNEUTRAL_CACHES
-			// Cache non-neutral mutations and read from the non-neutral buffers
+			// Cache non-neutral mutations, and use the product of their haploid fitness effects cached along with them
 			const MutationIndex *genome_iter, *genome_max;
 			
 			mutrun->beginend_nonneutral_pointers(&genome_iter, &genome_max, nonneutral_change_counter, nonneutral_regime);
+			mutrun->validate_nonneutral_fitness_products(fitness_product_counter);
+			
+			w *= mutrun->nonneutral_haploid_product();
 #else
 			// Read directly from the MutationRun buffers
 			const MutationIndex *genome_iter = mutrun->begin_pointer_const();
 			const MutationIndex *genome_max = mutrun->end_pointer_const();
-#endif
 			
 			// with an unpaired chromosome, we need to multiply each selection coefficient by the haploid dominance coefficient
 			while (genome_iter != genome_max)
-				w *= (mut_block_ptr + *genome_iter++)->cached_one_plus_haploiddom_sel_;
+				w *= mut_one_plus_haploiddom_sel[*genome_iter++];
+#endif
 		}
 		
 		return w;
@@ -2506,15 +2516,40 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
 		{
-			const MutationRun *mutrun1 = genome1->mutruns_[run_index];
-			const MutationRun *mutrun2 = genome2->mutruns_[run_index];
+			const MutationRun *mutrun1 = genome1->MutationRunAtIndex(run_index);
+			const MutationRun *mutrun2 = genome2->MutationRunAtIndex(run_index);
 			
 #if SLIM_USE_NONNEUTRAL_CACHES
 			// Cache non-neutral mutations and read from the non-neutral buffers
 			const MutationIndex *genome1_iter, *genome2_iter, *genome1_max, *genome2_max;
 			
 			mutrun1->beginend_nonneutral_pointers(&genome1_iter, &genome1_max, nonneutral_change_counter, nonneutral_regime);
+			
+			if (mutrun1 == mutrun2)
+			{
+				// Both genomes share this run (common after clonal or low-recombination inheritance), so every mutation in it is
+				// homozygous; the product cached with the run covers them all, and there is nothing to scan
+				mutrun1->validate_nonneutral_fitness_products(fitness_product_counter);
+				w *= mutrun1->nonneutral_homozygous_product();
+				continue;
+			}
+			
 			mutrun2->beginend_nonneutral_pointers(&genome2_iter, &genome2_max, nonneutral_change_counter, nonneutral_regime);
+			
+			if (genome1_iter == genome1_max)
+			{
+				// No non-neutral mutations in genome1's run, so every mutation in genome2's run is heterozygous
+				mutrun2->validate_nonneutral_fitness_products(fitness_product_counter);
+				w *= mutrun2->nonneutral_heterozygous_product();
+				continue;
+			}
+			if (genome2_iter == genome2_max)
+			{
+				// No non-neutral mutations in genome2's run, so every mutation in genome1's run is heterozygous
+				mutrun1->validate_nonneutral_fitness_products(fitness_product_counter);
+				w *= mutrun1->nonneutral_heterozygous_product();
+				continue;
+			}
 #else
 			// Read directly from the MutationRun buffers
 			const MutationIndex *genome1_iter = mutrun1->begin_pointer_const();
@@ -2528,32 +2563,32 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 			if (genome1_iter != genome1_max && genome2_iter != genome2_max)
 			{
 				MutationIndex genome1_mutation = *genome1_iter, genome2_mutation = *genome2_iter;
-				slim_position_t genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_, genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+				slim_position_t genome1_iter_position = mut_positions[genome1_mutation], genome2_iter_position = mut_positions[genome2_mutation];
 				
 				do
 				{
 					if (genome1_iter_position < genome2_iter_position)
 					{
 						// Process a mutation in genome1 since it is leading
-						w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_;
+						w *= mut_one_plus_dom_sel[genome1_mutation];
 						
 						if (++genome1_iter == genome1_max)
 							break;
 						else {
 							genome1_mutation = *genome1_iter;
-							genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+							genome1_iter_position = mut_positions[genome1_mutation];
 						}
 					}
 					else if (genome1_iter_position > genome2_iter_position)
 					{
 						// Process a mutation in genome2 since it is leading
-						w *= (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_;
+						w *= mut_one_plus_dom_sel[genome2_mutation];
 						
 						if (++genome2_iter == genome2_max)
 							break;
 						else {
 							genome2_mutation = *genome2_iter;
-							genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+							genome2_iter_position = mut_positions[genome2_mutation];
 						}
 					}
 					else
@@ -2568,12 +2603,12 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 							const MutationIndex *genome2_matchscan = genome2_iter; 
 							
 							// advance through genome2 with genome2_matchscan, looking for a match for the current mutation in genome1, to determine whether we are homozygous or not
-							while (genome2_matchscan != genome2_max && (mut_block_ptr + *genome2_matchscan)->position_ == position)
+							while (genome2_matchscan != genome2_max && mut_positions[*genome2_matchscan] == position)
 							{
 								if (genome1_mutation == *genome2_matchscan) 		// note pointer equality test
 								{
 									// a match was found, so we multiply our fitness by the full selection coefficient
-									w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_sel_;
+									w *= mut_one_plus_sel[genome1_mutation];
 									goto homozygousExit1;
 								}
 								
@@ -2581,7 +2616,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 							}
 							
 							// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-							w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_;
+							w *= mut_one_plus_dom_sel[genome1_mutation];
 							
 						homozygousExit1:
 							
@@ -2589,7 +2624,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 								break;
 							else {
 								genome1_mutation = *genome1_iter;
-								genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+								genome1_iter_position = mut_positions[genome1_mutation];
 							}
 						} while (genome1_iter_position == position);
 						
@@ -2599,7 +2634,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 							const MutationIndex *genome1_matchscan = genome1_start; 
 							
 							// advance through genome1 with genome1_matchscan, looking for a match for the current mutation in genome2, to determine whether we are homozygous or not
-							while (genome1_matchscan != genome1_max && (mut_block_ptr + *genome1_matchscan)->position_ == position)
+							while (genome1_matchscan != genome1_max && mut_positions[*genome1_matchscan] == position)
 							{
 								if (genome2_mutation == *genome1_matchscan)		// note pointer equality test
 								{
@@ -2611,7 +2646,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 							}
 							
 							// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-							w *= (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_;
+							w *= mut_one_plus_dom_sel[genome2_mutation];
 							
 						homozygousExit2:
 							
@@ -2619,7 +2654,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 								break;
 							else {
 								genome2_mutation = *genome2_iter;
-								genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+								genome2_iter_position = mut_positions[genome2_mutation];
 							}
 						} while (genome2_iter_position == position);
 						
@@ -2637,11 +2672,11 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 			
 			// if genome1 is unfinished, finish it
 			while (genome1_iter != genome1_max)
-				w *= (mut_block_ptr + *genome1_iter++)->cached_one_plus_dom_sel_;
+				w *= mut_one_plus_dom_sel[*genome1_iter++];
 			
 			// if genome2 is unfinished, finish it
 			while (genome2_iter != genome2_max)
-				w *= (mut_block_ptr + *genome2_iter++)->cached_one_plus_dom_sel_;
+				w *= mut_one_plus_dom_sel[*genome2_iter++];
 		}
 		
 		return w;
@@ -2660,7 +2695,10 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 	int32_t nonneutral_regime = species_.last_nonneutral_regime_;
 #endif
 	
-	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
+	const slim_selcoeff_t *mut_one_plus_sel = gSLiM_Mutation_OnePlusSel;
+	const slim_selcoeff_t *mut_one_plus_dom_sel = gSLiM_Mutation_OnePlusDomSel;
+	const slim_selcoeff_t *mut_one_plus_haploiddom_sel = gSLiM_Mutation_OnePlusHaploidDomSel;
 	Individual *individual = parent_individuals_[p_individual_index];
 	Genome *genome1 = parent_genomes_[(size_t)p_individual_index * 2];
 	Genome *genome2 = parent_genomes_[(size_t)p_individual_index * 2 + 1];
@@ -2680,7 +2718,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
 		{
-			const MutationRun *mutrun = genome->mutruns_[run_index];
+			const MutationRun *mutrun = genome->MutationRunAtIndex(run_index);
 			
 #if SLIM_USE_NONNEUTRAL_CACHES
 			// Cache non-neutral mutations and read from the non-neutral buffers
@@ -2698,7 +2736,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 			{
 				MutationIndex genome_mutation = *genome_iter;
 				
-				w *= ApplyMutationEffectCallbacks(genome_mutation, -1, (mut_block_ptr + genome_mutation)->cached_one_plus_haploiddom_sel_, p_mutationEffect_callbacks, individual);
+				w *= ApplyMutationEffectCallbacks(genome_mutation, -1, mut_one_plus_haploiddom_sel[genome_mutation], p_mutationEffect_callbacks, individual);
 				
 				if (w <= 0.0)
 					return 0.0;
@@ -2716,8 +2754,8 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
 		{
-			const MutationRun *mutrun1 = genome1->mutruns_[run_index];
-			const MutationRun *mutrun2 = genome2->mutruns_[run_index];
+			const MutationRun *mutrun1 = genome1->MutationRunAtIndex(run_index);
+			const MutationRun *mutrun2 = genome2->MutationRunAtIndex(run_index);
 			
 #if SLIM_USE_NONNEUTRAL_CACHES
 			// Cache non-neutral mutations and read from the non-neutral buffers
@@ -2738,14 +2776,14 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 			if (genome1_iter != genome1_max && genome2_iter != genome2_max)
 			{
 				MutationIndex genome1_mutation = *genome1_iter, genome2_mutation = *genome2_iter;
-				slim_position_t genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_, genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+				slim_position_t genome1_iter_position = mut_positions[genome1_mutation], genome2_iter_position = mut_positions[genome2_mutation];
 				
 				do
 				{
 					if (genome1_iter_position < genome2_iter_position)
 					{
 						// Process a mutation in genome1 since it is leading
-						w *= ApplyMutationEffectCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+						w *= ApplyMutationEffectCallbacks(genome1_mutation, false, mut_one_plus_dom_sel[genome1_mutation], p_mutationEffect_callbacks, individual);
 						
 						if (w <= 0.0)
 							return 0.0;
@@ -2754,13 +2792,13 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							break;
 						else {
 							genome1_mutation = *genome1_iter;
-							genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+							genome1_iter_position = mut_positions[genome1_mutation];
 						}
 					}
 					else if (genome1_iter_position > genome2_iter_position)
 					{
 						// Process a mutation in genome2 since it is leading
-						w *= ApplyMutationEffectCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+						w *= ApplyMutationEffectCallbacks(genome2_mutation, false, mut_one_plus_dom_sel[genome2_mutation], p_mutationEffect_callbacks, individual);
 						
 						if (w <= 0.0)
 							return 0.0;
@@ -2769,7 +2807,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							break;
 						else {
 							genome2_mutation = *genome2_iter;
-							genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+							genome2_iter_position = mut_positions[genome2_mutation];
 						}
 					}
 					else
@@ -2784,12 +2822,12 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							const MutationIndex *genome2_matchscan = genome2_iter; 
 							
 							// advance through genome2 with genome2_matchscan, looking for a match for the current mutation in genome1, to determine whether we are homozygous or not
-							while (genome2_matchscan != genome2_max && (mut_block_ptr + *genome2_matchscan)->position_ == position)
+							while (genome2_matchscan != genome2_max && mut_positions[*genome2_matchscan] == position)
 							{
 								if (genome1_mutation == *genome2_matchscan)		// note pointer equality test
 								{
 									// a match was found, so we multiply our fitness by the full selection coefficient
-									w *= ApplyMutationEffectCallbacks(genome1_mutation, true, (mut_block_ptr + genome1_mutation)->cached_one_plus_sel_, p_mutationEffect_callbacks, individual);
+									w *= ApplyMutationEffectCallbacks(genome1_mutation, true, mut_one_plus_sel[genome1_mutation], p_mutationEffect_callbacks, individual);
 									
 									goto homozygousExit3;
 								}
@@ -2798,7 +2836,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							}
 							
 							// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-							w *= ApplyMutationEffectCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+							w *= ApplyMutationEffectCallbacks(genome1_mutation, false, mut_one_plus_dom_sel[genome1_mutation], p_mutationEffect_callbacks, individual);
 							
 						homozygousExit3:
 							
@@ -2809,7 +2847,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 								break;
 							else {
 								genome1_mutation = *genome1_iter;
-								genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+								genome1_iter_position = mut_positions[genome1_mutation];
 							}
 						} while (genome1_iter_position == position);
 						
@@ -2819,7 +2857,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							const MutationIndex *genome1_matchscan = genome1_start; 
 							
 							// advance through genome1 with genome1_matchscan, looking for a match for the current mutation in genome2, to determine whether we are homozygous or not
-							while (genome1_matchscan != genome1_max && (mut_block_ptr + *genome1_matchscan)->position_ == position)
+							while (genome1_matchscan != genome1_max && mut_positions[*genome1_matchscan] == position)
 							{
 								if (genome2_mutation == *genome1_matchscan)		// note pointer equality test
 								{
@@ -2831,7 +2869,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							}
 							
 							// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-							w *= ApplyMutationEffectCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+							w *= ApplyMutationEffectCallbacks(genome2_mutation, false, mut_one_plus_dom_sel[genome2_mutation], p_mutationEffect_callbacks, individual);
 							
 							if (w <= 0.0)
 								return 0.0;
@@ -2842,7 +2880,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 								break;
 							else {
 								genome2_mutation = *genome2_iter;
-								genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+								genome2_iter_position = mut_positions[genome2_mutation];
 							}
 						} while (genome2_iter_position == position);
 						
@@ -2861,7 +2899,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 			{
 				MutationIndex genome1_mutation = *genome1_iter;
 				
-				w *= ApplyMutationEffectCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+				w *= ApplyMutationEffectCallbacks(genome1_mutation, false, mut_one_plus_dom_sel[genome1_mutation], p_mutationEffect_callbacks, individual);
 				
 				if (w <= 0.0)
 					return 0.0;
@@ -2874,7 +2912,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 			{
 				MutationIndex genome2_mutation = *genome2_iter;
 				
-				w *= ApplyMutationEffectCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+				w *= ApplyMutationEffectCallbacks(genome2_mutation, false, mut_one_plus_dom_sel[genome2_mutation], p_mutationEffect_callbacks, individual);
 				
 				if (w <= 0.0)
 					return 0.0;
@@ -2900,6 +2938,10 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 #endif
 	
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
+	const slim_selcoeff_t *mut_one_plus_sel = gSLiM_Mutation_OnePlusSel;
+	const slim_selcoeff_t *mut_one_plus_dom_sel = gSLiM_Mutation_OnePlusDomSel;
+	const slim_selcoeff_t *mut_one_plus_haploiddom_sel = gSLiM_Mutation_OnePlusHaploidDomSel;
 	Individual *individual = parent_individuals_[p_individual_index];
 	Genome *genome1 = parent_genomes_[(size_t)p_individual_index * 2];
 	Genome *genome2 = parent_genomes_[(size_t)p_individual_index * 2 + 1];
@@ -2919,7 +2961,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
 		{
-			const MutationRun *mutrun = genome->mutruns_[run_index];
+			const MutationRun *mutrun = genome->MutationRunAtIndex(run_index);
 			
 #if SLIM_USE_NONNEUTRAL_CACHES
 			// Cache non-neutral mutations and read from the non-neutral buffers
@@ -2939,14 +2981,14 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 				
 				if ((mut_block_ptr + genome_mutation)->mutation_type_ptr_ == p_single_callback_mut_type)
 				{
-					w *= ApplyMutationEffectCallbacks(genome_mutation, -1, (mut_block_ptr + genome_mutation)->cached_one_plus_haploiddom_sel_, p_mutationEffect_callbacks, individual);
+					w *= ApplyMutationEffectCallbacks(genome_mutation, -1, mut_one_plus_haploiddom_sel[genome_mutation], p_mutationEffect_callbacks, individual);
 					
 					if (w <= 0.0)
 						return 0.0;
 				}
 				else
 				{
-					w *= (mut_block_ptr + genome_mutation)->cached_one_plus_haploiddom_sel_;
+					w *= mut_one_plus_haploiddom_sel[genome_mutation];
 				}
 				
 				genome_iter++;
@@ -2962,8 +3004,8 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
 		{
-			const MutationRun *mutrun1 = genome1->mutruns_[run_index];
-			const MutationRun *mutrun2 = genome2->mutruns_[run_index];
+			const MutationRun *mutrun1 = genome1->MutationRunAtIndex(run_index);
+			const MutationRun *mutrun2 = genome2->MutationRunAtIndex(run_index);
 			
 #if SLIM_USE_NONNEUTRAL_CACHES
 			// Cache non-neutral mutations and read from the non-neutral buffers
@@ -2984,7 +3026,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 			if (genome1_iter != genome1_max && genome2_iter != genome2_max)
 			{
 				MutationIndex genome1_mutation = *genome1_iter, genome2_mutation = *genome2_iter;
-				slim_position_t genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_, genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+				slim_position_t genome1_iter_position = mut_positions[genome1_mutation], genome2_iter_position = mut_positions[genome2_mutation];
 				
 				do
 				{
@@ -2995,21 +3037,21 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 						
 						if (genome1_muttype == p_single_callback_mut_type)
 						{
-							w *= ApplyMutationEffectCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+							w *= ApplyMutationEffectCallbacks(genome1_mutation, false, mut_one_plus_dom_sel[genome1_mutation], p_mutationEffect_callbacks, individual);
 							
 							if (w <= 0.0)
 								return 0.0;
 						}
 						else
 						{
-							w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_;
+							w *= mut_one_plus_dom_sel[genome1_mutation];
 						}
 						
 						if (++genome1_iter == genome1_max)
 							break;
 						else {
 							genome1_mutation = *genome1_iter;
-							genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+							genome1_iter_position = mut_positions[genome1_mutation];
 						}
 					}
 					else if (genome1_iter_position > genome2_iter_position)
@@ -3019,21 +3061,21 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 						
 						if (genome2_muttype == p_single_callback_mut_type)
 						{
-							w *= ApplyMutationEffectCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+							w *= ApplyMutationEffectCallbacks(genome2_mutation, false, mut_one_plus_dom_sel[genome2_mutation], p_mutationEffect_callbacks, individual);
 							
 							if (w <= 0.0)
 								return 0.0;
 						}
 						else
 						{
-							w *= (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_;
+							w *= mut_one_plus_dom_sel[genome2_mutation];
 						}
 						
 						if (++genome2_iter == genome2_max)
 							break;
 						else {
 							genome2_mutation = *genome2_iter;
-							genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+							genome2_iter_position = mut_positions[genome2_mutation];
 						}
 					}
 					else
@@ -3052,12 +3094,12 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								const MutationIndex *genome2_matchscan = genome2_iter; 
 								
 								// advance through genome2 with genome2_matchscan, looking for a match for the current mutation in genome1, to determine whether we are homozygous or not
-								while (genome2_matchscan != genome2_max && (mut_block_ptr + *genome2_matchscan)->position_ == position)
+								while (genome2_matchscan != genome2_max && mut_positions[*genome2_matchscan] == position)
 								{
 									if (genome1_mutation == *genome2_matchscan)		// note pointer equality test
 									{
 										// a match was found, so we multiply our fitness by the full selection coefficient
-										w *= ApplyMutationEffectCallbacks(genome1_mutation, true, (mut_block_ptr + genome1_mutation)->cached_one_plus_sel_, p_mutationEffect_callbacks, individual);
+										w *= ApplyMutationEffectCallbacks(genome1_mutation, true, mut_one_plus_sel[genome1_mutation], p_mutationEffect_callbacks, individual);
 										
 										goto homozygousExit5;
 									}
@@ -3066,7 +3108,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								}
 								
 								// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-								w *= ApplyMutationEffectCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+								w *= ApplyMutationEffectCallbacks(genome1_mutation, false, mut_one_plus_dom_sel[genome1_mutation], p_mutationEffect_callbacks, individual);
 								
 							homozygousExit5:
 								
@@ -3078,12 +3120,12 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								const MutationIndex *genome2_matchscan = genome2_iter; 
 								
 								// advance through genome2 with genome2_matchscan, looking for a match for the current mutation in genome1, to determine whether we are homozygous or not
-								while (genome2_matchscan != genome2_max && (mut_block_ptr + *genome2_matchscan)->position_ == position)
+								while (genome2_matchscan != genome2_max && mut_positions[*genome2_matchscan] == position)
 								{
 									if (genome1_mutation == *genome2_matchscan) 		// note pointer equality test
 									{
 										// a match was found, so we multiply our fitness by the full selection coefficient
-										w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_sel_;
+										w *= mut_one_plus_sel[genome1_mutation];
 										goto homozygousExit6;
 									}
 									
@@ -3091,7 +3133,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								}
 								
 								// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-								w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_;
+								w *= mut_one_plus_dom_sel[genome1_mutation];
 								
 							homozygousExit6:
 								;
@@ -3101,7 +3143,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								break;
 							else {
 								genome1_mutation = *genome1_iter;
-								genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+								genome1_iter_position = mut_positions[genome1_mutation];
 							}
 						} while (genome1_iter_position == position);
 						
@@ -3115,7 +3157,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								const MutationIndex *genome1_matchscan = genome1_start; 
 								
 								// advance through genome1 with genome1_matchscan, looking for a match for the current mutation in genome2, to determine whether we are homozygous or not
-								while (genome1_matchscan != genome1_max && (mut_block_ptr + *genome1_matchscan)->position_ == position)
+								while (genome1_matchscan != genome1_max && mut_positions[*genome1_matchscan] == position)
 								{
 									if (genome2_mutation == *genome1_matchscan)		// note pointer equality test
 									{
@@ -3127,7 +3169,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								}
 								
 								// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-								w *= ApplyMutationEffectCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+								w *= ApplyMutationEffectCallbacks(genome2_mutation, false, mut_one_plus_dom_sel[genome2_mutation], p_mutationEffect_callbacks, individual);
 								
 								if (w <= 0.0)
 									return 0.0;
@@ -3140,7 +3182,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								const MutationIndex *genome1_matchscan = genome1_start; 
 								
 								// advance through genome1 with genome1_matchscan, looking for a match for the current mutation in genome2, to determine whether we are homozygous or not
-								while (genome1_matchscan != genome1_max && (mut_block_ptr + *genome1_matchscan)->position_ == position)
+								while (genome1_matchscan != genome1_max && mut_positions[*genome1_matchscan] == position)
 								{
 									if (genome2_mutation == *genome1_matchscan)		// note pointer equality test
 									{
@@ -3152,7 +3194,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								}
 								
 								// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-								w *= (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_;
+								w *= mut_one_plus_dom_sel[genome2_mutation];
 								
 							homozygousExit8:
 								;
@@ -3162,7 +3204,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								break;
 							else {
 								genome2_mutation = *genome2_iter;
-								genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+								genome2_iter_position = mut_positions[genome2_mutation];
 							}
 						} while (genome2_iter_position == position);
 						
@@ -3184,14 +3226,14 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 				
 				if (genome1_muttype == p_single_callback_mut_type)
 				{
-					w *= ApplyMutationEffectCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+					w *= ApplyMutationEffectCallbacks(genome1_mutation, false, mut_one_plus_dom_sel[genome1_mutation], p_mutationEffect_callbacks, individual);
 					
 					if (w <= 0.0)
 						return 0.0;
 				}
 				else
 				{
-					w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_;
+					w *= mut_one_plus_dom_sel[genome1_mutation];
 				}
 				
 				genome1_iter++;
@@ -3205,14 +3247,14 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 				
 				if (genome2_muttype == p_single_callback_mut_type)
 				{
-					w *= ApplyMutationEffectCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_mutationEffect_callbacks, individual);
+					w *= ApplyMutationEffectCallbacks(genome2_mutation, false, mut_one_plus_dom_sel[genome2_mutation], p_mutationEffect_callbacks, individual);
 					
 					if (w <= 0.0)
 						return 0.0;
 				}
 				else
 				{
-					w *= (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_;
+					w *= mut_one_plus_dom_sel[genome2_mutation];
 				}
 				
 				genome2_iter++;
@@ -3747,10 +3789,14 @@ void Subpopulation::ViabilitySurvival(std::vector<SLiMEidosBlock*> &p_survival_c
 	// pre-plan mortality; this avoids issues with callbacks accessing the subpop state while buffers are being modified
 	if (no_callbacks)
 	{
-		// this is the simple case with no callbacks and thus no shuffle buffer
+		// this is the simple case with no callbacks and thus no shuffle buffer; in deterministic mode, each chunk of 1024 individuals
+		// (matching the schedule) draws from its own keyed RNG stream, so the outcome does not depend on the number of threads
+		Eidos_RNG_KeyedRegion keyed_region(gEidosDeterministicParallel);
+		uint64_t rng_key = keyed_region.Key();
+		
 		EIDOS_BENCHMARK_START(EidosBenchmarkType::k_SURVIVAL);
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SURVIVAL);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, survival_buffer, parent_subpop_size_) firstprivate(individual_data) if(parent_subpop_size_ >= EIDOS_OMPMIN_SURVIVAL) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, survival_buffer, parent_subpop_size_, rng_key) firstprivate(individual_data) if(parent_subpop_size_ >= EIDOS_OMPMIN_SURVIVAL) num_threads(thread_count)
 		{
 			uint8_t *survival_buf_perthread = survival_buffer;
 			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
@@ -3758,6 +3804,9 @@ void Subpopulation::ViabilitySurvival(std::vector<SLiMEidosBlock*> &p_survival_c
 #pragma omp for schedule(dynamic, 1024) nowait
 			for (int individual_index = 0; individual_index < parent_subpop_size_; ++individual_index)
 			{
+				if (rng_key && (individual_index % 1024 == 0))
+					Eidos_RNG_SeedKeyedStream(EIDOS_STATE_RNG(omp_get_thread_num()), rng_key, (uint64_t)(individual_index / 1024));
+				
 				Individual *individual = individual_data[individual_index];
 				double fitness = individual->cached_fitness_UNSAFE_;	// never overridden in nonWF models, so this is safe with no check
 				uint8_t survived;
@@ -4524,6 +4573,9 @@ EidosValue_SP Subpopulation::ExecuteMethod_addCloned(EidosGlobalStringID p_metho
 	if (community_.executing_block_type_ != SLiMEidosBlockType::SLiMEidosReproductionCallback)
 		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCloned): method -addCloned() may not be called from a nested callback." << EidosTerminate();
 	
+	// script in the callback may have added nucleotide mutations since the mutation rate tables were last brought up to date
+	species_.TheChromosome().PrepareNucleotideMutationDraws();
+	
 	// Get and check the first parent (the mother)
 	EidosValue *parent_value = p_arguments[0].get();
 	Individual *parent = (Individual *)parent_value->ObjectData()[0];
@@ -4574,9 +4626,6 @@ EidosValue_SP Subpopulation::ExecuteMethod_addCloned(EidosGlobalStringID p_metho
 	EidosValue *defer_value = p_arguments[2].get();
 	bool defer = defer_value->LogicalData()[0];
 	
-	if (defer && parent_mutation_callbacks)
-		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCloned): deferred reproduction cannot be used when mutation() callbacks are enabled." << EidosTerminate();
-	
 	for (int64_t child_index = 0; child_index < child_count; ++child_index)
 	{
 		// Make the new individual as a candidate
@@ -4659,6 +4708,9 @@ EidosValue_SP Subpopulation::ExecuteMethod_addCrossed(EidosGlobalStringID p_meth
 	if (community_.executing_block_type_ != SLiMEidosBlockType::SLiMEidosReproductionCallback)
 		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossed): method -addCrossed() may not be called from a nested callback." << EidosTerminate();
 	
+	// script in the callback may have added nucleotide mutations since the mutation rate tables were last brought up to date
+	species_.TheChromosome().PrepareNucleotideMutationDraws();
+	
 	// Get and check the first parent (the mother)
 	EidosValue *parent1_value = p_arguments[0].get();
 	Individual *parent1 = (Individual *)parent1_value->ObjectData()[0];
@@ -4721,9 +4773,6 @@ EidosValue_SP Subpopulation::ExecuteMethod_addCrossed(EidosGlobalStringID p_meth
 	EidosValue *defer_value = p_arguments[4].get();
 	bool defer = defer_value->LogicalData()[0];
 	
-	if (defer && (parent1_recombination_callbacks || parent2_recombination_callbacks || parent1_mutation_callbacks || parent2_mutation_callbacks))
-		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addCrossed): deferred reproduction cannot be used when recombination() or mutation() callbacks are enabled." << EidosTerminate();
-	
 	EidosValue *sex_value = p_arguments[2].get();
 	
 	for (int64_t child_index = 0; child_index < child_count; ++child_index)
@@ -4922,9 +4971,9 @@ EidosValue_SP Subpopulation::ExecuteMethod_addEmpty(EidosGlobalStringID p_method
 				const MutationRun *mutrun = MutationRun::NewMutationRun(mutrun_context);
 				
 				if (!genome1_null)
-					genome1->mutruns_[run_index] = mutrun;
+					genome1->SetMutationRunAtIndex(run_index, mutrun);
 				if (!genome2_null)
-					genome2->mutruns_[run_index] = mutrun;
+					genome2->SetMutationRunAtIndex(run_index, mutrun);
 			}
 		}
 		
@@ -4972,6 +5021,9 @@ EidosValue_SP Subpopulation::ExecuteMethod_addRecombinant(EidosGlobalStringID p_
 	if (community_.executing_block_type_ != SLiMEidosBlockType::SLiMEidosReproductionCallback)
 		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addRecombinant): method -addRecombinant() may not be called from a nested callback." << EidosTerminate();
 	
+	// script in the callback may have added nucleotide mutations since the mutation rate tables were last brought up to date
+	species_.TheChromosome().PrepareNucleotideMutationDraws();
+	
 	// We could technically make this work in the no-genetics case, if the parameters specify that both child genomes are null, but there's
 	// really no reason for anybody to use addRecombinant() in that case, and getting all the logic correct below would be error-prone.
 	if (!species_.HasGenetics())
@@ -5104,9 +5156,6 @@ EidosValue_SP Subpopulation::ExecuteMethod_addRecombinant(EidosGlobalStringID p_
 	EidosValue *defer_value = p_arguments[11].get();
 	bool defer = defer_value->LogicalData()[0];
 	
-	if (defer && mutation_callbacks)
-		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addRecombinant): deferred reproduction cannot be used when mutation() callbacks are enabled." << EidosTerminate();
-	
 	for (int64_t child_index = 0; child_index < child_count; ++child_index)
 	{
 		GenomeType genome1_type, genome2_type;
@@ -5551,6 +5600,9 @@ EidosValue_SP Subpopulation::ExecuteMethod_addSelfed(EidosGlobalStringID p_metho
 	if (community_.executing_block_type_ != SLiMEidosBlockType::SLiMEidosReproductionCallback)
 		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addSelfed): method -addSelfed() may not be called from a nested callback." << EidosTerminate();
 	
+	// script in the callback may have added nucleotide mutations since the mutation rate tables were last brought up to date
+	species_.TheChromosome().PrepareNucleotideMutationDraws();
+	
 	// Get and check the first parent (the mother)
 	EidosValue *parent_value = p_arguments[0].get();
 	Individual *parent = (Individual *)parent_value->ObjectData()[0];
@@ -5613,9 +5665,6 @@ EidosValue_SP Subpopulation::ExecuteMethod_addSelfed(EidosGlobalStringID p_metho
 	EidosValue *defer_value = p_arguments[2].get();
 	bool defer = defer_value->LogicalData()[0];
 	
-	if (defer && (parent_recombination_callbacks || parent_mutation_callbacks))
-		EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_addSelfed): deferred reproduction cannot be used when recombination() or mutation() callbacks are enabled." << EidosTerminate();
-	
 	for (int64_t child_index = 0; child_index < child_count; ++child_index)
 	{
 		// Make the new individual as a candidate
@@ -7125,7 +7174,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_pointUniform(EidosGlobalStringID p_me
 		case 1:
 		{
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_POINT_UNIFORM_1D);
-#pragma omp parallel default(none) shared(point_count, gEidos_RNG_PERTHREAD) firstprivate(float_result_data) if(point_count >= EIDOS_OMPMIN_POINT_UNIFORM_1D) num_threads(thread_count)
+#pragma omp parallel default(none) shared(point_count, gEidos_RNG_PERTHREAD) firstprivate(float_result_data) if((point_count >= EIDOS_OMPMIN_POINT_UNIFORM_1D) && !gEidosDeterministicParallel) num_threads(thread_count)
 			{
 				gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 				double xsize = bounds_x1_ - bounds_x0_, xbase = bounds_x0_;
@@ -7141,7 +7190,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_pointUniform(EidosGlobalStringID p_me
 		case 2:
 		{
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_POINT_UNIFORM_2D);
-#pragma omp parallel default(none) shared(point_count, gEidos_RNG_PERTHREAD) firstprivate(float_result_data) if(point_count >= EIDOS_OMPMIN_POINT_UNIFORM_2D) num_threads(thread_count)
+#pragma omp parallel default(none) shared(point_count, gEidos_RNG_PERTHREAD) firstprivate(float_result_data) if((point_count >= EIDOS_OMPMIN_POINT_UNIFORM_2D) && !gEidosDeterministicParallel) num_threads(thread_count)
 			{
 				gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 				double xsize = bounds_x1_ - bounds_x0_, xbase = bounds_x0_;
@@ -7159,7 +7208,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_pointUniform(EidosGlobalStringID p_me
 		case 3:
 		{
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_POINT_UNIFORM_3D);
-#pragma omp parallel default(none) shared(point_count, gEidos_RNG_PERTHREAD) firstprivate(float_result_data) if(point_count >= EIDOS_OMPMIN_POINT_UNIFORM_3D) num_threads(thread_count)
+#pragma omp parallel default(none) shared(point_count, gEidos_RNG_PERTHREAD) firstprivate(float_result_data) if((point_count >= EIDOS_OMPMIN_POINT_UNIFORM_3D) && !gEidosDeterministicParallel) num_threads(thread_count)
 			{
 				gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 				double xsize = bounds_x1_ - bounds_x0_, xbase = bounds_x0_;
@@ -7607,7 +7656,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_sampleIndividuals(EidosGlobalStringID
 			EidosObject **object_result_data = result->data_mutable();
 			
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_SAMPLE_INDIVIDUALS_1);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, sample_size) firstprivate(candidate_count, first_candidate_index, excluded_index, object_result_data) if(sample_size >= EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_1) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, sample_size) firstprivate(candidate_count, first_candidate_index, excluded_index, object_result_data) if((sample_size >= EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_1) && !gEidosDeterministicParallel) num_threads(thread_count)
 			{
 				gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 				
@@ -7867,7 +7916,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_sampleIndividuals(EidosGlobalStringID
 		{
 			// base case with replacement
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_SAMPLE_INDIVIDUALS_2);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, sample_size, index_buffer) firstprivate(candidate_count, object_result_data) if(sample_size >= EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_2) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, sample_size, index_buffer) firstprivate(candidate_count, object_result_data) if((sample_size >= EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_2) && !gEidosDeterministicParallel) num_threads(thread_count)
 			{
 				gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 				
@@ -52,6 +52,20 @@
 #pragma mark Distribution draw/density functions
 #pragma mark -
 
+// The bulk fills in eidos_rng.h (Eidos_rng_uniform_fill() etc.) need a contiguous range of draws; inside a parallel region,
+// this gives each thread the same contiguous block that schedule(static) would, to fill from its own RNG.  Outside a parallel
+// region, or in a single-threaded build, it gives the whole range.
+static inline void _Eidos_ThreadDrawRange(int64_t p_count, int64_t *p_start, int64_t *p_thread_count)
+{
+	int64_t thread_count = omp_get_num_threads();
+	int64_t thread_num = omp_get_thread_num();
+	int64_t base_count = p_count / thread_count;
+	int64_t extra_count = p_count % thread_count;
+	
+	*p_start = thread_num * base_count + std::min(thread_num, extra_count);
+	*p_thread_count = base_count + ((thread_num < extra_count) ? 1 : 0);
+}
+
 
 //	(integer)findInterval(numeric x, numeric vec, [logical$ rightmostClosed = F], [logical$ allInside = F])
 EidosValue_SP Eidos_ExecuteFunction_findInterval(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
@@ -806,7 +820,7 @@ EidosValue_SP Eidos_ExecuteFunction_rbinom(const std::vector<EidosValue_SP> &p_a
 		{
 			// Special-case a probability of 0.5 since we can use Eidos_RandomBool() for it
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_RBINOM_1);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result) if(num_draws >= EIDOS_OMPMIN_RBINOM_1) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result) if((num_draws >= EIDOS_OMPMIN_RBINOM_1) && !gEidosDeterministicParallel) num_threads(thread_count)
 			{
 				Eidos_RNG_State *rng_state = EIDOS_STATE_RNG(omp_get_thread_num());
 				
@@ -818,7 +832,7 @@ EidosValue_SP Eidos_ExecuteFunction_rbinom(const std::vector<EidosValue_SP> &p_a
 		else
 		{
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_RBINOM_2);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, probability0, size0) if(num_draws >= EIDOS_OMPMIN_RBINOM_2) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, probability0, size0) if((num_draws >= EIDOS_OMPMIN_RBINOM_2) && !gEidosDeterministicParallel) num_threads(thread_count)
 			{
 				gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 				
@@ -836,7 +850,7 @@ EidosValue_SP Eidos_ExecuteFunction_rbinom(const std::vector<EidosValue_SP> &p_a
 		bool saw_error1 = false, saw_error2 = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_RBINOM_3);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, size_singleton, prob_singleton, size0, probability0, size_data, prob_data) reduction(||: saw_error1) reduction(||: saw_error2) if(num_draws >= EIDOS_OMPMIN_RBINOM_3) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, size_singleton, prob_singleton, size0, probability0, size_data, prob_data) reduction(||: saw_error1) reduction(||: saw_error2) if((num_draws >= EIDOS_OMPMIN_RBINOM_3) && !gEidosDeterministicParallel) num_threads(thread_count)
 		{
 			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 			
@@ -970,7 +984,7 @@ EidosValue_SP Eidos_ExecuteFunction_rdunif(const std::vector<EidosValue_SP> &p_a
 		if (count0 == 2)
 		{
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_RDUNIF_1);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, min_value0) if(num_draws >= EIDOS_OMPMIN_RDUNIF_1) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, min_value0) if((num_draws >= EIDOS_OMPMIN_RDUNIF_1) && !gEidosDeterministicParallel) num_threads(thread_count)
 			{
 				Eidos_RNG_State *rng_state = EIDOS_STATE_RNG(omp_get_thread_num());
 				
@@ -982,7 +996,7 @@ EidosValue_SP Eidos_ExecuteFunction_rdunif(const std::vector<EidosValue_SP> &p_a
 		else
 		{
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_RDUNIF_2);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, min_value0, count0) if(num_draws >= EIDOS_OMPMIN_RDUNIF_2) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, min_value0, count0) if((num_draws >= EIDOS_OMPMIN_RDUNIF_2) && !gEidosDeterministicParallel) num_threads(thread_count)
 			{
 				Eidos_MT_State *mt = EIDOS_MT_RNG(omp_get_thread_num());
 				
@@ -1000,7 +1014,7 @@ EidosValue_SP Eidos_ExecuteFunction_rdunif(const std::vector<EidosValue_SP> &p_a
 		bool saw_error = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_RDUNIF_3);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, min_singleton, max_singleton, min_value0, max_value0, min_data, max_data) reduction(||: saw_error) if(num_draws >= EIDOS_OMPMIN_RDUNIF_3) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, min_singleton, max_singleton, min_value0, max_value0, min_data, max_data) reduction(||: saw_error) if((num_draws >= EIDOS_OMPMIN_RDUNIF_3) && !gEidosDeterministicParallel) num_threads(thread_count)
 		{
 			Eidos_MT_State *mt = EIDOS_MT_RNG(omp_get_thread_num());
 			
@@ -1093,16 +1107,17 @@ EidosValue_SP Eidos_ExecuteFunction_rexp(const std::vector<EidosValue_SP> &p_arg
 	{
 		double mu0 = arg_mu->NumericAtIndex_NOCAST(0, nullptr);
 		EidosValue_Float *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(num_draws);
+		double *float_data = float_result->data_mutable();
 		result_SP = EidosValue_SP(float_result);
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_REXP_1);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_result, mu0) if(num_draws >= EIDOS_OMPMIN_REXP_1) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_data, mu0) if((num_draws >= EIDOS_OMPMIN_REXP_1) && !gEidosDeterministicParallel) num_threads(thread_count)
 		{
 			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
+			int64_t draw_start, draw_count;
 			
-#pragma omp for schedule(static) nowait
-			for (int64_t draw_index = 0; draw_index < num_draws; ++draw_index)
-				float_result->set_float_no_check(gsl_ran_exponential(rng, mu0), draw_index);
+			_Eidos_ThreadDrawRange(num_draws, &draw_start, &draw_count);
+			Eidos_ran_exponential_fill(rng, float_data + draw_start, draw_count, mu0);
 		}
 	}
 	else
@@ -1111,7 +1126,7 @@ EidosValue_SP Eidos_ExecuteFunction_rexp(const std::vector<EidosValue_SP> &p_arg
 		result_SP = EidosValue_SP(float_result);
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_REXP_2);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_result, arg_mu) if(num_draws >= EIDOS_OMPMIN_REXP_2) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_result, arg_mu) if((num_draws >= EIDOS_OMPMIN_REXP_2) && !gEidosDeterministicParallel) num_threads(thread_count)
 		{
 			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 				
@@ -1647,20 +1662,22 @@ EidosValue_SP Eidos_ExecuteFunction_rnorm(const std::vector<EidosValue_SP> &p_ar
 	
 	if (mu_singleton && sigma_singleton)
 	{
+		double *float_data = float_result->data_mutable();
+		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_RNORM_1);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_result, sigma0, mu0) if(num_draws >= EIDOS_OMPMIN_RNORM_1) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_data, sigma0, mu0) if((num_draws >= EIDOS_OMPMIN_RNORM_1) && !gEidosDeterministicParallel) num_threads(thread_count)
 		{
 			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
+			int64_t draw_start, draw_count;
 			
-#pragma omp for schedule(static) nowait
-			for (int64_t draw_index = 0; draw_index < num_draws; ++draw_index)
-				float_result->set_float_no_check(gsl_ran_gaussian(rng, sigma0) + mu0, draw_index);
+			_Eidos_ThreadDrawRange(num_draws, &draw_start, &draw_count);
+			Eidos_ran_gaussian_fill(rng, float_data + draw_start, draw_count, sigma0, mu0);
 		}
 	}
 	else if (sigma_singleton)	// && !mu_singleton
 	{
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_RNORM_2);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_result, sigma0, arg_mu) if(num_draws >= EIDOS_OMPMIN_RNORM_2) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_result, sigma0, arg_mu) if((num_draws >= EIDOS_OMPMIN_RNORM_2) && !gEidosDeterministicParallel) num_threads(thread_count)
 		{
 			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 			
@@ -1678,7 +1695,7 @@ EidosValue_SP Eidos_ExecuteFunction_rnorm(const std::vector<EidosValue_SP> &p_ar
 		bool saw_error = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_RNORM_3);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_result, mu_singleton, mu0, arg_mu, arg_sigma) reduction(||: saw_error) if(num_draws >= EIDOS_OMPMIN_RNORM_3) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_result, mu_singleton, mu0, arg_mu, arg_sigma) reduction(||: saw_error) if((num_draws >= EIDOS_OMPMIN_RNORM_3) && !gEidosDeterministicParallel) num_threads(thread_count)
 		{
 			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 			
@@ -1738,7 +1755,7 @@ EidosValue_SP Eidos_ExecuteFunction_rpois(const std::vector<EidosValue_SP> &p_ar
 		result_SP = EidosValue_SP(int_result);
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_RPOIS_1);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, lambda0) if(num_draws >= EIDOS_OMPMIN_RPOIS_1) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, lambda0) if((num_draws >= EIDOS_OMPMIN_RPOIS_1) && !gEidosDeterministicParallel) num_threads(thread_count)
 		{
 			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 			
@@ -1755,7 +1772,7 @@ EidosValue_SP Eidos_ExecuteFunction_rpois(const std::vector<EidosValue_SP> &p_ar
 		bool saw_error = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_RPOIS_2);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, arg_lambda) reduction(||: saw_error) if(num_draws >= EIDOS_OMPMIN_RPOIS_2) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(int_result, arg_lambda) reduction(||: saw_error) if((num_draws >= EIDOS_OMPMIN_RPOIS_2) && !gEidosDeterministicParallel) num_threads(thread_count)
 		{
 			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 			
@@ -1811,16 +1828,17 @@ EidosValue_SP Eidos_ExecuteFunction_runif(const std::vector<EidosValue_SP> &p_ar
 	{
 		// With the default min and max, we can streamline quite a bit
 		EidosValue_Float *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(num_draws);
+		double *float_data = float_result->data_mutable();
 		result_SP = EidosValue_SP(float_result);
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_RUNIF_1);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws, std::cout) firstprivate(float_result) if(num_draws >= EIDOS_OMPMIN_RUNIF_1) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_data) if((num_draws >= EIDOS_OMPMIN_RUNIF_1) && !gEidosDeterministicParallel) num_threads(thread_count)
 		{
 			gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
+			int64_t draw_start, draw_count;
 			
-#pragma omp for schedule(static) nowait
-			for (int64_t draw_index = 0; draw_index < num_draws; ++draw_index)
-				float_result->set_float_no_check(Eidos_rng_uniform(rng), draw_index);
+			_Eidos_ThreadDrawRange(num_draws, &draw_start, &draw_count);
+			Eidos_rng_uniform_fill(rng, float_data + draw_start, draw_count, 1.0, 0.0);
 		}
 	}
 	else
@@ -1833,16 +1851,17 @@ EidosValue_SP Eidos_ExecuteFunction_runif(const std::vector<EidosValue_SP> &p_ar
 				EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_runif): function runif() requires min < max." << EidosTerminate(nullptr);
 			
 			EidosValue_Float *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(num_draws);
+			double *float_data = float_result->data_mutable();
 			result_SP = EidosValue_SP(float_result);
 			
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_RUNIF_2);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_result, range0, min_value0) if(num_draws >= EIDOS_OMPMIN_RUNIF_2) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_data, range0, min_value0) if((num_draws >= EIDOS_OMPMIN_RUNIF_2) && !gEidosDeterministicParallel) num_threads(thread_count)
 			{
 				gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
+				int64_t draw_start, draw_count;
 				
-#pragma omp for schedule(static) nowait
-				for (int64_t draw_index = 0; draw_index < num_draws; ++draw_index)
-					float_result->set_float_no_check(Eidos_rng_uniform(rng) * range0 + min_value0, draw_index);
+				_Eidos_ThreadDrawRange(num_draws, &draw_start, &draw_count);
+				Eidos_rng_uniform_fill(rng, float_data + draw_start, draw_count, range0, min_value0);
 			}
 		}
 		else
@@ -1853,7 +1872,7 @@ EidosValue_SP Eidos_ExecuteFunction_runif(const std::vector<EidosValue_SP> &p_ar
 			bool saw_error = false;
 			
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_RUNIF_3);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_result, min_singleton, max_singleton, min_value0, max_value0, arg_min, arg_max) reduction(||: saw_error) if(num_draws >= EIDOS_OMPMIN_RUNIF_3) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, num_draws) firstprivate(float_result, min_singleton, max_singleton, min_value0, max_value0, arg_min, arg_max) reduction(||: saw_error) if((num_draws >= EIDOS_OMPMIN_RUNIF_3) && !gEidosDeterministicParallel) num_threads(thread_count)
 			{
 				gsl_rng *rng = EIDOS_GSL_RNG(omp_get_thread_num());
 				
@@ -2461,7 +2461,7 @@ EidosValue_SP Eidos_ExecuteFunction_sum(const std::vector<EidosValue_SP> &p_argu
 		double sum = 0;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SUM_FLOAT);
-#pragma omp parallel for simd schedule(simd:static) default(none) shared(x_count) firstprivate(float_data) reduction(+: sum) if(parallel:x_count >= EIDOS_OMPMIN_SUM_FLOAT) num_threads(thread_count)
+#pragma omp parallel for simd schedule(simd:static) default(none) shared(x_count) firstprivate(float_data) reduction(+: sum) if(parallel:(x_count >= EIDOS_OMPMIN_SUM_FLOAT) && !gEidosDeterministicParallel) num_threads(thread_count)
 		for (int value_index = 0; value_index < x_count; ++value_index)
 			sum += float_data[value_index];
 		
@@ -936,6 +936,12 @@ EidosValue_SP Eidos_ExecuteFunction_parallelGetTaskThreadCounts(__attribute__((u
 	return result_SP;
 }
 
+//	(logical$)parallelGetDeterministic(void)
+EidosValue_SP Eidos_ExecuteFunction_parallelGetDeterministic(__attribute__((unused)) const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	return (gEidosDeterministicParallel ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+}
+
 //	(void)parallelSetNumThreads([Ni$ numThreads = NULL])
 EidosValue_SP Eidos_ExecuteFunction_parallelSetNumThreads(__attribute__((unused)) const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
 {
@@ -1163,6 +1169,17 @@ EidosValue_SP Eidos_ExecuteFunction_parallelSetTaskThreadCounts(__attribute__((u
 	return gStaticEidosValueVOID;
 }
 
+//	(void)parallelSetDeterministic(logical$ deterministic)
+EidosValue_SP Eidos_ExecuteFunction_parallelSetDeterministic(__attribute__((unused)) const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	EidosValue *deterministic_value = p_arguments[0].get();
+	
+	// Like parallelSetNumThreads(), this is global state; SLiM resets it to F when a new model is constructed
+	gEidosDeterministicParallel = deterministic_value->LogicalAtIndex_NOCAST(0, nullptr);
+	
+	return gStaticEidosValueVOID;
+}
+
 //	(void)rm([Ns variableNames = NULL])		// [logical$ removeConstants = F] removed in SLiM 4
 EidosValue_SP Eidos_ExecuteFunction_rm(const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -72,9 +72,15 @@
 // for Eidos_calc_sha_256()
 #include <stdint.h>
 
-// for _Eidos_FlushZipBuffer()
+// for _Eidos_FlushZipBuffer() and Eidos_GzipStreamToFile()
 #include "../eidos_zlib/zlib.h"
 
+// for Eidos_GunzipFileToTemporaryFile()
+#include "lodepng.h"
+#ifndef _WIN32
+#include <sys/statvfs.h>
+#endif
+
 // for Eidos_ColorPaletteLookup()
 #include "eidos_tinycolormap.h"
 
@@ -93,6 +99,7 @@
 int gEidosMaxThreads = 1;
 int gEidosNumThreads = 1;
 bool gEidosNumThreadsOverride = false;
+bool gEidosDeterministicParallel = false;
 
 
 // Require 64-bit; apparently there are some issues on 32-bit, and nobody should be doing that anyway
@@ -2836,6 +2843,190 @@ void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const s
 	}
 }
 
+bool Eidos_FileIsGzipCompressed(const std::string &p_file_path)
+{
+	std::ifstream infile(p_file_path.c_str(), std::ios::in | std::ios::binary);
+	unsigned char magic[2] = {0, 0};
+	
+	if (!infile.is_open())
+		return false;
+	
+	infile.read(reinterpret_cast<char *>(&magic[0]), 2);
+	
+	return (infile.gcount() == 2) && (magic[0] == 0x1f) && (magic[1] == 0x8b);
+}
+
+bool Eidos_GzipStreamToFile(FILE *p_source, const std::string &p_gz_path)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_GzipStreamToFile():  filesystem write");
+	
+	// compress the whole of p_source, from its beginning, into a single gzip member; gzwrite() does its own buffering
+	gzFile gzf = gzopen(p_gz_path.c_str(), "wb");
+	
+	if (!gzf)
+		return false;
+	
+	bool failed = false;
+	std::vector<char> buffer(1024 * 1024);
+	
+	rewind(p_source);
+	
+	while (!failed)
+	{
+		size_t read_count = fread(buffer.data(), 1, buffer.size(), p_source);
+		
+		if (read_count > 0)
+			failed = (gzwrite(gzf, buffer.data(), (unsigned)read_count) == 0);
+		
+		if (read_count < buffer.size())
+		{
+			failed = failed || ferror(p_source);
+			break;
+		}
+	}
+	
+	if (gzclose_w(gzf) != Z_OK)
+		failed = true;
+	
+	return !failed;
+}
+
+// Returns false if the filesystem containing p_dir_path is known to have less than p_bytes available; true if it has room, or if we
+// can't tell (in which case a failure will be caught when writing)
+static bool _Eidos_DirectoryHasSpace(const std::string &p_dir_path, uint64_t p_bytes)
+{
+#ifndef _WIN32
+	struct statvfs fs_info;
+	
+	if (statvfs(p_dir_path.c_str(), &fs_info) == 0)
+		return ((uint64_t)fs_info.f_bavail * (uint64_t)fs_info.f_frsize >= p_bytes);
+#else
+	ULARGE_INTEGER free_bytes;
+	
+	if (GetDiskFreeSpaceExA(p_dir_path.c_str(), &free_bytes, NULL, NULL))
+		return ((uint64_t)free_bytes.QuadPart >= p_bytes);
+#endif
+	
+	return true;
+}
+
+std::string Eidos_GunzipFileToTemporaryFile(const std::string &p_gz_path, const std::string &p_suffix)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_GunzipFileToTemporaryFile():  filesystem write");
+	
+	// Read the whole compressed file; lodepng inflates from a complete buffer into a complete buffer, and we have no streaming
+	// inflater (eidos_zlib omits zlib's), so the compressed and decompressed data are both in memory at the peak.  The compressed
+	// data is freed before the decompressed data is written out, and the temporary directory is checked for space beforehand.
+	std::ifstream infile(p_gz_path.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+	
+	if (!infile.is_open())
+		EIDOS_TERMINATION << "ERROR (Eidos_GunzipFileToTemporaryFile): could not read file at path " << p_gz_path << "." << EidosTerminate(nullptr);
+	
+	std::streamoff gz_file_size = infile.tellg();
+	std::vector<unsigned char> gz_data((gz_file_size > 0) ? (size_t)gz_file_size : 0);
+	
+	infile.seekg(0);
+	
+	if (gz_data.size() && !infile.read((char *)gz_data.data(), (std::streamsize)gz_data.size()))
+		EIDOS_TERMINATION << "ERROR (Eidos_GunzipFileToTemporaryFile): could not read file at path " << p_gz_path << "." << EidosTerminate(nullptr);
+	
+	infile.close();
+	
+	size_t gz_size = gz_data.size();
+	const unsigned char *gz_bytes = gz_data.data();
+	
+	// parse the gzip header (RFC 1952): magic, method 8 (deflate), flags, mtime, extra flags, OS, then optional fields
+	if ((gz_size < 18) || (gz_bytes[0] != 0x1f) || (gz_bytes[1] != 0x8b) || (gz_bytes[2] != 8))
+		EIDOS_TERMINATION << "ERROR (Eidos_GunzipFileToTemporaryFile): file at path " << p_gz_path << " is not a gzip-compressed file." << EidosTerminate(nullptr);
+	
+	unsigned char flags = gz_bytes[3];
+	size_t header_end = 10;
+	
+	if (flags & 0x04)		// FEXTRA
+		header_end += 2 + (gz_bytes[header_end] | ((size_t)gz_bytes[header_end + 1] << 8));
+	if (flags & 0x08)		// FNAME
+		while ((header_end < gz_size) && gz_bytes[header_end++]) ;
+	if (flags & 0x10)		// FCOMMENT
+		while ((header_end < gz_size) && gz_bytes[header_end++]) ;
+	if (flags & 0x02)		// FHCRC
+		header_end += 2;
+	
+	if (header_end + 8 > gz_size)
+		EIDOS_TERMINATION << "ERROR (Eidos_GunzipFileToTemporaryFile): gzip-compressed file at path " << p_gz_path << " is truncated." << EidosTerminate(nullptr);
+	
+	// the deflate stream is followed by the CRC-32 and the length (mod 2^32) of the uncompressed data
+	const unsigned char *trailer = gz_bytes + gz_size - 8;
+	uint32_t expected_crc = (uint32_t)trailer[0] | ((uint32_t)trailer[1] << 8) | ((uint32_t)trailer[2] << 16) | ((uint32_t)trailer[3] << 24);
+	uint32_t expected_size = (uint32_t)trailer[4] | ((uint32_t)trailer[5] << 8) | ((uint32_t)trailer[6] << 16) | ((uint32_t)trailer[7] << 24);
+	
+	// the length is a lower bound on the decompressed size, so we can tell before inflating if the temporary directory is too full
+	std::string temp_dir = Eidos_TemporaryDirectory();
+	
+	if (!_Eidos_DirectoryHasSpace(temp_dir, expected_size))
+		EIDOS_TERMINATION << "ERROR (Eidos_GunzipFileToTemporaryFile): not enough space in the temporary directory " << temp_dir << " to decompress the file at path " << p_gz_path << " (" << expected_size << " bytes or more are needed)." << EidosTerminate(nullptr);
+	
+	// inflate the deflate stream
+	unsigned char *data = nullptr;
+	size_t data_size = 0;
+	unsigned error = lodepng_inflate(&data, &data_size, gz_bytes + header_end, gz_size - header_end - 8, &lodepng_default_decompress_settings);
+	
+	if (!error && ((uint32_t)crc32_z(0, data, data_size) != expected_crc || ((uint32_t)data_size != expected_size)))
+		error = 1;
+	
+	std::vector<unsigned char>().swap(gz_data);
+	
+	if (error)
+	{
+		free(data);
+		EIDOS_TERMINATION << "ERROR (Eidos_GunzipFileToTemporaryFile): gzip-compressed file at path " << p_gz_path << " is corrupt, or has more than one gzip member, and could not be decompressed." << EidosTerminate(nullptr);
+	}
+	
+	if ((data_size > expected_size) && !_Eidos_DirectoryHasSpace(temp_dir, data_size))
+	{
+		free(data);
+		EIDOS_TERMINATION << "ERROR (Eidos_GunzipFileToTemporaryFile): not enough space in the temporary directory " << temp_dir << " to decompress the file at path " << p_gz_path << " (" << data_size << " bytes are needed)." << EidosTerminate(nullptr);
+	}
+	
+	// write the decompressed data to a new temporary file
+	std::string file_path_template = temp_dir + "eidos_gunzip_XXXXXX" + p_suffix;
+	char *file_path_cstr = strdup(file_path_template.c_str());
+	int fd = Eidos_mkstemps(file_path_cstr, (int)p_suffix.length());
+	
+	if (fd == -1)
+	{
+		free(data);
+		free(file_path_cstr);
+		EIDOS_TERMINATION << "ERROR (Eidos_GunzipFileToTemporaryFile): could not create a temporary file for decompression." << EidosTerminate(nullptr);
+	}
+	
+	std::string file_path(file_path_cstr);
+	size_t written = 0;
+	
+	free(file_path_cstr);
+	
+	while (written < data_size)
+	{
+		ssize_t write_count = write(fd, data + written, data_size - written);
+		
+		if (write_count <= 0)
+			break;
+		
+		written += (size_t)write_count;
+	}
+	
+	// some filesystems report a write failure (running out of space, for example) only at close
+	bool close_failed = (close(fd) != 0);
+	
+	free(data);
+	
+	if ((written < data_size) || close_failed)
+	{
+		remove(file_path.c_str());
+		EIDOS_TERMINATION << "ERROR (Eidos_GunzipFileToTemporaryFile): could not write decompressed data to a temporary file in " << temp_dir << "; the disk may be full." << EidosTerminate(nullptr);
+	}
+	
+	return file_path;
+}
 
 #pragma mark -
 #pragma mark Utility functions
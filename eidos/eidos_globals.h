@@ -567,6 +567,16 @@ enum class EidosFileFlush {
 
 void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const std::string *> &p_contents, bool p_append, bool p_compress, EidosFileFlush p_flush_option);
 
+// Whole-file gzip compression and decompression, for binary formats that are written and read by other libraries; compression uses
+// eidos_zlib, which does not include zlib's decompressor, so decompression uses the inflate implementation in lodepng.  Only single-
+// member gzip files, such as those written by Eidos_GzipStreamToFile(), can be decompressed.  Eidos_GunzipFileToTemporaryFile() returns
+// the path of a new temporary file containing the decompressed data, which the caller is responsible for removing; it raises on failure,
+// including if the temporary directory does not have room for the decompressed data.  It is not streamed: lodepng inflates whole buffers,
+// so the compressed and decompressed data are both held in memory while decompressing.
+bool Eidos_FileIsGzipCompressed(const std::string &p_file_path);
+bool Eidos_GzipStreamToFile(FILE *p_source, const std::string &p_gz_path);
+std::string Eidos_GunzipFileToTemporaryFile(const std::string &p_gz_path, const std::string &p_suffix);
+
 
 // *******************************************************************************************************************
 //
@@ -1148,7 +1158,7 @@ enum _EidosGlobalStringID : uint32_t
 	gEidosID_Individual,
 	
 	gEidosID_LastEntry,					// IDs added by the Context should start here
-	gEidosID_LastContextEntry = 510		// IDs added by the Context must end before this value; Eidos reserves the remaining values
+	gEidosID_LastContextEntry = 520		// IDs added by the Context must end before this value; Eidos reserves the remaining values
 };
 
 extern std::vector<std::string> gEidosConstantNames;	// T, F, NULL, PI, E, INF, NAN
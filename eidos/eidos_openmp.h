@@ -95,6 +95,12 @@ extern int gEidosMaxThreads;
 extern int gEidosNumThreads;
 extern bool gEidosNumThreadsOverride;
 
+// This is set by the Eidos function parallelSetDeterministic().  When true, parallel regions that use the random number
+// generator, or that accumulate floating-point values in a thread-dependent order, must produce results that do not depend
+// on the number of threads used; they either use keyed RNG streams (see Eidos_RNG_KeyedRegion in eidos_rng.h) or run
+// single-threaded.  This is defined even in single-threaded builds, so that keyed streams give the same results there too.
+extern bool gEidosDeterministicParallel;
+
 
 // We want to use SIGTRAP to catch problems in the debugger in a few key spots, but it doesn't exist on Windows.
 // So we will just define SIGTRAP to be SIGABRT instead; SIGABRT is supported on Windows.
@@ -24,6 +24,9 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/time.h>
+#include <utility>
+#include <algorithm>
+#include <cmath>
 
 
 bool gEidos_RNG_Initialized = false;
@@ -34,6 +37,10 @@ Eidos_RNG_State gEidos_RNG_SINGLE;
 std::vector<Eidos_RNG_State *> gEidos_RNG_PERTHREAD;
 #endif
 
+// the main RNG state is swapped into this while a keyed region is active; see _Eidos_RNG_BeginKeyedRegion()
+static Eidos_RNG_State gEidos_RNG_KEYED_SPARE;
+static bool gEidos_RNG_KeyedRegionActive = false;
+
 
 static unsigned long int _Eidos_GenerateRNGSeed(void)
 {
@@ -107,6 +114,7 @@ void _Eidos_InitializeOneRNG(Eidos_RNG_State &r)
 	
 	r.random_bool_bit_counter_ = 0;
 	r.random_bool_bit_buffer_ = 0;
+	r.keyed_stream_ = 0;
 	
 	if (!r.gsl_rng_ || !r.mt_rng_.mt_)
 		EIDOS_TERMINATION << "ERROR (_Eidos_InitializeOneRNG): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
@@ -148,6 +156,8 @@ void Eidos_InitializeRNG(void)
 			std::cerr << "WARNING: parallel RNGs were not correctly initialized on their corresponding threads; this may cause slower random number generation." << std::endl;
 #endif	// end _OPENMP
 	
+	_Eidos_InitializeOneRNG(gEidos_RNG_KEYED_SPARE);
+	
 	gEidos_RNG_Initialized = true;
 }
 
@@ -197,6 +207,8 @@ void Eidos_FreeRNG(void)
 	gEidos_RNG_PERTHREAD.resize(0);
 #endif
 	
+	_Eidos_FreeOneRNG(gEidos_RNG_KEYED_SPARE);
+	
 	gEidos_RNG_Initialized = false;
 }
 
@@ -251,6 +263,183 @@ void Eidos_SetRNGSeed(unsigned long int p_seed)
 #endif
 }
 
+uint64_t _Eidos_RNG_BeginKeyedRegion(void)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("_Eidos_RNG_BeginKeyedRegion(): RNG change");
+	
+	if (gEidos_RNG_KeyedRegionActive)
+		EIDOS_TERMINATION << "ERROR (_Eidos_RNG_BeginKeyedRegion): (internal error) keyed RNG regions cannot be nested." << EidosTerminate(nullptr);
+	
+	// The key comes from the main RNG, so it is determined by the seed and by everything drawn before this point; zero is
+	// reserved to mean "not keyed", so we avoid it.  Drawing the key is the only effect the region has on the main RNG.
+	uint64_t key;
+	
+	do
+		key = Eidos_MT64_genrand64_int64(EIDOS_MT_RNG(0));
+	while (key == 0);
+	
+	// Swap the main RNG state out, so that thread 0's draws inside the region do not disturb it
+#ifndef _OPENMP
+	std::swap(gEidos_RNG_SINGLE, gEidos_RNG_KEYED_SPARE);
+#else
+	std::swap(*gEidos_RNG_PERTHREAD[0], gEidos_RNG_KEYED_SPARE);
+#endif
+	
+	gEidos_RNG_KeyedRegionActive = true;
+	
+	return key;
+}
+
+void _Eidos_RNG_EndKeyedRegion(void)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("_Eidos_RNG_EndKeyedRegion(): RNG change");
+	
+	if (!gEidos_RNG_KeyedRegionActive)
+		return;
+	
+#ifndef _OPENMP
+	std::swap(gEidos_RNG_SINGLE, gEidos_RNG_KEYED_SPARE);
+#else
+	std::swap(*gEidos_RNG_PERTHREAD[0], gEidos_RNG_KEYED_SPARE);
+#endif
+	
+	gEidos_RNG_KeyedRegionActive = false;
+}
+
+void Eidos_RNG_SeedKeyedStream(Eidos_RNG_State *p_rng_state, uint64_t p_key, uint64_t p_stream)
+{
+	// Two Philox blocks give us 256 bits derived from (key, stream); the first seeds taus2 directly, the second seeds MT64
+	// and the coin-flip buffer.  Philox is a bijection of the counter for a fixed key, so distinct streams get distinct seeds.
+	uint32_t key0 = (uint32_t)p_key, key1 = (uint32_t)(p_key >> 32);
+	uint32_t block0[4] = {(uint32_t)p_stream, (uint32_t)(p_stream >> 32), 0, 0};
+	uint32_t block1[4] = {(uint32_t)p_stream, (uint32_t)(p_stream >> 32), 1, 0};
+	
+	Eidos_Philox4x32(block0, key0, key1);
+	Eidos_Philox4x32(block1, key0, key1);
+	
+	// taus2 requires s1 >= 2, s2 >= 8, s3 >= 16; this follows taus_set() in the GSL, including its warm-up
+	taus_state_t *taus_state = (taus_state_t *)p_rng_state->gsl_rng_->state;
+	
+	taus_state->s1 = block0[0];
+	taus_state->s2 = block0[1];
+	taus_state->s3 = block0[2];
+	
+	if (taus_state->s1 < 2) taus_state->s1 += 2UL;
+	if (taus_state->s2 < 8) taus_state->s2 += 8UL;
+	if (taus_state->s3 < 16) taus_state->s3 += 16UL;
+	
+	for (int warmup = 0; warmup < 6; ++warmup)
+		taus_get_inline(taus_state);
+	
+	Eidos_MT64_init_genrand64(&p_rng_state->mt_rng_, ((uint64_t)block1[1] << 32) | block1[0]);
+	
+	p_rng_state->random_bool_bit_buffer_ = ((uint64_t)block1[3] << 32) | block1[2];
+	p_rng_state->random_bool_bit_counter_ = 63;		// as in Eidos_RandomBool(), bit 0 is considered used
+	p_rng_state->keyed_stream_ = p_stream;
+}
+
+// One step of taus2 on state held in locals; this is taus_get_inline() without the loads and stores, for the bulk fills below
+static inline __attribute__((always_inline)) unsigned long _Eidos_taus_step(unsigned long &s1, unsigned long &s2, unsigned long &s3)
+{
+#define TAUS_MASK 0xffffffffUL
+#define TAUSWORTHE(s,a,b,c,d) (((s &c) <<d) &TAUS_MASK) ^ ((((s <<a) &TAUS_MASK)^s) >>b)
+	
+	s1 = TAUSWORTHE (s1, 13, 19, 4294967294UL, 12);
+	s2 = TAUSWORTHE (s2, 2, 25, 4294967288UL, 4);
+	s3 = TAUSWORTHE (s3, 3, 11, 4294967280UL, 17);
+	
+#undef TAUS_MASK
+#undef TAUSWORTHE
+	
+	return (s1 ^ s2 ^ s3);
+}
+
+void Eidos_rng_uniform_fill(gsl_rng *p_r, double *p_buffer, int64_t p_count, double p_scale, double p_offset)
+{
+	RNG_INIT_CHECK();
+	
+	taus_state_t *state = (taus_state_t *)p_r->state;
+	unsigned long s1 = state->s1, s2 = state->s2, s3 = state->s3;
+	
+	if ((p_scale == 1.0) && (p_offset == 0.0))
+	{
+		for (int64_t index = 0; index < p_count; ++index)
+			p_buffer[index] = _Eidos_taus_step(s1, s2, s3) / 4294967296.0;
+	}
+	else
+	{
+		for (int64_t index = 0; index < p_count; ++index)
+			p_buffer[index] = (_Eidos_taus_step(s1, s2, s3) / 4294967296.0) * p_scale + p_offset;
+	}
+	
+	state->s1 = s1;
+	state->s2 = s2;
+	state->s3 = s3;
+}
+
+void Eidos_ran_exponential_fill(gsl_rng *p_r, double *p_buffer, int64_t p_count, double p_mu)
+{
+	// gsl_ran_exponential() is -mu * log1p(-u) for u from gsl_rng_uniform(); we draw all of the uniforms first, then transform
+	Eidos_rng_uniform_fill(p_r, p_buffer, p_count, 1.0, 0.0);
+	
+	for (int64_t index = 0; index < p_count; ++index)
+		p_buffer[index] = -p_mu * log1p(-p_buffer[index]);
+}
+
+void Eidos_ran_gaussian_fill(gsl_rng *p_r, double *p_buffer, int64_t p_count, double p_sigma, double p_mu)
+{
+	// gsl_ran_gaussian() uses the polar Box-Muller method, discarding the second variate; we must do the same to reproduce its
+	// values.  We work in batches: the rejection loop, which needs only uniforms, leaves y in p_buffer and r^2 in a local
+	// scratch buffer, and then a second pass does the log() and sqrt() for the whole batch.
+	RNG_INIT_CHECK();
+	
+	const int64_t batch_size = 256;
+	double r2_batch[batch_size];
+	taus_state_t *state = (taus_state_t *)p_r->state;
+	unsigned long s1 = state->s1, s2 = state->s2, s3 = state->s3;
+	
+	for (int64_t batch_start = 0; batch_start < p_count; batch_start += batch_size)
+	{
+		int64_t batch_count = std::min(batch_size, p_count - batch_start);
+		double *batch_buffer = p_buffer + batch_start;
+		
+		for (int64_t index = 0; index < batch_count; ++index)
+		{
+			double x, y, r2;
+			
+			do
+			{
+				// choose x,y in uniform square (-1,-1) to (+1,+1); this is Eidos_rng_uniform_pos(), inlined on our local state
+				double u;
+				
+				do u = _Eidos_taus_step(s1, s2, s3) / 4294967296.0; while (u == 0);
+				x = -1 + 2 * u;
+				
+				do u = _Eidos_taus_step(s1, s2, s3) / 4294967296.0; while (u == 0);
+				y = -1 + 2 * u;
+				
+				// see if it is in the unit circle
+				r2 = x * x + y * y;
+			}
+			while (r2 > 1.0 || r2 == 0);
+			
+			batch_buffer[index] = y;
+			r2_batch[index] = r2;
+		}
+		
+		for (int64_t index = 0; index < batch_count; ++index)
+		{
+			double r2 = r2_batch[index];
+			
+			batch_buffer[index] = p_sigma * batch_buffer[index] * sqrt(-2.0 * log(r2) / r2) + p_mu;
+		}
+	}
+	
+	state->s1 = s1;
+	state->s2 = s2;
+	state->s3 = s3;
+}
+
 #ifndef USE_GSL_POISSON
 double Eidos_FastRandomPoisson_PRECALCULATE(double p_mu)
 {
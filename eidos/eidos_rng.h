@@ -65,6 +65,9 @@ typedef struct Eidos_RNG_State
 	// random coin-flip generator; based on the MT64 generator now
 	int random_bool_bit_counter_;
 	uint64_t random_bool_bit_buffer_;
+	
+	// the keyed stream this state was last seeded for by Eidos_RNG_SeedKeyedStream(); see below
+	uint64_t keyed_stream_;
 } Eidos_RNG_State;
 
 
@@ -226,6 +229,19 @@ template <class T> inline void Eidos_ran_shuffle(gsl_rng *r, T *base, uint32_t n
 }
 
 
+// Bulk generation of continuous variates.  These fill p_buffer with p_count draws, producing exactly the same values, and
+// leaving the generator in exactly the same state, as the corresponding sequence of single draws would: Eidos_rng_uniform()
+// for the uniform fill, gsl_ran_exponential() for the exponential fill, and gsl_ran_gaussian() for the Gaussian fill.  They are
+// faster because the taus2 state stays in registers for the whole fill, with no per-draw call or function-pointer indirection,
+// and because the transcendental transforms are done in a separate pass over each batch of uniforms, which the compiler can
+// pipeline (and vectorize, where the math library permits).  Note that p_scale is applied before p_offset, as in the single-draw
+// expressions these replace (e.g., Eidos_rng_uniform(rng) * range + min, or gsl_ran_gaussian(rng, sigma) + mu).  These must only
+// be used with the taus2 generator that Eidos always uses for gsl_rng_; see taus_get_inline().
+void Eidos_rng_uniform_fill(gsl_rng *p_r, double *p_buffer, int64_t p_count, double p_scale, double p_offset);
+void Eidos_ran_exponential_fill(gsl_rng *p_r, double *p_buffer, int64_t p_count, double p_mu);
+void Eidos_ran_gaussian_fill(gsl_rng *p_r, double *p_buffer, int64_t p_count, double p_sigma, double p_mu);
+
+
 // Fast Poisson drawing, usable when mu is small; algorithm from Wikipedia, referenced to Luc Devroye,
 // Non-Uniform Random Variate Generation (Springer-Verlag, New York, 1986), chapter 10, page 505.
 // The GSL Poisson code does not allow us to precalculate the exp() value, it is more than three times
@@ -524,6 +540,71 @@ static inline __attribute__((always_inline)) bool Eidos_RandomBool(Eidos_RNG_Sta
 }
 
 
+#pragma mark -
+#pragma mark Keyed streams
+#pragma mark -
+
+// When gEidosDeterministicParallel is true (see parallelSetDeterministic()), parallel tasks that use the RNG need to produce
+// the same random numbers no matter how many threads run them, and no matter which thread runs which piece of the work.  To
+// achieve that, such a task is run as a "keyed region": a 64-bit key is drawn from the main RNG at the start of the region,
+// and the work is divided into fixed pieces (chunks of loop iterations), each of which gets its own "keyed stream".  The
+// thread that executes a piece reseeds its RNG state with Eidos_RNG_SeedKeyedStream() for that piece's stream index, so the
+// random numbers for the piece are a pure function of the key and the stream index.  The seeding is done with Philox4x32-10,
+// a counter-based generator (Salmon et al. 2011, "Parallel random numbers: as easy as 1, 2, 3"); the taus2 and MT64 generators
+// are then used for the actual draws as usual, so all existing code continues to work unmodified inside a keyed region.  The
+// main RNG state is swapped out for the duration of the region, so thread 0's work within the region does not disturb it;
+// the main RNG thus advances by exactly one draw (the key) per keyed region, regardless of the thread count.
+
+// The number of consecutive loop iterations that share one keyed stream, for loops over offspring; inside a keyed region, such
+// loops are scheduled in chunks of this size, so that each stream is consumed by a single thread in sequential order
+#define EIDOS_RNG_KEYED_CHUNK	16
+
+// Philox4x32-10: encrypts a 128-bit counter with a 64-bit key, in place
+inline __attribute__((always_inline)) void Eidos_Philox4x32(uint32_t p_counter[4], uint32_t p_key0, uint32_t p_key1)
+{
+	for (int round = 0; round < 10; ++round)
+	{
+		uint64_t product0 = (uint64_t)0xD2511F53UL * p_counter[0];
+		uint64_t product1 = (uint64_t)0xCD9E8D57UL * p_counter[2];
+		uint32_t c0 = (uint32_t)(product1 >> 32) ^ p_counter[1] ^ p_key0;
+		uint32_t c2 = (uint32_t)(product0 >> 32) ^ p_counter[3] ^ p_key1;
+		
+		p_counter[0] = c0;
+		p_counter[1] = (uint32_t)product1;
+		p_counter[2] = c2;
+		p_counter[3] = (uint32_t)product0;
+		
+		p_key0 += 0x9E3779B9UL;
+		p_key1 += 0xBB67AE85UL;
+	}
+}
+
+// begin/end a keyed region; called outside of any parallel region.  These are used through Eidos_RNG_KeyedRegion, below.
+uint64_t _Eidos_RNG_BeginKeyedRegion(void);
+void _Eidos_RNG_EndKeyedRegion(void);
+
+// reseed an RNG state (normally EIDOS_STATE_RNG(omp_get_thread_num())) for stream p_stream of the region keyed by p_key
+void Eidos_RNG_SeedKeyedStream(Eidos_RNG_State *p_rng_state, uint64_t p_key, uint64_t p_stream);
+
+// A keyed region, scoped to the lifetime of this object so that the main RNG state is restored even if an error is raised.  If
+// p_active is false (normally because gEidosDeterministicParallel is false), this does nothing and Key() returns 0; otherwise
+// Key() returns the (non-zero) key to be passed to Eidos_RNG_SeedKeyedStream().
+class Eidos_RNG_KeyedRegion
+{
+private:
+	uint64_t key_ = 0;
+	
+public:
+	Eidos_RNG_KeyedRegion(const Eidos_RNG_KeyedRegion&) = delete;
+	Eidos_RNG_KeyedRegion& operator=(const Eidos_RNG_KeyedRegion&) = delete;
+	
+	explicit Eidos_RNG_KeyedRegion(bool p_active) { if (p_active) key_ = _Eidos_RNG_BeginKeyedRegion(); }
+	~Eidos_RNG_KeyedRegion(void) { if (key_) _Eidos_RNG_EndKeyedRegion(); }
+	
+	inline __attribute__((always_inline)) uint64_t Key(void) const { return key_; }
+};
+
+
 #endif /* defined(__Eidos__eidos_rng__) */
 
 
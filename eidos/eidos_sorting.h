@@ -82,17 +82,18 @@ static void _Eidos_ParallelQuicksort_Comparator(T *values, int64_t lo, int64_t h
 		T &pivot3 = *(values + ((lo + hi) >> 1));
 		T pivot;
 		
-		if (pivot1 > pivot2)
+		// the comparisons use the comparator, so this works for types without operator>, and for descending sorts
+		if (comparator(pivot2, pivot1))
 		{
-			if (pivot2 > pivot3)		pivot = pivot2;
-			else if (pivot1 > pivot3)	pivot = pivot3;
-			else						pivot = pivot1;
+			if (comparator(pivot3, pivot2))			pivot = pivot2;
+			else if (comparator(pivot3, pivot1))	pivot = pivot3;
+			else									pivot = pivot1;
 		}
 		else
 		{
-			if (pivot1 > pivot3)		pivot = pivot1;
-			else if (pivot2 > pivot3)	pivot = pivot3;
-			else						pivot = pivot2;
+			if (comparator(pivot3, pivot1))			pivot = pivot1;
+			else if (comparator(pivot3, pivot2))	pivot = pivot3;
+			else									pivot = pivot2;
 		}
 		
 		// note that std::partition is not guaranteed to leave the pivot value in position
@@ -881,6 +881,13 @@ void _RunFunctionMiscTests(const std::string &temp_path)
 	EidosAssertScriptRaise("license('foo');", 0, "too many arguments supplied");
 	EidosAssertScriptRaise("license(_Test(7));", 0, "too many arguments supplied");
 	
+	// parallelGetDeterministic() / parallelSetDeterministic(); note these tests reset the mode to F
+	EidosAssertScriptSuccess_L("parallelGetDeterministic();", false);
+	EidosAssertScriptSuccess_L("parallelSetDeterministic(T); x = parallelGetDeterministic(); parallelSetDeterministic(F); x;", true);
+	EidosAssertScriptSuccess_L("parallelSetDeterministic(T); setSeed(5); x = runif(100000); y = rnorm(100000); setSeed(5); z = all(x == runif(100000)) & all(y == rnorm(100000)); parallelSetDeterministic(F); z;", true);
+	EidosAssertScriptRaise("parallelSetDeterministic(NULL);", 0, "cannot be type");
+	EidosAssertScriptRaise("parallelSetDeterministic(1);", 0, "cannot be type");
+	
 	// rm()
 	EidosAssertScriptSuccess_VOID("rm();");
 	EidosAssertScriptRaise("x=37; rm('x'); x;", 15, "undefined identifier");
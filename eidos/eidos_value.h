@@ -1088,6 +1088,19 @@ public:
 	inline __attribute__((always_inline)) EidosObject **data_mutable(void) { WILL_MODIFY(this); return values_; }		// the accessors below should be used to modify, since they handle Retain()/Release()
 	inline __attribute__((always_inline)) EidosObject * const *data(void) const { return values_; }
 	
+	// Replaces each non-null element with p_patch(element), with no retain/release; this is for client code that moves the
+	// objects it owns in memory, and so must repoint the values that refer to them (SLiM's mutation block compaction, e.g.)
+	template <typename F> void PatchPointers(const F &p_patch)
+	{
+		for (size_t value_index = 0; value_index < count_; ++value_index)
+		{
+			EidosObject *element = values_[value_index];
+			
+			if (element)
+				values_[value_index] = p_patch(element);
+		}
+	}
+	
 	// fast accessors; you can use the _RR or _NORR versions in a tight loop to avoid overhead, when you know
 	// whether the EidosObject subclass you are using inherits from EidosDictionaryRetained or not;
 	// you can call UsesRetainRelease() to find that out if you don't know or want to assert() for safety